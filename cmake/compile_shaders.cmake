@@ -12,6 +12,9 @@ file(GLOB_RECURSE GLSL_SOURCE_FILES CONFIGURE_DEPENDS
         "${SHADER_SRC_DIR}/*.frag"
         "${SHADER_SRC_DIR}/*.comp"
 )
+file(GLOB_RECURSE GLSL_INCLUDE_FILES CONFIGURE_DEPENDS
+        "${SHADER_SRC_DIR}/*.glsl"
+)
 set(SPIRV_BINARY_FILES)
 foreach(GLSL ${GLSL_SOURCE_FILES})
     file(RELATIVE_PATH REL ${SHADER_SRC_DIR} ${GLSL})
@@ -22,10 +25,69 @@ foreach(GLSL ${GLSL_SOURCE_FILES})
             OUTPUT ${SPIRV}
             COMMAND ${CMAKE_COMMAND} -E make_directory ${SPIRV_DIR}
             COMMAND ${GLSL_VALIDATOR} -V -I${SHADER_SRC_DIR} ${GLSL} -o ${SPIRV}
-            DEPENDS ${GLSL}
+            DEPENDS ${GLSL} ${GLSL_INCLUDE_FILES}
             COMMENT "glslangValidator Compiling: ${REL} -> ${SPIRV}"
             VERBATIM)
     list(APPEND SPIRV_BINARY_FILES ${SPIRV})
 endforeach()
 
+# Shaders that write the offscreen drawable also get one variant per storage format:
+# foo.comp -> foo.<format>.comp.spv compiled with -DOFFSCREEN_FORMAT=<format>.
+# The plain foo.comp.spv is the rgba16f default (see offscreen_shader_variant in renderer_iface.h).
+set(OFFSCREEN_VARIANT_SHADERS sky.comp gradient.comp gradient_color.comp barchart.comp barchart_font.comp linechart.comp scatter_shade.comp heatmap.comp
+        dashboard_line.comp dashboard_bars.comp dashboard_heat.comp)
+set(OFFSCREEN_VARIANT_FORMATS rgba8 rgb10_a2 r11f_g11f_b10f)
+foreach(REL ${OFFSCREEN_VARIANT_SHADERS})
+    set(GLSL "${SHADER_SRC_DIR}/${REL}")
+    get_filename_component(NAME_WE ${REL} NAME_WE)
+    get_filename_component(EXT ${REL} LAST_EXT)
+    foreach(FMT ${OFFSCREEN_VARIANT_FORMATS})
+        set(SPIRV "${SHADER_OUT_DIR}/${NAME_WE}.${FMT}${EXT}.spv")
+        add_custom_command(
+                OUTPUT ${SPIRV}
+                COMMAND ${CMAKE_COMMAND} -E make_directory ${SHADER_OUT_DIR}
+                COMMAND ${GLSL_VALIDATOR} -V -I${SHADER_SRC_DIR} -DOFFSCREEN_FORMAT=${FMT} ${GLSL} -o ${SPIRV}
+                DEPENDS ${GLSL} ${GLSL_INCLUDE_FILES}
+                COMMENT "glslangValidator Compiling: ${REL} (${FMT}) -> ${SPIRV}"
+                VERBATIM)
+        list(APPEND SPIRV_BINARY_FILES ${SPIRV})
+    endforeach()
+endforeach()
+
+# Compute shaders that can write the swapchain image directly (engine direct-present mode):
+# foo.comp -> foo.present.comp.spv with the bindless storage images declared writeonly and formatless.
+set(DIRECT_PRESENT_SHADERS barchart.comp)
+foreach(REL ${DIRECT_PRESENT_SHADERS})
+    set(GLSL "${SHADER_SRC_DIR}/${REL}")
+    get_filename_component(NAME_WE ${REL} NAME_WE)
+    get_filename_component(EXT ${REL} LAST_EXT)
+    set(SPIRV "${SHADER_OUT_DIR}/${NAME_WE}.present${EXT}.spv")
+    add_custom_command(
+            OUTPUT ${SPIRV}
+            COMMAND ${CMAKE_COMMAND} -E make_directory ${SHADER_OUT_DIR}
+            COMMAND ${GLSL_VALIDATOR} -V -I${SHADER_SRC_DIR} -DBINDLESS_STORAGE_IMAGE_WRITEONLY ${GLSL} -o ${SPIRV}
+            DEPENDS ${GLSL} ${GLSL_INCLUDE_FILES}
+            COMMENT "glslangValidator Compiling: ${REL} (present) -> ${SPIRV}"
+            VERBATIM)
+    list(APPEND SPIRV_BINARY_FILES ${SPIRV})
+endforeach()
+
+# Compute shaders with a subgroup-operation path: foo.comp -> foo.subgroup.comp.spv compiled with
+# -DSUBGROUP_OPS for SPIR-V 1.3; the plain foo.comp.spv stays loadable on devices without them.
+set(SUBGROUP_VARIANT_SHADERS scatter_splat.comp prim_reduce.comp prim_histogram.comp prim_scan.comp prim_compact.comp prim_radix.comp)
+foreach(REL ${SUBGROUP_VARIANT_SHADERS})
+    set(GLSL "${SHADER_SRC_DIR}/${REL}")
+    get_filename_component(NAME_WE ${REL} NAME_WE)
+    get_filename_component(EXT ${REL} LAST_EXT)
+    set(SPIRV "${SHADER_OUT_DIR}/${NAME_WE}.subgroup${EXT}.spv")
+    add_custom_command(
+            OUTPUT ${SPIRV}
+            COMMAND ${CMAKE_COMMAND} -E make_directory ${SHADER_OUT_DIR}
+            COMMAND ${GLSL_VALIDATOR} -V --target-env vulkan1.1 -I${SHADER_SRC_DIR} -DSUBGROUP_OPS ${GLSL} -o ${SPIRV}
+            DEPENDS ${GLSL} ${GLSL_INCLUDE_FILES}
+            COMMENT "glslangValidator Compiling: ${REL} (subgroup) -> ${SPIRV}"
+            VERBATIM)
+    list(APPEND SPIRV_BINARY_FILES ${SPIRV})
+endforeach()
+
 add_custom_target(compile_shaders ALL DEPENDS ${SPIRV_BINARY_FILES})
@@ -3,8 +3,13 @@
 #include "renderer_mesh.h"
 #include "renderer_barchart.h"
 #include "renderer_barchart_font.h"
+#include "renderer_linechart.h"
+#include "renderer_scatter.h"
+#include "renderer_heatmap.h"
+#include "renderer_dashboard.h"
 
 #include <memory>
+#include <span>
 
 std::unique_ptr<IRenderer> CreateDefaultComputeRenderer()
 {
@@ -13,4 +18,21 @@ std::unique_ptr<IRenderer> CreateDefaultComputeRenderer()
     // return std::make_unique<MeshRenderer>();
     // return std::make_unique<BarChartRenderer>();
     return std::make_unique<BarChartRendererMSDF>();
+}
+
+// 所有示例渲染器（按名字），供调试面板的报告使用
+std::span<const RendererInfo> ExampleRenderers()
+{
+    static const RendererInfo renderers[] = {
+        {"compute_bg", []() -> std::unique_ptr<IRenderer> { return std::make_unique<ComputeBackgroundRenderer>(); }},
+        {"triangle", []() -> std::unique_ptr<IRenderer> { return std::make_unique<TriangleRenderer>(); }},
+        {"mesh", []() -> std::unique_ptr<IRenderer> { return std::make_unique<MeshRenderer>(); }},
+        {"barchart", []() -> std::unique_ptr<IRenderer> { return std::make_unique<BarChartRenderer>(); }},
+        {"barchart_msdf", []() -> std::unique_ptr<IRenderer> { return std::make_unique<BarChartRendererMSDF>(); }},
+        {"linechart", []() -> std::unique_ptr<IRenderer> { return std::make_unique<LineChartRenderer>(); }},
+        {"scatter", []() -> std::unique_ptr<IRenderer> { return std::make_unique<ScatterRenderer>(); }},
+        {"heatmap", []() -> std::unique_ptr<IRenderer> { return std::make_unique<HeatmapRenderer>(); }},
+        {"dashboard", []() -> std::unique_ptr<IRenderer> { return std::make_unique<DashboardRenderer>(); }},
+    };
+    return renderers;
 }
\ No newline at end of file
@@ -0,0 +1,35 @@
+#ifndef EXAMPLE_UTILS_H
+#define EXAMPLE_UTILS_H
+
+#include <charconv>
+#include <cstdint>
+#include <string_view>
+#include <system_error>
+
+// 各示例渲染器共用的小工具：set_option 的数值解析、合成数据用的整数哈希
+namespace example_utils
+{
+    // 整段文本都是合法数字时才写入 out
+    template <typename T>
+    bool parse_number(std::string_view text, T& out)
+    {
+        auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), out);
+        return ec == std::errc() && ptr == text.data() + text.size();
+    }
+
+    // lowbias32 整数哈希
+    inline uint32_t hash_u32(uint32_t x)
+    {
+        x ^= x >> 16;
+        x *= 0x7FEB352Du;
+        x ^= x >> 15;
+        x *= 0x846CA68Bu;
+        x ^= x >> 16;
+        return x;
+    }
+
+    // 哈希的高 24 位映射到 [0, 1)
+    inline float hash01(uint32_t x) { return float(hash_u32(x) >> 8) * (1.0f / 16777216.0f); }
+}
+
+#endif //EXAMPLE_UTILS_H
@@ -0,0 +1,230 @@
+#include "line_downsample.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#define LINE_DOWNSAMPLE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace line_downsample
+{
+namespace
+{
+    // linechart_lttb.comp 的工作组大小，CPU 参考按同样的通道数求桶和
+    constexpr uint32_t LttbLanes = 256;
+
+    // 区间内的最小/最大值及其首次出现的下标
+    struct MinMax
+    {
+        float lo = std::numeric_limits<float>::infinity();
+        float hi = -std::numeric_limits<float>::infinity();
+        uint32_t loIdx = 0;
+        uint32_t hiIdx = 0;
+    };
+
+    // 对 [first, last) 按环拆成连续段，fn(ptr, n, 段首的相对下标)
+    template <typename F>
+    void for_each_segment(const Samples& s, uint32_t first, uint32_t last, F&& fn)
+    {
+        while (first < last)
+        {
+            const uint32_t slot = (s.start + first) & (s.capacity - 1);
+            const uint32_t n = std::min(last - first, s.capacity - slot);
+            fn(s.data + slot, n, first);
+            first += n;
+        }
+    }
+
+    // 下标更大的段后到，所以严格比较即可保留首次出现
+    void scan_minmax(const float* p, uint32_t n, uint32_t base, MinMax& m)
+    {
+        uint32_t i = 0;
+#if LINE_DOWNSAMPLE_SSE2
+        if (n >= 8)
+        {
+            __m128 vlo = _mm_set1_ps(m.lo), vhi = _mm_set1_ps(m.hi);
+            __m128i ilo = _mm_set1_epi32(int(m.loIdx)), ihi = _mm_set1_epi32(int(m.hiIdx));
+            __m128i idx = _mm_setr_epi32(int(base), int(base + 1), int(base + 2), int(base + 3));
+            const __m128i step = _mm_set1_epi32(4);
+            for (; i + 4 <= n; i += 4)
+            {
+                const __m128 v = _mm_loadu_ps(p + i);
+                const __m128 lt = _mm_cmplt_ps(v, vlo);
+                const __m128 gt = _mm_cmpgt_ps(v, vhi);
+                vlo = _mm_or_ps(_mm_and_ps(lt, v), _mm_andnot_ps(lt, vlo));
+                vhi = _mm_or_ps(_mm_and_ps(gt, v), _mm_andnot_ps(gt, vhi));
+                const __m128i lti = _mm_castps_si128(lt), gti = _mm_castps_si128(gt);
+                ilo = _mm_or_si128(_mm_and_si128(lti, idx), _mm_andnot_si128(lti, ilo));
+                ihi = _mm_or_si128(_mm_and_si128(gti, idx), _mm_andnot_si128(gti, ihi));
+                idx = _mm_add_epi32(idx, step);
+            }
+            alignas(16) float lo[4], hi[4];
+            alignas(16) uint32_t loI[4], hiI[4];
+            _mm_store_ps(lo, vlo);
+            _mm_store_ps(hi, vhi);
+            _mm_store_si128(reinterpret_cast<__m128i*>(loI), ilo);
+            _mm_store_si128(reinterpret_cast<__m128i*>(hiI), ihi);
+            // 各通道各自保留了首次出现；合并时相等取下标小的
+            for (int k = 0; k < 4; ++k)
+            {
+                if (lo[k] < m.lo || (lo[k] == m.lo && loI[k] < m.loIdx)) { m.lo = lo[k]; m.loIdx = loI[k]; }
+                if (hi[k] > m.hi || (hi[k] == m.hi && hiI[k] < m.hiIdx)) { m.hi = hi[k]; m.hiIdx = hiI[k]; }
+            }
+        }
+#endif
+        for (; i < n; ++i)
+        {
+            if (p[i] < m.lo) { m.lo = p[i]; m.loIdx = base + i; }
+            if (p[i] > m.hi) { m.hi = p[i]; m.hiIdx = base + i; }
+        }
+    }
+
+    // [first, last) 的和，加法顺序与 linechart_lttb.comp 完全相同：第 r 个样本（相对 first）
+    // 累加进通道 r % 256，各通道按下标顺序累加，最后 256 个通道两两折半归约。
+    // 单次浮点加法两边都是正确舍入，顺序相同结果就逐位相同
+    float bucket_sum(const Samples& s, uint32_t first, uint32_t last)
+    {
+        alignas(16) float lanes[LttbLanes] = {};
+        for_each_segment(s, first, last, [&](const float* p, uint32_t n, uint32_t base) {
+            uint32_t i = 0;
+#if LINE_DOWNSAMPLE_SSE2
+            // 通道号对齐到 4 之后每 4 个样本正好落在相邻 4 个通道（不会跨过 256 回绕），整组相加
+            for (; i < n && ((base + i - first) & 3) != 0; ++i) lanes[(base + i - first) & (LttbLanes - 1)] += p[i];
+            for (; i + 4 <= n; i += 4)
+            {
+                float* lane = lanes + ((base + i - first) & (LttbLanes - 1));
+                _mm_store_ps(lane, _mm_add_ps(_mm_load_ps(lane), _mm_loadu_ps(p + i)));
+            }
+#endif
+            for (; i < n; ++i) lanes[(base + i - first) & (LttbLanes - 1)] += p[i];
+        });
+        for (uint32_t stride = LttbLanes / 2; stride > 0; stride >>= 1)
+            for (uint32_t l = 0; l < stride; ++l) lanes[l] += lanes[l + stride];
+        return lanes[0];
+    }
+
+    // 三角形面积（×2×桶内点数）最大的点；相等取下标小的。b 的 x 坐标取相对 a 的整数差。
+    // dyc = 平均点 y 差 × 点数，cx = 平均点 x 差 × 点数：不做除法，运算与 GPU 逐次相同
+    void scan_area(const float* p, uint32_t n, uint32_t base, uint32_t a, float ya, float cx, float dyc,
+                   float& best, uint32_t& bestIdx)
+    {
+        uint32_t i = 0;
+#if LINE_DOWNSAMPLE_SSE2
+        if (n >= 8)
+        {
+            const __m128 vya = _mm_set1_ps(ya), vcx = _mm_set1_ps(cx), vdyc = _mm_set1_ps(dyc);
+            const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+            __m128 vbest = _mm_set1_ps(best);
+            __m128i ibest = _mm_set1_epi32(int(bestIdx));
+            __m128i idx = _mm_setr_epi32(int(base), int(base + 1), int(base + 2), int(base + 3));
+            const __m128i step = _mm_set1_epi32(4);
+            const __m128i va = _mm_set1_epi32(int(a));
+            for (; i + 4 <= n; i += 4)
+            {
+                const __m128 yb = _mm_loadu_ps(p + i);
+                const __m128 bx = _mm_cvtepi32_ps(_mm_sub_epi32(idx, va));
+                const __m128 area = _mm_and_ps(absMask, _mm_sub_ps(_mm_mul_ps(bx, vdyc), _mm_mul_ps(vcx, _mm_sub_ps(yb, vya))));
+                const __m128 gt = _mm_cmpgt_ps(area, vbest);
+                vbest = _mm_or_ps(_mm_and_ps(gt, area), _mm_andnot_ps(gt, vbest));
+                const __m128i gti = _mm_castps_si128(gt);
+                ibest = _mm_or_si128(_mm_and_si128(gti, idx), _mm_andnot_si128(gti, ibest));
+                idx = _mm_add_epi32(idx, step);
+            }
+            alignas(16) float lanes[4];
+            alignas(16) uint32_t lanesI[4];
+            _mm_store_ps(lanes, vbest);
+            _mm_store_si128(reinterpret_cast<__m128i*>(lanesI), ibest);
+            for (int k = 0; k < 4; ++k)
+            {
+                if (lanes[k] > best || (lanes[k] == best && lanesI[k] < bestIdx)) { best = lanes[k]; bestIdx = lanesI[k]; }
+            }
+        }
+#endif
+        for (; i < n; ++i)
+        {
+            const float bx = float(int32_t(base + i - a));
+            const float area = std::abs(bx * dyc - cx * (p[i] - ya));
+            if (area > best) { best = area; bestIdx = base + i; }
+        }
+    }
+}
+
+void m4(const Samples& s, uint32_t columns, std::span<Point> out)
+{
+    if (columns == 0 || out.size() < size_t(columns) * 4) return;
+    if (s.count < 2)
+    {
+        std::fill_n(out.begin(), size_t(columns) * 4, Point{0, s.count ? s[0] : 0.0f});
+        return;
+    }
+
+    const float last = float(s.count - 1);
+    const float scale = last / float(columns);
+    for (uint32_t c = 0; c < columns; ++c)
+    {
+        const float u0 = float(c) * scale;
+        const float u1 = std::min(float(c + 1) * scale, last);
+        const uint32_t i0 = uint32_t(std::ceil(u0));
+        const uint32_t i1 = uint32_t(std::floor(u1));
+        Point* o = out.data() + size_t(c) * 4;
+        if (i0 > i1)
+        {
+            std::fill_n(o, 4, Point{i1, s[i1]});
+            continue;
+        }
+        MinMax m;
+        m.loIdx = m.hiIdx = i0;
+        for_each_segment(s, i0, i1 + 1, [&](const float* p, uint32_t n, uint32_t base) { scan_minmax(p, n, base, m); });
+        const uint32_t a = std::min(m.loIdx, m.hiIdx), b = std::max(m.loIdx, m.hiIdx);
+        o[0] = {i0, s[i0]};
+        o[1] = {a, s[a]};
+        o[2] = {b, s[b]};
+        o[3] = {i1, s[i1]};
+    }
+}
+
+void lttb(const Samples& s, uint32_t threshold, std::span<Point> out)
+{
+    if (threshold == 0 || out.size() < threshold) return;
+    const uint32_t n = s.count;
+    if (n <= threshold || threshold < 3)
+    {
+        const uint32_t copied = std::min(n, threshold);
+        for (uint32_t i = 0; i < copied; ++i) out[i] = {i, s[i]};
+        const Point pad = n ? Point{n - 1, s[n - 1]} : Point{0, 0.0f};
+        std::fill(out.begin() + copied, out.begin() + threshold, pad);
+        return;
+    }
+
+    // 桶 b 覆盖 [floor(b * every) + 1, floor((b + 1) * every) + 1)，首尾两点单独保留
+    const float every = float(n - 2) / float(threshold - 2);
+    auto bucket_begin = [&](uint32_t b) { return std::min(uint32_t(std::floor(float(b) * every)) + 1, n - 1); };
+
+    uint32_t a = 0;
+    float ya = s[0];
+    out[0] = {0, ya};
+    for (uint32_t b = 0; b + 2 < threshold; ++b)
+    {
+        // 下一个桶的平均点（最后一个桶用末点）
+        const uint32_t avgBegin = bucket_begin(b + 1);
+        const uint32_t avgEnd = std::max(std::min(bucket_begin(b + 2), n), avgBegin + 1);
+        // 面积整体乘以桶内点数（正数，argmax 不变），省掉求平均的除法：GPU 上的除法不保证正确舍入
+        const float cnt = float(avgEnd - avgBegin);
+        const float dyc = bucket_sum(s, avgBegin, avgEnd) - ya * cnt;
+        const float cx = float(int32_t(avgBegin + avgEnd - 1 - 2 * a)) * 0.5f * cnt;
+
+        float best = -1.0f;
+        uint32_t bestIdx = bucket_begin(b);
+        for_each_segment(s, bucket_begin(b), bucket_begin(b + 1), [&](const float* p, uint32_t cnt, uint32_t base) {
+            scan_area(p, cnt, base, a, ya, cx, dyc, best, bestIdx);
+        });
+        a = bestIdx;
+        ya = s[a];
+        out[b + 1] = {a, ya};
+    }
+    out[threshold - 1] = {n - 1, s[n - 1]};
+}
+}
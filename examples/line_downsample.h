@@ -0,0 +1,38 @@
+#ifndef LINE_DOWNSAMPLE_H
+#define LINE_DOWNSAMPLE_H
+
+#include <cstdint>
+#include <span>
+
+// 折线降采样的 CPU 参考实现（SSE2，其他平台退回标量），与 linechart_m4.comp /
+// linechart_lttb.comp 逐点一致，用于正确性校验和 CPU/GPU 基准对比。
+namespace line_downsample
+{
+    // 与 linechart_common.glsl 的 DownsamplePoint 相同：index 相对视窗起点
+    struct Point
+    {
+        uint32_t index;
+        float value;
+    };
+
+    // 环形缓冲里的一段样本：[start, start + count) 按 capacity 回绕，最多拆成两段连续内存
+    struct Samples
+    {
+        const float* data;
+        uint32_t capacity; // 2 的幂；普通连续数组传 >= count 的任意 2 的幂并令 start = 0
+        uint32_t start;
+        uint32_t count;
+
+        float operator[](uint32_t i) const { return data[(start + i) & (capacity - 1)]; }
+    };
+
+    // M4：每列输出 4 个点（首、最小/最大按下标排序、尾），列的划分与 linechart_reduce.comp 相同；
+    // 没有整数样本落入的列输出 4 个 floor(u1) 处的样本。out 至少 4 * columns 个点
+    void m4(const Samples& s, uint32_t columns, std::span<Point> out);
+
+    // Largest-Triangle-Three-Buckets：输出 threshold 个点（含首尾），样本不多于 threshold
+    // 时原样输出并用最后一个点补齐。out 至少 threshold 个点
+    void lttb(const Samples& s, uint32_t threshold, std::span<Point> out);
+}
+
+#endif //LINE_DOWNSAMPLE_H
@@ -2,8 +2,16 @@
 #include <stdexcept>
 #include <array>
 #include <vector>
+#include <string>
 #include <fstream>
+#include <algorithm>
+#include <cmath>
 #include "src/ext/vk_initializers.h"
+#include "src/ext/vk_pipelines.h"
+#include "src/ext/vk_scratch.h"
+#include "src/ext/vk_deletion.h"
+#include "src/gpu_memory.h"
+#include "imgui.h"
 
 #ifndef VK_CHECK
 #define VK_CHECK(x) do { VkResult err__ = (x); if (err__ != VK_SUCCESS) { throw std::runtime_error(std::string("Vulkan error ") + std::to_string(err__)); } } while(0)
@@ -36,51 +44,281 @@ VkShaderModule create_shader_module(VkDevice device, const std::vector<char>& co
 
 } // namespace
 
+BarChartRenderer::BarChartRenderer()
+{
+    // 默认数据：11 根柱子，值为 0..10
+    std::vector<float> values(11);
+    for (uint32_t i = 0; i < values.size(); ++i) values[i] = float(i);
+    set_data(values);
+}
+
+// ==== 数据 API ====
+
+void BarChartRenderer::set_data(std::span<const float> values, uint32_t seriesCount, Layout layout)
+{
+    series_ = std::max(seriesCount, 1u);
+    layout_ = layout;
+    // 末尾不足一组的值丢弃
+    data_.assign(values.begin(), values.begin() + (values.size() / series_) * series_);
+    dirty_begin_ = 0;
+    dirty_end_ = data_.size();
+    changes_.clear();
+    full_damage_ = true;
+}
+
+void BarChartRenderer::update_value(uint32_t bar, uint32_t series, float value)
+{
+    if (bar >= bar_count() || series >= series_) return;
+    const size_t idx = size_t(bar) * series_ + series;
+    if (data_[idx] == value) return;
+
+    if (!full_damage_ && changes_.size() < MaxTrackedChanges)
+    {
+        const bool stacked = layout_ == Layout::Stacked && series_ > 1;
+        changes_.push_back(Change{bar, series, stacked ? column_total(bar) : data_[idx]});
+    }
+    else
+    {
+        full_damage_ = true;
+        changes_.clear();
+    }
+    data_[idx] = value;
+
+    if (dirty_begin_ == dirty_end_) { dirty_begin_ = idx; dirty_end_ = idx + 1; }
+    else { dirty_begin_ = std::min(dirty_begin_, idx); dirty_end_ = std::max(dirty_end_, idx + 1); }
+}
+
+void BarChartRenderer::set_max_value(float maxValue)
+{
+    if (maxValue <= 0.0f || maxValue == params_.max_value) return;
+    params_.max_value = maxValue;
+    full_damage_ = true;
+    changes_.clear();
+}
+
 // ==== IRenderer 接口实现 ====
 
 void BarChartRenderer::initialize(const RenderContext& ctx)
 {
     create_pipelines(ctx);
-    create_descriptors(ctx);
+    // 新的数据缓冲在第一次 record 时创建并整体上传
+    dirty_begin_ = 0;
+    dirty_end_ = data_.size();
+    full_damage_ = true;
 }
 
 void BarChartRenderer::destroy(const RenderContext& ctx)
 {
-    destroy_descriptors(ctx.device);
     destroy_pipelines(ctx.device);
+    destroy_data(ctx.allocator);
 }
 
 void BarChartRenderer::on_swapchain_resized(const RenderContext& ctx)
 {
-    // 重新写 dset 指向新的 offscreen view
-    destroy_descriptors(ctx.device);
-    create_descriptors(ctx);
+    // offscreen 的 bindless 句柄由引擎保持稳定，无需重写描述符
+}
+
+void BarChartRenderer::on_imgui()
+{
+    ImGui::Begin("Bar Chart");
+    ImGui::Text("%u bars x %u series, %.1f KB on GPU", bar_count(), series_,
+                double(gpu_.capacity * sizeof(float)) / 1024.0);
+    ImGui::SliderInt("Bars", &gen_bars_, 1, 200000, "%d", ImGuiSliderFlags_Logarithmic);
+    ImGui::SliderInt("Series", &gen_series_, 1, 6);
+    ImGui::RadioButton("Grouped", &gen_layout_, int(Layout::Grouped));
+    ImGui::SameLine();
+    ImGui::RadioButton("Stacked", &gen_layout_, int(Layout::Stacked));
+    if (ImGui::Button("Generate data")) generate_demo_data();
+
+    ImGui::Separator();
+    int path = int(path_);
+    ImGui::RadioButton("Auto", &path, int(Path::Auto));
+    ImGui::SameLine();
+    ImGui::RadioButton("Compute", &path, int(Path::Compute));
+    ImGui::SameLine();
+    ImGui::RadioButton("Raster", &path, int(Path::Raster));
+    if (path != int(path_)) set_path(Path(path));
+    ImGui::Text("Drawing with %s (auto: raster up to %u instances)", use_raster() ? "raster" : "compute", raster_threshold_);
+
+    ImGui::Separator();
+    ImGui::Checkbox("Animate one bar per frame", &animate_);
+    float pct = target_damage_ * 100.0f;
+    if (ImGui::SliderFloat("Changed area per frame", &pct, 0.1f, 20.0f, "%.1f%%", ImGuiSliderFlags_Logarithmic))
+        target_damage_ = pct / 100.0f;
+    ImGui::TextDisabled("Compare with Benchmarks > Damage tracking");
+    ImGui::End();
+}
+
+void BarChartRenderer::generate_demo_data()
+{
+    const uint32_t bars = uint32_t(std::max(gen_bars_, 1));
+    const uint32_t series = uint32_t(std::max(gen_series_, 1));
+    const Layout layout = Layout(gen_layout_);
+    // 堆叠时每段取 1/S，总高度仍在 max_value 内
+    const float scale = params_.max_value * (layout == Layout::Stacked ? 1.0f / float(series) : 1.0f);
+    std::vector<float> values(size_t(bars) * series);
+    for (uint32_t i = 0; i < bars; ++i)
+        for (uint32_t s = 0; s < series; ++s)
+            values[size_t(i) * series + s] = scale * (0.55f + 0.4f * std::sin(float(i) * 0.013f + float(s) * 1.7f));
+    set_data(values, series, layout);
+}
+
+void BarChartRenderer::report_damage(DamageRegion& damage, const RenderContext& ctx)
+{
+    (void)ctx;
+    const VkExtent2D e = damage.extent();
+    if (animate_) animate_step(e);
+
+    if (full_damage_ || bench_full_redraw_) damage.add_full();
+    else for (const Change& c : changes_) damage.add(change_rect(c, e.width, e.height));
+    full_damage_ = false;
+    changes_.clear();
+}
+
+void BarChartRenderer::animate_step(VkExtent2D extent)
+{
+    const uint32_t bars = bar_count();
+    const Geometry g = geometry(extent.width, extent.height);
+    if (bars == 0 || g.innerH <= 0.0f) return;
+
+    // 轮流改每个值；改动面积 = 目标占比 × 整帧，Δh = 面积 / 改动宽度，再换算回数值
+    const uint32_t step = anim_step_++ % (bars * series_);
+    const uint32_t bar = step % bars;
+    const uint32_t series = step / bars;
+    const bool stacked = layout_ == Layout::Stacked && series_ > 1;
+    const float changedW = stacked || series_ == 1 ? g.barW : g.barW / float(series_);
+    const float areaPx = target_damage_ * float(extent.width) * float(extent.height);
+    const float dv = std::min(areaPx / changedW / g.innerH * params_.max_value, params_.max_value);
+
+    // 到顶后回落
+    const float old = data_[size_t(bar) * series_ + series];
+    const float top = stacked ? column_total(bar) - old + dv : old + dv;
+    update_value(bar, series, top > params_.max_value ? std::max(old - dv, 0.0f) : old + dv);
+}
+
+BarChartRenderer::Geometry BarChartRenderer::geometry(uint32_t width, uint32_t height) const
+{
+    Geometry g{};
+    const float innerW = float(width) - 2.0f * params_.margin_px;
+    g.innerH = float(height) - params_.margin_px - params_.base_line_px;
+    g.slotW = innerW / float(std::max(bar_count(), 1u));
+    g.gap = std::min(params_.gap_px, g.slotW * 0.25f);
+    g.barW = std::max(1.0f, g.slotW - g.gap);
+    g.axisY = float(int(height) - int(params_.base_line_px));
+    return g;
+}
+
+float BarChartRenderer::column_total(uint32_t bar) const
+{
+    float total = 0.0f;
+    for (uint32_t s = 0; s < series_; ++s) total += std::max(data_[size_t(bar) * series_ + s], 0.0f);
+    return total;
+}
+
+VkRect2D BarChartRenderer::change_rect(const Change& c, uint32_t width, uint32_t height) const
+{
+    const Geometry g = geometry(width, height);
+    auto h = [&](float v) { return g.innerH * std::clamp(v / params_.max_value, 0.0f, 1.0f); };
+
+    float x0 = params_.margin_px + float(c.bar) * g.slotW + g.gap * 0.5f;
+    float x1 = x0 + g.barW;
+    float y0, y1;
+    if (layout_ == Layout::Stacked && series_ > 1)
+    {
+        // 改一段会移动它上面的所有段：从轴线到新旧总高的较高者
+        y0 = g.axisY - std::max(h(c.before), h(column_total(c.bar)));
+        y1 = g.axisY;
+    }
+    else
+    {
+        const float now = data_[size_t(c.bar) * series_ + c.series];
+        if (series_ > 1)
+        {
+            const float subW = g.barW / float(series_);
+            x0 += float(c.series) * subW;
+            x1 = x0 + subW;
+        }
+        y0 = g.axisY - std::max(h(c.before), h(now));
+        y1 = g.axisY - std::min(h(c.before), h(now));
+    }
+    // shader 的测试为 y0 <= y <= y1，底边多包含一行
+    const int32_t rx0 = int32_t(std::floor(x0));
+    const int32_t ry0 = int32_t(std::floor(y0));
+    const int32_t rx1 = int32_t(std::ceil(x1));
+    const int32_t ry1 = int32_t(std::ceil(y1)) + 1;
+    return VkRect2D{{rx0, ry0}, {uint32_t(std::max(rx1 - rx0, 0)), uint32_t(std::max(ry1 - ry0, 0))}};
 }
 
 void BarChartRenderer::record(VkCommandBuffer cmd, uint32_t width, uint32_t height, const RenderContext& ctx)
 {
-    // 1) offscreen 改为 GENERAL 供 compute 写
+    // 新数据先拷进 GPU 缓冲，两条路径共用
+    upload_data(cmd, ctx);
+
+    // direct-present：compute 直接写 swapchain，省掉 offscreen 写 + blit 的整屏读写
+    const bool direct = ctx.swapchainStorageIndex != BindlessHeap::InvalidIndex && pipes_.presentPipeline && !use_raster();
+    if (direct)
+    {
+        // 源 stage 与引擎等待 acquire 信号量的 COMPUTE_SHADER stage 串联
+        transition_image(cmd,
+                         ctx.swapchainImage,
+                         VK_IMAGE_LAYOUT_UNDEFINED,
+                         VK_IMAGE_LAYOUT_GENERAL,
+                         VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                         VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                         0,
+                         VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT);
+        // swapchain 保持 GENERAL，引擎 composite pass 在其上叠加 ImGui
+        record_bars(cmd, pipes_.presentPipeline, ctx.swapchainStorageIndex, width, height, ctx);
+        return;
+    }
+
+    // 没有变化的像素：offscreen 保持上一帧内容
+    const bool partial = ctx.damage && !ctx.damage->full();
+    if (partial && ctx.damage->empty()) return;
+
+    if (use_raster())
+    {
+        record_raster(cmd, width, height, ctx);
+        return;
+    }
+
+    // 1) offscreen 改为 GENERAL 供 compute 写（等上一帧 composite 的采样/blit 读完）
+    //    局部重画必须保留旧内容，不能从 UNDEFINED 转换
     transition_image(cmd,
                      ctx.offscreenImage,
-                     VK_IMAGE_LAYOUT_UNDEFINED,
+                     partial ? VK_IMAGE_LAYOUT_GENERAL : VK_IMAGE_LAYOUT_UNDEFINED,
                      VK_IMAGE_LAYOUT_GENERAL,
-                     VK_PIPELINE_STAGE_2_NONE,
+                     VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_2_TRANSFER_BIT,
                      VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
                      0,
                      VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT);
 
-    // 2) 绑定 compute 与描述符
-    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipes_.pipeline);
-    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipes_.layout,
-                            0, 1, &dset_, 0, nullptr);
+    // 2) 绑定 compute、push 常量、dispatch
+    record_bars(cmd, pipes_.pipeline, ctx.offscreenStorageIndex, width, height, ctx);
 
-    // 3) push 常量
+    // 3) offscreen 保持 GENERAL，由引擎 composite pass 采样到 swapchain
+}
+
+void BarChartRenderer::record_bars(VkCommandBuffer cmd, VkPipeline pipeline, uint32_t imageIndex,
+                                   uint32_t width, uint32_t height, const RenderContext& ctx)
+{
+    // 绑定 compute（bindless 堆已由引擎在帧开始时绑定到 set 0）
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+
+    // push 常量：资源通过 32 位句柄引用
     struct Push {
         uint32_t W, H;
         float margin_px;
         float gap_px;
         float base_line_px;
         float max_value;
+        uint32_t image_index;
+        uint32_t tile_count;
+        VkDeviceAddress tiles;
+        VkDeviceAddress values;
+        uint32_t bar_count;
+        uint32_t series_count;
+        uint32_t layout_mode;
     } push;
     push.W = width;
     push.H = height;
@@ -88,72 +326,251 @@ void BarChartRenderer::record(VkCommandBuffer cmd, uint32_t width, uint32_t heig
     push.gap_px = params_.gap_px;
     push.base_line_px = params_.base_line_px;
     push.max_value = params_.max_value;
-    vkCmdPushConstants(cmd, pipes_.layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(Push), &push);
+    push.image_index = imageIndex;
+    // direct-present 每帧都是新的 swapchain 图像，只能整帧画
+    const bool tiled = pipeline == pipes_.pipeline && ctx.damage && !ctx.damage->full();
+    push.tile_count = tiled ? ctx.damage->tile_count() : 0;
+    push.tiles = tiled ? ctx.damage->tiles() : 0;
+    push.values = gpu_.address;
+    push.bar_count = gpu_.buffer ? bar_count() : 0;
+    push.series_count = series_;
+    push.layout_mode = static_cast<uint32_t>(layout_);
+    ctx.bindless->push(cmd, &push, sizeof(Push));
+
+    if (tiled)
+    {
+        // 每个脏 tile 一个 16x16 workgroup；超过 65535 块时排成二维网格
+        const VkExtent2D groups = ctx.damage->tile_groups();
+        vkCmdDispatch(cmd, groups.width, groups.height, 1);
+        return;
+    }
 
-    // 4) dispatch
     const uint32_t groupSizeX = 16;
     const uint32_t groupSizeY = 16;
     uint32_t gx = (width  + groupSizeX - 1) / groupSizeX;
     uint32_t gy = (height + groupSizeY - 1) / groupSizeY;
     vkCmdDispatch(cmd, gx, gy, 1);
+}
 
-    // 5) 准备拷贝
+bool BarChartRenderer::use_raster() const
+{
+    if (!pipes_.rasterPipeline) return false;
+    if (path_ == Path::Auto) return data_.size() <= raster_threshold_;
+    return path_ == Path::Raster;
+}
+
+void BarChartRenderer::record_raster(VkCommandBuffer cmd, uint32_t width, uint32_t height, const RenderContext& ctx)
+{
+    const bool partial = ctx.damage && !ctx.damage->full();
+
+    // 1) offscreen 作颜色附件（GENERAL 可直接渲染）；局部重画时 LOAD 保留旧内容
     transition_image(cmd,
                      ctx.offscreenImage,
+                     partial ? VK_IMAGE_LAYOUT_GENERAL : VK_IMAGE_LAYOUT_UNDEFINED,
                      VK_IMAGE_LAYOUT_GENERAL,
-                     VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-                     VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
-                     VK_PIPELINE_STAGE_2_TRANSFER_BIT,
-                     VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
-                     VK_ACCESS_2_TRANSFER_READ_BIT);
-
-    // 注意：engine 的 end_frame 在 present 前不会再改布局
-    // ui_->render_overlay 需要 swapchain 在 TRANSFER_DST_OPTIMAL
-    // 所以这里把 swapchain image 变为 TRANSFER_DST_OPTIMAL 并保持
-    transition_image(cmd,
-                     ctx.swapchainImage,
-                     VK_IMAGE_LAYOUT_UNDEFINED,
-                     VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                     VK_PIPELINE_STAGE_2_NONE,
-                     VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+                     VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+                     VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
                      0,
-                     VK_ACCESS_2_TRANSFER_WRITE_BIT);
+                     VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT);
+
+    // 与 barchart_common.glsl 一致的配色
+    const VkClearColorValue background{{0.08f, 0.09f, 0.10f, 1.0f}};
+    const VkClearColorValue axis{{0.75f, 0.75f, 0.78f, 1.0f}};
+
+    VkRenderingAttachmentInfo color{VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO};
+    color.imageView = ctx.offscreenImageView;
+    color.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+    color.loadOp = partial ? VK_ATTACHMENT_LOAD_OP_LOAD : VK_ATTACHMENT_LOAD_OP_CLEAR;
+    color.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    color.clearValue.color = background;
+
+    VkRenderingInfo ri{VK_STRUCTURE_TYPE_RENDERING_INFO};
+    ri.renderArea = {{0, 0}, {width, height}};
+    ri.layerCount = 1;
+    ri.colorAttachmentCount = 1;
+    ri.pColorAttachments = &color;
+    vkCmdBeginRendering(cmd, &ri);
+
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipes_.rasterPipeline);
+    VkViewport vp{0.0f, 0.0f, float(width), float(height), 0.0f, 1.0f};
+    vkCmdSetViewport(cmd, 0, 1, &vp);
+
+    // 与 barchart_raster.vert 的 push 块一致
+    struct Push {
+        uint32_t W, H;
+        float margin_px;
+        float gap_px;
+        float base_line_px;
+        float max_value;
+        VkDeviceAddress values;
+        uint32_t bar_count;
+        uint32_t series_count;
+        uint32_t layout_mode;
+    } push{width, height, params_.margin_px, params_.gap_px, params_.base_line_px, params_.max_value,
+           gpu_.address, bar_count(), series_, static_cast<uint32_t>(layout_)};
+    ctx.bindless->push(cmd, &push, sizeof(Push));
+
+    const Geometry g = geometry(width, height);
+    const VkRect2D full{{0, 0}, {width, height}};
+    const std::span<const VkRect2D> regions = partial ? ctx.damage->rects() : std::span<const VkRect2D>(&full, 1);
+    for (const VkRect2D& r : regions)
+    {
+        vkCmdSetScissor(cmd, 0, 1, &r);
+
+        // 背景（整帧时由 loadOp 清除）与轴线用 clear 画，柱子压在轴线之上
+        VkClearAttachment clear{VK_IMAGE_ASPECT_COLOR_BIT, 0, {}};
+        VkClearRect rect{r, 0, 1};
+        if (partial)
+        {
+            clear.clearValue.color = background;
+            vkCmdClearAttachments(cmd, 1, &clear, 1, &rect);
+        }
+        const int32_t ax0 = std::max(int32_t(params_.margin_px), r.offset.x);
+        const int32_t ax1 = std::min(int32_t(width) - int32_t(params_.margin_px), r.offset.x + int32_t(r.extent.width));
+        const int32_t ay = int32_t(g.axisY);
+        if (ax1 > ax0 && ay >= r.offset.y && ay < r.offset.y + int32_t(r.extent.height))
+        {
+            clear.clearValue.color = axis;
+            rect.rect = {{ax0, ay}, {uint32_t(ax1 - ax0), 1}};
+            vkCmdClearAttachments(cmd, 1, &clear, 1, &rect);
+        }
+
+        // 只画与该区域相交的柱子
+        const uint32_t bars = bar_count();
+        if (bars == 0 || g.slotW <= 0.0f) continue;
+        const float fx0 = (float(r.offset.x) - params_.margin_px - g.barW) / g.slotW;
+        const float fx1 = (float(r.offset.x + int32_t(r.extent.width)) - params_.margin_px) / g.slotW;
+        const uint32_t first = uint32_t(std::clamp(std::floor(fx0), 0.0f, float(bars - 1)));
+        const uint32_t last = uint32_t(std::clamp(std::floor(fx1), 0.0f, float(bars - 1)));
+        if (fx1 < 0.0f || last < first) continue;
+        vkCmdDraw(cmd, 6, (last - first + 1) * series_, 0, first * series_);
+    }
+
+    vkCmdEndRendering(cmd);
+
+    // 2) offscreen 保持 GENERAL，由引擎 composite pass 采样到 swapchain
+}
 
-    // 6) blit 到 swapchain，拉伸铺满
-    copy_offscreen_to_swapchain(cmd, ctx.offscreenImage, ctx.swapchainImage, ctx.frameExtent);
+RendererSweep BarChartRenderer::make_timing_sweep()
+{
+    static constexpr uint32_t Counts[] = {10, 1000, 100000, 1000000};
+    RendererSweep sweep;
+    for (uint32_t n : Counts)
+    {
+        for (Path p : {Path::Compute, Path::Raster})
+        {
+            std::string label = std::to_string(n) + (p == Path::Compute ? " bars, compute" : " bars, raster");
+            sweep.steps.push_back({std::move(label), [this, n, p]() {
+                bench_full_redraw_ = true;
+                if (bar_count() != n || series_ != 1)
+                {
+                    std::vector<float> values(n);
+                    for (uint32_t i = 0; i < n; ++i) values[i] = params_.max_value * (0.55f + 0.4f * std::sin(float(i) * 0.013f));
+                    set_data(values);
+                }
+                set_path(p);
+            }});
+        }
+    }
+
+    // 取 raster 仍然更快的最大数量与 compute 开始更快的数量的几何平均作为阈值
+    sweep.report = [this](const std::vector<double>& ms) {
+        if (ms.size() != std::size(Counts) * 2) return;
+        double rasterWins = 0.0;
+        for (size_t i = 0; i < std::size(Counts); ++i)
+        {
+            const double compute = ms[i * 2], raster = ms[i * 2 + 1];
+            if (compute < 0.0 || raster < 0.0) return; // 没有时间戳
+            if (raster >= compute)
+            {
+                raster_threshold_ = rasterWins > 0.0 ? uint32_t(std::sqrt(rasterWins * Counts[i])) : 0;
+                return;
+            }
+            rasterWins = Counts[i];
+        }
+        raster_threshold_ = ~0u;
+    };
+
+    sweep.restore = [this, data = data_, series = series_, layout = layout_, path = path_]() {
+        bench_full_redraw_ = false;
+        set_data(data, series, layout);
+        set_path(path);
+    };
+    return sweep;
 }
 
 // ==== 内部资源 ====
 
+void BarChartRenderer::upload_data(VkCommandBuffer cmd, const RenderContext& ctx)
+{
+    if (data_.empty()) return;
+
+    // 容量不够：旧缓冲交给引擎延迟销毁（在飞帧可能还在读），按 2 倍增长
+    if (gpu_.capacity < data_.size())
+    {
+        if (gpu_.buffer) ctx.retired->push_buffer(gpu_.buffer, gpu_.allocation);
+        gpu_.capacity = std::max<size_t>({data_.size(), gpu_.capacity * 2, 1024});
+
+        VkBufferCreateInfo bi{VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+        bi.size = gpu_.capacity * sizeof(float);
+        bi.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT |
+                   VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+        VmaAllocationCreateInfo ai{};
+        ai.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+        VK_CHECK(gpu_memory::create_buffer(ctx.allocator, bi, ai, "BarChart/values", &gpu_.buffer, &gpu_.allocation));
+
+        VkBufferDeviceAddressInfo addrInfo{VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO};
+        addrInfo.buffer = gpu_.buffer;
+        gpu_.address = vkGetBufferDeviceAddress(ctx.device, &addrInfo);
+
+        dirty_begin_ = 0;
+        dirty_end_ = data_.size();
+    }
+    if (dirty_begin_ >= dirty_end_) return;
+
+    // 帧 scratch 是按帧轮转的映射内存：写完即可作为拷贝源，fence 之后自动回收
+    const size_t count = dirty_end_ - dirty_begin_;
+    ScratchAllocation src = ctx.frameScratch->push(data_.data() + dirty_begin_, count, sizeof(float));
+
+    // 上一帧的 compute / 顶点着色器读完才能覆盖（WAR 只需执行依赖）
+    VkMemoryBarrier2 before{VK_STRUCTURE_TYPE_MEMORY_BARRIER_2};
+    before.srcStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT;
+    before.dstStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT;
+    before.dstAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+    VkDependencyInfo dep{VK_STRUCTURE_TYPE_DEPENDENCY_INFO};
+    dep.memoryBarrierCount = 1;
+    dep.pMemoryBarriers = &before;
+    vkCmdPipelineBarrier2(cmd, &dep);
+
+    VkBufferCopy region{src.offset, dirty_begin_ * sizeof(float), count * sizeof(float)};
+    vkCmdCopyBuffer(cmd, src.buffer, gpu_.buffer, 1, &region);
+
+    VkMemoryBarrier2 after{VK_STRUCTURE_TYPE_MEMORY_BARRIER_2};
+    after.srcStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT;
+    after.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+    after.dstStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT;
+    after.dstAccessMask = VK_ACCESS_2_SHADER_STORAGE_READ_BIT;
+    dep.pMemoryBarriers = &after;
+    vkCmdPipelineBarrier2(cmd, &dep);
+
+    dirty_begin_ = dirty_end_ = 0;
+}
+
+void BarChartRenderer::destroy_data(VmaAllocator allocator)
+{
+    if (gpu_.buffer) gpu_memory::destroy_buffer(allocator, gpu_.buffer, gpu_.allocation);
+    gpu_ = {};
+}
+
 void BarChartRenderer::create_pipelines(const RenderContext& ctx)
 {
-    // descriptor set layout: binding 0 = storage image
-    VkDescriptorSetLayoutBinding b0{};
-    b0.binding = 0;
-    b0.descriptorCount = 1;
-    b0.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
-    b0.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
-
-    VkDescriptorSetLayoutCreateInfo dslci{VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO};
-    dslci.bindingCount = 1;
-    dslci.pBindings = &b0;
-    VK_CHECK(vkCreateDescriptorSetLayout(ctx.device, &dslci, nullptr, &pipes_.dsl));
-
-    // pipeline layout
-    VkPushConstantRange pcr{};
-    pcr.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
-    pcr.offset = 0;
-    pcr.size = sizeof(uint32_t) * 2 + sizeof(float) * 4;
-
-    VkPipelineLayoutCreateInfo plci{VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO};
-    plci.setLayoutCount = 1;
-    plci.pSetLayouts = &pipes_.dsl;
-    plci.pushConstantRangeCount = 1;
-    plci.pPushConstantRanges = &pcr;
-    VK_CHECK(vkCreatePipelineLayout(ctx.device, &plci, nullptr, &pipes_.layout));
+    // pipeline layout：直接使用 bindless 堆的共享 layout（set 0 = 堆，push 常量覆盖所有 stage）
+    pipes_.layout = ctx.bindless->pipelineLayout;
 
     // shader
-    auto code = read_file("shaders/barchart.comp.spv");
+    // 按 offscreen 格式选择 shader 变体
+    const std::string path = std::string("shaders/barchart") + offscreen_shader_variant(ctx.offscreenFormat) + ".comp.spv";
+    auto code = read_file(path.c_str());
     pipes_.cs = create_shader_module(ctx.device, code);
 
     VkComputePipelineCreateInfo cpci{VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO};
@@ -169,39 +586,45 @@ void BarChartRenderer::create_pipelines(const RenderContext& ctx)
     cpci.layout = pipes_.layout;
 
     VK_CHECK(vkCreateComputePipelines(ctx.device, VK_NULL_HANDLE, 1, &cpci, nullptr, &pipes_.pipeline));
-}
 
-void BarChartRenderer::create_descriptors(const RenderContext& ctx)
-{
-    // 分配 dset
-    dset_ = ctx.descriptorAllocator->allocate(ctx.device, pipes_.dsl);
-
-    // 写 binding 0 指向 offscreen image view，layout GENERAL
-    VkDescriptorImageInfo ii{};
-    ii.imageView = ctx.offscreenImageView;
-    ii.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
-
-    VkWriteDescriptorSet write{VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
-    write.dstSet = dset_;
-    write.dstBinding = 0;
-    write.descriptorCount = 1;
-    write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
-    write.pImageInfo = &ii;
-    vkUpdateDescriptorSets(ctx.device, 1, &write, 0, nullptr);
+    // 光栅路径：同一 bindless layout，顶点从数据缓冲按设备地址拉取，无顶点输入
+    VkShaderModule vs{}, fs{};
+    if (!vkutil::load_shader_module("./shaders/barchart_raster.vert.spv", ctx.device, &vs) ||
+        !vkutil::load_shader_module("./shaders/barchart_raster.frag.spv", ctx.device, &fs))
+        throw std::runtime_error("Failed to load barchart_raster shaders");
+    PipelineBuilder pb;
+    pb._pipelineLayout = pipes_.layout;
+    pb.set_shaders(vs, fs);
+    pb.set_input_topology(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST);
+    pb.set_polygon_mode(VK_POLYGON_MODE_FILL);
+    pb.set_cull_mode(VK_CULL_MODE_NONE, VK_FRONT_FACE_CLOCKWISE);
+    pb.set_multisampling_none();
+    pb.disable_blending();
+    pb.disable_depthtest();
+    pb.set_color_attachment_format(ctx.offscreenFormat);
+    pb.set_depth_format(VK_FORMAT_UNDEFINED);
+    pipes_.rasterPipeline = pb.build_pipeline(ctx.device);
+    vkDestroyShaderModule(ctx.device, vs, nullptr);
+    vkDestroyShaderModule(ctx.device, fs, nullptr);
+
+    // swapchain 可作 storage image 时再建直写变体（同一 layout，只换 shader）
+    if (ctx.caps.storageSwapchain)
+    {
+        auto presentCode = read_file("shaders/barchart.present.comp.spv");
+        pipes_.presentCs = create_shader_module(ctx.device, presentCode);
+        cpci.stage.module = pipes_.presentCs;
+        VK_CHECK(vkCreateComputePipelines(ctx.device, VK_NULL_HANDLE, 1, &cpci, nullptr, &pipes_.presentPipeline));
+    }
 }
 
 void BarChartRenderer::destroy_pipelines(VkDevice device)
 {
     if (pipes_.pipeline) { vkDestroyPipeline(device, pipes_.pipeline, nullptr); pipes_.pipeline = VK_NULL_HANDLE; }
     if (pipes_.cs) { vkDestroyShaderModule(device, pipes_.cs, nullptr); pipes_.cs = VK_NULL_HANDLE; }
-    if (pipes_.layout) { vkDestroyPipelineLayout(device, pipes_.layout, nullptr); pipes_.layout = VK_NULL_HANDLE; }
-    if (pipes_.dsl) { vkDestroyDescriptorSetLayout(device, pipes_.dsl, nullptr); pipes_.dsl = VK_NULL_HANDLE; }
-}
-
-void BarChartRenderer::destroy_descriptors(VkDevice device)
-{
-    // dset 由自定义 DescriptorAllocator 统一回收，无需在此显式销毁
-    dset_ = VK_NULL_HANDLE;
+    if (pipes_.presentPipeline) { vkDestroyPipeline(device, pipes_.presentPipeline, nullptr); pipes_.presentPipeline = VK_NULL_HANDLE; }
+    if (pipes_.presentCs) { vkDestroyShaderModule(device, pipes_.presentCs, nullptr); pipes_.presentCs = VK_NULL_HANDLE; }
+    if (pipes_.rasterPipeline) { vkDestroyPipeline(device, pipes_.rasterPipeline, nullptr); pipes_.rasterPipeline = VK_NULL_HANDLE; }
+    pipes_.layout = VK_NULL_HANDLE;
 }
 
 // ==== 工具函数 ====
@@ -235,35 +658,3 @@ void BarChartRenderer::transition_image(VkCommandBuffer cmd,
     dep.pImageMemoryBarriers = &b;
     vkCmdPipelineBarrier2(cmd, &dep);
 }
-
-void BarChartRenderer::copy_offscreen_to_swapchain(VkCommandBuffer cmd,
-                                                   VkImage src,
-                                                   VkImage dst,
-                                                   VkExtent2D extent)
-{
-    VkImageBlit2 blit{VK_STRUCTURE_TYPE_IMAGE_BLIT_2};
-    blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    blit.srcSubresource.mipLevel = 0;
-    blit.srcSubresource.baseArrayLayer = 0;
-    blit.srcSubresource.layerCount = 1;
-    blit.srcOffsets[0] = {0, 0, 0};
-    blit.srcOffsets[1] = {static_cast<int32_t>(extent.width), static_cast<int32_t>(extent.height), 1};
-
-    blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    blit.dstSubresource.mipLevel = 0;
-    blit.dstSubresource.baseArrayLayer = 0;
-    blit.dstSubresource.layerCount = 1;
-    blit.dstOffsets[0] = {0, 0, 0};
-    blit.dstOffsets[1] = {static_cast<int32_t>(extent.width), static_cast<int32_t>(extent.height), 1};
-
-    VkBlitImageInfo2 info{VK_STRUCTURE_TYPE_BLIT_IMAGE_INFO_2};
-    info.srcImage = src;
-    info.srcImageLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-    info.dstImage = dst;
-    info.dstImageLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-    info.filter = VK_FILTER_LINEAR;
-    info.regionCount = 1;
-    info.pRegions = &blit;
-
-    vkCmdBlitImage2(cmd, &info);
-}
@@ -3,32 +3,70 @@
 
 #include <vulkan/vulkan.h>
 #include <memory>
+#include <span>
 #include <vector>
 #include "src/renderer_iface.h"
-#include "src/ext/vk_descriptors.h"
+#include "src/ext/vk_bindless.h"
+#include "vk_mem_alloc.h"
 
 class BarChartRenderer final : public IRenderer
 {
 public:
-    BarChartRenderer() = default;
+    BarChartRenderer();
     ~BarChartRenderer() override = default;
 
+    // 多序列的排列方式（与 barchart.comp 的 LAYOUT_* 一致）
+    enum class Layout : uint32_t { Grouped = 0, Stacked = 1 };
+
+    // 整体替换数据：values[bar * seriesCount + series]，下一帧整帧重画。
+    // 只更新 CPU 副本，record() 时经帧 scratch 拷进 GPU 缓冲；容量不够才重建缓冲，管线不动
+    void set_data(std::span<const float> values, uint32_t seriesCount = 1, Layout layout = Layout::Grouped);
+    // 修改单个值：只上传变化的范围，只重画这根柱子
+    void update_value(uint32_t bar, uint32_t series, float value);
+    void set_max_value(float maxValue);
+    uint32_t bar_count() const { return static_cast<uint32_t>(data_.size() / series_); }
+    uint32_t series_count() const { return series_; }
+
     void initialize(const RenderContext& ctx) override;
     void destroy(const RenderContext& ctx) override;
 
     void record(VkCommandBuffer cmd, uint32_t width, uint32_t height, const RenderContext& ctx) override;
     void on_swapchain_resized(const RenderContext& ctx) override;
-    void on_imgui() override {}  // 本例不需要 ImGui
+    void on_imgui() override;
+    // 数据变化或动画模式才重画；其余由引擎侧的 resize / 切换触发
+    bool needs_redraw() override { return animate_ || bench_full_redraw_ || full_damage_ || !changes_.empty(); }
+    // 只上报 update_value 改过的柱子，其余 tile 保持上一帧内容
+    void report_damage(DamageRegion& damage, const RenderContext& ctx) override;
+    // SDR 看板：8 位 offscreen 足够，填充与 blit 带宽减半
+    VkFormat preferred_offscreen_format() const override { return VK_FORMAT_R8G8B8A8_UNORM; }
+    // 光栅路径画在 offscreen 上，只有 compute 路径能直写 swapchain
+    bool supports_direct_present() const override { return pipes_.presentPipeline != VK_NULL_HANDLE && !use_raster(); }
+    // compute vs raster 在 10 / 1k / 100k / 1M 根柱子下的 GPU 耗时，结果用来更新自动切换阈值
+    const char* timing_sweep_label() const override { return "GPU time bars: compute vs raster"; }
+    RendererSweep make_timing_sweep() override;
+
+    // 柱子的绘制路径：逐像素 compute，或实例化矩形交给光栅器
+    enum class Path { Auto, Compute, Raster };
+    void set_path(Path path) { path_ = path; full_damage_ = true; }
 
 private:
     struct Pipelines {
         VkPipeline pipeline = VK_NULL_HANDLE;
-        VkPipelineLayout layout = VK_NULL_HANDLE;
-        VkDescriptorSetLayout dsl = VK_NULL_HANDLE;
+        VkPipelineLayout layout = VK_NULL_HANDLE; // 借用 bindless 堆的共享 layout，不归本类销毁
         VkShaderModule cs = VK_NULL_HANDLE;
+        // 直接写 swapchain 的变体（引擎 direct-present 模式，caps.storageSwapchain 时才创建）
+        VkPipeline presentPipeline = VK_NULL_HANDLE;
+        VkShaderModule presentCs = VK_NULL_HANDLE;
+        // 实例化矩形（barchart_raster.vert/.frag），同一 layout，目标为 offscreen 颜色附件
+        VkPipeline rasterPipeline = VK_NULL_HANDLE;
     } pipes_;
 
-    VkDescriptorSet dset_ = VK_NULL_HANDLE;
+    // Auto：实例数不超过阈值走光栅，否则走 compute（compute 的代价只和像素数有关）
+    Path path_ = Path::Auto;
+    uint32_t raster_threshold_ = 16384; // 实例数；跑一次 timing sweep 后按交叉点更新
+    bool bench_full_redraw_ = false;    // sweep 期间每帧整帧重画
+    bool use_raster() const;
+    void record_raster(VkCommandBuffer cmd, uint32_t width, uint32_t height, const RenderContext& ctx);
 
     // 简单参数，后续你可以暴露到 UI
     struct Params {
@@ -38,10 +76,55 @@ private:
         float max_value = 10.0f;    // 归一化高度上限
     } params_;
 
+    // CPU 侧数据：values[bar * series_ + series]
+    std::vector<float> data_;
+    uint32_t series_ = 1;
+    Layout layout_ = Layout::Grouped;
+
+    // GPU 侧数据缓冲（device local，shader 通过设备地址读取）
+    struct DataBuffer {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VmaAllocation allocation{};
+        VkDeviceAddress address = 0;
+        size_t capacity = 0; // float 个数
+    } gpu_;
+    // 待上传的 float 范围 [dirty_begin_, dirty_end_)
+    size_t dirty_begin_ = 0;
+    size_t dirty_end_ = 0;
+
+    // 待上报的损伤：整帧，或逐个改动（before = 分组时的旧值 / 堆叠时的旧总高）
+    struct Change { uint32_t bar; uint32_t series; float before; };
+    static constexpr size_t MaxTrackedChanges = 256; // 超过后直接整帧重画
+    std::vector<Change> changes_;
+    bool full_damage_ = true;
+
+    // 动画模式：每帧按目标面积改一个值
+    bool animate_ = false;
+    float target_damage_ = 0.01f; // 每帧期望的变化面积占比
+    uint32_t anim_step_ = 0;
+    // 面板里的数据生成参数
+    int gen_bars_ = 11;
+    int gen_series_ = 1;
+    int gen_layout_ = 0;
+
+    // 与 barchart.comp 一致的柱体几何
+    struct Geometry { float slotW, gap, barW, innerH, axisY; };
+    Geometry geometry(uint32_t width, uint32_t height) const;
+    float column_total(uint32_t bar) const;
+    // 一次改动覆盖的像素矩形
+    VkRect2D change_rect(const Change& c, uint32_t width, uint32_t height) const;
+    void animate_step(VkExtent2D extent);
+    void generate_demo_data();
+
+    // 把脏范围经帧 scratch 拷进数据缓冲（必要时扩容）
+    void upload_data(VkCommandBuffer cmd, const RenderContext& ctx);
+    void destroy_data(VmaAllocator allocator);
+
     void create_pipelines(const RenderContext& ctx);
-    void create_descriptors(const RenderContext& ctx);
     void destroy_pipelines(VkDevice device);
-    void destroy_descriptors(VkDevice device);
+    // 绑定管线、写 push 常量并 dispatch，目标为 bindless storage image 句柄
+    void record_bars(VkCommandBuffer cmd, VkPipeline pipeline, uint32_t imageIndex,
+                     uint32_t width, uint32_t height, const RenderContext& ctx);
 
     // 工具函数：同步与布局转换
     void transition_image(VkCommandBuffer cmd,
@@ -53,12 +136,6 @@ private:
                           VkAccessFlags2 srcAccess,
                           VkAccessFlags2 dstAccess,
                           VkImageAspectFlags aspect = VK_IMAGE_ASPECT_COLOR_BIT);
-
-    // 把 offscreen 拷贝到 swapchain（等比例拉伸至整个窗口）
-    void copy_offscreen_to_swapchain(VkCommandBuffer cmd,
-                                     VkImage src,
-                                     VkImage dst,
-                                     VkExtent2D extent);
 };
 
 #endif //RENDERER_BARCHART_H
\ No newline at end of file
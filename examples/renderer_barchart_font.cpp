@@ -1,11 +1,16 @@
 #include "renderer_barchart_font.h"
 #include "src/ext/vk_initializers.h"
+#include "src/ext/vk_descriptor_buffer.h"
+#include "src/gpu_memory.h"
 #include <fstream>
 #include <sstream>
 #include <regex>
+#include <cstddef>
+#include <chrono>
 #include <stdexcept>
 
 #include "stb_image.h"
+#include "imgui.h"
 
 #ifndef VK_CHECK
 #define VK_CHECK(x) do { VkResult err__=(x); if(err__!=VK_SUCCESS){ throw std::runtime_error("Vulkan error "+std::to_string(err__)); } } while(0)
@@ -36,90 +41,142 @@ void BarChartRendererMSDF::initialize(const RenderContext& ctx){
     if(atlas_json_.empty()) atlas_json_ = "assets/atlas_digits.json";
 
     create_bar_pipeline(ctx);
-    create_bar_descriptors(ctx);
 
     create_text_pipeline(ctx);
     load_msdf_atlas(ctx);        // 读取 PNG + 上传 + 创建 sampler/view
     parse_msdf_json();           // 解析 0..9 的 uv
-    ensure_glyph_ssbo(ctx);      // 建 SSBO
     create_text_descriptors(ctx);
 }
 
 void BarChartRendererMSDF::destroy(const RenderContext& ctx){
     destroy_text_pipeline(ctx.device);
     destroy_bar_pipeline(ctx.device);
-    destroy_glyph_ssbo(ctx.device, ctx.allocator);
     destroy_font_resources(ctx.device, ctx.allocator);
 }
 
 void BarChartRendererMSDF::on_swapchain_resized(const RenderContext& ctx){
-    // offscreen view 没变（引擎维护），只需重写 bar 的 descriptor 指向新的 view
-    create_bar_descriptors(ctx);
+    // 柱子 pass 走 bindless 句柄（引擎保持稳定）；文字 pass 的描述符每帧重新写，无需处理
+    (void)ctx;
+}
+
+void BarChartRendererMSDF::on_imgui(){
+    ImGui::Begin("Bar Chart (MSDF)");
+    int path=(int)text_path_;
+    ImGui::RadioButton("Descriptor set", &path, (int)DescriptorPath::Set);
+    ImGui::SameLine();
+    ImGui::BeginDisabled(push_descriptor_set_==nullptr);
+    ImGui::RadioButton("Push descriptor", &path, (int)DescriptorPath::Push);
+    ImGui::EndDisabled();
+    ImGui::SameLine();
+    ImGui::BeginDisabled(!descriptor_buffer_);
+    ImGui::RadioButton("Descriptor buffer", &path, (int)DescriptorPath::Buffer);
+    ImGui::EndDisabled();
+    if(path!=(int)text_path_) dirty_=true;
+    text_path_=(DescriptorPath)path;
+    if(!push_descriptor_set_) ImGui::TextDisabled("VK_KHR_push_descriptor not available");
+    if(!descriptor_buffer_) ImGui::TextDisabled("VK_EXT_descriptor_buffer not available");
+    ImGui::Text("Text pass record: set %.2f us, push %.2f us, buffer %.2f us",
+                text_record_us_[0], text_record_us_[1], text_record_us_[2]);
+    ImGui::End();
 }
 
 void BarChartRendererMSDF::record(VkCommandBuffer cmd, uint32_t W, uint32_t H, const RenderContext& ctx){
-    // 1) offscreen → GENERAL，写柱子
-    transition_image(cmd, ctx.offscreenImage, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL,
-                     VK_PIPELINE_STAGE_2_NONE, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, 0,
+    // 局部重画：两个 pass 都只 dispatch 脏 tile，offscreen 保留上一帧内容
+    const bool partial = ctx.damage && !ctx.damage->full();
+    if(partial && ctx.damage->empty()) return;
+    const uint32_t tileCount = partial ? ctx.damage->tile_count() : 0;
+    const VkDeviceAddress tiles = partial ? ctx.damage->tiles() : 0;
+
+    // 1) offscreen → GENERAL，写柱子（等上一帧 composite 的采样/blit 读完）
+    transition_image(cmd, ctx.offscreenImage, partial ? VK_IMAGE_LAYOUT_GENERAL : VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL,
+                     VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, 0,
                      VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT);
 
-    // 绑定柱状图 compute
+    // 绑定柱状图 compute（bindless 堆已由引擎绑定在 set 0）
     vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, bar_.pipeline);
-    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, bar_.layout, 0, 1, &bar_.dset, 0, nullptr);
 
+    // 与 barchart.comp 的 push 块一致：值固定为 0..10，每帧 11 个 float 直接放进帧 scratch
+    float values[11];
+    for(uint32_t i=0;i<11;++i) values[i]=float(i);
+    const VkDeviceAddress valuesAddr = ctx.frameScratch->push(values, 11, sizeof(float)).address;
     struct PCBar{
-        uint32_t W,H; float margin_px,gap_px,base_line_px,max_value;
-    } pcBar{W,H, params_.margin_px, params_.gap_px, params_.base_line_px, params_.max_value};
+        uint32_t W,H; float margin_px,gap_px,base_line_px,max_value; uint32_t image_index;
+        uint32_t tile_count; VkDeviceAddress tiles; VkDeviceAddress values; uint32_t bar_count, series_count, layout_mode;
+    } pcBar{W,H, params_.margin_px, params_.gap_px, params_.base_line_px, params_.max_value, ctx.offscreenStorageIndex,
+            tileCount, tiles, valuesAddr, 11, 1, 0};
 
-    vkCmdPushConstants(cmd, bar_.layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(PCBar), &pcBar);
+    ctx.bindless->push(cmd, &pcBar, sizeof(PCBar));
 
     uint32_t gx=(W+15)/16, gy=(H+15)/16;
+    if(partial) { const VkExtent2D g = ctx.damage->tile_groups(); gx=g.width; gy=g.height; }
     vkCmdDispatch(cmd, gx, gy, 1);
 
+    // 文字 pass 读-改-写柱子 pass 的结果：compute 写 → compute 读写
+    transition_image(cmd, ctx.offscreenImage, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_GENERAL,
+                     VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                     VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+                     VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT);
+
     // 2) 同一张 offscreen 上叠加 MSDF 文字
     // 准备 glyph 实例（基于柱子几何）
-    build_digits_for_bars(W,H,ctx);
+    ScratchAllocation glyphs = build_digits_for_bars(W,H,ctx);
+    // 没有 glyph 时不绑定也不派发：range 为 0 的 SSBO 描述符不合法
+    if(glyphs.size == 0) return;
 
     // atlas 维持在 SHADER_READ_ONLY_OPTIMAL，无需改布局
-    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, text_.pipeline);
-    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, text_.layout, 0, 1, &text_.dset, 0, nullptr);
+    const auto t0 = std::chrono::steady_clock::now();
+    VkPipelineLayout textLayout = text_.layout;
+    if(text_path_ == DescriptorPath::Push){
+        // 直接把三个描述符录进命令缓冲，没有池/分配/resize 重写
+        textLayout = text_.pushLayout;
+        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, text_.pushPipeline);
+        DescriptorWriter w;
+        w.write_image(0, ctx.offscreenImageView, VK_NULL_HANDLE, VK_IMAGE_LAYOUT_GENERAL, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE);
+        w.write_image(1, atlas_view_, atlas_sampler_, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
+        w.write_buffer(2, glyphs.buffer, glyphs.size, glyphs.offset, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER);
+        w.push_set(push_descriptor_set_, cmd, VK_PIPELINE_BIND_POINT_COMPUTE, textLayout);
+    } else if(text_path_ == DescriptorPath::Buffer){
+        // 描述符直接编码进本帧的 ring，绑定只是一个偏移
+        textLayout = text_.bufferLayout;
+        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, text_.bufferPipeline);
+        DescriptorWriter w;
+        w.write_image(0, ctx.offscreenImageView, VK_NULL_HANDLE, VK_IMAGE_LAYOUT_GENERAL, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE);
+        w.write_image(1, atlas_view_, atlas_sampler_, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
+        w.write_buffer(2, glyphs.buffer, glyphs.size, glyphs.offset, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER);
+        VkDeviceSize offset = ctx.frameDescriptorBuffer->push(ctx.device, text_.bufferDsl, w);
+        ctx.frameDescriptorBuffer->bind(cmd);
+        ctx.frameDescriptorBuffer->set_offset(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, textLayout, 0, offset);
+    } else {
+        // 本帧的 set：帧描述符池在 fence 之后整体重置，模板一次写完
+        VkDescriptorSet set = ctx.frameDescriptors->allocate(ctx.device, text_.dsl);
+        TextDescriptors d{};
+        d.target = {VK_NULL_HANDLE, ctx.offscreenImageView, VK_IMAGE_LAYOUT_GENERAL};
+        d.atlas  = {atlas_sampler_, atlas_view_, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+        d.glyphs = {glyphs.buffer, glyphs.offset, glyphs.size};
+        vkUpdateDescriptorSetWithTemplate(ctx.device, set, text_.tmpl, &d);
+        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, text_.pipeline);
+        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, text_.layout, 0, 1, &set, 0, nullptr);
+    }
 
-    struct PCText{ uint32_t W,H; float pxRange, gamma; } pcT{W,H, params_.pxRange, 2.2f};
-    vkCmdPushConstants(cmd, text_.layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(PCText), &pcT);
+    PCText pcT{W,H, params_.pxRange, 2.2f, tileCount, 0, tiles};
+    vkCmdPushConstants(cmd, textLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(PCText), &pcT);
 
     vkCmdDispatch(cmd, gx, gy, 1);
+    double& avg = text_record_us_[(int)text_path_];
+    avg = avg*0.95 + std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now()-t0).count()*0.05;
 
-    // 3) offscreen → TRANSFER_SRC，swapchain → TRANSFER_DST，blit
-    transition_image(cmd, ctx.offscreenImage, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-                     VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_2_TRANSFER_BIT,
-                     VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT, VK_ACCESS_2_TRANSFER_READ_BIT);
-    transition_image(cmd, ctx.swapchainImage, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                     VK_PIPELINE_STAGE_2_NONE, VK_PIPELINE_STAGE_2_TRANSFER_BIT, 0, VK_ACCESS_2_TRANSFER_WRITE_BIT);
-
-    copy_offscreen_to_swapchain(cmd, ctx.offscreenImage, ctx.swapchainImage, ctx.frameExtent);
+    // 3) offscreen 保持 GENERAL，由引擎 composite pass 采样到 swapchain
 }
 
 // ===== 资源：柱状图 =====
 
 void BarChartRendererMSDF::create_bar_pipeline(const RenderContext& ctx){
-    // dsl: binding0 = storage image
-    VkDescriptorSetLayoutBinding b0{};
-    b0.binding=0; b0.descriptorCount=1; b0.descriptorType=VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
-    b0.stageFlags=VK_SHADER_STAGE_COMPUTE_BIT;
+    // 与 BarChartRenderer 共用 barchart.comp：set 0 = bindless 堆
+    bar_.layout=ctx.bindless->pipelineLayout;
 
-    VkDescriptorSetLayoutCreateInfo dslci{VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO};
-    dslci.bindingCount=1; dslci.pBindings=&b0;
-    VK_CHECK(vkCreateDescriptorSetLayout(ctx.device,&dslci,nullptr,&bar_.dsl));
-
-    VkPushConstantRange pcr{};
-    pcr.stageFlags=VK_SHADER_STAGE_COMPUTE_BIT; pcr.offset=0;
-    pcr.size=sizeof(uint32_t)*2 + sizeof(float)*4;
-
-    VkPipelineLayoutCreateInfo plci{VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO};
-    plci.setLayoutCount=1; plci.pSetLayouts=&bar_.dsl; plci.pushConstantRangeCount=1; plci.pPushConstantRanges=&pcr;
-    VK_CHECK(vkCreatePipelineLayout(ctx.device,&plci,nullptr,&bar_.layout));
-
-    auto code=read_bin("shaders/barchart.comp.spv");
+    // 按 offscreen 格式选择 shader 变体
+    const std::string path=std::string("shaders/barchart")+offscreen_shader_variant(ctx.offscreenFormat)+".comp.spv";
+    auto code=read_bin(path.c_str());
     bar_.cs=create_shader(ctx.device, code);
 
     VkComputePipelineCreateInfo cpci{VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO};
@@ -129,22 +186,10 @@ void BarChartRendererMSDF::create_bar_pipeline(const RenderContext& ctx){
     VK_CHECK(vkCreateComputePipelines(ctx.device, VK_NULL_HANDLE, 1, &cpci, nullptr, &bar_.pipeline));
 }
 
-void BarChartRendererMSDF::create_bar_descriptors(const RenderContext& ctx){
-    if(bar_.dset){} // 会被新的覆盖
-    bar_.dset = ctx.descriptorAllocator->allocate(ctx.device, bar_.dsl);
-
-    VkDescriptorImageInfo ii{}; ii.imageView=ctx.offscreenImageView; ii.imageLayout=VK_IMAGE_LAYOUT_GENERAL;
-
-    VkWriteDescriptorSet w{VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
-    w.dstSet=bar_.dset; w.dstBinding=0; w.descriptorCount=1; w.descriptorType=VK_DESCRIPTOR_TYPE_STORAGE_IMAGE; w.pImageInfo=&ii;
-    vkUpdateDescriptorSets(ctx.device,1,&w,0,nullptr);
-}
-
 void BarChartRendererMSDF::destroy_bar_pipeline(VkDevice d){
     if(bar_.pipeline){ vkDestroyPipeline(d,bar_.pipeline,nullptr); bar_.pipeline=VK_NULL_HANDLE; }
     if(bar_.cs){ vkDestroyShaderModule(d,bar_.cs,nullptr); bar_.cs=VK_NULL_HANDLE; }
-    if(bar_.layout){ vkDestroyPipelineLayout(d,bar_.layout,nullptr); bar_.layout=VK_NULL_HANDLE; }
-    if(bar_.dsl){ vkDestroyDescriptorSetLayout(d,bar_.dsl,nullptr); bar_.dsl=VK_NULL_HANDLE; }
+    bar_.layout=VK_NULL_HANDLE;
 }
 
 // ===== 资源：文字管线 + 字体图集 + SSBO =====
@@ -156,62 +201,64 @@ void BarChartRendererMSDF::create_text_pipeline(const RenderContext& ctx){
     VkDescriptorSetLayoutBinding b2{}; b2.binding=2; b2.descriptorCount=1; b2.descriptorType=VK_DESCRIPTOR_TYPE_STORAGE_BUFFER; b2.stageFlags=VK_SHADER_STAGE_COMPUTE_BIT;
     std::array<VkDescriptorSetLayoutBinding,3> binds{b0,b1,b2};
 
-    VkDescriptorSetLayoutCreateInfo dslci{VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO};
-    dslci.bindingCount=(uint32_t)binds.size(); dslci.pBindings=binds.data();
-    VK_CHECK(vkCreateDescriptorSetLayout(ctx.device,&dslci,nullptr,&text_.dsl));
+    const std::string path=std::string("shaders/barchart_font")+offscreen_shader_variant(ctx.offscreenFormat)+".comp.spv";
+    auto code=read_bin(path.c_str());
+    text_.cs=create_shader(ctx.device, code);
 
-    VkPushConstantRange pcr{}; pcr.stageFlags=VK_SHADER_STAGE_COMPUTE_BIT; pcr.offset=0; pcr.size=sizeof(uint32_t)*2 + sizeof(float)*2;
-    VkPipelineLayoutCreateInfo plci{VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO};
-    plci.setLayoutCount=1; plci.pSetLayouts=&text_.dsl; plci.pushConstantRangeCount=1; plci.pPushConstantRanges=&pcr;
-    VK_CHECK(vkCreatePipelineLayout(ctx.device,&plci,nullptr,&text_.layout));
+    // 同一个 shader，按 set layout 的 flags 建两套 layout/pipeline
+    auto build=[&](VkDescriptorSetLayoutCreateFlags flags, VkDescriptorSetLayout& dsl, VkPipelineLayout& layout, VkPipeline& pipeline,
+                   VkPipelineCreateFlags pipelineFlags){
+        VkDescriptorSetLayoutCreateInfo dslci{VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO};
+        dslci.flags=flags; dslci.bindingCount=(uint32_t)binds.size(); dslci.pBindings=binds.data();
+        VK_CHECK(vkCreateDescriptorSetLayout(ctx.device,&dslci,nullptr,&dsl));
+
+        VkPushConstantRange pcr{}; pcr.stageFlags=VK_SHADER_STAGE_COMPUTE_BIT; pcr.offset=0; pcr.size=sizeof(PCText);
+        VkPipelineLayoutCreateInfo plci{VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO};
+        plci.setLayoutCount=1; plci.pSetLayouts=&dsl; plci.pushConstantRangeCount=1; plci.pPushConstantRanges=&pcr;
+        VK_CHECK(vkCreatePipelineLayout(ctx.device,&plci,nullptr,&layout));
+
+        VkComputePipelineCreateInfo cpci{VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO};
+        cpci.stage=VkPipelineShaderStageCreateInfo{VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,nullptr,0,
+            VK_SHADER_STAGE_COMPUTE_BIT, text_.cs, "main", nullptr};
+        cpci.flags=pipelineFlags; cpci.layout=layout;
+        VK_CHECK(vkCreateComputePipelines(ctx.device, VK_NULL_HANDLE, 1, &cpci, nullptr, &pipeline));
+    };
 
-    auto code=read_bin("shaders/barchart_font.comp.spv");
-    text_.cs=create_shader(ctx.device, code);
+    // set 路径始终保留作为回退
+    build(0, text_.dsl, text_.layout, text_.pipeline, 0);
+    text_path_ = DescriptorPath::Set;
 
-    VkComputePipelineCreateInfo cpci{VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO};
-    cpci.stage=VkPipelineShaderStageCreateInfo{VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,nullptr,0,
-        VK_SHADER_STAGE_COMPUTE_BIT, text_.cs, "main", nullptr};
-    cpci.layout=text_.layout;
-    VK_CHECK(vkCreateComputePipelines(ctx.device, VK_NULL_HANDLE, 1, &cpci, nullptr, &text_.pipeline));
-}
+    push_descriptor_set_ = ctx.caps.pushDescriptor ? ctx.caps.cmdPushDescriptorSet : nullptr;
+    if(push_descriptor_set_){
+        build(VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR, text_.pushDsl, text_.pushLayout, text_.pushPipeline, 0);
+        text_path_ = DescriptorPath::Push;
+    }
 
-void BarChartRendererMSDF::ensure_glyph_ssbo(const RenderContext& ctx){
-    if(glyph_buf_) return;
-    VkDeviceSize cap = sizeof(float)* (2+2+4+4) * glyph_cap_; // 按 Glyph 估算
-    VkBufferCreateInfo bi{VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
-    bi.size = cap; bi.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
-    VmaAllocationCreateInfo ai{}; ai.usage = VMA_MEMORY_USAGE_AUTO; ai.flags = VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
-    VK_CHECK(vmaCreateBuffer(ctx.allocator, &bi, &ai, &glyph_buf_, &glyph_alloc_, nullptr));
+    descriptor_buffer_ = ctx.frameDescriptorBuffer != nullptr;
+    if(descriptor_buffer_){
+        build(VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT, text_.bufferDsl, text_.bufferLayout, text_.bufferPipeline,
+              VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT);
+    }
 }
 
 void BarChartRendererMSDF::create_text_descriptors(const RenderContext& ctx){
-    text_.dset = ctx.descriptorAllocator->allocate(ctx.device, text_.dsl);
-
-    VkDescriptorImageInfo img{};
-    img.sampler = atlas_sampler_; img.imageView = atlas_view_; img.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-
-    VkDescriptorBufferInfo buf{};
-    buf.buffer = glyph_buf_; buf.offset=0; buf.range = VK_WHOLE_SIZE;
-
-    std::array<VkWriteDescriptorSet,2> ws{};
-    // b1 sampler
-    ws[0] = VkWriteDescriptorSet{VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,nullptr, text_.dset, 1, 0, 1,
-                                 VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, &img, nullptr, nullptr};
-    // b2 ssbo
-    ws[1] = VkWriteDescriptorSet{VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,nullptr, text_.dset, 2, 0, 1,
-                                 VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, nullptr, &buf, nullptr};
-
-    // 还要把 b0=storage image 也补上，沿用 offscreen
-    VkDescriptorImageInfo ii{}; ii.imageView = ctx.offscreenImageView; ii.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
-    VkWriteDescriptorSet w0{VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
-    w0.dstSet = text_.dset; w0.dstBinding = 0; w0.descriptorCount=1; w0.descriptorType=VK_DESCRIPTOR_TYPE_STORAGE_IMAGE; w0.pImageInfo=&ii;
-
-    std::array<VkWriteDescriptorSet,3> all{w0, ws[0], ws[1]};
-    vkUpdateDescriptorSets(ctx.device, (uint32_t)all.size(), all.data(), 0, nullptr);
+    // set 本身每帧从 ctx.frameDescriptors 分配，这里只编译 update template
+    DescriptorUpdateTemplateBuilder tb;
+    tb.add_entry(0, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,          offsetof(TextDescriptors, target));
+    tb.add_entry(1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, offsetof(TextDescriptors, atlas));
+    tb.add_entry(2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,         offsetof(TextDescriptors, glyphs));
+    text_.tmpl = tb.build(ctx.device, text_.dsl);
 }
 
 void BarChartRendererMSDF::destroy_text_pipeline(VkDevice d){
     if(text_.pipeline){ vkDestroyPipeline(d,text_.pipeline,nullptr); text_.pipeline=VK_NULL_HANDLE; }
+    if(text_.tmpl){ vkDestroyDescriptorUpdateTemplate(d,text_.tmpl,nullptr); text_.tmpl=VK_NULL_HANDLE; }
+    if(text_.pushPipeline){ vkDestroyPipeline(d,text_.pushPipeline,nullptr); text_.pushPipeline=VK_NULL_HANDLE; }
+    if(text_.pushLayout){ vkDestroyPipelineLayout(d,text_.pushLayout,nullptr); text_.pushLayout=VK_NULL_HANDLE; }
+    if(text_.pushDsl){ vkDestroyDescriptorSetLayout(d,text_.pushDsl,nullptr); text_.pushDsl=VK_NULL_HANDLE; }
+    if(text_.bufferPipeline){ vkDestroyPipeline(d,text_.bufferPipeline,nullptr); text_.bufferPipeline=VK_NULL_HANDLE; }
+    if(text_.bufferLayout){ vkDestroyPipelineLayout(d,text_.bufferLayout,nullptr); text_.bufferLayout=VK_NULL_HANDLE; }
+    if(text_.bufferDsl){ vkDestroyDescriptorSetLayout(d,text_.bufferDsl,nullptr); text_.bufferDsl=VK_NULL_HANDLE; }
     if(text_.cs){ vkDestroyShaderModule(d,text_.cs,nullptr); text_.cs=VK_NULL_HANDLE; }
     if(text_.layout){ vkDestroyPipelineLayout(d,text_.layout,nullptr); text_.layout=VK_NULL_HANDLE; }
     if(text_.dsl){ vkDestroyDescriptorSetLayout(d,text_.dsl,nullptr); text_.dsl=VK_NULL_HANDLE; }
@@ -220,10 +267,7 @@ void BarChartRendererMSDF::destroy_text_pipeline(VkDevice d){
 void BarChartRendererMSDF::destroy_font_resources(VkDevice d, VmaAllocator a){
     if(atlas_view_){ vkDestroyImageView(d, atlas_view_, nullptr); atlas_view_={}; }
     if(atlas_sampler_){ vkDestroySampler(d, atlas_sampler_, nullptr); atlas_sampler_={}; }
-    if(atlas_image_){ vmaDestroyImage(a, atlas_image_, atlas_alloc_); atlas_image_={}; atlas_alloc_={}; }
-}
-void BarChartRendererMSDF::destroy_glyph_ssbo(VkDevice d, VmaAllocator a){
-    if(glyph_buf_){ vmaDestroyBuffer(a, glyph_buf_, glyph_alloc_); glyph_buf_={}; glyph_alloc_={}; }
+    if(atlas_image_){ gpu_memory::destroy_image(a, atlas_image_, atlas_alloc_); atlas_image_={}; atlas_alloc_={}; }
 }
 
 // ===== 读取 PNG 并上传，解析 JSON =====
@@ -238,7 +282,7 @@ void BarChartRendererMSDF::load_msdf_atlas(const RenderContext& ctx){
     VkBuffer staging{}; VmaAllocation stagingAlloc{};
     VkBufferCreateInfo bi{VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO}; bi.size=bytes; bi.usage=VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
     VmaAllocationCreateInfo ai{}; ai.usage=VMA_MEMORY_USAGE_AUTO; ai.flags=VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT;
-    VK_CHECK(vmaCreateBuffer(ctx.allocator,&bi,&ai,&staging,&stagingAlloc,nullptr));
+    VK_CHECK(gpu_memory::create_buffer(ctx.allocator, bi, ai, "MSDF/atlas-staging", &staging, &stagingAlloc));
 
     void* mapped{}; vmaMapMemory(ctx.allocator, stagingAlloc, &mapped);
     memcpy(mapped,data,(size_t)bytes);
@@ -251,7 +295,7 @@ void BarChartRendererMSDF::load_msdf_atlas(const RenderContext& ctx){
                                                       VK_IMAGE_USAGE_TRANSFER_DST_BIT|VK_IMAGE_USAGE_SAMPLED_BIT,
                                                       extent);
     VmaAllocationCreateInfo iai{}; iai.usage=VMA_MEMORY_USAGE_AUTO; iai.flags=VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
-    VK_CHECK(vmaCreateImage(ctx.allocator,&ici,&iai,&atlas_image_,&atlas_alloc_,nullptr));
+    VK_CHECK(gpu_memory::create_image(ctx.allocator, ici, iai, "MSDF/atlas", &atlas_image_, &atlas_alloc_));
 
     VkImageViewCreateInfo vci = vkinit::imageview_create_info(VK_FORMAT_R8G8B8A8_UNORM, atlas_image_, VK_IMAGE_ASPECT_COLOR_BIT);
     VK_CHECK(vkCreateImageView(ctx.device,&vci,nullptr,&atlas_view_));
@@ -299,7 +343,7 @@ void BarChartRendererMSDF::load_msdf_atlas(const RenderContext& ctx){
     VK_CHECK(vkQueueWaitIdle(ctx.graphics_queue));
 
     vkDestroyCommandPool(ctx.device,pool,nullptr);
-    vmaDestroyBuffer(ctx.allocator, staging, stagingAlloc);
+    gpu_memory::destroy_buffer(ctx.allocator, staging, stagingAlloc);
 }
 
 void BarChartRendererMSDF::parse_msdf_json(){
@@ -353,9 +397,9 @@ void BarChartRendererMSDF::parse_msdf_json(){
 
 // ===== 每帧构建 glyph 实例 =====
 
-void BarChartRendererMSDF::build_digits_for_bars(uint32_t W, uint32_t H, const RenderContext& ctx){
+ScratchAllocation BarChartRendererMSDF::build_digits_for_bars(uint32_t W, uint32_t H, const RenderContext& ctx){
     struct GlyphCPU { float px,py,sx,sy,u0,v0,u1,v1,r,g,b,a; };
-    std::vector<GlyphCPU> gs;
+    std::pmr::vector<GlyphCPU> gs(ctx.frameArena); // 帧内临时数据，走引擎的帧 arena
     gs.reserve(32);
 
     // 与 shader 一致的柱体几何
@@ -364,7 +408,8 @@ void BarChartRendererMSDF::build_digits_for_bars(uint32_t W, uint32_t H, const R
     float innerW = float(W) - 2.0f*params_.margin_px;
     float innerH = float(H) - params_.margin_px - params_.base_line_px;
     float slotW  = innerW / float(N);
-    float barW   = std::max(1.0f, slotW - params_.gap_px);
+    float gap    = std::min(params_.gap_px, slotW*0.25f); // barchart.comp 在柱子很密时收缩间隙
+    float barW   = std::max(1.0f, slotW - gap);
 
     auto addDigit=[&](int d, float xc, float yTop){
         float Hlbl = params_.label_px;
@@ -378,7 +423,7 @@ void BarChartRendererMSDF::build_digits_for_bars(uint32_t W, uint32_t H, const R
     for(uint32_t i=0;i<N;++i){
         float v = float(i);
         float h = innerH * std::min(std::max(v/params_.max_value,0.0f),1.0f);
-        float x0 = params_.margin_px + float(i)*slotW + params_.gap_px*0.5f;
+        float x0 = params_.margin_px + float(i)*slotW + gap*0.5f;
         float x1 = x0 + barW;
         float yTop = axis_y - h;
         float xc = 0.5f*(x0+x1);
@@ -395,39 +440,9 @@ void BarChartRendererMSDF::build_digits_for_bars(uint32_t W, uint32_t H, const R
         }
     }
 
-    // 写入 SSBO
-    VkDeviceSize bytes = gs.size()*sizeof(GlyphCPU);
-    // 用一个小 staging 写入（也可以直接建 HOST 可见 SSBO）
-    VkBuffer staging{}; VmaAllocation stagingAlloc{};
-    VkBufferCreateInfo bi{VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO}; bi.size=bytes; bi.usage=VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-    VmaAllocationCreateInfo ai{}; ai.usage=VMA_MEMORY_USAGE_AUTO; ai.flags=VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT;
-    VK_CHECK(vmaCreateBuffer(ctx.allocator,&bi,&ai,&staging,&stagingAlloc,nullptr));
-    void* mp{}; vmaMapMemory(ctx.allocator, stagingAlloc, &mp); memcpy(mp, gs.data(), (size_t)bytes); vmaUnmapMemory(ctx.allocator, stagingAlloc);
-
-    // 目标 SSBO 若还没创建就建一个（已在 initialize 中保底创建）
-    ensure_glyph_ssbo(ctx);
-
-    // 复制 staging → glyph_buf_
-    // 用一次性 cmd
-    // 这里直接借用图形队列（和绘制同队列），可安全按帧写入
-    VkCommandPool pool{};
-    VkCommandPoolCreateInfo pci = vkinit::command_pool_create_info(ctx.graphics_queue_family, VK_COMMAND_POOL_CREATE_TRANSIENT_BIT);
-    VK_CHECK(vkCreateCommandPool(ctx.device,&pci,nullptr,&pool));
-    VkCommandBufferAllocateInfo cbai = vkinit::command_buffer_allocate_info(pool,1);
-    VkCommandBuffer cmd; VK_CHECK(vkAllocateCommandBuffers(ctx.device,&cbai,&cmd));
-    VkCommandBufferBeginInfo bi2 = vkinit::command_buffer_begin_info(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
-    VK_CHECK(vkBeginCommandBuffer(cmd,&bi2));
-    VkBufferCopy region{0,0,bytes};
-    vkCmdCopyBuffer(cmd, staging, glyph_buf_, 1, &region);
-    VK_CHECK(vkEndCommandBuffer(cmd));
-    VkCommandBufferSubmitInfo cbsi = vkinit::command_buffer_submit_info(cmd);
-    VkSubmitInfo2 si = vkinit::submit_info(&cbsi,nullptr,nullptr);
-    VK_CHECK(vkQueueSubmit2(ctx.graphics_queue,1,&si,VK_NULL_HANDLE));
-    VK_CHECK(vkQueueWaitIdle(ctx.graphics_queue));
-    vkDestroyCommandPool(ctx.device,pool,nullptr);
-    vmaDestroyBuffer(ctx.allocator, staging, stagingAlloc);
-
-    // 更新 descriptor 不需要改，因为 glyph_buf_ 没换
+    // 写入本帧 scratch：映射内存直接可见，buffer/offset 交给描述符
+    if(gs.empty()) return {};
+    return ctx.frameScratch->push(gs.data(), gs.size());
 }
 
 // ===== 同步工具 =====
@@ -443,15 +458,3 @@ void BarChartRendererMSDF::transition_image(VkCommandBuffer cmd, VkImage img,
     VkDependencyInfo dep{VK_STRUCTURE_TYPE_DEPENDENCY_INFO}; dep.imageMemoryBarrierCount=1; dep.pImageMemoryBarriers=&b;
     vkCmdPipelineBarrier2(cmd,&dep);
 }
-void BarChartRendererMSDF::copy_offscreen_to_swapchain(VkCommandBuffer cmd, VkImage src, VkImage dst, VkExtent2D extent){
-    VkImageBlit2 blit{VK_STRUCTURE_TYPE_IMAGE_BLIT_2};
-    blit.srcSubresource.aspectMask=VK_IMAGE_ASPECT_COLOR_BIT; blit.srcSubresource.layerCount=1;
-    blit.srcOffsets[0]={0,0,0}; blit.srcOffsets[1]={(int32_t)extent.width,(int32_t)extent.height,1};
-    blit.dstSubresource.aspectMask=VK_IMAGE_ASPECT_COLOR_BIT; blit.dstSubresource.layerCount=1;
-    blit.dstOffsets[0]={0,0,0}; blit.dstOffsets[1]={(int32_t)extent.width,(int32_t)extent.height,1};
-    VkBlitImageInfo2 info{VK_STRUCTURE_TYPE_BLIT_IMAGE_INFO_2};
-    info.srcImage=src; info.srcImageLayout=VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-    info.dstImage=dst; info.dstImageLayout=VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL; info.regionCount=1; info.pRegions=&blit;
-    info.filter=VK_FILTER_LINEAR;
-    vkCmdBlitImage2(cmd,&info);
-}
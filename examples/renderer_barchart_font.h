@@ -4,6 +4,8 @@
 #include <vulkan/vulkan.h>
 #include "src/renderer_iface.h"
 #include "src/ext/vk_descriptors.h"
+#include "src/ext/vk_bindless.h"
+#include "src/ext/vk_scratch.h"
 #include "vk_mem_alloc.h"
 #include <array>
 #include <string>
@@ -15,7 +17,11 @@ public:
     void destroy(const RenderContext& ctx) override;
     void record(VkCommandBuffer cmd, uint32_t width, uint32_t height, const RenderContext& ctx) override;
     void on_swapchain_resized(const RenderContext& ctx) override;
-    void on_imgui() override {}
+    void on_imgui() override;
+    // 静态看板：画面不变；切换描述符路径时重画一帧，让新路径真正录制一次
+    bool needs_redraw() override { const bool d = dirty_; dirty_ = false; return d; }
+    // SDR 看板：8 位 offscreen 足够，填充与 blit 带宽减半
+    VkFormat preferred_offscreen_format() const override { return VK_FORMAT_R8G8B8A8_UNORM; }
 
     // 供你设置图集路径（默认指向 CMake 生成物）
     void set_msdf_paths(const std::string& png, const std::string& json) {
@@ -26,10 +32,8 @@ private:
     // —— 柱状图 compute（沿用你之前的实现） ——
     struct BarPipe {
         VkPipeline pipeline{};
-        VkPipelineLayout layout{};
-        VkDescriptorSetLayout dsl{};
+        VkPipelineLayout layout{}; // bindless 堆的共享 layout，不归本类销毁
         VkShaderModule cs{};
-        VkDescriptorSet dset{};
     } bar_;
 
     // —— MSDF 文字 compute ——
@@ -38,10 +42,38 @@ private:
         VkPipelineLayout layout{};
         VkDescriptorSetLayout dsl{};
         VkShaderModule cs{};
-        VkDescriptorSet dset{};
+        VkDescriptorUpdateTemplate tmpl{}; // 按 TextDescriptors 的内存布局一次写完整个 set（每帧从 frameDescriptors 分配）
+
+        // VK_KHR_push_descriptor 变体：push layout + 独立的 pipeline，不分配 set
+        VkDescriptorSetLayout pushDsl{};
+        VkPipelineLayout pushLayout{};
+        VkPipeline pushPipeline{};
+
+        // VK_EXT_descriptor_buffer 变体：描述符每帧写进引擎的 descriptor ring，按偏移绑定
+        VkDescriptorSetLayout bufferDsl{};
+        VkPipelineLayout bufferLayout{};
+        VkPipeline bufferPipeline{};
     } text_;
 
-    // offscreen storage image 已由引擎提供，bar_.dset 里绑定 binding0
+    // 文字 pass 的 push 常量（与 barchart_font.comp 一致，tiles 为脏 tile 列表的设备地址）
+    struct PCText{ uint32_t W,H; float pxRange, gamma; uint32_t tileCount, pad; VkDeviceAddress tiles; };
+
+    // 文字 pass 的描述符路径；设备不支持的路径在面板里禁用
+    enum class DescriptorPath { Set, Push, Buffer };
+    DescriptorPath text_path_ = DescriptorPath::Set;
+    bool dirty_ = true;
+    PFN_vkCmdPushDescriptorSetKHR push_descriptor_set_{};
+    bool descriptor_buffer_ = false;
+    double text_record_us_[3]{}; // 各路径的 CPU 录制耗时（平滑后）
+
+    // update template 的打包数据：成员顺序/偏移与 create_text_descriptors 中的条目一一对应
+    struct TextDescriptors {
+        VkDescriptorImageInfo  target;  // b0 storage image (offscreen)
+        VkDescriptorImageInfo  atlas;   // b1 combined image sampler
+        VkDescriptorBufferInfo glyphs;  // b2 ssbo
+    };
+
+    // offscreen storage image 已由引擎注册进 bindless 堆，柱子 pass 通过句柄访问
 
     // 字体图集资源
     VkImage        atlas_image_{};
@@ -50,11 +82,6 @@ private:
     VkSampler      atlas_sampler_{};
     uint32_t       atlas_w_{}, atlas_h_{};
 
-    // glyph 实例 SSBO
-    VkBuffer       glyph_buf_{};
-    VmaAllocation  glyph_alloc_{};
-    uint32_t       glyph_cap_ = 256; // 最多实例数
-
     // uv 表，仅做 0..9（你需要可以扩展）
     struct UvRect { float u0,v0,u1,v1; };
     UvRect uv_digits_[10]{};
@@ -77,27 +104,23 @@ private:
     // 内部函数
     void create_bar_pipeline(const RenderContext& ctx);
     void create_text_pipeline(const RenderContext& ctx);
-    void create_bar_descriptors(const RenderContext& ctx);
     void create_text_descriptors(const RenderContext& ctx);
 
     void destroy_bar_pipeline(VkDevice d);
     void destroy_text_pipeline(VkDevice d);
     void destroy_font_resources(VkDevice d, VmaAllocator a);
-    void destroy_glyph_ssbo(VkDevice d, VmaAllocator a);
 
     void load_msdf_atlas(const RenderContext& ctx);          // 读 PNG + 上传到 GPU
     void parse_msdf_json();                                   // 从 JSON 读出 0..9 的 uv
-    void ensure_glyph_ssbo(const RenderContext& ctx);         // 创建 SSBO
 
-    // 每帧构建 glyph 实例数据并写入 SSBO
-    void build_digits_for_bars(uint32_t W, uint32_t H, const RenderContext& ctx);
+    // 每帧构建 glyph 实例数据，直接写进引擎的帧 scratch 内存（无 VMA 调用、无提交等待）
+    ScratchAllocation build_digits_for_bars(uint32_t W, uint32_t H, const RenderContext& ctx);
 
     // 小工具：过渡布局（同步2）
     void transition_image(VkCommandBuffer cmd, VkImage img,
                           VkImageLayout oldL, VkImageLayout newL,
                           VkPipelineStageFlags2 src, VkPipelineStageFlags2 dst,
                           VkAccessFlags2 srcAcc, VkAccessFlags2 dstAcc);
-    void copy_offscreen_to_swapchain(VkCommandBuffer cmd, VkImage src, VkImage dst, VkExtent2D extent);
 };
 
 #endif //RENDERER_BARCHART_FONT_H
\ No newline at end of file
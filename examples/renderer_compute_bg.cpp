@@ -7,8 +7,10 @@
 #include "src/ext/vk_pipelines.h"
 
 #include <stdexcept>
+#include <string>
 #include <cmath>
 #include <algorithm>
+#include <chrono>
 
 #include "imgui.h"
 
@@ -18,30 +20,26 @@
 
 void ComputeBackgroundRenderer::initialize(const RenderContext& ctx)
 {
+    pushDescriptorSet_ = ctx.caps.pushDescriptor ? ctx.caps.cmdPushDescriptorSet : nullptr;
+
     // Descriptor set layout for storage image at binding 0
     {
         DescriptorLayoutBuilder b;
         b.add_binding(0, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE);
-        drawImageSetLayout_ = b.build(ctx.device, VK_SHADER_STAGE_COMPUTE_BIT);
+        const VkDescriptorSetLayoutCreateFlags flags = pushDescriptorSet_ ? VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR : 0;
+        drawImageSetLayout_ = b.build(ctx.device, VK_SHADER_STAGE_COMPUTE_BIT, nullptr, flags);
     }
 
-    // Allocate descriptor set from global pool
-    drawImageSet_ = ctx.descriptorAllocator->allocate(ctx.device, drawImageSetLayout_);
-
-    // Point it to engine-provided offscreen image view
-    VkDescriptorImageInfo imgInfo{};
-    imgInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
-    imgInfo.imageView = ctx.offscreenImageView;
-
-    VkWriteDescriptorSet w{};
-    w.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    w.dstSet = drawImageSet_;
-    w.dstBinding = 0;
-    w.descriptorCount = 1;
-    w.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
-    w.pImageInfo = &imgInfo;
+    if (!pushDescriptorSet_)
+    {
+        // Fallback: allocate descriptor set from global pool
+        drawImageSet_ = ctx.descriptorAllocator->allocate(ctx.device, drawImageSetLayout_);
 
-    vkUpdateDescriptorSets(ctx.device, 1, &w, 0, nullptr);
+        // Point it to engine-provided offscreen image view
+        DescriptorWriter writer;
+        writer.write_image(0, ctx.offscreenImageView, VK_NULL_HANDLE, VK_IMAGE_LAYOUT_GENERAL, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE);
+        writer.update_set(ctx.device, drawImageSet_);
+    }
 
     // Pipeline layout with push constants
     {
@@ -64,11 +62,14 @@ void ComputeBackgroundRenderer::initialize(const RenderContext& ctx)
     VkShaderModule gradientShader{};
     VkShaderModule skyShader{};
 
-    if (!vkutil::load_shader_module("./shaders/gradient_color.comp.spv", ctx.device, &gradientShader))
+    // Variants match the offscreen storage format
+    const std::string gradientPath = std::string("./shaders/gradient_color") + offscreen_shader_variant(ctx.offscreenFormat) + ".comp.spv";
+    const std::string skyPath = std::string("./shaders/sky") + offscreen_shader_variant(ctx.offscreenFormat) + ".comp.spv";
+    if (!vkutil::load_shader_module(gradientPath.c_str(), ctx.device, &gradientShader))
     {
         throw std::runtime_error("Failed to load gradient shader");
     }
-    if (!vkutil::load_shader_module("./shaders/sky.comp.spv", ctx.device, &skyShader))
+    if (!vkutil::load_shader_module(skyPath.c_str(), ctx.device, &skyShader))
     {
         throw std::runtime_error("Failed to load sky shader");
     }
@@ -123,33 +124,29 @@ void ComputeBackgroundRenderer::record(VkCommandBuffer cmd,
 
     // Bind compute effect and write to offscreen
     ComputeEffect& fx = effects_[std::clamp(current_effect_, 0, (int)effects_.size() - 1)];
+    const auto t0 = std::chrono::steady_clock::now();
     vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, fx.pipeline);
-    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE,
-                            pipelineLayout_, 0, 1, &drawImageSet_, 0, nullptr);
+    if (pushDescriptorSet_)
+    {
+        DescriptorWriter writer;
+        writer.write_image(0, ctx.offscreenImageView, VK_NULL_HANDLE, VK_IMAGE_LAYOUT_GENERAL, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE);
+        writer.push_set(pushDescriptorSet_, cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout_);
+    }
+    else
+    {
+        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE,
+                                pipelineLayout_, 0, 1, &drawImageSet_, 0, nullptr);
+    }
     vkCmdPushConstants(cmd, pipelineLayout_, VK_SHADER_STAGE_COMPUTE_BIT,
                        0, sizeof(ComputePushConstants), &fx.data);
 
     const uint32_t gx = static_cast<uint32_t>(std::ceil(width / 16.0));
     const uint32_t gy = static_cast<uint32_t>(std::ceil(height / 16.0));
     vkCmdDispatch(cmd, gx, gy, 1);
+    const double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+    recordUs_ = recordUs_ * 0.95 + us * 0.05;
 
-    // Copy offscreen to current swapchain image
-    vkutil::transition_image(cmd, ctx.offscreenImage,
-                             VK_IMAGE_LAYOUT_GENERAL,
-                             VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
-    vkutil::transition_image(cmd, ctx.swapchainImage,
-                             VK_IMAGE_LAYOUT_UNDEFINED,
-                             VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-
-    vkutil::copy_image_to_image(cmd,
-                                ctx.offscreenImage,
-                                ctx.swapchainImage,
-                                VkExtent2D{width, height},
-                                VkExtent2D{width, height});
-
-    vkutil::transition_image(cmd, ctx.swapchainImage,
-                             VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                             VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+    // Offscreen stays in GENERAL; the engine composite pass resolves it to the swapchain
 }
 
 void ComputeBackgroundRenderer::destroy(const RenderContext& ctx)
@@ -182,29 +179,23 @@ void ComputeBackgroundRenderer::destroy(const RenderContext& ctx)
 
 void ComputeBackgroundRenderer::on_swapchain_resized(const RenderContext& ctx)
 {
-    VkDescriptorImageInfo imgInfo{};
-    imgInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
-    imgInfo.imageView   = ctx.offscreenImageView;
-
-    VkWriteDescriptorSet w{};
-    w.sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    w.dstSet          = drawImageSet_;
-    w.dstBinding      = 0;
-    w.descriptorCount = 1;
-    w.descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
-    w.pImageInfo      = &imgInfo;
-
-    vkUpdateDescriptorSets(ctx.device, 1, &w, 0, nullptr);
+    // Push path reads the view at record time, nothing to rewrite
+    if (pushDescriptorSet_) return;
+
+    DescriptorWriter writer;
+    writer.write_image(0, ctx.offscreenImageView, VK_NULL_HANDLE, VK_IMAGE_LAYOUT_GENERAL, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE);
+    writer.update_set(ctx.device, drawImageSet_);
 }
 
 void ComputeBackgroundRenderer::on_imgui()
 {
     ImGui::Begin("Background");
     ImGui::Text("Effect index: %d", current_effect_);
+    ImGui::Text("Descriptors: %s, record %.2f us", pushDescriptorSet_ ? "push" : "set", recordUs_);
     int e = current_effect_;
     if (ImGui::RadioButton("Gradient", e == 0)) e = 0;
     ImGui::SameLine();
     if (ImGui::RadioButton("Sky", e == 1)) e = 1;
-    if (e != current_effect_) current_effect_ = e;
+    if (e != current_effect_) set_effect_index(e);
     ImGui::End();
 }
@@ -33,14 +33,19 @@ public:
     void destroy(const RenderContext& ctx) override;
     void on_swapchain_resized(const RenderContext& ctx) override;
     void on_imgui() override;
+    // Both effects are static images; only switching effects changes the output
+    bool needs_redraw() override { const bool d = dirty_; dirty_ = false; return d; }
 
     // Optional API to switch effect at runtime
-    void set_effect_index(int idx) { current_effect_ = idx; }
+    void set_effect_index(int idx) { dirty_ |= idx != current_effect_; current_effect_ = idx; }
 
 private:
-    // Descriptors
+    // Descriptors. With VK_KHR_push_descriptor the layout is a push layout and no set is
+    // allocated: the offscreen view is pushed at record time, so resizes need no rewrite.
     VkDescriptorSetLayout drawImageSetLayout_{};
     VkDescriptorSet drawImageSet_{};
+    PFN_vkCmdPushDescriptorSetKHR pushDescriptorSet_{};
+    double recordUs_{}; // smoothed CPU time of the dispatch recording
 
     // Pipelines
     VkPipelineLayout pipelineLayout_{};
@@ -50,6 +55,7 @@ private:
     // For simplicity here we destroy in destroy()
 
     int current_effect_{1};
+    bool dirty_{true};
 };
 
 
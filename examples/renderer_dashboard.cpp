@@ -0,0 +1,354 @@
+#include "renderer_dashboard.h"
+#include "example_utils.h"
+#include "src/ext/vk_initializers.h"
+#include "src/ext/vk_pipelines.h"
+#include "src/ext/vk_bindless.h"
+#include "src/ext/vk_scratch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "imgui.h"
+
+#ifndef VK_CHECK
+#define VK_CHECK(x) do { VkResult err__ = (x); if (err__ != VK_SUCCESS) { throw std::runtime_error(std::string("Vulkan error ") + std::to_string(err__)); } } while(0)
+#endif
+
+namespace {
+
+// dashboard_common.glsl 的 DashboardPanel（std430，64 字节）
+struct GpuPanel {
+    VkDeviceAddress values;
+    uint32_t pad[2];
+    int32_t rect[4];
+    float range[2];
+    uint32_t count;
+    uint32_t chart;
+    float color[4];
+};
+static_assert(sizeof(GpuPanel) == 64);
+
+// 与 dashboard_common.glsl 的 push 块一致
+struct DashboardPush {
+    VkDeviceAddress panels;
+    VkDeviceAddress items;
+    uint32_t item_count;
+    uint32_t image_index;
+    uint32_t panel_override;
+    uint32_t W, H;
+};
+
+constexpr uint32_t NoPanel = ~0u;
+constexpr uint32_t MaxGroups = 65535; // maxComputeWorkGroupCount 的保证下限，超出的工作项排到第二维
+constexpr float DashboardBackground[4] = {0.04f, 0.04f, 0.05f, 1.0f};
+constexpr float Palette[6][3] = {
+    {0.35f, 0.75f, 1.0f}, {1.0f, 0.62f, 0.25f}, {0.45f, 0.9f, 0.5f},
+    {0.95f, 0.4f, 0.5f}, {0.75f, 0.55f, 1.0f}, {0.95f, 0.85f, 0.35f},
+};
+
+const char* chart_name(DashboardRenderer::Chart chart)
+{
+    switch (chart)
+    {
+    case DashboardRenderer::Chart::Line: return "line";
+    case DashboardRenderer::Chart::Bars: return "bars";
+    case DashboardRenderer::Chart::Heat: return "heat";
+    default: return "?";
+    }
+}
+
+} // namespace
+
+DashboardRenderer::DashboardRenderer() = default;
+
+// ==== IRenderer 接口 ====
+
+bool DashboardRenderer::set_option(std::string_view key, std::string_view value)
+{
+    uint32_t n = 0;
+    if (key == "panels" && example_utils::parse_number(value, n) && n > 0) { panel_count_ = std::min(n, 1024u); return true; }
+    if (key == "animate" && example_utils::parse_number(value, n)) { animate_ = n != 0; return true; }
+    if (key == "mode")
+    {
+        if (value == "batched") { mode_ = Mode::Batched; return true; }
+        if (value == "per_panel") { mode_ = Mode::PerPanel; return true; }
+    }
+    return false;
+}
+
+void DashboardRenderer::initialize(const RenderContext& ctx)
+{
+    // 每种图表一条管线，都用 bindless 堆的共享 layout：面板表 / 工作项 / 数据走设备地址
+    const std::string suffix = std::string(offscreen_shader_variant(ctx.offscreenFormat)) + ".comp.spv";
+    pipelines_[uint32_t(Chart::Line)] = vkutil::create_compute_pipeline(ctx.device, ctx.bindless->pipelineLayout, ("shaders/dashboard_line" + suffix).c_str());
+    pipelines_[uint32_t(Chart::Bars)] = vkutil::create_compute_pipeline(ctx.device, ctx.bindless->pipelineLayout, ("shaders/dashboard_bars" + suffix).c_str());
+    pipelines_[uint32_t(Chart::Heat)] = vkutil::create_compute_pipeline(ctx.device, ctx.bindless->pipelineLayout, ("shaders/dashboard_heat" + suffix).c_str());
+    layout_count_ = 0;
+    dirty_ = true;
+}
+
+void DashboardRenderer::destroy(const RenderContext& ctx)
+{
+    for (VkPipeline& p : pipelines_)
+    {
+        if (p) vkDestroyPipeline(ctx.device, p, nullptr);
+        p = VK_NULL_HANDLE;
+    }
+}
+
+void DashboardRenderer::on_imgui()
+{
+    ImGui::Begin("Dashboard");
+    ImGui::Text("%u panels in %ux%u, %u dispatches, %u workgroups last frame", uint32_t(layout_panels_.size()),
+                layout_width_, layout_height_, last_dispatches_, last_workgroups_);
+    if (mode_ == Mode::Batched)
+    {
+        for (uint32_t c = 0; c < uint32_t(Chart::Count); ++c)
+            ImGui::Text("  %-5s %u tiles", chart_name(Chart(c)), uint32_t(items_[c].size() / 2));
+    }
+
+    int panels = int(panel_count_);
+    if (ImGui::SliderInt("Panels", &panels, 1, 400, "%d", ImGuiSliderFlags_Logarithmic))
+    {
+        panel_count_ = uint32_t(std::max(panels, 1));
+        dirty_ = true;
+    }
+    int mode = int(mode_);
+    ImGui::RadioButton("Batched (one dispatch per chart type)", &mode, int(Mode::Batched));
+    ImGui::RadioButton("Per panel (full-screen dispatch each)", &mode, int(Mode::PerPanel));
+    if (mode != int(mode_)) { mode_ = Mode(mode); dirty_ = true; }
+    ImGui::Checkbox("Animate", &animate_);
+    if (!sweep_result_.empty()) ImGui::TextUnformatted(sweep_result_.c_str());
+    ImGui::TextDisabled("Panel count is also set with --set panels=N");
+    ImGui::End();
+}
+
+void DashboardRenderer::build_layout(uint32_t width, uint32_t height)
+{
+    // 面板按接近 1.6:1 的宽高比排成网格，间距 6 像素
+    const uint32_t n = panel_count_;
+    const double aspect = double(std::max(width, 1u)) / double(std::max(height, 1u));
+    const uint32_t cols = std::clamp(uint32_t(std::ceil(std::sqrt(n * aspect / 1.6))), 1u, n);
+    const uint32_t rows = (n + cols - 1) / cols;
+    const int32_t gap = 6;
+    const int32_t w = std::max((int32_t(width) - gap * int32_t(cols + 1)) / int32_t(cols), 8);
+    const int32_t h = std::max((int32_t(height) - gap * int32_t(rows + 1)) / int32_t(rows), 8);
+
+    layout_panels_.resize(n);
+    uint32_t offset = 0;
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        PanelLayout& p = layout_panels_[i];
+        p.rect[0] = gap + int32_t(i % cols) * (w + gap);
+        p.rect[1] = gap + int32_t(i / cols) * (h + gap);
+        p.rect[2] = w;
+        p.rect[3] = h;
+        p.chart = Chart(i % uint32_t(Chart::Count));
+        p.count = p.chart == Chart::Bars ? 24 : 256; // 热力格 16×16
+        p.offset = offset;
+        offset += p.count;
+    }
+    data_.resize(offset);
+    layout_width_ = width;
+    layout_height_ = height;
+    layout_count_ = n;
+}
+
+void DashboardRenderer::generate_data(float* out) const
+{
+    // 模拟各面板的实时指标，值都在 [0, 1]
+    const float t = time_;
+    const uint32_t tick = uint32_t(t * 20.0f);
+    for (uint32_t i = 0; i < layout_panels_.size(); ++i)
+    {
+        const PanelLayout& p = layout_panels_[i];
+        const float phase = example_utils::hash01(i * 977u + 13u) * 6.2831853f;
+        float* v = out + p.offset;
+        for (uint32_t k = 0; k < p.count; ++k)
+        {
+            switch (p.chart)
+            {
+            case Chart::Line:
+            {
+                const float x = float(k) / float(p.count - 1);
+                v[k] = 0.5f + 0.28f * std::sin(6.2831853f * x * 2.0f + phase + t * 1.3f) +
+                       0.12f * std::sin(6.2831853f * x * 9.0f - t * 2.1f + phase * 3.0f) +
+                       0.06f * (example_utils::hash01(k * 31u + i * 7919u + tick) - 0.5f);
+                break;
+            }
+            case Chart::Bars:
+                v[k] = 0.55f + 0.4f * std::sin(t * 0.9f + float(k) * 0.55f + phase * 5.0f);
+                break;
+            default:
+                v[k] = 0.5f + 0.5f * std::sin(float(k % 16) * 0.45f + t + phase) * std::cos(float(k / 16) * 0.35f - t * 0.7f);
+                break;
+            }
+        }
+    }
+}
+
+void DashboardRenderer::record(VkCommandBuffer cmd, uint32_t width, uint32_t height, const RenderContext& ctx)
+{
+    if (layout_count_ != panel_count_ || layout_width_ != width || layout_height_ != height) build_layout(width, height);
+    if (animate_) time_ += 1.0f / 60.0f;
+    const uint32_t n = uint32_t(layout_panels_.size());
+
+    // 1) 本帧数据 + 面板表进帧 scratch（面板可以指向任意缓冲，这里都在同一块里）
+    generate_data(data_.data());
+    const ScratchAllocation data = ctx.frameScratch->push(data_.data(), data_.size(), 16);
+    const ScratchAllocation table = ctx.frameScratch->allocate(sizeof(GpuPanel) * n, 16);
+    GpuPanel* gpu = static_cast<GpuPanel*>(table.ptr);
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        const PanelLayout& p = layout_panels_[i];
+        GpuPanel g{};
+        g.values = data.address + VkDeviceAddress(p.offset) * sizeof(float);
+        std::copy(std::begin(p.rect), std::end(p.rect), g.rect);
+        g.range[0] = 0.0f;
+        g.range[1] = 1.0f;
+        g.count = p.count;
+        g.chart = uint32_t(p.chart);
+        const float* c = Palette[i % 6];
+        g.color[0] = c[0];
+        g.color[1] = c[1];
+        g.color[2] = c[2];
+        g.color[3] = 1.0f;
+        gpu[i] = g;
+    }
+
+    // 2) 一次清屏（面板之间的缝隙），之后各派发只写互不重叠的面板像素
+    VkImageMemoryBarrier2 ib{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2};
+    ib.srcStageMask = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_2_TRANSFER_BIT;
+    ib.dstStageMask = VK_PIPELINE_STAGE_2_CLEAR_BIT;
+    ib.dstAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+    ib.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    ib.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+    ib.image = ctx.offscreenImage;
+    ib.subresourceRange = vkinit::image_subresource_range(VK_IMAGE_ASPECT_COLOR_BIT);
+    VkDependencyInfo dep{VK_STRUCTURE_TYPE_DEPENDENCY_INFO};
+    dep.imageMemoryBarrierCount = 1;
+    dep.pImageMemoryBarriers = &ib;
+    vkCmdPipelineBarrier2(cmd, &dep);
+    VkClearColorValue clear{};
+    std::copy(std::begin(DashboardBackground), std::end(DashboardBackground), clear.float32);
+    const VkImageSubresourceRange range = vkinit::image_subresource_range(VK_IMAGE_ASPECT_COLOR_BIT);
+    vkCmdClearColorImage(cmd, ctx.offscreenImage, VK_IMAGE_LAYOUT_GENERAL, &clear, 1, &range);
+
+    VkMemoryBarrier2 mb{VK_STRUCTURE_TYPE_MEMORY_BARRIER_2};
+    mb.srcStageMask = VK_PIPELINE_STAGE_2_CLEAR_BIT;
+    mb.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+    mb.dstStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+    mb.dstAccessMask = VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+    dep = {VK_STRUCTURE_TYPE_DEPENDENCY_INFO};
+    dep.memoryBarrierCount = 1;
+    dep.pMemoryBarriers = &mb;
+    vkCmdPipelineBarrier2(cmd, &dep);
+
+    DashboardPush pc{};
+    pc.panels = table.address;
+    pc.image_index = ctx.offscreenStorageIndex;
+    pc.W = width;
+    pc.H = height;
+    last_dispatches_ = 0;
+    last_workgroups_ = 0;
+
+    if (mode_ == Mode::Batched)
+    {
+        // 3) 每种图表一张工作表（面板, 16×16 块），一次派发，一个工作组一块
+        for (auto& items : items_) items.clear();
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            const PanelLayout& p = layout_panels_[i];
+            const uint32_t tilesX = (uint32_t(p.rect[2]) + TileSize - 1) / TileSize;
+            const uint32_t tilesY = (uint32_t(p.rect[3]) + TileSize - 1) / TileSize;
+            std::vector<uint32_t>& items = items_[uint32_t(p.chart)];
+            for (uint32_t ty = 0; ty < tilesY; ++ty)
+            {
+                for (uint32_t tx = 0; tx < tilesX; ++tx)
+                {
+                    items.push_back(i);
+                    items.push_back(tx | (ty << 16));
+                }
+            }
+        }
+        pc.panel_override = NoPanel;
+        for (uint32_t c = 0; c < uint32_t(Chart::Count); ++c)
+        {
+            const uint32_t count = uint32_t(items_[c].size() / 2);
+            if (count == 0) continue;
+            pc.items = ctx.frameScratch->push(items_[c].data(), items_[c].size(), 8).address;
+            pc.item_count = count;
+            vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipelines_[c]);
+            ctx.bindless->push(cmd, &pc, sizeof(pc));
+            const uint32_t x = std::min(count, MaxGroups);
+            vkCmdDispatch(cmd, x, (count + x - 1) / x, 1);
+            ++last_dispatches_;
+            last_workgroups_ += count;
+        }
+    }
+    else
+    {
+        // 对照：每个面板像独立渲染器一样等上一个写完、整屏派发一次
+        const uint32_t tilesX = (width + TileSize - 1) / TileSize;
+        const uint32_t tilesY = (height + TileSize - 1) / TileSize;
+        mb.srcStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+        mb.srcAccessMask = VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            if (i > 0) vkCmdPipelineBarrier2(cmd, &dep);
+            pc.panel_override = i;
+            vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipelines_[uint32_t(layout_panels_[i].chart)]);
+            ctx.bindless->push(cmd, &pc, sizeof(pc));
+            vkCmdDispatch(cmd, tilesX, tilesY, 1);
+            ++last_dispatches_;
+            last_workgroups_ += tilesX * tilesY;
+        }
+    }
+    // offscreen 保持 GENERAL，由引擎 composite pass 一次性采样上屏
+}
+
+RendererSweep DashboardRenderer::make_timing_sweep()
+{
+    // 1 / 10 / 50 / 200 个面板下，按类型批量派发 vs 逐面板整屏派发
+    struct Variant { uint32_t panels; Mode mode; };
+    std::vector<Variant> variants;
+    for (uint32_t n : {1u, 10u, 50u, 200u})
+    {
+        variants.push_back({n, Mode::Batched});
+        variants.push_back({n, Mode::PerPanel});
+    }
+
+    RendererSweep sweep;
+    for (const Variant& v : variants)
+    {
+        char label[64];
+        std::snprintf(label, sizeof(label), "%u panels, %s", v.panels, v.mode == Mode::Batched ? "batched" : "per panel");
+        sweep.steps.push_back({label, [this, v]() {
+            panel_count_ = v.panels;
+            mode_ = v.mode;
+        }});
+    }
+    sweep.report = [this, variants](const std::vector<double>& ms) {
+        std::string text = "sweep (GPU ms, us per panel):";
+        for (size_t i = 0; i + 1 < ms.size() && i + 1 < variants.size(); i += 2)
+        {
+            const uint32_t n = variants[i].panels;
+            char part[128];
+            std::snprintf(part, sizeof(part), "\n  %4u panels  batched %7.3f ms (%6.1f)  per panel %7.3f ms (%6.1f)  x%.1f", n,
+                          ms[i], ms[i] * 1e3 / n, ms[i + 1], ms[i + 1] * 1e3 / n, ms[i] > 0.0 ? ms[i + 1] / ms[i] : 0.0);
+            text += part;
+        }
+        sweep_result_ = text;
+        std::printf("%s\n", text.c_str());
+    };
+    sweep.restore = [this, panels = panel_count_, mode = mode_]() {
+        panel_count_ = panels;
+        mode_ = mode;
+        dirty_ = true;
+    };
+    return sweep;
+}
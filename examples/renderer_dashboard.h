@@ -0,0 +1,72 @@
+#ifndef RENDERER_DASHBOARD_H
+#define RENDERER_DASHBOARD_H
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "src/renderer_iface.h"
+#include "src/ext/vk_bindless.h"
+
+// 多面板仪表盘：几十上百个小图表（折线 / 柱状 / 小热力格）合成进同一张 offscreen。
+// 面板表（视口矩形、图表类型、数据缓冲地址、值域、颜色）每帧写进帧 scratch 的 SSBO；
+// CPU 把每个面板切成 16×16 像素块，按图表类型各列一张工作表，每种类型一次 dispatch，
+// 一个工作组画一块，像素只被写一次。整帧只有一次清屏 + 每类型一次派发，由引擎 composite 一次性上屏。
+// 对照模式“逐面板”模拟每个图表各自一个渲染器：每个面板一次屏障 + 一次整屏派发（面板外的块直接退出）。
+class DashboardRenderer final : public IRenderer
+{
+public:
+    DashboardRenderer();
+    ~DashboardRenderer() override = default;
+
+    void initialize(const RenderContext& ctx) override;
+    void destroy(const RenderContext& ctx) override;
+    void record(VkCommandBuffer cmd, uint32_t width, uint32_t height, const RenderContext& ctx) override;
+    void on_swapchain_resized(const RenderContext& ctx) override { dirty_ = true; }
+    void on_imgui() override;
+    bool needs_redraw() override { const bool d = animate_ || dirty_; dirty_ = false; return d; }
+    VkFormat preferred_offscreen_format() const override { return VK_FORMAT_R8G8B8A8_UNORM; }
+    // panels=N / mode=batched|per_panel / animate=0|1
+    bool set_option(std::string_view key, std::string_view value) override;
+
+    // 与 dashboard_common.glsl 的 DASHBOARD_* 一致
+    enum class Chart : uint32_t { Line = 0, Bars = 1, Heat = 2, Count = 3 };
+    enum class Mode { Batched, PerPanel };
+    static constexpr uint32_t TileSize = 16;
+
+    const char* timing_sweep_label() const override { return "Sweep panel counts (1-200, batched vs per panel)"; }
+    RendererSweep make_timing_sweep() override;
+
+private:
+    struct PanelLayout {
+        int32_t rect[4]; // x, y, w, h（像素）
+        Chart chart;
+        uint32_t count;  // 数据点数
+        uint32_t offset; // 在本帧数据区里的起始下标
+    };
+    std::vector<PanelLayout> layout_panels_;
+    uint32_t layout_width_ = 0, layout_height_ = 0, layout_count_ = 0;
+    void build_layout(uint32_t width, uint32_t height);
+    // 本帧的数据（模拟实时指标），按 PanelLayout::offset 排列
+    void generate_data(float* out) const;
+
+    // 每帧复用的 CPU 暂存
+    std::vector<float> data_;
+    std::vector<uint32_t> items_[uint32_t(Chart::Count)]; // 每块两个 uint：面板下标，块坐标 tx | ty << 16
+
+    // —— 管线（都用 bindless 堆的共享 layout）——
+    VkPipeline pipelines_[uint32_t(Chart::Count)]{};
+
+    // —— 参数 ——
+    uint32_t panel_count_ = 24;
+    Mode mode_ = Mode::Batched;
+    bool animate_ = true;
+    bool dirty_ = true;
+    float time_ = 0.0f;
+    uint32_t last_dispatches_ = 0;
+    uint32_t last_workgroups_ = 0;
+    std::string sweep_result_;
+};
+
+#endif //RENDERER_DASHBOARD_H
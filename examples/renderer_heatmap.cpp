@@ -0,0 +1,618 @@
+#include "renderer_heatmap.h"
+#include "example_utils.h"
+#include "src/ext/vk_initializers.h"
+#include "src/ext/vk_pipelines.h"
+#include "src/ext/vk_bindless.h"
+#include "src/ext/vk_scratch.h"
+#include "src/gpu_memory.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <glm/gtc/packing.hpp>
+
+#include "imgui.h"
+
+#ifndef VK_CHECK
+#define VK_CHECK(x) do { VkResult err__ = (x); if (err__ != VK_SUCCESS) { throw std::runtime_error(std::string("Vulkan error ") + std::to_string(err__)); } } while(0)
+#endif
+
+namespace {
+
+// 与 heatmap.comp 的 push 块一致
+struct ShadePush {
+    VkDeviceAddress table;
+    float origin[2];         // 像素 (0, 0) 处的矩阵坐标（列, 行）
+    float range[2];
+    int32_t grid_origin[2];  // 页表第一块瓦片的 (tx, ty)
+    float cells_per_pixel;
+    uint32_t size;
+    uint32_t level;
+    uint32_t grid_width, grid_height;
+    uint32_t cache_index;
+    uint32_t image_index;
+    uint32_t W, H;
+    uint32_t colormap;
+    uint32_t flags;          // 1 = 画瓦片边界并压暗由上级顶替的瓦片
+};
+
+constexpr uint32_t NoEntry = ~0u;
+
+} // namespace
+
+HeatmapRenderer::HeatmapRenderer() = default;
+
+HeatmapRenderer::~HeatmapRenderer()
+{
+    stop_worker();
+}
+
+// ==== IRenderer 接口 ====
+
+bool HeatmapRenderer::set_option(std::string_view key, std::string_view value)
+{
+    uint32_t n = 0;
+    if (key == "size" && example_utils::parse_number(value, n) && n > 0) { size_ = std::min(n, 1u << 20); return true; }
+    if (key == "cache" && example_utils::parse_number(value, n)) { cache_tiles_ = std::clamp(n, 16u, 1u << 16); return true; }
+    if (key == "upload_budget" && example_utils::parse_number(value, n) && n > 0) { upload_budget_ = std::min(n, 64u); return true; }
+    return false;
+}
+
+void HeatmapRenderer::initialize(const RenderContext& ctx)
+{
+    levels_ = 1;
+    while (tiles_per_side(levels_ - 1) > 1) ++levels_;
+    create_pipelines(ctx);
+    create_cache(ctx);
+    start_worker();
+    dirty_ = true;
+}
+
+void HeatmapRenderer::destroy(const RenderContext& ctx)
+{
+    stop_worker();
+    if (shade_) vkDestroyPipeline(ctx.device, shade_, nullptr);
+    shade_ = VK_NULL_HANDLE;
+    layout_ = VK_NULL_HANDLE;
+    destroy_cache(ctx);
+}
+
+void HeatmapRenderer::on_swapchain_resized(const RenderContext& ctx)
+{
+    dirty_ = true;
+    const uint32_t needed = std::min(tiles_needed(ctx.frameExtent.width, ctx.frameExtent.height), ctx.caps.maxImageArrayLayers);
+    if (cache_.image && needed > cache_.layers)
+    {
+        destroy_cache(ctx);
+        create_cache(ctx);
+    }
+}
+
+void HeatmapRenderer::on_imgui()
+{
+    ImGui::Begin("Heatmap");
+    const double cacheMiB = double(cache_.layers) * TileSize * TileSize * sizeof(uint16_t) / 1048576.0;
+    ImGui::Text("Matrix %ux%u, %u levels of %ux%u tiles", size_, size_, levels_, TileSize, TileSize);
+    ImGui::Text("Tile cache: %zu / %u layers resident (R16_SFLOAT array, %.0f MiB)", resident_.size(), cache_.layers, cacheMiB);
+
+    const uint32_t frameTotal = stats_.frame_hits + stats_.frame_misses;
+    const uint64_t total = stats_.hits + stats_.misses;
+    ImGui::Text("Level %u: %u visible tiles, hit rate %.1f%% this frame, %.1f%% overall", stats_.level, stats_.visible,
+                frameTotal ? 100.0 * stats_.frame_hits / frameTotal : 100.0, total ? 100.0 * double(stats_.hits) / double(total) : 100.0);
+    double generateMs;
+    {
+        std::lock_guard lock(mutex_);
+        generateMs = generate_ms_;
+    }
+    ImGui::Text("Uploads: %u this frame, %llu total, %llu evictions", stats_.uploads,
+                static_cast<unsigned long long>(stats_.total_uploads), static_cast<unsigned long long>(stats_.evictions));
+    ImGui::Text("Queued: %u tiles, %.2f ms per generated tile", stats_.queued, generateMs);
+
+    int colormap = colormap_;
+    ImGui::RadioButton("Diverging", &colormap, 0);
+    ImGui::SameLine();
+    ImGui::RadioButton("Viridis", &colormap, 1);
+    if (colormap != colormap_) { colormap_ = colormap; dirty_ = true; }
+    if (ImGui::DragFloatRange2("Value range", &range_[0], &range_[1], 0.01f, -1.0f, 1.0f, "%.2f")) dirty_ = true;
+    int budget = int(upload_budget_);
+    if (ImGui::SliderInt("Uploads / frame", &budget, 1, 64)) upload_budget_ = uint32_t(budget);
+    if (ImGui::Checkbox("Tile grid (dim = parent fallback)", &show_tile_grid_)) dirty_ = true;
+    if (ImGui::Button("Flush cache"))
+    {
+        // 槽位清空即可：纹理内容等被覆盖前不会再被页表引用
+        lru_.clear();
+        for (uint32_t i = 0; i < slots_.size(); ++i) slots_[i] = Slot{~0ull, 0, false, lru_.insert(lru_.end(), i)};
+        resident_.clear();
+        stats_ = {};
+        dirty_ = true;
+    }
+
+    // 鼠标：滚轮以光标为锚缩放，左键拖动平移（不在 ImGui 窗口上时）
+    const ImGuiIO& io = ImGui::GetIO();
+    const double ox = io.DisplaySize.x * 0.5, oy = io.DisplaySize.y * 0.5;
+    if (!io.WantCaptureMouse && cells_per_pixel_ > 0.0)
+    {
+        if (io.MouseWheel != 0.0f)
+        {
+            // 光标下的单元在缩放前后保持不动
+            const double cx = center_[0] + (io.MousePos.x - ox) * cells_per_pixel_;
+            const double cy = center_[1] + (io.MousePos.y - oy) * cells_per_pixel_;
+            cells_per_pixel_ = std::clamp(cells_per_pixel_ / std::pow(1.25, double(io.MouseWheel)), 1.0 / 64.0, double(size_) / 64.0);
+            center_[0] = cx - (io.MousePos.x - ox) * cells_per_pixel_;
+            center_[1] = cy - (io.MousePos.y - oy) * cells_per_pixel_;
+            dirty_ = true;
+        }
+        if (ImGui::IsMouseDragging(ImGuiMouseButton_Left) && (io.MouseDelta.x != 0.0f || io.MouseDelta.y != 0.0f))
+        {
+            center_[0] -= io.MouseDelta.x * cells_per_pixel_;
+            center_[1] -= io.MouseDelta.y * cells_per_pixel_;
+            dirty_ = true;
+        }
+        const double col = center_[0] + (io.MousePos.x - ox) * cells_per_pixel_;
+        const double row = center_[1] + (io.MousePos.y - oy) * cells_per_pixel_;
+        if (col >= 0.0 && row >= 0.0 && col < size_ && row < size_)
+            ImGui::Text("Cursor: row %u, col %u = %.3f", uint32_t(row), uint32_t(col), cell_value(uint32_t(row), uint32_t(col)));
+    }
+    ImGui::Text("%.3f cells / pixel at (%.0f, %.0f)", cells_per_pixel_, center_[0], center_[1]);
+    ImGui::SameLine();
+    if (ImGui::Button("Reset view"))
+    {
+        cells_per_pixel_ = 0.0;
+        dirty_ = true;
+    }
+    ImGui::TextDisabled("Matrix size is also set with --set size=N");
+    ImGui::End();
+}
+
+void HeatmapRenderer::fit_view(uint32_t width, uint32_t height)
+{
+    cells_per_pixel_ = double(size_) / double(std::max(std::min(width, height), 1u)) * 1.05;
+    center_[0] = center_[1] = size_ * 0.5;
+}
+
+void HeatmapRenderer::record(VkCommandBuffer cmd, uint32_t width, uint32_t height, const RenderContext& ctx)
+{
+    if (cells_per_pixel_ <= 0.0) fit_view(width, height);
+    // 视图中心不离开矩阵，瓦片下标也就不会溢出
+    center_[0] = std::clamp(center_[0], 0.0, double(size_));
+    center_[1] = std::clamp(center_[1], 0.0, double(size_));
+    ++frame_;
+    frame_touched_ = 0;
+
+    // 1) 先上传就绪瓦片，本帧的页表就能用上它们
+    upload_ready(cmd, ctx);
+
+    // 2) 选级别：一个纹素至少占一个像素。高层级纹素只是 2×2 个点采样的平均（见 generate_tile），
+    //    比单元更细的结构在缩小时会混叠；要无混叠需要真正逐级平均的数据源
+    uint32_t level = 0;
+    if (cells_per_pixel_ > 1.0) level = uint32_t(std::ceil(std::log2(cells_per_pixel_) - 1e-6));
+    level = std::min(level, levels_ - 1);
+    const double originX = center_[0] - width * 0.5 * cells_per_pixel_;
+    const double originY = center_[1] - height * 0.5 * cells_per_pixel_;
+    const double tileCells = double(TileSize) * double(1u << level);
+    const int32_t tiles = int32_t(tiles_per_side(level));
+    const int32_t tx0 = std::max(int32_t(std::floor(originX / tileCells)), 0);
+    const int32_t ty0 = std::max(int32_t(std::floor(originY / tileCells)), 0);
+    const int32_t tx1 = std::min(int32_t(std::floor((originX + width * cells_per_pixel_) / tileCells)), tiles - 1);
+    const int32_t ty1 = std::min(int32_t(std::floor((originY + height * cells_per_pixel_) / tileCells)), tiles - 1);
+    const uint32_t gw = tx1 >= tx0 ? uint32_t(tx1 - tx0 + 1) : 0;
+    const uint32_t gh = ty1 >= ty0 ? uint32_t(ty1 - ty0 + 1) : 0;
+    build_page_table(level, tx0, ty0, gw, gh);
+
+    // 3) 页表进帧 scratch，着色写满 offscreen
+    // 视图完全在矩阵外时没有可见瓦片，着色不会读页表
+    const VkDeviceAddress table = page_table_.empty() ? 0 : ctx.frameScratch->push(page_table_.data(), page_table_.size(), 4).address;
+
+    VkImageMemoryBarrier2 ob{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2};
+    ob.srcStageMask = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_2_TRANSFER_BIT;
+    ob.dstStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+    ob.dstAccessMask = VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+    ob.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    ob.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+    ob.image = ctx.offscreenImage;
+    ob.subresourceRange = vkinit::image_subresource_range(VK_IMAGE_ASPECT_COLOR_BIT);
+    VkDependencyInfo dep{VK_STRUCTURE_TYPE_DEPENDENCY_INFO};
+    dep.imageMemoryBarrierCount = 1;
+    dep.pImageMemoryBarriers = &ob;
+    vkCmdPipelineBarrier2(cmd, &dep);
+
+    ShadePush sp{};
+    sp.table = table;
+    sp.origin[0] = float(originX);
+    sp.origin[1] = float(originY);
+    sp.cells_per_pixel = float(cells_per_pixel_);
+    sp.size = size_;
+    sp.level = level;
+    sp.grid_origin[0] = tx0;
+    sp.grid_origin[1] = ty0;
+    sp.grid_width = gw;
+    sp.grid_height = gh;
+    sp.cache_index = cache_.index;
+    sp.image_index = ctx.offscreenStorageIndex;
+    sp.W = width;
+    sp.H = height;
+    sp.range[0] = range_[0];
+    sp.range[1] = std::max(range_[1], range_[0] + 1e-4f);
+    sp.colormap = uint32_t(colormap_);
+    sp.flags = show_tile_grid_ ? 1u : 0u;
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, shade_);
+    ctx.bindless->push(cmd, &sp, sizeof(sp));
+    vkCmdDispatch(cmd, (width + 15) / 16, (height + 15) / 16, 1);
+    // offscreen 保持 GENERAL，由引擎 composite pass 采样
+}
+
+// ==== 瓦片缓存 ====
+
+uint32_t HeatmapRenderer::tiles_per_side(uint32_t level) const
+{
+    const uint64_t span = uint64_t(TileSize) << level;
+    return uint32_t((size_ + span - 1) / span);
+}
+
+uint32_t HeatmapRenderer::acquire_slot()
+{
+    // lru_ 按最近一次引用排序，队首不可用则没有可用的：上一帧还在用的瓦片不淘汰，免得视口内来回换
+    if (lru_.empty()) return ~0u;
+    const uint32_t slot = lru_.front();
+    Slot& s = slots_[slot];
+    if (s.key != ~0ull)
+    {
+        if (s.last_used + 1 >= frame_) return ~0u;
+        resident_.erase(s.key);
+        ++stats_.evictions;
+    }
+    return slot;
+}
+
+void HeatmapRenderer::touch(uint32_t slot)
+{
+    Slot& s = slots_[slot];
+    if (s.last_used != frame_) ++frame_touched_;
+    s.last_used = frame_;
+    if (!s.pinned) lru_.splice(lru_.end(), lru_, s.lru);
+}
+
+void HeatmapRenderer::upload_ready(VkCommandBuffer cmd, const RenderContext& ctx)
+{
+    std::pmr::vector<ReadyTile> uploads(ctx.frameArena); // 帧内临时数据，走引擎的帧 arena
+    {
+        std::lock_guard lock(mutex_);
+        const size_t n = std::min<size_t>(ready_.size(), upload_budget_);
+        uploads.reserve(n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            uploads.push_back(std::move(ready_.back()));
+            ready_.pop_back();
+        }
+    }
+
+    const VkImageSubresourceRange range = vkinit::image_subresource_range(VK_IMAGE_ASPECT_COLOR_BIT);
+    if (!uploads.empty())
+    {
+        // 首次：UNDEFINED → GENERAL；之后：等之前帧的着色读完再覆盖（WAR）
+        VkImageMemoryBarrier2 ib{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2};
+        ib.srcStageMask = cache_.initialized ? VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT : VK_PIPELINE_STAGE_2_NONE;
+        ib.dstStageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
+        ib.dstAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+        ib.oldLayout = cache_.initialized ? VK_IMAGE_LAYOUT_GENERAL : VK_IMAGE_LAYOUT_UNDEFINED;
+        ib.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+        ib.image = cache_.image;
+        ib.subresourceRange = range;
+        VkDependencyInfo dep{VK_STRUCTURE_TYPE_DEPENDENCY_INFO};
+        dep.imageMemoryBarrierCount = 1;
+        dep.pImageMemoryBarriers = &ib;
+        vkCmdPipelineBarrier2(cmd, &dep);
+        cache_.initialized = true;
+    }
+
+    // 一次 vkCmdCopyBufferToImage 只有一个源缓冲：帧 scratch 换块时先把攒下的区域提交
+    VkBufferImageCopy regions[64];
+    uint32_t regionCount = 0;
+    VkBuffer staging = VK_NULL_HANDLE;
+    size_t consumed = 0;
+    for (; consumed < uploads.size(); ++consumed)
+    {
+        ReadyTile& tile = uploads[consumed];
+        if (resident_.contains(tile.key)) continue;
+        const uint32_t slot = acquire_slot();
+        if (slot == ~0u) break;
+        const ScratchAllocation a = ctx.frameScratch->push(tile.texels.data(), tile.texels.size(), 16);
+        if (regionCount > 0 && a.buffer != staging)
+        {
+            vkCmdCopyBufferToImage(cmd, staging, cache_.image, VK_IMAGE_LAYOUT_GENERAL, regionCount, regions);
+            regionCount = 0;
+        }
+        staging = a.buffer;
+        VkBufferImageCopy& r = regions[regionCount++];
+        r = {};
+        r.bufferOffset = a.offset;
+        r.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, slot, 1};
+        r.imageExtent = {TileSize, TileSize, 1};
+
+        Slot& s = slots_[slot];
+        s.key = tile.key;
+        resident_[tile.key] = slot;
+        touch(slot);
+        if (key_level(tile.key) == levels_ - 1)
+        {
+            s.pinned = true;
+            lru_.erase(s.lru);
+        }
+    }
+    if (regionCount > 0) vkCmdCopyBufferToImage(cmd, staging, cache_.image, VK_IMAGE_LAYOUT_GENERAL, regionCount, regions);
+
+    if (!uploads.empty() || !cache_.initialized)
+    {
+        // 拷贝 → 着色采样；还没有任何瓦片时在这里完成首次布局转换
+        VkImageMemoryBarrier2 ib{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2};
+        ib.srcStageMask = cache_.initialized ? VK_PIPELINE_STAGE_2_COPY_BIT : VK_PIPELINE_STAGE_2_NONE;
+        ib.srcAccessMask = cache_.initialized ? VK_ACCESS_2_TRANSFER_WRITE_BIT : VK_ACCESS_2_NONE;
+        ib.dstStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+        ib.dstAccessMask = VK_ACCESS_2_SHADER_SAMPLED_READ_BIT;
+        ib.oldLayout = cache_.initialized ? VK_IMAGE_LAYOUT_GENERAL : VK_IMAGE_LAYOUT_UNDEFINED;
+        ib.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+        ib.image = cache_.image;
+        ib.subresourceRange = range;
+        VkDependencyInfo dep{VK_STRUCTURE_TYPE_DEPENDENCY_INFO};
+        dep.imageMemoryBarrierCount = 1;
+        dep.pImageMemoryBarriers = &ib;
+        vkCmdPipelineBarrier2(cmd, &dep);
+        cache_.initialized = true;
+    }
+    stats_.uploads = uint32_t(consumed);
+    stats_.total_uploads += consumed;
+
+    // 没放进缓存的留到下一帧；已上传的内存还给 worker
+    std::lock_guard lock(mutex_);
+    for (size_t i = 0; i < uploads.size(); ++i)
+    {
+        if (i < consumed) spare_.push_back(std::move(uploads[i].texels));
+        else ready_.push_back(std::move(uploads[i]));
+    }
+}
+
+void HeatmapRenderer::build_page_table(uint32_t level, int32_t tx0, int32_t ty0, uint32_t gw, uint32_t gh)
+{
+    page_table_.assign(std::max<size_t>(size_t(gw) * gh, 1), NoEntry);
+    wanted_.clear();
+    stats_.frame_hits = stats_.frame_misses = 0;
+    stats_.level = level;
+    stats_.visible = gw * gh;
+
+    // 根瓦片最先要：有了它任何缺失都能被顶替
+    const TileKey root = make_key(levels_ - 1, 0, 0);
+    if (!resident_.contains(root)) wanted_.push_back(root);
+    const size_t visibleFirst = wanted_.size();
+
+    for (uint32_t gy = 0; gy < gh; ++gy)
+    {
+        for (uint32_t gx = 0; gx < gw; ++gx)
+        {
+            const uint32_t tx = uint32_t(tx0) + gx, ty = uint32_t(ty0) + gy;
+            uint32_t& entry = page_table_[gy * gw + gx];
+            if (auto it = resident_.find(make_key(level, tx, ty)); it != resident_.end())
+            {
+                touch(it->second);
+                entry = it->second;
+                ++stats_.frame_hits;
+                continue;
+            }
+            ++stats_.frame_misses;
+            if (make_key(level, tx, ty) != root) wanted_.push_back(make_key(level, tx, ty));
+            // 先用最近的已驻留上级放大顶替
+            for (uint32_t up = 1; level + up < levels_; ++up)
+            {
+                if (auto it = resident_.find(make_key(level + up, tx >> up, ty >> up)); it != resident_.end())
+                {
+                    touch(it->second);
+                    entry = it->second | (up << 16);
+                    break;
+                }
+            }
+        }
+    }
+    stats_.hits += stats_.frame_hits;
+    stats_.misses += stats_.frame_misses;
+
+    // 离视口中心近的先生成
+    const float cx = float(tx0) + float(gw) * 0.5f - 0.5f, cy = float(ty0) + float(gh) * 0.5f - 0.5f;
+    std::sort(wanted_.begin() + visibleFirst, wanted_.end(), [cx, cy](TileKey a, TileKey b) {
+        const float da = std::abs(float(key_tx(a)) - cx) + std::abs(float(key_ty(a)) - cy);
+        const float db = std::abs(float(key_tx(b)) - cx) + std::abs(float(key_ty(b)) - cy);
+        return da < db;
+    });
+
+    // 预取视口外一圈同级瓦片（平移时先到）；已驻留的续期，免得被当成最久未用淘汰。
+    // 只取缓存还放得下的部分，否则请求永远上传不了，streaming_ 不会落下
+    int64_t prefetch = int64_t(cache_.layers) - frame_touched_ - int64_t(wanted_.size());
+    if (gw > 0 && gh > 0)
+    {
+        const int32_t tiles = int32_t(tiles_per_side(level));
+        for (int32_t ty = ty0 - 1; ty <= ty0 + int32_t(gh) && prefetch > 0; ++ty)
+        {
+            for (int32_t tx = tx0 - 1; tx <= tx0 + int32_t(gw); ++tx)
+            {
+                const bool inside = tx >= tx0 && ty >= ty0 && tx < tx0 + int32_t(gw) && ty < ty0 + int32_t(gh);
+                if (inside || tx < 0 || ty < 0 || tx >= tiles || ty >= tiles) continue;
+                if (prefetch <= 0) break;
+                --prefetch;
+                const TileKey key = make_key(level, uint32_t(tx), uint32_t(ty));
+                if (auto it = resident_.find(key); it != resident_.end()) touch(it->second);
+                else wanted_.push_back(key);
+            }
+        }
+    }
+
+    // 整体替换请求队列：移出视口的请求直接作废，已生成但不再需要的瓦片也丢掉
+    std::lock_guard lock(mutex_);
+    std::erase_if(ready_, [this](ReadyTile& t) {
+        if (std::find(wanted_.begin(), wanted_.end(), t.key) != wanted_.end()) return false;
+        spare_.push_back(std::move(t.texels));
+        return true;
+    });
+    queue_.clear();
+    for (auto it = wanted_.rbegin(); it != wanted_.rend(); ++it)
+    {
+        const TileKey key = *it;
+        if (key == busy_ || std::any_of(ready_.begin(), ready_.end(), [key](const ReadyTile& t) { return t.key == key; })) continue;
+        queue_.push_back(key);
+    }
+    stats_.queued = uint32_t(queue_.size());
+    streaming_ = stats_.frame_misses > 0 || !queue_.empty() || !ready_.empty() || busy_ != ~0ull;
+    if (!queue_.empty()) wake_.notify_one();
+}
+
+void HeatmapRenderer::create_cache(const RenderContext& ctx)
+{
+    // 至少装得下当前窗口一帧要用的瓦片，否则可见瓦片互相淘汰、永远收敛不了
+    const uint32_t needed = tiles_needed(ctx.frameExtent.width, ctx.frameExtent.height);
+    cache_.layers = std::min(std::max(cache_tiles_, needed), ctx.caps.maxImageArrayLayers);
+    VkImageCreateInfo ici = vkinit::image_create_info(VK_FORMAT_R16_SFLOAT, VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+                                                      VkExtent3D{TileSize, TileSize, 1});
+    ici.arrayLayers = cache_.layers;
+    VmaAllocationCreateInfo ai{};
+    ai.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+    VK_CHECK(gpu_memory::create_image(ctx.allocator, ici, ai, "Heatmap/tile cache", &cache_.image, &cache_.allocation));
+    VkImageViewCreateInfo vci = vkinit::imageview_create_info(VK_FORMAT_R16_SFLOAT, cache_.image, VK_IMAGE_ASPECT_COLOR_BIT);
+    vci.viewType = VK_IMAGE_VIEW_TYPE_2D_ARRAY;
+    vci.subresourceRange.layerCount = cache_.layers;
+    VK_CHECK(vkCreateImageView(ctx.device, &vci, nullptr, &cache_.view));
+    // 拷贝和采样都在 GENERAL 下进行，省去每帧的布局来回
+    cache_.index = ctx.bindless->add_sampled_image(ctx.device, cache_.view, VK_IMAGE_LAYOUT_GENERAL);
+    cache_.initialized = false;
+
+    slots_.assign(cache_.layers, Slot{});
+    lru_.clear();
+    for (uint32_t i = 0; i < cache_.layers; ++i) slots_[i].lru = lru_.insert(lru_.end(), i);
+    resident_.clear();
+    stats_ = {};
+}
+
+void HeatmapRenderer::destroy_cache(const RenderContext& ctx)
+{
+    if (cache_.index != ~0u) ctx.bindless->release(BindlessHeap::SampledImage, cache_.index);
+    if (cache_.view) vkDestroyImageView(ctx.device, cache_.view, nullptr);
+    if (cache_.image) gpu_memory::destroy_image(ctx.allocator, cache_.image, cache_.allocation);
+    cache_ = {};
+    slots_.clear();
+    lru_.clear();
+    resident_.clear();
+}
+
+void HeatmapRenderer::create_pipelines(const RenderContext& ctx)
+{
+    // 页表走设备地址，瓦片缓存走 sampled image 句柄（纹理数组视图），offscreen 走 storage image 句柄
+    layout_ = ctx.bindless->pipelineLayout;
+    shade_ = vkutil::create_compute_pipeline(ctx.device, layout_,
+        (std::string("shaders/heatmap") + offscreen_shader_variant(ctx.offscreenFormat) + ".comp.spv").c_str());
+}
+
+// ==== 后台生成 ====
+
+void HeatmapRenderer::start_worker()
+{
+    stop_ = false;
+    worker_ = std::thread([this]() { worker_loop(); });
+}
+
+void HeatmapRenderer::stop_worker()
+{
+    if (!worker_.joinable()) return;
+    {
+        std::lock_guard lock(mutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    worker_.join();
+    queue_.clear();
+    ready_.clear();
+    busy_ = ~0ull;
+}
+
+void HeatmapRenderer::worker_loop()
+{
+    std::unique_lock lock(mutex_);
+    while (true)
+    {
+        wake_.wait(lock, [this]() { return stop_ || !queue_.empty(); });
+        if (stop_) return;
+        const TileKey key = queue_.back();
+        queue_.pop_back();
+        busy_ = key;
+        std::vector<uint16_t> texels;
+        if (!spare_.empty())
+        {
+            texels = std::move(spare_.back());
+            spare_.pop_back();
+        }
+        lock.unlock();
+
+        texels.resize(size_t(TileSize) * TileSize);
+        const auto t0 = std::chrono::steady_clock::now();
+        generate_tile(key, texels.data());
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+
+        lock.lock();
+        busy_ = ~0ull;
+        generate_ms_ = ms;
+        ready_.push_back({key, std::move(texels)});
+    }
+}
+
+// ==== 合成矩阵 ====
+
+float HeatmapRenderer::cell_value(uint32_t row, uint32_t col) const
+{
+    // 对称、对角为 1 的“相关矩阵”：两个平滑的低秩因子 + 成簇的块 + 小噪声
+    const uint32_t i = std::min(row, col), j = std::max(row, col);
+    if (i == j) return 1.0f;
+    const float k1 = 6.2831853f / (float(size_) * 0.37f), k2 = 6.2831853f / (float(size_) * 0.11f);
+    const float fi = float(i), fj = float(j);
+    float v = 0.45f * std::sin(fi * k1 + 1.3f) * std::sin(fj * k1 + 1.3f) + 0.25f * std::cos(fi * k2) * std::cos(fj * k2);
+    const uint32_t group = std::max(size_ / 24, 1u);
+    if (i / group == j / group) v += 0.25f + 0.4f * example_utils::hash01(i / group ^ seed_);
+    v += 0.16f * (example_utils::hash01(i * 0x9E3779B1u ^ j * 0x85EBCA77u ^ seed_) - 0.5f);
+    return std::clamp(v, -1.0f, 1.0f);
+}
+
+void HeatmapRenderer::generate_tile(TileKey key, uint16_t* out) const
+{
+    // level L 的纹素覆盖 2^L × 2^L 个单元，这里只点采样其中 2×2 个分层位置再求平均，并不是
+    // L-1 级四个子纹素的平均，所以 L ≥ 2 时是欠采样、会混叠。真实数据源应离线存好逐级平均的
+    // 金字塔；合成数据逐单元求平均在高层级太慢（根瓦片要遍历整个矩阵），由子瓦片递归构建
+    // 又要先生成全部下层瓦片
+    const uint32_t level = key_level(key);
+    const uint64_t span = uint64_t(1) << level;
+    const uint64_t samples = std::min<uint64_t>(span, 2);
+    for (uint32_t y = 0; y < TileSize; ++y)
+    {
+        const uint64_t row0 = (uint64_t(key_ty(key)) * TileSize + y) * span;
+        for (uint32_t x = 0; x < TileSize; ++x)
+        {
+            const uint64_t col0 = (uint64_t(key_tx(key)) * TileSize + x) * span;
+            float value = 0.0f;
+            if (row0 < size_ && col0 < size_)
+            {
+                float sum = 0.0f;
+                uint32_t n = 0;
+                for (uint64_t sy = 0; sy < samples; ++sy)
+                {
+                    const uint64_t row = row0 + (2 * sy + 1) * span / (2 * samples);
+                    for (uint64_t sx = 0; sx < samples; ++sx)
+                    {
+                        const uint64_t col = col0 + (2 * sx + 1) * span / (2 * samples);
+                        if (row >= size_ || col >= size_) continue;
+                        sum += cell_value(uint32_t(row), uint32_t(col));
+                        ++n;
+                    }
+                }
+                value = n > 0 ? sum / float(n) : cell_value(uint32_t(row0), uint32_t(col0));
+            }
+            out[y * TileSize + x] = uint16_t(glm::packHalf1x16(value));
+        }
+    }
+}
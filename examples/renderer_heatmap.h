@@ -0,0 +1,147 @@
+#ifndef RENDERER_HEATMAP_H
+#define RENDERER_HEATMAP_H
+
+#include <vulkan/vulkan.h>
+#include <condition_variable>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "src/renderer_iface.h"
+#include "src/ext/vk_bindless.h"
+#include "vk_mem_alloc.h"
+
+// 大矩阵热力图（如 16k×16k 相关矩阵）：矩阵切成 256×256 的瓦片，外加逐级减半的瓦片金字塔
+// （合成数据的高层级纹素是 2×2 个点采样的平均，不是真正的盒式下采样，缩小时会混叠）。GPU 上只有一张 R16_SFLOAT 纹理数组作为瓦片缓存（每层一块瓦片，LRU 淘汰），
+// 每帧按当前缩放选一级、只请求视口内（外加一圈预取）的瓦片；后台线程生成瓦片数据，
+// record() 每帧最多把 upload_budget 块经帧 scratch 拷进缓存，整个过程不等 GPU 也不等生成。
+// 缺的瓦片由已驻留的上级瓦片放大顶替（根瓦片常驻），所以平移 / 缩放时画面不会出现空洞。
+// 着色在 compute 里查页表 → 取纹理数组 → 色表，直接写进 offscreen。
+class HeatmapRenderer final : public IRenderer
+{
+public:
+    HeatmapRenderer();
+    ~HeatmapRenderer() override;
+
+    void initialize(const RenderContext& ctx) override;
+    void destroy(const RenderContext& ctx) override;
+    void record(VkCommandBuffer cmd, uint32_t width, uint32_t height, const RenderContext& ctx) override;
+    // 窗口变大后缓存装不下可见 + 预取的瓦片时重建缓存（此时 GPU 已空闲）
+    void on_swapchain_resized(const RenderContext& ctx) override;
+    void on_imgui() override;
+    // 还有瓦片在生成 / 待上传时继续重画，直到视口内全部是目标级别的瓦片
+    bool needs_redraw() override { const bool d = dirty_ || streaming_; dirty_ = false; return d; }
+    VkFormat preferred_offscreen_format() const override { return VK_FORMAT_R8G8B8A8_UNORM; }
+    // size=矩阵边长 / cache=缓存瓦片数（至少按窗口所需取）/ upload_budget=每帧上传瓦片数，须在 initialize 之前设置
+    bool set_option(std::string_view key, std::string_view value) override;
+
+    static constexpr uint32_t TileSize = 256;
+    static constexpr uint32_t DefaultCacheTiles = 256; // maxImageArrayLayers 的保证下限
+    // 一帧里必须同时驻留的瓦片上限：可见网格 + 预取一圈 + 顶替用的上一级 + 根瓦片。
+    // 选级别保证一块瓦片至少占 TileSize 像素，可见网格每边至多 ceil(边长 / TileSize) + 1 块
+    static uint32_t tiles_needed(uint32_t width, uint32_t height)
+    {
+        const uint32_t gw = (width + TileSize - 1) / TileSize + 1, gh = (height + TileSize - 1) / TileSize + 1;
+        return gw * gh + 2 * (gw + gh) + 4 + (gw / 2 + 2) * (gh / 2 + 2) + 1;
+    }
+
+private:
+    // 瓦片键：level << 48 | ty << 24 | tx
+    using TileKey = uint64_t;
+    static TileKey make_key(uint32_t level, uint32_t tx, uint32_t ty) { return (uint64_t(level) << 48) | (uint64_t(ty) << 24) | tx; }
+    static uint32_t key_level(TileKey k) { return uint32_t(k >> 48); }
+    static uint32_t key_tx(TileKey k) { return uint32_t(k & 0xFFFFFF); }
+    static uint32_t key_ty(TileKey k) { return uint32_t((k >> 24) & 0xFFFFFF); }
+
+    // —— 矩阵（合成数据源）——
+    uint32_t size_ = 16384;
+    uint32_t levels_ = 1;     // level 0 为原始分辨率，levels_ - 1 为单块根瓦片
+    uint32_t seed_ = 0xC0FFEEu;
+    uint32_t tiles_per_side(uint32_t level) const;
+    // 生成一块瓦片（TileSize² 个 half，矩阵外的纹素填 0，着色时不会取到）；在后台线程调用
+    void generate_tile(TileKey key, uint16_t* out) const;
+    float cell_value(uint32_t row, uint32_t col) const;
+
+    // —— 瓦片缓存（纹理数组，bindless sampled image）——
+    struct Cache {
+        VkImage image = VK_NULL_HANDLE;
+        VmaAllocation allocation{};
+        VkImageView view = VK_NULL_HANDLE;
+        uint32_t index = ~0u;
+        uint32_t layers = 0;
+        bool initialized = false; // 首帧从 UNDEFINED 转到 GENERAL
+    } cache_;
+    uint32_t cache_tiles_ = DefaultCacheTiles; // 请求的层数；实际取 max(请求, tiles_needed)，不超过设备上限
+    struct Slot {
+        TileKey key = ~0ull;
+        uint64_t last_used = 0;   // 最近一次被页表引用的帧号
+        bool pinned = false;      // 根瓦片不淘汰
+        std::list<uint32_t>::iterator lru;
+    };
+    std::vector<Slot> slots_;
+    std::list<uint32_t> lru_;     // 最久未用的在前；空槽也按此顺序取
+    std::unordered_map<TileKey, uint32_t> resident_;
+    uint64_t frame_ = 0;
+    uint32_t frame_touched_ = 0;  // 本帧已引用（因而不可淘汰）的槽数
+    // 找一块可写的槽：空槽或最久未用且本帧未引用的；没有时返回 ~0u
+    uint32_t acquire_slot();
+    void touch(uint32_t slot);
+
+    // —— 后台生成线程 ——
+    struct ReadyTile { TileKey key; std::vector<uint16_t> texels; };
+    std::thread worker_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::vector<TileKey> queue_;     // 每帧整体替换为当前需要的瓦片，最优先的在末尾（worker 从尾部取）
+    std::vector<ReadyTile> ready_;   // 已生成待上传
+    std::vector<std::vector<uint16_t>> spare_; // 上传完的瓦片内存还给 worker 复用
+    TileKey busy_ = ~0ull;           // 正在生成的瓦片
+    bool stop_ = false;
+    double generate_ms_ = 0.0;       // 最近一块瓦片的生成耗时（worker 写，面板读）
+    void worker_loop();
+    void start_worker();
+    void stop_worker();
+
+    // —— 统计 ——
+    struct Stats {
+        uint64_t hits = 0, misses = 0;        // 累计：视口内需要的目标级瓦片是否已驻留
+        uint32_t frame_hits = 0, frame_misses = 0;
+        uint32_t uploads = 0;                 // 最近一帧上传的瓦片数
+        uint64_t total_uploads = 0, evictions = 0;
+        uint32_t queued = 0;
+        uint32_t level = 0;
+        uint32_t visible = 0;
+    } stats_;
+
+    // —— 管线 ——
+    VkPipelineLayout layout_ = VK_NULL_HANDLE; // bindless 堆的共享 layout，不归本类销毁
+    VkPipeline shade_ = VK_NULL_HANDLE;
+
+    // —— 参数 ——
+    uint32_t upload_budget_ = 8;
+    bool dirty_ = true;
+    bool streaming_ = false;       // 上一帧仍有缺失瓦片
+    int colormap_ = 0;             // 0 = 发散（相关系数），1 = viridis
+    float range_[2] = {-1.0f, 1.0f};
+    bool show_tile_grid_ = false;
+    // 视图：矩阵坐标（列, 行）center 处于屏幕中心，每像素 cells_per_pixel_ 个单元
+    double center_[2] = {0.0, 0.0};
+    double cells_per_pixel_ = 0.0; // 0 = 首帧按窗口适配整个矩阵
+
+    void fit_view(uint32_t width, uint32_t height);
+    // 把就绪瓦片（至多 upload_budget_ 块）经帧 scratch 拷进缓存
+    void upload_ready(VkCommandBuffer cmd, const RenderContext& ctx);
+    // 按视图写页表（每块可见瓦片一个 uint：缓存层 | 顶替的上级级差 << 16，缺失为 ~0u）并重排请求队列
+    void build_page_table(uint32_t level, int32_t tx0, int32_t ty0, uint32_t gw, uint32_t gh);
+    std::vector<uint32_t> page_table_;
+    std::vector<TileKey> wanted_;
+    void create_cache(const RenderContext& ctx);
+    void destroy_cache(const RenderContext& ctx);
+    void create_pipelines(const RenderContext& ctx);
+};
+
+#endif //RENDERER_HEATMAP_H
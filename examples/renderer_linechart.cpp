@@ -0,0 +1,931 @@
+#include "renderer_linechart.h"
+#include "line_downsample.h"
+#include "example_utils.h"
+#include "src/ext/vk_initializers.h"
+#include "src/ext/vk_pipelines.h"
+#include "src/ext/vk_bindless.h"
+#include "src/ext/vk_scratch.h"
+#include "src/ext/vk_deletion.h"
+#include "src/ext/vk_immediate.h"
+#include "src/gpu_memory.h"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include "imgui.h"
+
+#ifndef VK_CHECK
+#define VK_CHECK(x) do { VkResult err__ = (x); if (err__ != VK_SUCCESS) { throw std::runtime_error(std::string("Vulkan error ") + std::to_string(err__)); } } while(0)
+#endif
+
+namespace {
+
+// 把 count 个样本（samples[series * count + i]）写进按环布局的内存，从累计位置 head 开始
+void write_ring(float* base, uint32_t series, uint32_t capacity, uint64_t head, const float* samples, uint32_t count)
+{
+    const uint32_t slot = static_cast<uint32_t>(head & (capacity - 1));
+    const uint32_t first = std::min(count, capacity - slot);
+    for (uint32_t s = 0; s < series; ++s)
+    {
+        float* dst = base + size_t(s) * capacity;
+        const float* src = samples + size_t(s) * count;
+        std::memcpy(dst + slot, src, first * sizeof(float));
+        if (count > first) std::memcpy(dst, src + first, (count - first) * sizeof(float));
+    }
+}
+
+// 与 linechart.comp / linechart_raster.* 的 push 块一致
+struct ShadePush {
+    VkDeviceAddress env;
+    uint32_t W, H;
+    uint32_t image_index;
+    uint32_t series_count;
+    uint32_t plot_x;
+    uint32_t plot_w;
+    float plot_y;
+    float plot_h;
+    float half_width;
+};
+
+} // namespace
+
+LineChartRenderer::LineChartRenderer() = default;
+
+// ==== IRenderer 接口 ====
+
+bool LineChartRenderer::set_option(std::string_view key, std::string_view value)
+{
+    uint32_t n = 0;
+    if (key == "series" && example_utils::parse_number(value, n) && n > 0) { series_ = std::min(n, 256u); return true; }
+    // 先钳位再取 2 的幂：bit_ceil 对 > 2^31 的值未定义
+    if (key == "points" && example_utils::parse_number(value, n) && n > 0) { capacity_ = std::bit_ceil(std::clamp(n, 1024u, MaxCapacity)); return true; }
+    if (key == "rate" && example_utils::parse_number(value, n)) { rate_ = n; return true; }
+    if (key == "streaming" && example_utils::parse_number(value, n)) { streaming_ = n != 0; return true; }
+    if (key == "pyramid" && example_utils::parse_number(value, n)) { use_pyramid_ = n != 0; return true; }
+    if (key == "zoom" && example_utils::parse_number(value, n)) { view_count_ = n; return true; }
+    if (key == "cpu_bench" && example_utils::parse_number(value, n)) { cpu_bench_ = n != 0; return true; }
+    if (key == "reduce")
+    {
+        if (value == "envelope") { reduce_mode_ = Reduce::Envelope; return true; }
+        if (value == "m4") { reduce_mode_ = Reduce::M4; return true; }
+        if (value == "lttb") { reduce_mode_ = Reduce::LTTB; return true; }
+    }
+    if (key == "path")
+    {
+        if (value == "compute") { path_ = Path::Compute; return true; }
+        if (value == "raster") { path_ = Path::Raster; return true; }
+    }
+    return false;
+}
+
+void LineChartRenderer::initialize(const RenderContext& ctx)
+{
+    frames_in_flight_ = std::max(ctx.framesInFlight, 1u);
+    create_pipelines(ctx);
+    create_ring(ctx);
+    create_pyramid(ctx);
+    fill_history(ctx);
+    dirty_ = true;
+    if (cpu_bench_)
+    {
+        // 只跑一次（--set cpu_bench=1），结果同时打印到 stdout 供无头基准记录
+        cpu_bench_ = false;
+        run_cpu_benchmark();
+    }
+}
+
+void LineChartRenderer::destroy(const RenderContext& ctx)
+{
+    if (reduce_) { vkDestroyPipeline(ctx.device, reduce_, nullptr); reduce_ = VK_NULL_HANDLE; }
+    if (shade_) { vkDestroyPipeline(ctx.device, shade_, nullptr); shade_ = VK_NULL_HANDLE; }
+    if (raster_) { vkDestroyPipeline(ctx.device, raster_, nullptr); raster_ = VK_NULL_HANDLE; }
+    if (pyramid_build_) { vkDestroyPipeline(ctx.device, pyramid_build_, nullptr); pyramid_build_ = VK_NULL_HANDLE; }
+    if (lod_) { vkDestroyPipeline(ctx.device, lod_, nullptr); lod_ = VK_NULL_HANDLE; }
+    if (m4_) { vkDestroyPipeline(ctx.device, m4_, nullptr); m4_ = VK_NULL_HANDLE; }
+    if (lttb_) { vkDestroyPipeline(ctx.device, lttb_, nullptr); lttb_ = VK_NULL_HANDLE; }
+    if (points_) { vkDestroyPipeline(ctx.device, points_, nullptr); points_ = VK_NULL_HANDLE; }
+    layout_ = VK_NULL_HANDLE;
+    if (ring_.buffer) gpu_memory::destroy_buffer(ctx.allocator, ring_.buffer, ring_.allocation);
+    ring_ = {};
+    if (pyramid_.buffer) gpu_memory::destroy_buffer(ctx.allocator, pyramid_.buffer, pyramid_.allocation);
+    pyramid_ = {};
+    pyramid_head_ = 0;
+    pending_.clear();
+    pending_data_.clear();
+}
+
+void LineChartRenderer::on_swapchain_resized(const RenderContext& ctx)
+{
+    // 包络缓冲每帧按当前宽度从 scratch 分配，无需处理
+    (void)ctx;
+}
+
+void LineChartRenderer::on_imgui()
+{
+    ImGui::Begin("Line Chart");
+    ImGui::Text("%u series x %u points (%.1f MiB ring, %s)", series_, capacity_,
+                double(size_t(series_) * capacity_ * sizeof(float)) / 1048576.0,
+                ring_.mapped ? "written in place" : "copied via frame scratch");
+    ImGui::Text("Visible: %u points per series, head %llu", visible_count(), static_cast<unsigned long long>(head_));
+    if (ImGui::Checkbox("Streaming", &streaming_)) dirty_ = true;
+    int rate = int(rate_);
+    if (ImGui::SliderInt("Samples per frame", &rate, 1, int(slack() / 4), "%d", ImGuiSliderFlags_Logarithmic)) rate_ = uint32_t(rate);
+    int path = int(path_);
+    ImGui::RadioButton("Compute", &path, int(Path::Compute));
+    ImGui::SameLine();
+    ImGui::RadioButton("Raster", &path, int(Path::Raster));
+    if (path != int(path_)) { path_ = Path(path); dirty_ = true; }
+    if (ImGui::SliderFloat("Line width", &line_width_, 1.0f, 6.0f, "%.1f px")) dirty_ = true;
+
+    ImGui::SeparatorText("Level of detail");
+    ImGui::Text("Pyramid: %u levels x8, %.1f MiB", pyramid_.levels,
+                double(size_t(series_) * pyramid_.entriesPerSeries * PyramidEntryBytes) / 1048576.0);
+    int mode = int(reduce_mode_);
+    ImGui::RadioButton("Envelope", &mode, int(Reduce::Envelope));
+    ImGui::SameLine();
+    ImGui::RadioButton("M4", &mode, int(Reduce::M4));
+    ImGui::SameLine();
+    ImGui::RadioButton("LTTB", &mode, int(Reduce::LTTB));
+    if (mode != int(reduce_mode_)) { reduce_mode_ = Reduce(mode); dirty_ = true; }
+    ImGui::BeginDisabled(reduce_mode_ != Reduce::Envelope);
+    if (ImGui::Checkbox("Reduce from pyramid", &use_pyramid_)) dirty_ = true;
+    ImGui::EndDisabled();
+    const View v = view(head_);
+    const double perColumn = double(v.count) / double(std::max(last_plot_w_, 1u));
+    uint32_t level = 0;
+    while (level < pyramid_.levels && double(1u << (3 * (level + 1))) <= perColumn) ++level;
+    ImGui::Text("%u samples in view, %.1f per column -> level %u", v.count, perColumn, use_pyramid_ ? level : 0u);
+
+    // 鼠标：滚轮以右端为锚缩放，左键拖动平移（不在 ImGui 窗口上时）
+    const uint32_t visible = visible_count();
+    const ImGuiIO& io = ImGui::GetIO();
+    if (!io.WantCaptureMouse && visible > 0)
+    {
+        if (io.MouseWheel != 0.0f)
+        {
+            const double next = double(v.count) * std::pow(0.8, double(io.MouseWheel));
+            set_view(uint32_t(std::clamp(next, 16.0, double(visible))), follow_ ? 0 : head_ - view_end_);
+        }
+        if (ImGui::IsMouseDragging(ImGuiMouseButton_Left) && io.MouseDelta.x != 0.0f)
+        {
+            const double shift = double(io.MouseDelta.x) * perColumn;
+            const uint64_t offset = follow_ ? 0 : head_ - view_end_;
+            set_view(v.count, uint64_t(std::max(0.0, double(offset) + shift)));
+        }
+    }
+    int zoom = int(v.count);
+    if (ImGui::SliderInt("Samples in view", &zoom, 16, int(std::max(visible, 17u)), "%d", ImGuiSliderFlags_Logarithmic))
+        set_view(uint32_t(zoom), follow_ ? 0 : head_ - view_end_);
+    if (ImGui::Checkbox("Follow newest", &follow_))
+    {
+        view_end_ = head_;
+        dirty_ = true;
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Show all")) { view_count_ = 0; follow_newest(); }
+
+    if (ImGui::Button("Validate envelope")) validate_requested_ = true;
+    ImGui::SameLine();
+    ImGui::TextUnformatted(validation_.empty() ? "GPU envelope vs CPU brute force" : validation_.c_str());
+    if (ImGui::Button("Benchmark CPU reference")) run_cpu_benchmark();
+    if (!cpu_bench_result_.empty()) ImGui::TextUnformatted(cpu_bench_result_.c_str());
+    ImGui::TextDisabled("Series / points are set with --set series=N --set points=N");
+    ImGui::End();
+}
+
+void LineChartRenderer::record(VkCommandBuffer cmd, uint32_t width, uint32_t height, const RenderContext& ctx)
+{
+    frame_appended_ = 0;
+    if (validate_requested_)
+    {
+        validate_requested_ = false;
+        validate(ctx, width, height);
+    }
+
+    // 1) 模拟遥测：新样本写进环（或待拷贝队列），head 前移即完成滚动
+    if (streaming_) simulate_frame();
+    upload_pending(cmd, ctx);
+    update_pyramid(cmd, ctx);
+
+    const uint32_t plotX = uint32_t(margin_px_);
+    const uint32_t plotW = width > 2 * plotX ? width - 2 * plotX : 1;
+    const float plotY = margin_px_;
+    const float plotH = std::max(1.0f, float(height) - 2.0f * margin_px_);
+
+    last_plot_w_ = plotW;
+
+    // 2) 按列归约 min/max 包络（plotW × series），结果放在帧 scratch
+    ScratchAllocation env = ctx.frameScratch->allocate(VkDeviceSize(series_) * plotW * sizeof(float) * 2, 8);
+    VkDeviceAddress points = 0;
+    if (reduce_mode_ != Reduce::Envelope)
+        points = ctx.frameScratch->allocate(VkDeviceSize(series_) * points_stride(plotW) * sizeof(line_downsample::Point), 8).address;
+    dispatch_reduce(cmd, ctx, view(head_), env.address, points, plotW, plotY, plotH);
+
+    VkMemoryBarrier2 mb{VK_STRUCTURE_TYPE_MEMORY_BARRIER_2};
+    mb.srcStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+    mb.srcAccessMask = VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+    mb.dstStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT;
+    mb.dstAccessMask = VK_ACCESS_2_SHADER_STORAGE_READ_BIT;
+    // offscreen：等上一帧 composite 的采样读完；内容整帧重画
+    VkImageMemoryBarrier2 ib{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2};
+    ib.srcStageMask = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_2_TRANSFER_BIT;
+    ib.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    ib.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+    ib.image = ctx.offscreenImage;
+    ib.subresourceRange = vkinit::image_subresource_range(VK_IMAGE_ASPECT_COLOR_BIT);
+    if (path_ == Path::Compute)
+    {
+        ib.dstStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+        ib.dstAccessMask = VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+    }
+    else
+    {
+        ib.dstStageMask = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
+        ib.dstAccessMask = VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT;
+    }
+    VkDependencyInfo dep{VK_STRUCTURE_TYPE_DEPENDENCY_INFO};
+    dep.memoryBarrierCount = 1;
+    dep.pMemoryBarriers = &mb;
+    dep.imageMemoryBarrierCount = 1;
+    dep.pImageMemoryBarriers = &ib;
+    vkCmdPipelineBarrier2(cmd, &dep);
+
+    ShadePush sp{env.address, width, height, ctx.offscreenStorageIndex, series_, plotX, plotW, plotY, plotH, line_width_ * 0.5f};
+
+    // 3) 包络 → 抗锯齿折线
+    if (path_ == Path::Compute)
+    {
+        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, shade_);
+        ctx.bindless->push(cmd, &sp, sizeof(sp));
+        vkCmdDispatch(cmd, (width + 15) / 16, (height + 15) / 16, 1);
+        return; // offscreen 保持 GENERAL，由引擎 composite pass 采样
+    }
+
+    VkRenderingAttachmentInfo color{VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO};
+    color.imageView = ctx.offscreenImageView;
+    color.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+    color.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    color.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    color.clearValue.color = {{0.08f, 0.09f, 0.10f, 1.0f}}; // chart_background()
+
+    VkRenderingInfo ri{VK_STRUCTURE_TYPE_RENDERING_INFO};
+    ri.renderArea = {{0, 0}, {width, height}};
+    ri.layerCount = 1;
+    ri.colorAttachmentCount = 1;
+    ri.pColorAttachments = &color;
+    vkCmdBeginRendering(cmd, &ri);
+
+    // 轴线与 compute 路径相同：绘图区下方一行
+    const int32_t axisY = int32_t(plotY + plotH) + 1;
+    if (axisY >= 0 && axisY < int32_t(height))
+    {
+        VkClearAttachment axis{VK_IMAGE_ASPECT_COLOR_BIT, 0, {}};
+        axis.clearValue.color = {{0.75f, 0.75f, 0.78f, 1.0f}}; // chart_axis()
+        VkClearRect rect{{{int32_t(plotX), axisY}, {std::min(plotW, width - plotX), 1}}, 0, 1};
+        vkCmdClearAttachments(cmd, 1, &axis, 1, &rect);
+    }
+
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, raster_);
+    VkViewport vp{0.0f, 0.0f, float(width), float(height), 0.0f, 1.0f};
+    vkCmdSetViewport(cmd, 0, 1, &vp);
+    VkRect2D sc{{0, 0}, {width, height}};
+    vkCmdSetScissor(cmd, 0, 1, &sc);
+    ctx.bindless->push(cmd, &sp, sizeof(sp));
+    // 实例按序列排列，混合顺序与 compute 路径的循环一致
+    vkCmdDraw(cmd, 6, series_ * plotW, 0, 0);
+    vkCmdEndRendering(cmd);
+}
+
+void LineChartRenderer::dispatch_reduce(VkCommandBuffer cmd, const RenderContext& ctx, const View& v, VkDeviceAddress env,
+                                        VkDeviceAddress points, uint32_t plotW, float plotY, float plotH)
+{
+    if (reduce_mode_ != Reduce::Envelope)
+    {
+        // 比例由 CPU 算好传入：GPU 的除法允许几个 ulp 误差，会让列边界与参考实现错开
+        const float scale = v.count >= 2 ? float(v.count - 1) / float(plotW) : 0.0f;
+        const uint32_t stride = points_stride(plotW);
+        uint32_t pointCount = stride;
+        if (reduce_mode_ == Reduce::M4)
+        {
+            struct M4Push {
+                VkDeviceAddress ring;
+                VkDeviceAddress pts;
+                uint32_t capacity, start, count, columns;
+                float scale;
+            } mp{ring_.address, points, capacity_, v.start, v.count, plotW, scale};
+            vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m4_);
+            ctx.bindless->push(cmd, &mp, sizeof(mp));
+            vkCmdDispatch(cmd, plotW, series_, 1);
+        }
+        else
+        {
+            pointCount = plotW * 2;
+            struct LttbPush {
+                VkDeviceAddress ring;
+                VkDeviceAddress pts;
+                uint32_t capacity, start, count, threshold, stride;
+                float every;
+            } lp{ring_.address, points, capacity_, v.start, v.count, pointCount, stride,
+                 pointCount > 2 && v.count > 2 ? float(v.count - 2) / float(pointCount - 2) : 0.0f};
+            vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, lttb_);
+            ctx.bindless->push(cmd, &lp, sizeof(lp));
+            vkCmdDispatch(cmd, 1, series_, 1);
+        }
+
+        VkMemoryBarrier2 mb{VK_STRUCTURE_TYPE_MEMORY_BARRIER_2};
+        mb.srcStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+        mb.srcAccessMask = VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+        mb.dstStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+        mb.dstAccessMask = VK_ACCESS_2_SHADER_STORAGE_READ_BIT;
+        VkDependencyInfo dep{VK_STRUCTURE_TYPE_DEPENDENCY_INFO};
+        dep.memoryBarrierCount = 1;
+        dep.pMemoryBarriers = &mb;
+        vkCmdPipelineBarrier2(cmd, &dep);
+
+        // 点 → 列包络，之后的着色与包络模式相同
+        struct PointsPush {
+            VkDeviceAddress pts;
+            VkDeviceAddress env;
+            uint32_t point_count, stride, count, plot_w;
+            float plot_y, plot_h, v_min, v_max, scale;
+        } pp{points, env, pointCount, stride, v.count, plotW, plotY, plotH, v_min_, v_max_, scale};
+        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, points_);
+        ctx.bindless->push(cmd, &pp, sizeof(pp));
+        vkCmdDispatch(cmd, (plotW + 63) / 64, series_, 1);
+        return;
+    }
+
+    if (use_pyramid_ && pyramid_.levels > 0)
+    {
+        // 金字塔：每线程一列，O(层数) 次读取
+        struct LodPush {
+            VkDeviceAddress ring;
+            VkDeviceAddress env;
+            VkDeviceAddress pyr;
+            uint32_t capacity, start, count, plot_w;
+            float plot_y, plot_h, v_min, v_max;
+            uint32_t levels;
+        } lp{ring_.address, env, pyramid_.address, capacity_, v.start, v.count, plotW, plotY, plotH, v_min_, v_max_, pyramid_.levels};
+        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, lod_);
+        ctx.bindless->push(cmd, &lp, sizeof(lp));
+        vkCmdDispatch(cmd, (plotW + 63) / 64, series_, 1);
+        return;
+    }
+
+    // 逐样本：每个 workgroup 一列，代价随视窗内点数线性增长
+    struct ReducePush {
+        VkDeviceAddress ring;
+        VkDeviceAddress env;
+        uint32_t capacity, start, count, plot_w;
+        float plot_y, plot_h, v_min, v_max;
+    } rp{ring_.address, env, capacity_, v.start, v.count, plotW, plotY, plotH, v_min_, v_max_};
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, reduce_);
+    ctx.bindless->push(cmd, &rp, sizeof(rp));
+    vkCmdDispatch(cmd, plotW, series_, 1);
+}
+
+RendererSweep LineChartRenderer::make_timing_sweep()
+{
+    // 10M-100M 点的视窗下比较四种归约；视窗受环的可见窗口限制
+    // （--set series=1 --set points=134217728 才能覆盖 100M）。新数据停住，每步都是同一帧内容
+    static constexpr uint32_t Counts[] = {10'000'000, 30'000'000, 100'000'000};
+    struct Mode { const char* name; Reduce reduce; bool pyramid; };
+    static constexpr Mode Modes[] = {
+        {"brute force", Reduce::Envelope, false},
+        {"pyramid", Reduce::Envelope, true},
+        {"M4", Reduce::M4, false},
+        {"LTTB", Reduce::LTTB, false},
+    };
+    RendererSweep sweep;
+    const uint32_t visible = visible_count();
+    for (uint32_t n : Counts)
+    {
+        const uint32_t count = std::min(n, visible);
+        for (const Mode& m : Modes)
+        {
+            char label[64];
+            std::snprintf(label, sizeof(label), "%.1fM points, %s", count / 1e6, m.name);
+            sweep.steps.push_back({label, [this, count, m]() {
+                streaming_ = false;
+                reduce_mode_ = m.reduce;
+                use_pyramid_ = m.pyramid;
+                set_view(count, 0);
+            }});
+        }
+        if (count < n) break; // 更大的视窗和这一步一样
+    }
+    sweep.report = [this](const std::vector<double>& ms) {
+        std::string text = "sweep (GPU ms):";
+        for (size_t i = 0; i < ms.size(); ++i)
+        {
+            char part[32];
+            std::snprintf(part, sizeof(part), "%s%.3f", i % std::size(Modes) == 0 ? "\n  " : " / ", ms[i]);
+            text += part;
+        }
+        validation_ = text + "\n  (brute force / pyramid / M4 / LTTB)";
+    };
+    sweep.restore = [this, streaming = streaming_, pyramid = use_pyramid_, mode = reduce_mode_, count = view_count_, follow = follow_]() {
+        streaming_ = streaming;
+        use_pyramid_ = pyramid;
+        reduce_mode_ = mode;
+        view_count_ = count;
+        follow_ = follow;
+        dirty_ = true;
+    };
+    return sweep;
+}
+
+void LineChartRenderer::run_cpu_benchmark()
+{
+    // 单条序列、连续内存上的合成数据；与 GPU 同样每列 4 点（M4）/ 2 点（LTTB）
+    static constexpr uint32_t Counts[] = {10'000'000, 30'000'000, 100'000'000};
+    const uint32_t columns = std::max(last_plot_w_, 2u);
+    std::vector<float> data(Counts[std::size(Counts) - 1]);
+    uint32_t noise = 0x9E3779B9u;
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+        noise = noise * 1664525u + 1013904223u;
+        data[i] = std::sin(float(i % 1000000u) * 0.002f) + 0.15f * (float(noise >> 8) * (2.0f / 16777216.0f) - 1.0f);
+    }
+    std::vector<line_downsample::Point> out(size_t(columns) * 4);
+
+    cpu_bench_result_ = "CPU reference, " + std::to_string(columns) + " columns:";
+    for (uint32_t n : Counts)
+    {
+        const line_downsample::Samples samples{data.data(), std::bit_ceil(n), 0, n};
+        const auto t0 = std::chrono::steady_clock::now();
+        line_downsample::m4(samples, columns, out);
+        const auto t1 = std::chrono::steady_clock::now();
+        line_downsample::lttb(samples, columns * 2, out);
+        const auto t2 = std::chrono::steady_clock::now();
+        char line[128];
+        std::snprintf(line, sizeof(line), "\n  %3uM points: M4 %8.2f ms, LTTB %8.2f ms", n / 1000000,
+                      std::chrono::duration<double, std::milli>(t1 - t0).count(),
+                      std::chrono::duration<double, std::milli>(t2 - t1).count());
+        cpu_bench_result_ += line;
+    }
+    std::printf("%s\n", cpu_bench_result_.c_str());
+}
+
+// ==== 数据 ====
+
+uint32_t LineChartRenderer::visible_count() const
+{
+    return static_cast<uint32_t>(std::min<uint64_t>(head_, capacity_ - slack()));
+}
+
+LineChartRenderer::View LineChartRenderer::view(uint64_t head) const
+{
+    const uint64_t visible = std::min<uint64_t>(head, capacity_ - slack());
+    const uint64_t count = view_count_ == 0 ? visible : std::min<uint64_t>(view_count_, visible);
+    // 不跟随时右端停在 view_end_，但不能滑出可见窗口
+    uint64_t end = follow_ ? head : std::clamp<uint64_t>(view_end_, head - visible + count, head);
+    return View{static_cast<uint32_t>((end - count) & (capacity_ - 1)), static_cast<uint32_t>(count)};
+}
+
+void LineChartRenderer::set_view(uint32_t count, uint64_t offsetFromNewest)
+{
+    view_count_ = count;
+    follow_ = offsetFromNewest == 0;
+    view_end_ = head_ - std::min<uint64_t>(offsetFromNewest, head_);
+    dirty_ = true;
+}
+
+void LineChartRenderer::append(std::span<const float> samples, uint32_t count)
+{
+    if (!ring_.buffer || count == 0 || samples.size() < size_t(series_) * count) return;
+    // 本帧预算跨调用累计：每个在飞帧的可见窗口各占一份 slack
+    const uint32_t budget = slack() / frames_in_flight_;
+    count = std::min(count, budget - std::min(budget, frame_appended_));
+    if (count == 0) return;
+    frame_appended_ += count;
+
+    if (ring_.mapped)
+    {
+        // 直接写映射内存；写入的槽位在所有在飞帧的可见窗口之外（见 slack()）
+        write_ring(ring_.mapped, series_, capacity_, head_, samples.data(), count);
+        const uint32_t slot = static_cast<uint32_t>(head_ & (capacity_ - 1));
+        const uint32_t first = std::min(count, capacity_ - slot);
+        for (uint32_t s = 0; s < series_; ++s)
+        {
+            const VkDeviceSize base = VkDeviceSize(s) * capacity_;
+            vmaFlushAllocation(allocator_, ring_.allocation, (base + slot) * sizeof(float), first * sizeof(float));
+            if (count > first) vmaFlushAllocation(allocator_, ring_.allocation, base * sizeof(float), (count - first) * sizeof(float));
+        }
+    }
+    else
+    {
+        pending_.push_back(PendingChunk{head_, count, pending_data_.size()});
+        pending_data_.insert(pending_data_.end(), samples.begin(), samples.begin() + size_t(series_) * count);
+    }
+    head_ += count;
+    dirty_ = true;
+}
+
+void LineChartRenderer::upload_pending(VkCommandBuffer cmd, const RenderContext& ctx)
+{
+    if (pending_.empty()) return;
+
+    ScratchAllocation src = ctx.frameScratch->push(pending_data_.data(), pending_data_.size(), sizeof(float));
+    std::pmr::vector<VkBufferCopy> regions(ctx.frameArena); // 帧内临时数据，走引擎的帧 arena
+    regions.reserve(pending_.size() * series_ * 2);
+    for (const PendingChunk& c : pending_)
+    {
+        const uint32_t slot = static_cast<uint32_t>(c.head & (capacity_ - 1));
+        const uint32_t first = std::min(c.count, capacity_ - slot);
+        for (uint32_t s = 0; s < series_; ++s)
+        {
+            const VkDeviceSize srcOff = src.offset + (c.offset + size_t(s) * c.count) * sizeof(float);
+            const VkDeviceSize dstOff = VkDeviceSize(s) * capacity_ * sizeof(float);
+            regions.push_back(VkBufferCopy{srcOff, dstOff + slot * sizeof(float), first * sizeof(float)});
+            if (c.count > first)
+                regions.push_back(VkBufferCopy{srcOff + first * sizeof(float), dstOff, (c.count - first) * sizeof(float)});
+        }
+    }
+
+    // 上一帧的归约读完才能覆盖（WAR 只需执行依赖），拷贝结果对本帧归约可见
+    VkMemoryBarrier2 before{VK_STRUCTURE_TYPE_MEMORY_BARRIER_2};
+    before.srcStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+    before.dstStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT;
+    before.dstAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+    VkDependencyInfo dep{VK_STRUCTURE_TYPE_DEPENDENCY_INFO};
+    dep.memoryBarrierCount = 1;
+    dep.pMemoryBarriers = &before;
+    vkCmdPipelineBarrier2(cmd, &dep);
+
+    vkCmdCopyBuffer(cmd, src.buffer, ring_.buffer, uint32_t(regions.size()), regions.data());
+
+    VkMemoryBarrier2 after{VK_STRUCTURE_TYPE_MEMORY_BARRIER_2};
+    after.srcStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT;
+    after.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+    after.dstStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+    after.dstAccessMask = VK_ACCESS_2_SHADER_STORAGE_READ_BIT;
+    dep.pMemoryBarriers = &after;
+    vkCmdPipelineBarrier2(cmd, &dep);
+
+    pending_.clear();
+    pending_data_.clear();
+}
+
+void LineChartRenderer::generate(float* out, uint32_t count)
+{
+    // 每条序列占一条水平带：慢正弦 + 快正弦 + 噪声
+    const float band = series_ > 1 ? 1.8f / float(series_ - 1) : 0.0f;
+    const float amp = series_ > 1 ? band * 0.6f : 0.8f;
+    for (uint32_t s = 0; s < series_; ++s)
+    {
+        const float offset = series_ > 1 ? -0.9f + band * float(s) : 0.0f;
+        const float w = 0.002f * (1.0f + 0.37f * float(s));
+        uint32_t& noise = gen_noise_[s];
+        float* dst = out + size_t(s) * count;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            const float t = float((gen_t_ + i) % 1000000u);
+            noise = noise * 1664525u + 1013904223u;
+            const float n = float(noise >> 8) * (2.0f / 16777216.0f) - 1.0f;
+            dst[i] = offset + amp * (0.7f * std::sin(t * w + gen_phase_[s]) + 0.3f * std::sin(t * w * 7.3f) + 0.15f * n);
+        }
+    }
+    gen_t_ += count;
+}
+
+void LineChartRenderer::simulate_frame()
+{
+    const uint32_t count = std::min(rate_, slack() / 4);
+    if (count == 0) return;
+    gen_block_.resize(size_t(series_) * count);
+    generate(gen_block_.data(), count);
+    append(gen_block_, count);
+}
+
+// ==== 资源 ====
+
+void LineChartRenderer::create_ring(const RenderContext& ctx)
+{
+    allocator_ = ctx.allocator;
+    gen_phase_.resize(series_);
+    gen_noise_.resize(series_);
+    for (uint32_t s = 0; s < series_; ++s)
+    {
+        gen_phase_[s] = float(s) * 1.3f;
+        gen_noise_[s] = 0x9E3779B9u * (s + 1);
+    }
+
+    // 优先 device local 且可映射（ReBAR / UMA），否则退回 device local + 拷贝
+    VkBufferCreateInfo bi{VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+    bi.size = VkDeviceSize(series_) * capacity_ * sizeof(float);
+    bi.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+    VmaAllocationCreateInfo ai{};
+    ai.usage = VMA_MEMORY_USAGE_AUTO;
+    ai.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_HOST_ACCESS_ALLOW_TRANSFER_INSTEAD_BIT |
+               VMA_ALLOCATION_CREATE_MAPPED_BIT;
+    VmaAllocationInfo info{};
+    VK_CHECK(gpu_memory::create_buffer(ctx.allocator, bi, ai, "LineChart/ring", &ring_.buffer, &ring_.allocation, &info));
+
+    VkMemoryPropertyFlags props{};
+    vmaGetAllocationMemoryProperties(ctx.allocator, ring_.allocation, &props);
+    ring_.mapped = (props & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) ? static_cast<float*>(info.pMappedData) : nullptr;
+
+    VkBufferDeviceAddressInfo addrInfo{VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO};
+    addrInfo.buffer = ring_.buffer;
+    ring_.address = vkGetBufferDeviceAddress(ctx.device, &addrInfo);
+    head_ = 0;
+    gen_t_ = 0;
+}
+
+void LineChartRenderer::fill_history(const RenderContext& ctx)
+{
+    // 一开始就填满可见窗口，基准测试从第一帧起就是满负载
+    const uint32_t total = capacity_ - slack();
+    const uint32_t chunk = 1u << 14;
+    gen_block_.resize(size_t(series_) * chunk);
+
+    if (ring_.mapped)
+    {
+        for (uint32_t done = 0; done < total; done += chunk)
+        {
+            const uint32_t n = std::min(chunk, total - done);
+            generate(gen_block_.data(), n);
+            write_ring(ring_.mapped, series_, capacity_, head_, gen_block_.data(), n);
+            head_ += n;
+        }
+        vmaFlushAllocation(ctx.allocator, ring_.allocation, 0, VK_WHOLE_SIZE);
+        return;
+    }
+
+    // 不可映射：整环经一次性 staging 上传
+    VkBuffer staging{};
+    VmaAllocation stagingAlloc{};
+    VmaAllocationInfo info{};
+    VkBufferCreateInfo bi{VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+    bi.size = VkDeviceSize(series_) * capacity_ * sizeof(float);
+    bi.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+    VmaAllocationCreateInfo ai{};
+    ai.usage = VMA_MEMORY_USAGE_AUTO;
+    ai.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+    VK_CHECK(gpu_memory::create_buffer(ctx.allocator, bi, ai, "LineChart/history-staging", &staging, &stagingAlloc, &info));
+
+    for (uint32_t done = 0; done < total; done += chunk)
+    {
+        const uint32_t n = std::min(chunk, total - done);
+        generate(gen_block_.data(), n);
+        write_ring(static_cast<float*>(info.pMappedData), series_, capacity_, head_, gen_block_.data(), n);
+        head_ += n;
+    }
+    vmaFlushAllocation(ctx.allocator, stagingAlloc, 0, VK_WHOLE_SIZE);
+
+    ctx.immediate->submit(ctx.device, [&](VkCommandBuffer cmd) {
+        VkBufferCopy region{0, 0, bi.size};
+        vkCmdCopyBuffer(cmd, staging, ring_.buffer, 1, &region);
+    });
+    gpu_memory::destroy_buffer(ctx.allocator, staging, stagingAlloc);
+}
+
+void LineChartRenderer::create_pyramid(const RenderContext& ctx)
+{
+    // 每层 8 叉；最顶层至少留 64 个节点，否则再往上一层几乎不省读取
+    pyramid_.levels = 0;
+    pyramid_.entriesPerSeries = 0;
+    while (pyramid_.levels < 6 && (capacity_ >> (3 * (pyramid_.levels + 1))) >= 64)
+    {
+        ++pyramid_.levels;
+        pyramid_.entriesPerSeries += capacity_ >> (3 * pyramid_.levels);
+    }
+    pyramid_head_ = 0;
+    if (pyramid_.levels == 0) return;
+
+    VkBufferCreateInfo bi{VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+    bi.size = VkDeviceSize(series_) * pyramid_.entriesPerSeries * PyramidEntryBytes;
+    bi.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+    VmaAllocationCreateInfo ai{};
+    ai.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+    VK_CHECK(gpu_memory::create_buffer(ctx.allocator, bi, ai, "LineChart/pyramid", &pyramid_.buffer, &pyramid_.allocation));
+
+    VkBufferDeviceAddressInfo addrInfo{VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO};
+    addrInfo.buffer = pyramid_.buffer;
+    pyramid_.address = vkGetBufferDeviceAddress(ctx.device, &addrInfo);
+}
+
+void LineChartRenderer::update_pyramid(VkCommandBuffer cmd, const RenderContext& ctx)
+{
+    if (pyramid_.levels == 0 || head_ == pyramid_head_) return;
+
+    // 只重算 [h0, h1) 新样本落入的节点；落后太多（首帧 / 重建）时从可见窗口起点开始
+    const uint64_t h1 = head_;
+    const uint64_t h0 = std::max(pyramid_head_, h1 - std::min<uint64_t>(h1, capacity_ - slack()));
+
+    // 上一帧的归约读完才能改写节点；本帧新样本（拷贝或映射写入）在此之前已可见
+    VkMemoryBarrier2 mb{VK_STRUCTURE_TYPE_MEMORY_BARRIER_2};
+    mb.srcStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+    mb.srcAccessMask = VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+    mb.dstStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+    mb.dstAccessMask = VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+    VkDependencyInfo dep{VK_STRUCTURE_TYPE_DEPENDENCY_INFO};
+    dep.memoryBarrierCount = 1;
+    dep.pMemoryBarriers = &mb;
+
+    struct PyramidPush {
+        VkDeviceAddress ring;
+        VkDeviceAddress pyr;
+        uint32_t capacity, levels, level, first, block_count, valid_end;
+    } pp{ring_.address, pyramid_.address, capacity_, pyramid_.levels, 0, 0, 0, 0};
+
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pyramid_build_);
+    for (uint32_t level = 1; level <= pyramid_.levels; ++level)
+    {
+        // 每层依赖上一层（第 1 层依赖环），所以层与层之间都要屏障
+        vkCmdPipelineBarrier2(cmd, &dep);
+        const uint32_t shift = 3 * level;
+        const uint32_t entries = capacity_ >> shift;
+        const uint64_t b0 = h0 >> shift;
+        const uint64_t b1 = (h1 - 1) >> shift;
+        pp.level = level;
+        pp.first = static_cast<uint32_t>(b0 & (entries - 1));
+        pp.block_count = static_cast<uint32_t>(std::min<uint64_t>(b1 - b0 + 1, entries));
+        pp.valid_end = static_cast<uint32_t>(h1 - (b0 << shift));
+        ctx.bindless->push(cmd, &pp, sizeof(pp));
+        vkCmdDispatch(cmd, (pp.block_count + 63) / 64, series_, 1);
+    }
+    // 顶层写完才能开始按列归约
+    vkCmdPipelineBarrier2(cmd, &dep);
+    pyramid_head_ = h1;
+}
+
+void LineChartRenderer::validate(const RenderContext& ctx, uint32_t width, uint32_t height)
+{
+    // 用金字塔当前汇总到的 head 取视窗：本帧新追加的样本还没进金字塔
+    const View v = view(pyramid_head_);
+    const uint32_t plotX = uint32_t(margin_px_);
+    const uint32_t plotW = width > 2 * plotX ? width - 2 * plotX : 1;
+    const float plotY = margin_px_;
+    const float plotH = std::max(1.0f, float(height) - 2.0f * margin_px_);
+
+    // 读回缓冲：[环 | 包络 | 降采样点]
+    const VkDeviceSize ringBytes = VkDeviceSize(series_) * capacity_ * sizeof(float);
+    const VkDeviceSize envBytes = VkDeviceSize(series_) * plotW * sizeof(float) * 2;
+    const uint32_t stride = points_stride(plotW);
+    const VkDeviceSize pointBytes = VkDeviceSize(series_) * stride * sizeof(line_downsample::Point);
+    VkBufferCreateInfo bi{VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+    bi.size = ringBytes + envBytes + pointBytes;
+    bi.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+    VmaAllocationCreateInfo ai{};
+    ai.usage = VMA_MEMORY_USAGE_AUTO;
+    ai.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+    VkBuffer readback{};
+    VmaAllocation readbackAlloc{};
+    VmaAllocationInfo info{};
+    VK_CHECK(gpu_memory::create_buffer(ctx.allocator, bi, ai, "LineChart/validation", &readback, &readbackAlloc, &info));
+    VkBufferDeviceAddressInfo addrInfo{VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO};
+    addrInfo.buffer = readback;
+    const VkDeviceAddress envAddress = vkGetBufferDeviceAddress(ctx.device, &addrInfo) + ringBytes;
+
+    ctx.immediate->submit(ctx.device, [&](VkCommandBuffer cmd) {
+        // 之前各帧对环 / 金字塔的写入（拷贝与 compute）对本次读取可见
+        VkMemoryBarrier2 mb{VK_STRUCTURE_TYPE_MEMORY_BARRIER_2};
+        mb.srcStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_2_TRANSFER_BIT;
+        mb.srcAccessMask = VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT | VK_ACCESS_2_TRANSFER_WRITE_BIT;
+        mb.dstStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_2_TRANSFER_BIT;
+        mb.dstAccessMask = VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_TRANSFER_READ_BIT;
+        VkDependencyInfo dep{VK_STRUCTURE_TYPE_DEPENDENCY_INFO};
+        dep.memoryBarrierCount = 1;
+        dep.pMemoryBarriers = &mb;
+        vkCmdPipelineBarrier2(cmd, &dep);
+
+        VkBufferCopy region{0, 0, ringBytes};
+        vkCmdCopyBuffer(cmd, ring_.buffer, readback, 1, &region);
+        ctx.bindless->bind(cmd, VK_PIPELINE_BIND_POINT_COMPUTE);
+        dispatch_reduce(cmd, ctx, v, envAddress, envAddress + envBytes, plotW, plotY, plotH);
+
+        mb.srcStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_2_TRANSFER_BIT;
+        mb.srcAccessMask = VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT | VK_ACCESS_2_TRANSFER_WRITE_BIT;
+        mb.dstStageMask = VK_PIPELINE_STAGE_2_HOST_BIT;
+        mb.dstAccessMask = VK_ACCESS_2_HOST_READ_BIT;
+        vkCmdPipelineBarrier2(cmd, &dep);
+    });
+    vmaInvalidateAllocation(ctx.allocator, readbackAlloc, 0, VK_WHOLE_SIZE);
+
+    // CPU 参考：与 linechart_reduce.comp 相同的列划分，逐样本取 min/max
+    const float* ring = static_cast<const float*>(info.pMappedData);
+    const float* gpu = reinterpret_cast<const float*>(static_cast<const uint8_t*>(info.pMappedData) + ringBytes);
+    const uint32_t mask = capacity_ - 1;
+    auto toY = [&](float value) {
+        return plotY + (1.0f - std::clamp((value - v_min_) / (v_max_ - v_min_), 0.0f, 1.0f)) * plotH;
+    };
+    double maxError = 0.0;
+    uint32_t bad = 0;
+    // LTTB 只保留视觉上显著的点，包络本来就不等于逐样本归约，改为比较选中的点
+    if (v.count >= 2 && reduce_mode_ != Reduce::LTTB)
+    {
+        const float scale = float(v.count - 1) / float(plotW);
+        for (uint32_t s = 0; s < series_; ++s)
+        {
+            const float* series = ring + size_t(s) * capacity_;
+            auto sample = [&](uint32_t i) { return series[(v.start + i) & mask]; };
+            auto valueAt = [&](float u) {
+                const uint32_t i = std::min(uint32_t(u), v.count - 1);
+                const uint32_t j = std::min(i + 1, v.count - 1);
+                const float t = u - float(i);
+                return sample(i) * (1.0f - t) + sample(j) * t;
+            };
+            for (uint32_t c = 0; c < plotW; ++c)
+            {
+                const float u0 = float(c) * scale;
+                const float u1 = std::min(float(c + 1) * scale, float(v.count - 1));
+                const float a = valueAt(u0), b = valueAt(u1);
+                float mn = std::min(a, b), mx = std::max(a, b);
+                for (uint32_t i = uint32_t(std::ceil(u0)); i <= uint32_t(std::floor(u1)); ++i)
+                {
+                    mn = std::min(mn, sample(i));
+                    mx = std::max(mx, sample(i));
+                }
+                const float* e = gpu + (size_t(s) * plotW + c) * 2;
+                const double err = std::max(std::abs(double(e[0]) - toY(mx)), std::abs(double(e[1]) - toY(mn)));
+                maxError = std::max(maxError, err);
+                if (err > 1e-2) ++bad;
+            }
+        }
+    }
+
+    // 降采样点与 CPU 参考实现（line_downsample.cpp）逐点比较，M4 和 LTTB 都必须完全相同。
+    // LTTB 不留容差：两边的桶和按同一个 256 通道顺序累加、面积不做除法，每一步都是正确舍入的
+    // 单次运算，面积逐位相同；真正的平局两边都取下标小的点，所以任何不同都是 bug
+    uint32_t pointMismatch = 0, pointTotal = 0;
+    if (reduce_mode_ != Reduce::Envelope)
+    {
+        const auto* gpuPoints = reinterpret_cast<const line_downsample::Point*>(
+            static_cast<const uint8_t*>(info.pMappedData) + ringBytes + envBytes);
+        const uint32_t pointCount = reduce_mode_ == Reduce::M4 ? stride : plotW * 2;
+        std::vector<line_downsample::Point> ref(stride);
+        for (uint32_t s = 0; s < series_; ++s)
+        {
+            const line_downsample::Samples samples{ring + size_t(s) * capacity_, capacity_, v.start, v.count};
+            if (reduce_mode_ == Reduce::M4)
+                line_downsample::m4(samples, plotW, ref);
+            else
+                line_downsample::lttb(samples, pointCount, ref);
+            for (uint32_t k = 0; k < pointCount; ++k)
+            {
+                const line_downsample::Point& g = gpuPoints[size_t(s) * stride + k];
+                if (g.index != ref[k].index || g.value != ref[k].value) ++pointMismatch;
+            }
+            pointTotal += pointCount;
+        }
+    }
+    gpu_memory::destroy_buffer(ctx.allocator, readback, readbackAlloc);
+
+    const char* mode = reduce_mode_ == Reduce::M4 ? "M4" : reduce_mode_ == Reduce::LTTB ? "LTTB" : use_pyramid_ ? "pyramid" : "brute force";
+    char text[256];
+    if (reduce_mode_ == Reduce::LTTB)
+    {
+        std::snprintf(text, sizeof(text), "%s (LTTB): %u/%u points differ from CPU LTTB", pointMismatch == 0 ? "PASS" : "FAIL",
+                      pointMismatch, pointTotal);
+    }
+    else
+    {
+        const bool pass = bad == 0 && pointMismatch == 0;
+        int len = std::snprintf(text, sizeof(text), "%s (%s): %u/%u columns off, max error %.4f px", pass ? "PASS" : "FAIL", mode, bad,
+                                series_ * plotW, maxError);
+        if (reduce_mode_ == Reduce::M4 && len > 0 && size_t(len) < sizeof(text))
+            std::snprintf(text + len, sizeof(text) - size_t(len), ", %u/%u points differ from CPU M4", pointMismatch, pointTotal);
+    }
+    validation_ = text;
+}
+
+void LineChartRenderer::create_pipelines(const RenderContext& ctx)
+{
+    // 三条管线都用 bindless 堆的共享 layout：资源走设备地址 / 句柄，push 常量覆盖所有 stage
+    layout_ = ctx.bindless->pipelineLayout;
+    reduce_ = vkutil::create_compute_pipeline(ctx.device, layout_, "shaders/linechart_reduce.comp.spv");
+    lod_ = vkutil::create_compute_pipeline(ctx.device, layout_, "shaders/linechart_lod.comp.spv");
+    m4_ = vkutil::create_compute_pipeline(ctx.device, layout_, "shaders/linechart_m4.comp.spv");
+    lttb_ = vkutil::create_compute_pipeline(ctx.device, layout_, "shaders/linechart_lttb.comp.spv");
+    points_ = vkutil::create_compute_pipeline(ctx.device, layout_, "shaders/linechart_points.comp.spv");
+    pyramid_build_ = vkutil::create_compute_pipeline(ctx.device, layout_, "shaders/linechart_pyramid.comp.spv");
+    shade_ = vkutil::create_compute_pipeline(ctx.device, layout_,
+        (std::string("shaders/linechart") + offscreen_shader_variant(ctx.offscreenFormat) + ".comp.spv").c_str());
+
+    VkShaderModule vs{}, fs{};
+    if (!vkutil::load_shader_module("./shaders/linechart_raster.vert.spv", ctx.device, &vs) ||
+        !vkutil::load_shader_module("./shaders/linechart_raster.frag.spv", ctx.device, &fs))
+        throw std::runtime_error("Failed to load linechart_raster shaders");
+    PipelineBuilder pb;
+    pb._pipelineLayout = layout_;
+    pb.set_shaders(vs, fs);
+    pb.set_input_topology(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST);
+    pb.set_polygon_mode(VK_POLYGON_MODE_FILL);
+    pb.set_cull_mode(VK_CULL_MODE_NONE, VK_FRONT_FACE_CLOCKWISE);
+    pb.set_multisampling_none();
+    pb.enable_blending_alphablend();
+    pb.disable_depthtest();
+    pb.set_color_attachment_format(ctx.offscreenFormat);
+    pb.set_depth_format(VK_FORMAT_UNDEFINED);
+    raster_ = pb.build_pipeline(ctx.device);
+    vkDestroyShaderModule(ctx.device, vs, nullptr);
+    vkDestroyShaderModule(ctx.device, fs, nullptr);
+}
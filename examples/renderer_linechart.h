@@ -0,0 +1,150 @@
+#ifndef RENDERER_LINECHART_H
+#define RENDERER_LINECHART_H
+
+#include <vulkan/vulkan.h>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "src/renderer_iface.h"
+#include "src/ext/vk_bindless.h"
+#include "vk_mem_alloc.h"
+
+// 实时遥测折线图：每条序列在 GPU 上有一段定长环形缓冲，新样本每帧直接写进映射内存，
+// 滚动只改 head（不重新上传历史）。每帧先按列归约出 min/max 包络，再用 compute 或
+// 光栅把包络画成抗锯齿折线，所以着色代价只和像素数 × 序列数有关，与点数无关。
+// 环上再维护一座 8 叉 min/max 金字塔（随追加增量更新），按列归约时从中取与当前
+// 像素密度匹配的层，任意缩放级别下归约都是 O(像素)。也可以先把视窗降采样成每列几个点
+// （M4 / LTTB，见 line_downsample.h），再由这些点重建包络。
+class LineChartRenderer final : public IRenderer
+{
+public:
+    LineChartRenderer();
+    ~LineChartRenderer() override = default;
+
+    void initialize(const RenderContext& ctx) override;
+    void destroy(const RenderContext& ctx) override;
+    void record(VkCommandBuffer cmd, uint32_t width, uint32_t height, const RenderContext& ctx) override;
+    void on_swapchain_resized(const RenderContext& ctx) override;
+    void on_imgui() override;
+    // 流式数据每帧都在滚动；暂停后只在参数变化时重画
+    bool needs_redraw() override { const bool d = streaming_ || dirty_; dirty_ = false; return d; }
+    VkFormat preferred_offscreen_format() const override { return VK_FORMAT_R8G8B8A8_UNORM; }
+    // series / points / rate / path=compute|raster / streaming=0|1，须在 initialize 之前设置
+    bool set_option(std::string_view key, std::string_view value) override;
+
+    // 追加 count 个样本：samples[series * count + i]。环可映射时直接写进 GPU 可见内存，
+    // 否则先存起来，record() 里经帧 scratch 拷贝。两次 record() 之间所有调用合计最多追加
+    // slack() / 在飞帧数 个样本（每个在飞帧的可见窗口都要留出余量），超出的部分丢弃
+    void append(std::span<const float> samples, uint32_t count);
+    uint32_t series_count() const { return series_; }
+    uint32_t capacity() const { return capacity_; }
+    // 环里不画出来的余量：正在 GPU 上读取的旧帧可见窗口不会被新样本覆盖
+    uint32_t slack() const { return capacity_ / 8; }
+    static constexpr uint32_t MaxCapacity = 1u << 28; // 每条序列的环容量上限（points 选项）
+
+    // 视窗：显示最新 count 个样本之前 offset 个样本处的一段（count = 0 表示整个可见窗口）
+    void set_view(uint32_t count, uint64_t offsetFromNewest);
+    void follow_newest() { follow_ = true; dirty_ = true; }
+
+    enum class Path { Compute, Raster };
+    // 包络的来源：逐样本 / 金字塔归约，或先降采样（M4 每列 4 点，LTTB 每列 2 点）
+    enum class Reduce { Envelope, M4, LTTB };
+
+    const char* timing_sweep_label() const override { return "Sweep reduce modes (10M-100M points)"; }
+    RendererSweep make_timing_sweep() override;
+
+private:
+    // —— 环形缓冲 ——
+    struct Ring {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VmaAllocation allocation{};
+        VkDeviceAddress address = 0;
+        float* mapped = nullptr; // 可映射（ReBAR / UMA）时非空
+    } ring_;
+    uint32_t series_ = 16;
+    uint32_t capacity_ = 1u << 18; // 每条序列的槽数，2 的幂
+    uint64_t head_ = 0;            // 累计写入的样本数；槽位 = head_ % capacity_
+    uint32_t frame_appended_ = 0;  // 自上次 record() 以来 append() 写入的样本数
+    uint32_t frames_in_flight_ = 1;
+    VmaAllocator allocator_{};     // append() 刷新映射内存用
+
+    // —— min/max 金字塔（linechart_common.glsl 的 MinMaxPyramid）——
+    struct Pyramid {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VmaAllocation allocation{};
+        VkDeviceAddress address = 0;
+        uint32_t levels = 0;
+        uint32_t entriesPerSeries = 0;
+    } pyramid_;
+    uint64_t pyramid_head_ = 0; // 金字塔已汇总到的 head
+    static constexpr uint32_t PyramidEntryBytes = 12; // MinMaxCount
+
+    // 不可映射时待拷贝的追加：每段 samples[series * count + i]
+    struct PendingChunk { uint64_t head; uint32_t count; size_t offset; };
+    std::vector<PendingChunk> pending_;
+    std::vector<float> pending_data_;
+
+    // —— 管线 ——
+    VkPipelineLayout layout_ = VK_NULL_HANDLE; // bindless 堆的共享 layout，不归本类销毁
+    VkPipeline reduce_ = VK_NULL_HANDLE;
+    VkPipeline shade_ = VK_NULL_HANDLE;
+    VkPipeline raster_ = VK_NULL_HANDLE;
+    VkPipeline pyramid_build_ = VK_NULL_HANDLE;
+    VkPipeline lod_ = VK_NULL_HANDLE;
+    VkPipeline m4_ = VK_NULL_HANDLE;
+    VkPipeline lttb_ = VK_NULL_HANDLE;
+    VkPipeline points_ = VK_NULL_HANDLE;
+
+    // —— 参数 ——
+    Path path_ = Path::Compute;
+    bool streaming_ = true;
+    bool dirty_ = true;
+    uint32_t rate_ = 1000;     // 模拟数据：每帧每条序列追加的样本数
+    float line_width_ = 1.5f;
+    float v_min_ = -1.1f, v_max_ = 1.1f;
+    float margin_px_ = 40.0f;
+    bool use_pyramid_ = true;
+    Reduce reduce_mode_ = Reduce::Envelope;
+    // 降采样点缓冲每条序列的点数（M4 的 4 点/列；LTTB 只用前 2 点/列）
+    static uint32_t points_stride(uint32_t plotW) { return plotW * 4; }
+
+    // CPU 参考实现（SSE2）的 10M-100M 点降采样计时
+    bool cpu_bench_ = false;
+    std::string cpu_bench_result_;
+    void run_cpu_benchmark();
+
+    // 视窗（平移 / 缩放）
+    bool follow_ = true;       // 右端跟随最新样本
+    uint64_t view_end_ = 0;    // 不跟随时视窗右端的绝对样本下标
+    uint32_t view_count_ = 0;  // 视窗内样本数，0 = 整个可见窗口
+    uint32_t last_plot_w_ = 1; // 最近一帧的绘图区宽度（鼠标平移换算用）
+    struct View { uint32_t start; uint32_t count; };
+    View view(uint64_t head) const;
+
+    // 校验：读回 GPU 包络，与 CPU 逐样本归约比较
+    bool validate_requested_ = false;
+    std::string validation_;
+    void validate(const RenderContext& ctx, uint32_t width, uint32_t height);
+
+    // 模拟遥测源
+    std::vector<float> gen_phase_;
+    std::vector<uint32_t> gen_noise_;
+    std::vector<float> gen_block_;
+    uint64_t gen_t_ = 0;
+    void generate(float* out, uint32_t count);
+    void simulate_frame();
+
+    uint32_t visible_count() const;
+    void create_ring(const RenderContext& ctx);
+    void create_pyramid(const RenderContext& ctx);
+    void update_pyramid(VkCommandBuffer cmd, const RenderContext& ctx);
+    // points：series × points_stride(plotW) 个 DownsamplePoint，仅 M4 / LTTB 使用
+    void dispatch_reduce(VkCommandBuffer cmd, const RenderContext& ctx, const View& v, VkDeviceAddress env,
+                         VkDeviceAddress points, uint32_t plotW, float plotY, float plotH);
+    void fill_history(const RenderContext& ctx);
+    void upload_pending(VkCommandBuffer cmd, const RenderContext& ctx);
+    void create_pipelines(const RenderContext& ctx);
+};
+
+#endif //RENDERER_LINECHART_H
@@ -2,6 +2,9 @@
 #include "src/ext/vk_initializers.h"
 #include "src/ext/vk_images.h"
 #include "src/ext/vk_pipelines.h"
+#include "src/gpu_memory.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
 #include <cstring>
 #include <cmath>
 #include <stdexcept>
@@ -13,7 +16,19 @@
 #endif
 
 // ---- helpers ----
-AllocatedBuffer MeshRenderer::create_buffer(VmaAllocator alloc, size_t size, VkBufferUsageFlags usage,
+namespace {
+// 正交视图：绕 (axisX, axisY, 0) 转 angle 弧度，再把 z ∈ [-0.5, 0.5] 压进深度范围 [0.25, 0.75]
+glm::mat4 view_matrix(float angle, float axisX, float axisY)
+{
+    const glm::mat4 depthRange = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, 0.5f))
+                               * glm::scale(glm::mat4(1.0f), glm::vec3(1.0f, 1.0f, 0.5f));
+    return depthRange * glm::rotate(glm::mat4(1.0f), angle, glm::vec3(axisX, axisY, 0.0f));
+}
+
+constexpr uint32_t InsetMargin = 16; // 小窗离 offscreen 右上角的像素
+}
+
+AllocatedBuffer MeshRenderer::create_buffer(VmaAllocator alloc, const char* tag, size_t size, VkBufferUsageFlags usage,
                                             VmaMemoryUsage memUsage, VmaAllocationCreateFlags flags)
 {
     VkBufferCreateInfo bi{VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
@@ -25,13 +40,13 @@ AllocatedBuffer MeshRenderer::create_buffer(VmaAllocator alloc, size_t size, VkB
     ai.flags = flags; // 我们会用 VMA_ALLOCATION_CREATE_MAPPED_BIT
 
     AllocatedBuffer out{};
-    VK_CHECK(vmaCreateBuffer(alloc, &bi, &ai, &out.buffer, &out.allocation, &out.info));
+    VK_CHECK(gpu_memory::create_buffer(alloc, bi, ai, tag, &out.buffer, &out.allocation, &out.info));
     return out;
 }
 
 void MeshRenderer::destroy_buffer(VmaAllocator alloc, const AllocatedBuffer& b)
 {
-    if (b.buffer) vmaDestroyBuffer(alloc, b.buffer, b.allocation);
+    if (b.buffer) gpu_memory::destroy_buffer(alloc, b.buffer, b.allocation);
 }
 
 void MeshRenderer::immediate_submit(VkDevice device, VkQueue queue, uint32_t qfamily,
@@ -94,11 +109,12 @@ void MeshRenderer::initialize(const RenderContext& ctx)
     pb.set_cull_mode(VK_CULL_MODE_NONE, VK_FRONT_FACE_CLOCKWISE);
     pb.set_multisampling_none();
     pb.disable_blending();
-    pb.disable_depthtest(); // 先不做深度，等你后续接“Depth”步骤
+    // 两块矩形互相穿插，靠深度测试决定谁在前（深度清成 1，小的在前）
+    pb.enable_depthtest(true, VK_COMPARE_OP_LESS_OR_EQUAL);
 
-    // 目标颜色格式用 offscreen（与你 Engine 一致）
-    pb.set_color_attachment_format(VK_FORMAT_R16G16B16A16_SFLOAT);
-    pb.set_depth_format(VK_FORMAT_UNDEFINED);
+    // 目标颜色格式用 offscreen（与你 Engine 一致）；小窗附件用同一格式，同一条管线两个视角都能画
+    pb.set_color_attachment_format(ctx.offscreenFormat);
+    pb.set_depth_format(DepthFormat);
 
     pipeline_ = pb.build_pipeline(ctx.device);
 
@@ -106,12 +122,14 @@ void MeshRenderer::initialize(const RenderContext& ctx)
     vkDestroyShaderModule(ctx.device, fs, nullptr);
 
     // 2) 创建 mesh：一个矩形（两个三角形）
-    struct Vertex { float px, py, pz; float r,g,b,a; };
+    // 布局与 colored_triangle_mesh.vert 的 Vertex 一致（std430，48 字节）
+    struct Vertex { float px, py, pz, uv_x; float nx, ny, nz, uv_y; float r,g,b,a; };
+    static_assert(sizeof(Vertex) == 48);
     Vertex verts[4] = {
-        {  0.5f,-0.5f,0,  0,0,0,1 },
-        {  0.5f, 0.5f,0,  0.5f,0.5f,0.5f,1 },
-        { -0.5f,-0.5f,0,  1,0,0,1 },
-        { -0.5f, 0.5f,0,  0,1,0,1 }
+        {  0.5f,-0.5f,0, 1,  0,0,1, 0,  0,0,0,1 },
+        {  0.5f, 0.5f,0, 1,  0,0,1, 1,  0.5f,0.5f,0.5f,1 },
+        { -0.5f,-0.5f,0, 0,  0,0,1, 0,  1,0,0,1 },
+        { -0.5f, 0.5f,0, 0,  0,0,1, 1,  0,1,0,1 }
     };
     uint32_t indices[6] = {0,1,2, 2,1,3};
     indexCount_ = 6;
@@ -123,13 +141,13 @@ void MeshRenderer::initialize(const RenderContext& ctx)
     const size_t ibSize = sizeof(indices);
 
     // GPU-only 目标缓冲
-    vertexBuffer_ = create_buffer(allocator, vbSize,
+    vertexBuffer_ = create_buffer(allocator, "Mesh/vertices", vbSize,
                                   VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
                                   VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT |
                                   VK_BUFFER_USAGE_TRANSFER_DST_BIT,
                                   VMA_MEMORY_USAGE_GPU_ONLY);
 
-    indexBuffer_  = create_buffer(allocator, ibSize,
+    indexBuffer_  = create_buffer(allocator, "Mesh/indices", ibSize,
                                   VK_BUFFER_USAGE_INDEX_BUFFER_BIT |
                                   VK_BUFFER_USAGE_TRANSFER_DST_BIT,
                                   VMA_MEMORY_USAGE_GPU_ONLY);
@@ -141,7 +159,7 @@ void MeshRenderer::initialize(const RenderContext& ctx)
 
     // staging（CPU 可见 + 持久映射）
     AllocatedBuffer staging =
-        create_buffer(allocator, vbSize + ibSize,
+        create_buffer(allocator, "Mesh/staging", vbSize + ibSize,
                       VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
                       VMA_MEMORY_USAGE_CPU_ONLY,
                       VMA_ALLOCATION_CREATE_MAPPED_BIT);
@@ -163,33 +181,46 @@ void MeshRenderer::initialize(const RenderContext& ctx)
     destroy_buffer(allocator, staging);
 }
 
-void MeshRenderer::record(VkCommandBuffer cmd, uint32_t width, uint32_t height, const RenderContext& ctx)
+void MeshRenderer::declare_attachments(TransientPool& pool, const RenderContext& ctx)
 {
-    // 约定：和你的 Engine 对齐——先把 offscreen 当作渲染目标，
-    // 再 copy 到 swapchain，最后**让 swapchain 保持在 TRANSFER_DST_OPTIMAL**
-    // 以便 ImGuiLayer 接管并转 PRESENT。
-
-    // offscreen: UNDEFINED/GENERAL -> COLOR_ATTACHMENT_OPTIMAL（清屏）
-    vkutil::transition_image(cmd, ctx.offscreenImage,
-                             VK_IMAGE_LAYOUT_UNDEFINED,
-                             VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+    // 小窗为帧尺寸的 1/4；主深度跟随帧尺寸（extent 留 {0, 0}）
+    insetExtent_ = {std::max(1u, ctx.frameExtent.width / 4), std::max(1u, ctx.frameExtent.height / 4)};
+    depth_ = pool.request({"Mesh/depth", DepthFormat, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
+                           VK_IMAGE_ASPECT_DEPTH_BIT, {}, 1, 1});
+    insetColor_ = pool.request({"Mesh/inset", ctx.offscreenFormat, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+                                VK_IMAGE_ASPECT_COLOR_BIT, insetExtent_, 0, 2});
+    insetDepth_ = pool.request({"Mesh/inset-depth", DepthFormat, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
+                                VK_IMAGE_ASPECT_DEPTH_BIT, insetExtent_, 0, 0});
+}
 
+void MeshRenderer::draw_scene(VkCommandBuffer cmd, VkImageView colorView, VkImageLayout colorLayout, VkImageView depthView,
+                              VkExtent2D extent, float angle, float axisX, float axisY)
+{
     VkClearValue clear{};
     clear.color = {0.05f, 0.05f, 0.08f, 1.0f};
 
     VkRenderingAttachmentInfo color{VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO};
-    color.imageView   = ctx.offscreenImageView;
-    color.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    color.imageView   = colorView;
+    color.imageLayout = colorLayout;
     color.loadOp      = VK_ATTACHMENT_LOAD_OP_CLEAR;
     color.storeOp     = VK_ATTACHMENT_STORE_OP_STORE;
     color.clearValue  = clear;
 
+    // 深度只在本 pass 内有用，不必写回
+    VkRenderingAttachmentInfo depth{VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO};
+    depth.imageView   = depthView;
+    depth.imageLayout = VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL;
+    depth.loadOp      = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    depth.storeOp     = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    depth.clearValue.depthStencil = {1.0f, 0};
+
     VkRenderingInfo ri{VK_STRUCTURE_TYPE_RENDERING_INFO};
     ri.renderArea.offset = {0,0};
-    ri.renderArea.extent = {width, height};
+    ri.renderArea.extent = extent;
     ri.layerCount = 1;
     ri.colorAttachmentCount = 1;
     ri.pColorAttachments = &color;
+    ri.pDepthAttachment = &depth;
 
     vkCmdBeginRendering(cmd, &ri);
 
@@ -197,45 +228,72 @@ void MeshRenderer::record(VkCommandBuffer cmd, uint32_t width, uint32_t height,
 
     // 动态 viewport/scissor
     VkViewport vp{};
-    vp.width  = static_cast<float>(width);
-    vp.height = static_cast<float>(height);
+    vp.width  = static_cast<float>(extent.width);
+    vp.height = static_cast<float>(extent.height);
     vp.minDepth = 0.f; vp.maxDepth = 1.f;
     vkCmdSetViewport(cmd, 0, 1, &vp);
 
-    VkRect2D sc{{0,0},{width,height}};
+    VkRect2D sc{{0,0},extent};
     vkCmdSetScissor(cmd, 0, 1, &sc);
 
-    // push constants
-    GPUDrawPushConstants pc{};
-    pc.worldMatrix = glm::mat4(1.0f);
-    pc.vertexBuffer = vertexDeviceAddress_;
-    vkCmdPushConstants(cmd, pipelineLayout_, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(GPUDrawPushConstants), &pc);
-
     // 绑定索引缓冲（顶点数据在 shader 里通过设备地址取用）
     vkCmdBindIndexBuffer(cmd, indexBuffer_.buffer, 0, VK_INDEX_TYPE_UINT32);
 
-    vkCmdDrawIndexed(cmd, indexCount_, 1, 0, 0, 0);
+    // 同一块矩形画两次，分别转 ±angle，在中间穿插
+    for (float sign : {1.0f, -1.0f})
+    {
+        GPUDrawPushConstants pc{};
+        pc.worldMatrix = view_matrix(sign * angle, axisX, axisY);
+        pc.vertexBuffer = vertexDeviceAddress_;
+        vkCmdPushConstants(cmd, pipelineLayout_, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(GPUDrawPushConstants), &pc);
+        vkCmdDrawIndexed(cmd, indexCount_, 1, 0, 0, 0);
+    }
 
     vkCmdEndRendering(cmd);
+}
 
-    // offscreen -> TRANSFER_SRC_OPTIMAL
-    vkutil::transition_image(cmd, ctx.offscreenImage,
-                             VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
-                             VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
-
-    // swapchain: UNDEFINED -> TRANSFER_DST_OPTIMAL
-    vkutil::transition_image(cmd, ctx.swapchainImage,
-                             VK_IMAGE_LAYOUT_UNDEFINED,
-                             VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-
-    // copy
-    vkutil::copy_image_to_image(cmd,
-                                ctx.offscreenImage,
-                                ctx.swapchainImage,
-                                VkExtent2D{width, height},
-                                VkExtent2D{width, height});
-
-    // 注意：这里**不要**转 PRESENT，保持在 TRANSFER_DST_OPTIMAL，让 ImGuiLayer 接着画并最终转 PRESENT
+void MeshRenderer::record(VkCommandBuffer cmd, uint32_t width, uint32_t height, const RenderContext& ctx)
+{
+    // 约定：和你的 Engine 对齐——只把 offscreen 当作渲染目标，
+    // 结束时**让 offscreen 保持在 GENERAL**，swapchain 由 Engine 的 composite pass 负责。
+    transients_ = ctx.transients;
+    const TransientImage& depth = ctx.transients->get(depth_);
+    const TransientImage& inset = ctx.transients->get(insetColor_);
+    const TransientImage& insetDepth = ctx.transients->get(insetDepth_);
+
+    // pass 0：小窗（绕 x 轴看）。临时附件每帧内容未定义，从 UNDEFINED 经全屏障转换
+    vkutil::transition_image(cmd, inset.image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+    vkutil::transition_image(cmd, insetDepth.image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL);
+    draw_scene(cmd, inset.view, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, insetDepth.view, insetExtent_, 0.6f, 1.0f, 0.0f);
+
+    // pass 1：主视角（绕 y 轴看）。offscreen: UNDEFINED -> GENERAL（GENERAL 可直接作 ColorAttachment，清屏）；
+    // 主深度可能与小窗深度共用内存，UNDEFINED 转换的全屏障同时把它排在 pass 0 之后
+    vkutil::transition_image(cmd, ctx.offscreenImage, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL);
+    vkutil::transition_image(cmd, depth.image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL);
+    draw_scene(cmd, ctx.offscreenImageView, VK_IMAGE_LAYOUT_GENERAL, depth.view, {width, height}, 0.6f, 0.0f, 1.0f);
+
+    // pass 2：小窗原样拷进 offscreen 右上角（offscreen 留在 GENERAL）
+    vkutil::transition_image(cmd, inset.image, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+    vkutil::transition_image(cmd, ctx.offscreenImage, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_GENERAL);
+    const uint32_t w = std::min(insetExtent_.width, width), h = std::min(insetExtent_.height, height);
+    const int32_t x0 = static_cast<int32_t>(width > w + InsetMargin ? width - w - InsetMargin : width - w);
+    const int32_t y0 = static_cast<int32_t>(height > h + InsetMargin ? InsetMargin : 0);
+
+    // 同格式同尺寸，用 copy 而不是 blit：不依赖格式的 BLIT 特性
+    VkImageCopy2 region{.sType = VK_STRUCTURE_TYPE_IMAGE_COPY_2};
+    region.srcSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+    region.dstSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+    region.dstOffset = {x0, y0, 0};
+    region.extent = {w, h, 1};
+
+    VkCopyImageInfo2 copy{.sType = VK_STRUCTURE_TYPE_COPY_IMAGE_INFO_2};
+    copy.srcImage = inset.image;
+    copy.srcImageLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    copy.dstImage = ctx.offscreenImage;
+    copy.dstImageLayout = VK_IMAGE_LAYOUT_GENERAL;
+    copy.regionCount = 1;
+    copy.pRegions = &region;
+    vkCmdCopyImage2(cmd, &copy);
 }
 
 void MeshRenderer::destroy(const RenderContext& ctx)
@@ -248,6 +306,7 @@ void MeshRenderer::destroy(const RenderContext& ctx)
 
     pipeline_ = VK_NULL_HANDLE;
     pipelineLayout_ = VK_NULL_HANDLE;
+    transients_ = nullptr;
 }
 
 void MeshRenderer::on_swapchain_resized(const RenderContext& ctx)
@@ -257,7 +316,13 @@ void MeshRenderer::on_swapchain_resized(const RenderContext& ctx)
 void MeshRenderer::on_imgui()
 {
     if (ImGui::Begin("Mesh Renderer")) {
-        ImGui::Text("Draws a rectangle via graphics pipeline");
+        ImGui::Text("Draws two crossing rectangles with depth test, plus an inset view");
+        if (transients_ != nullptr)
+        {
+            const TransientPool::Plan p = transients_->plan();
+            ImGui::Text("Attachments: %u images in %u slots, %.2f MiB (%.2f MiB without aliasing)",
+                        p.images, p.slots, p.allocatedBytes / 1048576.0, p.requestedBytes / 1048576.0);
+        }
         ImGui::End();
     }
 }
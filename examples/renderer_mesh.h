@@ -2,6 +2,7 @@
 #define RENDERER_MESH_H
 
 #include "src/renderer_iface.h"
+#include "src/ext/vk_transient.h"
 #include <glm/mat4x4.hpp>
 #include <functional>
 
@@ -22,19 +23,27 @@ public:
     void record(VkCommandBuffer cmd, uint32_t w, uint32_t h, const RenderContext& ctx) override;
     void destroy(const RenderContext& ctx) override;
     void on_swapchain_resized(const RenderContext& ctx) override;
+    // 深度和小窗（inset）附件都向引擎的 TransientPool 申请，小窗深度与主深度的存活区间不重叠，共用一块内存
+    void declare_attachments(TransientPool& pool, const RenderContext& ctx) override;
 
     // （可选）UI 调试
     void on_imgui() override;
+    // 静态画面：只有引擎侧的 resize / 切换需要重画
+    bool needs_redraw() override { return false; }
 
 private:
     // 上传 mesh 用
-    AllocatedBuffer create_buffer(VmaAllocator alloc, size_t size, VkBufferUsageFlags usage, VmaMemoryUsage memUsage, VmaAllocationCreateFlags flags = 0);
+    AllocatedBuffer create_buffer(VmaAllocator alloc, const char* tag, size_t size, VkBufferUsageFlags usage, VmaMemoryUsage memUsage, VmaAllocationCreateFlags flags = 0);
     void destroy_buffer(VmaAllocator alloc, const AllocatedBuffer& b);
 
     // 一次性提交（staging copy）
     void immediate_submit(VkDevice device, VkQueue queue, uint32_t qfamily,
                           std::function<void(VkCommandBuffer)> &&fn);
 
+    // 用给定视角把两块交叉的矩形画进 color / depth（动态渲染，清屏 + 深度测试）
+    void draw_scene(VkCommandBuffer cmd, VkImageView color, VkImageLayout colorLayout, VkImageView depth,
+                    VkExtent2D extent, float angle, float axisX, float axisY);
+
     // 资源
     VkPipelineLayout pipelineLayout_{};
     VkPipeline pipeline_{};
@@ -45,6 +54,15 @@ private:
     uint32_t indexCount_{6};
     VkDeviceAddress vertexDeviceAddress_{};
 
+    // 本帧附件（declare_attachments 里按固定顺序申请）：
+    // pass 0 小窗视角 -> insetColor_ + insetDepth_；pass 1 主视角 -> offscreen + depth_；pass 2 小窗拷进 offscreen 右上角
+    static constexpr VkFormat DepthFormat = VK_FORMAT_D32_SFLOAT;
+    TransientPool::Handle depth_{TransientPool::InvalidHandle};
+    TransientPool::Handle insetColor_{TransientPool::InvalidHandle};
+    TransientPool::Handle insetDepth_{TransientPool::InvalidHandle};
+    VkExtent2D insetExtent_{};
+    const TransientPool* transients_{}; // 引擎的池，record() 时记下，面板显示别名结果
+
     // 上传临时对象的销毁延后到 destroy()
 };
 
@@ -0,0 +1,502 @@
+#include "renderer_scatter.h"
+#include "example_utils.h"
+#include "src/ext/vk_initializers.h"
+#include "src/ext/vk_pipelines.h"
+#include "src/ext/vk_bindless.h"
+#include "src/ext/vk_scratch.h"
+#include "src/ext/vk_deletion.h"
+#include "src/gpu_memory.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "imgui.h"
+
+#ifndef VK_CHECK
+#define VK_CHECK(x) do { VkResult err__ = (x); if (err__ != VK_SUCCESS) { throw std::runtime_error(std::string("Vulkan error ") + std::to_string(err__)); } } while(0)
+#endif
+
+namespace {
+
+void memory_barrier(VkCommandBuffer cmd, VkPipelineStageFlags2 srcStage, VkAccessFlags2 srcAccess,
+                    VkPipelineStageFlags2 dstStage, VkAccessFlags2 dstAccess)
+{
+    VkMemoryBarrier2 mb{VK_STRUCTURE_TYPE_MEMORY_BARRIER_2};
+    mb.srcStageMask = srcStage;
+    mb.srcAccessMask = srcAccess;
+    mb.dstStageMask = dstStage;
+    mb.dstAccessMask = dstAccess;
+    VkDependencyInfo dep{VK_STRUCTURE_TYPE_DEPENDENCY_INFO};
+    dep.memoryBarrierCount = 1;
+    dep.pMemoryBarriers = &mb;
+    vkCmdPipelineBarrier2(cmd, &dep);
+}
+
+// 与 scatter_splat.comp / scatter_sprite.* 的 push 块一致（前 44 字节相同）
+struct PointsPush {
+    VkDeviceAddress pts;
+    float center[2];
+    float origin[2];
+    uint32_t count;
+    uint32_t W, H;
+    float scale;
+    union { uint32_t density_index; float radius; };
+};
+
+struct GeneratePush {
+    VkDeviceAddress pts;
+    uint32_t count;
+    uint32_t seed;
+    uint32_t clusters;
+};
+
+struct MaxPush {
+    VkDeviceAddress stats;
+    uint32_t density_index;
+    uint32_t W, H;
+};
+
+struct ShadePush {
+    VkDeviceAddress stats;
+    uint32_t density_index;
+    uint32_t image_index;
+    uint32_t W, H;
+    float exposure;
+};
+
+constexpr float ScatterBackground[4] = {0.06f, 0.06f, 0.08f, 1.0f}; // scatter_background()
+
+} // namespace
+
+ScatterRenderer::ScatterRenderer() = default;
+
+// ==== IRenderer 接口 ====
+
+bool ScatterRenderer::set_option(std::string_view key, std::string_view value)
+{
+    uint32_t n = 0;
+    if (key == "points" && example_utils::parse_number(value, n) && n > 0) { requested_count_ = std::min(n, 100'000'000u); return true; }
+    if (key == "clusters" && example_utils::parse_number(value, n) && n > 0) { clusters_ = std::min(n, 1024u); return true; }
+    if (key == "aggregate" && example_utils::parse_number(value, n)) { aggregate_ = n != 0; return true; }
+    if (key == "sprite_threshold" && example_utils::parse_number(value, n)) { sprite_threshold_ = n; return true; }
+    if (key == "path")
+    {
+        if (value == "auto") { path_ = Path::Auto; return true; }
+        if (value == "density") { path_ = Path::Density; return true; }
+        if (value == "sprites") { path_ = Path::Sprites; return true; }
+    }
+    return false;
+}
+
+void ScatterRenderer::initialize(const RenderContext& ctx)
+{
+    create_pipelines(ctx);
+    create_density(ctx, ctx.frameExtent);
+    dirty_ = true;
+}
+
+void ScatterRenderer::destroy(const RenderContext& ctx)
+{
+    for (VkPipeline* p : {&generate_, &splat_, &splat_aggregate_, &max_, &shade_, &sprite_})
+    {
+        if (*p) vkDestroyPipeline(ctx.device, *p, nullptr);
+        *p = VK_NULL_HANDLE;
+    }
+    layout_ = VK_NULL_HANDLE;
+    destroy_density(ctx);
+    if (points_.buffer) gpu_memory::destroy_buffer(ctx.allocator, points_.buffer, points_.allocation);
+    points_ = {};
+}
+
+void ScatterRenderer::on_swapchain_resized(const RenderContext& ctx)
+{
+    // 设备已空闲：密度图按新尺寸直接重建
+    destroy_density(ctx);
+    create_density(ctx, ctx.frameExtent);
+    dirty_ = true;
+}
+
+void ScatterRenderer::on_imgui()
+{
+    ImGui::Begin("Scatter");
+    ImGui::Text("%u points (%.1f MiB), %u clusters", points_.count,
+                double(size_t(points_.count) * sizeof(float) * 2) / 1048576.0, points_.clusters);
+    ImGui::Text("Density image %ux%u R32_UINT, drawn with %s", density_.extent.width, density_.extent.height,
+                last_sprites_ ? "sprites" : (aggregate_ && splat_aggregate_ ? "subgroup-aggregated atomics" : "image atomics"));
+    if (splat_aggregate_) ImGui::Text("Subgroup ballot: yes (subgroup size %u)", subgroup_size_);
+    else ImGui::TextDisabled("Subgroup ballot: not supported, plain atomics only");
+
+    int count = int(requested_count_);
+    if (ImGui::SliderInt("Points", &count, 1000, 100'000'000, "%d", ImGuiSliderFlags_Logarithmic))
+    {
+        requested_count_ = uint32_t(std::max(count, 1));
+        dirty_ = true;
+    }
+    int clusters = int(clusters_);
+    if (ImGui::SliderInt("Clusters", &clusters, 1, 256)) { clusters_ = uint32_t(clusters); dirty_ = true; }
+
+    int path = int(path_);
+    ImGui::RadioButton("Auto", &path, int(Path::Auto));
+    ImGui::SameLine();
+    ImGui::RadioButton("Density", &path, int(Path::Density));
+    ImGui::SameLine();
+    ImGui::RadioButton("Sprites", &path, int(Path::Sprites));
+    if (path != int(path_)) { path_ = Path(path); dirty_ = true; }
+    int threshold = int(sprite_threshold_);
+    if (ImGui::SliderInt("Sprite threshold", &threshold, 1000, 10'000'000, "%d", ImGuiSliderFlags_Logarithmic))
+    {
+        sprite_threshold_ = uint32_t(std::max(threshold, 0));
+        dirty_ = true;
+    }
+    ImGui::BeginDisabled(!splat_aggregate_);
+    if (ImGui::Checkbox("Aggregate atomics per subgroup", &aggregate_)) dirty_ = true;
+    ImGui::EndDisabled();
+    if (ImGui::SliderFloat("Exposure", &exposure_, 0.25f, 4.0f, "%.2f", ImGuiSliderFlags_Logarithmic)) dirty_ = true;
+    if (ImGui::SliderFloat("Sprite radius", &sprite_radius_, 0.5f, 6.0f, "%.1f px")) dirty_ = true;
+
+    // 鼠标：滚轮以光标为锚缩放，左键拖动平移（不在 ImGui 窗口上时）
+    const ImGuiIO& io = ImGui::GetIO();
+    if (!io.WantCaptureMouse)
+    {
+        const float ox = io.DisplaySize.x * 0.5f, oy = io.DisplaySize.y * 0.5f;
+        if (io.MouseWheel != 0.0f)
+        {
+            // 光标下的数据点在缩放前后保持不动
+            const float px = center_[0] + (io.MousePos.x - ox) / last_scale_;
+            const float py = center_[1] - (io.MousePos.y - oy) / last_scale_;
+            const float zoom = std::clamp(zoom_ * std::pow(1.25f, io.MouseWheel), 0.25f, 4096.0f);
+            const float next = last_scale_ * zoom / zoom_;
+            zoom_ = zoom;
+            center_[0] = px - (io.MousePos.x - ox) / next;
+            center_[1] = py + (io.MousePos.y - oy) / next;
+            dirty_ = true;
+        }
+        if (ImGui::IsMouseDragging(ImGuiMouseButton_Left) && (io.MouseDelta.x != 0.0f || io.MouseDelta.y != 0.0f))
+        {
+            center_[0] -= io.MouseDelta.x / last_scale_;
+            center_[1] += io.MouseDelta.y / last_scale_;
+            dirty_ = true;
+        }
+    }
+    ImGui::Text("Zoom %.2fx at (%.3f, %.3f)", zoom_, center_[0], center_[1]);
+    ImGui::SameLine();
+    if (ImGui::Button("Reset view"))
+    {
+        zoom_ = 1.0f;
+        center_[0] = center_[1] = 0.0f;
+        dirty_ = true;
+    }
+    if (!sweep_result_.empty()) ImGui::TextUnformatted(sweep_result_.c_str());
+    ImGui::TextDisabled("Point count is also set with --set points=N");
+    ImGui::End();
+}
+
+void ScatterRenderer::record(VkCommandBuffer cmd, uint32_t width, uint32_t height, const RenderContext& ctx)
+{
+    ensure_points(cmd, ctx);
+    last_scale_ = pixel_scale(width, height);
+    last_sprites_ = use_sprites();
+    if (last_sprites_) record_sprites(cmd, width, height, ctx);
+    else record_density(cmd, width, height, ctx);
+}
+
+bool ScatterRenderer::use_sprites() const
+{
+    if (path_ == Path::Auto) return points_.count < sprite_threshold_;
+    return path_ == Path::Sprites;
+}
+
+float ScatterRenderer::pixel_scale(uint32_t width, uint32_t height) const
+{
+    return zoom_ * float(std::min(width, height)) / 2.2f;
+}
+
+void ScatterRenderer::record_density(VkCommandBuffer cmd, uint32_t width, uint32_t height, const RenderContext& ctx)
+{
+    // 密度图按交换链尺寸创建，点只累加到其范围内（着色时范围外按 0 处理）
+    const uint32_t W = std::min(width, density_.extent.width);
+    const uint32_t H = std::min(height, density_.extent.height);
+
+    // 1) 清零密度图：上一帧的 max / shade 读完后整张丢弃
+    VkImageMemoryBarrier2 ib{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2};
+    ib.srcStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+    ib.dstStageMask = VK_PIPELINE_STAGE_2_CLEAR_BIT;
+    ib.dstAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+    ib.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    ib.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+    ib.image = density_.image;
+    ib.subresourceRange = vkinit::image_subresource_range(VK_IMAGE_ASPECT_COLOR_BIT);
+    VkDependencyInfo dep{VK_STRUCTURE_TYPE_DEPENDENCY_INFO};
+    dep.imageMemoryBarrierCount = 1;
+    dep.pImageMemoryBarriers = &ib;
+    vkCmdPipelineBarrier2(cmd, &dep);
+    VkClearColorValue zero{};
+    const VkImageSubresourceRange range = vkinit::image_subresource_range(VK_IMAGE_ASPECT_COLOR_BIT);
+    vkCmdClearColorImage(cmd, density_.image, VK_IMAGE_LAYOUT_GENERAL, &zero, 1, &range);
+    memory_barrier(cmd, VK_PIPELINE_STAGE_2_CLEAR_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                   VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT);
+
+    // 2) 每个点一次原子加（可用时按 subgroup 合并）
+    PointsPush pp{};
+    pp.pts = points_.address;
+    pp.center[0] = center_[0];
+    pp.center[1] = center_[1];
+    pp.origin[0] = float(width) * 0.5f;
+    pp.origin[1] = float(height) * 0.5f;
+    pp.count = points_.count;
+    pp.W = W;
+    pp.H = H;
+    pp.scale = last_scale_;
+    pp.density_index = density_.index;
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, aggregate_ && splat_aggregate_ ? splat_aggregate_ : splat_);
+    ctx.bindless->push(cmd, &pp, sizeof(pp));
+    vkCmdDispatch(cmd, std::clamp((points_.count + 255) / 256, 1u, MaxGroups), 1, 1);
+
+    // 3) 最大密度（对数归一化的分母），结果在帧 scratch 里，CPU 先清零
+    ScratchAllocation stats = ctx.frameScratch->allocate(sizeof(uint32_t), 4);
+    std::memset(stats.ptr, 0, sizeof(uint32_t));
+    memory_barrier(cmd, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+                   VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT);
+    MaxPush mp{stats.address, density_.index, W, H};
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, max_);
+    ctx.bindless->push(cmd, &mp, sizeof(mp));
+    vkCmdDispatch(cmd, (W + 15) / 16, (H + 15) / 16, 1);
+
+    // 4) 着色：offscreen 等上一帧 composite 的采样读完，内容整帧重画
+    VkMemoryBarrier2 mb{VK_STRUCTURE_TYPE_MEMORY_BARRIER_2};
+    mb.srcStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+    mb.srcAccessMask = VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+    mb.dstStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+    mb.dstAccessMask = VK_ACCESS_2_SHADER_STORAGE_READ_BIT;
+    VkImageMemoryBarrier2 ob{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2};
+    ob.srcStageMask = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_2_TRANSFER_BIT;
+    ob.dstStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+    ob.dstAccessMask = VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+    ob.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    ob.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+    ob.image = ctx.offscreenImage;
+    ob.subresourceRange = vkinit::image_subresource_range(VK_IMAGE_ASPECT_COLOR_BIT);
+    dep = {VK_STRUCTURE_TYPE_DEPENDENCY_INFO};
+    dep.memoryBarrierCount = 1;
+    dep.pMemoryBarriers = &mb;
+    dep.imageMemoryBarrierCount = 1;
+    dep.pImageMemoryBarriers = &ob;
+    vkCmdPipelineBarrier2(cmd, &dep);
+
+    ShadePush sp{stats.address, density_.index, ctx.offscreenStorageIndex, width, height, exposure_};
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, shade_);
+    ctx.bindless->push(cmd, &sp, sizeof(sp));
+    vkCmdDispatch(cmd, (width + 15) / 16, (height + 15) / 16, 1);
+    // offscreen 保持 GENERAL，由引擎 composite pass 采样
+}
+
+void ScatterRenderer::record_sprites(VkCommandBuffer cmd, uint32_t width, uint32_t height, const RenderContext& ctx)
+{
+    VkImageMemoryBarrier2 ib{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2};
+    ib.srcStageMask = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_2_TRANSFER_BIT;
+    ib.dstStageMask = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
+    ib.dstAccessMask = VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT;
+    ib.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    ib.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+    ib.image = ctx.offscreenImage;
+    ib.subresourceRange = vkinit::image_subresource_range(VK_IMAGE_ASPECT_COLOR_BIT);
+    VkDependencyInfo dep{VK_STRUCTURE_TYPE_DEPENDENCY_INFO};
+    dep.imageMemoryBarrierCount = 1;
+    dep.pImageMemoryBarriers = &ib;
+    vkCmdPipelineBarrier2(cmd, &dep);
+
+    VkRenderingAttachmentInfo color{VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO};
+    color.imageView = ctx.offscreenImageView;
+    color.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+    color.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    color.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    std::copy(std::begin(ScatterBackground), std::end(ScatterBackground), color.clearValue.color.float32);
+
+    VkRenderingInfo ri{VK_STRUCTURE_TYPE_RENDERING_INFO};
+    ri.renderArea = {{0, 0}, {width, height}};
+    ri.layerCount = 1;
+    ri.colorAttachmentCount = 1;
+    ri.pColorAttachments = &color;
+    vkCmdBeginRendering(cmd, &ri);
+
+    PointsPush pp{};
+    pp.pts = points_.address;
+    pp.center[0] = center_[0];
+    pp.center[1] = center_[1];
+    pp.origin[0] = float(width) * 0.5f;
+    pp.origin[1] = float(height) * 0.5f;
+    pp.count = points_.count;
+    pp.W = width;
+    pp.H = height;
+    pp.scale = last_scale_;
+    pp.radius = sprite_radius_;
+
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, sprite_);
+    VkViewport vp{0.0f, 0.0f, float(width), float(height), 0.0f, 1.0f};
+    vkCmdSetViewport(cmd, 0, 1, &vp);
+    VkRect2D sc{{0, 0}, {width, height}};
+    vkCmdSetScissor(cmd, 0, 1, &sc);
+    ctx.bindless->push(cmd, &pp, sizeof(pp));
+    vkCmdDraw(cmd, 6, points_.count, 0, 0);
+    vkCmdEndRendering(cmd);
+}
+
+RendererSweep ScatterRenderer::make_timing_sweep()
+{
+    // 密度路径：1M-50M 点下逐点原子 vs subgroup 合并；再在 100k / 1M 点比较光栅圆点与密度图，
+    // 用两点线性拟合估计交点，作为新的 sprite_threshold
+    struct Variant { uint32_t count; Path path; bool aggregate; };
+    std::vector<Variant> variants;
+    for (uint32_t n : {1'000'000u, 10'000'000u, 50'000'000u})
+    {
+        variants.push_back({n, Path::Density, false});
+        if (splat_aggregate_) variants.push_back({n, Path::Density, true});
+    }
+    const size_t crossoverFirst = variants.size();
+    for (uint32_t n : {100'000u, 1'000'000u})
+    {
+        variants.push_back({n, Path::Sprites, false});
+        variants.push_back({n, Path::Density, splat_aggregate_ != VK_NULL_HANDLE});
+    }
+
+    RendererSweep sweep;
+    for (const Variant& v : variants)
+    {
+        char label[64];
+        std::snprintf(label, sizeof(label), "%.1fM points, %s", v.count / 1e6,
+                      v.path == Path::Sprites ? "sprites" : (v.aggregate ? "aggregated atomics" : "atomics"));
+        sweep.steps.push_back({label, [this, v]() {
+            requested_count_ = v.count;
+            path_ = v.path;
+            aggregate_ = v.aggregate;
+        }});
+    }
+    sweep.report = [this, variants, crossoverFirst](const std::vector<double>& ms) {
+        std::string text = "sweep (GPU ms, Mpoints/s):";
+        for (size_t i = 0; i < ms.size() && i < variants.size(); ++i)
+        {
+            const Variant& v = variants[i];
+            char part[96];
+            std::snprintf(part, sizeof(part), "\n  %5.1fM %-18s %8.3f ms %9.1f", v.count / 1e6,
+                          v.path == Path::Sprites ? "sprites" : (v.aggregate ? "aggregated atomics" : "atomics"),
+                          ms[i], ms[i] > 0.0 ? v.count / (ms[i] * 1e3) : 0.0);
+            text += part;
+        }
+        // 各路径耗时近似为 a + b·N：光栅圆点的 b 大，密度图的 a（清空 + 扫描整张图）大
+        if (ms.size() >= crossoverFirst + 4 && ms[crossoverFirst] > 0.0)
+        {
+            const double n0 = variants[crossoverFirst].count, n1 = variants[crossoverFirst + 2].count;
+            const double s0 = ms[crossoverFirst], d0 = ms[crossoverFirst + 1];
+            const double s1 = ms[crossoverFirst + 2], d1 = ms[crossoverFirst + 3];
+            const double sb = (s1 - s0) / (n1 - n0), db = (d1 - d0) / (n1 - n0);
+            const double sa = s0 - sb * n0, da = d0 - db * n0;
+            double crossover = sb > db ? (da - sa) / (sb - db) : 1e7;
+            crossover = std::clamp(crossover, 1e3, 1e7);
+            sprite_threshold_ = uint32_t(crossover);
+            char part[96];
+            std::snprintf(part, sizeof(part), "\n  sprites faster below ~%u points (auto threshold updated)", sprite_threshold_);
+            text += part;
+        }
+        sweep_result_ = text;
+        std::printf("%s\n", text.c_str());
+    };
+    sweep.restore = [this, count = requested_count_, path = path_, aggregate = aggregate_]() {
+        requested_count_ = count;
+        path_ = path;
+        aggregate_ = aggregate;
+        dirty_ = true;
+    };
+    return sweep;
+}
+
+// ==== 资源 ====
+
+void ScatterRenderer::ensure_points(VkCommandBuffer cmd, const RenderContext& ctx)
+{
+    if (points_.buffer && points_.count == requested_count_ && points_.clusters == clusters_) return;
+    // 旧缓冲可能还被在途帧读取
+    if (points_.buffer) ctx.retired->push_buffer(points_.buffer, points_.allocation);
+    points_ = {};
+
+    VkBufferCreateInfo bi{VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+    bi.size = VkDeviceSize(requested_count_) * sizeof(float) * 2;
+    bi.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+    VmaAllocationCreateInfo ai{};
+    ai.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+    VK_CHECK(gpu_memory::create_buffer(ctx.allocator, bi, ai, "Scatter/points", &points_.buffer, &points_.allocation));
+    VkBufferDeviceAddressInfo addrInfo{VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO};
+    addrInfo.buffer = points_.buffer;
+    points_.address = vkGetBufferDeviceAddress(ctx.device, &addrInfo);
+    points_.count = requested_count_;
+    points_.clusters = clusters_;
+
+    GeneratePush gp{points_.address, points_.count, seed_, points_.clusters};
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, generate_);
+    ctx.bindless->push(cmd, &gp, sizeof(gp));
+    vkCmdDispatch(cmd, std::clamp((points_.count + 255) / 256, 1u, MaxGroups), 1, 1);
+    memory_barrier(cmd, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+                   VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT);
+}
+
+void ScatterRenderer::create_density(const RenderContext& ctx, VkExtent2D extent)
+{
+    density_.extent = {std::max(extent.width, 1u), std::max(extent.height, 1u)};
+    VkImageCreateInfo ici = vkinit::image_create_info(VK_FORMAT_R32_UINT,
+                                                      VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+                                                      VkExtent3D{density_.extent.width, density_.extent.height, 1});
+    VmaAllocationCreateInfo ai{};
+    ai.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+    VK_CHECK(gpu_memory::create_image(ctx.allocator, ici, ai, "Scatter/density", &density_.image, &density_.allocation));
+    VkImageViewCreateInfo vci = vkinit::imageview_create_info(VK_FORMAT_R32_UINT, density_.image, VK_IMAGE_ASPECT_COLOR_BIT);
+    VK_CHECK(vkCreateImageView(ctx.device, &vci, nullptr, &density_.view));
+    density_.index = ctx.bindless->add_storage_image(ctx.device, density_.view);
+}
+
+void ScatterRenderer::destroy_density(const RenderContext& ctx)
+{
+    if (density_.index != ~0u) ctx.bindless->release(BindlessHeap::StorageImage, density_.index);
+    if (density_.view) vkDestroyImageView(ctx.device, density_.view, nullptr);
+    if (density_.image) gpu_memory::destroy_image(ctx.allocator, density_.image, density_.allocation);
+    density_ = {};
+}
+
+void ScatterRenderer::create_pipelines(const RenderContext& ctx)
+{
+    // 全部用 bindless 堆的共享 layout：点走设备地址，密度图 / offscreen 走 storage image 句柄
+    layout_ = ctx.bindless->pipelineLayout;
+    generate_ = vkutil::create_compute_pipeline(ctx.device, layout_, "shaders/scatter_generate.comp.spv");
+    splat_ = vkutil::create_compute_pipeline(ctx.device, layout_, "shaders/scatter_splat.comp.spv");
+    // subgroup 变体的模块声明了 ballot 能力，设备不支持时不能创建
+    if (ctx.caps.subgroupBallot)
+    {
+        splat_aggregate_ = vkutil::create_compute_pipeline(ctx.device, layout_, "shaders/scatter_splat.subgroup.comp.spv");
+        subgroup_size_ = ctx.caps.subgroupSize;
+    }
+    max_ = vkutil::create_compute_pipeline(ctx.device, layout_, "shaders/scatter_max.comp.spv");
+    shade_ = vkutil::create_compute_pipeline(ctx.device, layout_,
+        (std::string("shaders/scatter_shade") + offscreen_shader_variant(ctx.offscreenFormat) + ".comp.spv").c_str());
+
+    VkShaderModule vs{}, fs{};
+    if (!vkutil::load_shader_module("./shaders/scatter_sprite.vert.spv", ctx.device, &vs) ||
+        !vkutil::load_shader_module("./shaders/scatter_sprite.frag.spv", ctx.device, &fs))
+        throw std::runtime_error("Failed to load scatter_sprite shaders");
+    PipelineBuilder pb;
+    pb._pipelineLayout = layout_;
+    pb.set_shaders(vs, fs);
+    pb.set_input_topology(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST);
+    pb.set_polygon_mode(VK_POLYGON_MODE_FILL);
+    pb.set_cull_mode(VK_CULL_MODE_NONE, VK_FRONT_FACE_CLOCKWISE);
+    pb.set_multisampling_none();
+    pb.enable_blending_alphablend();
+    pb.disable_depthtest();
+    pb.set_color_attachment_format(ctx.offscreenFormat);
+    pb.set_depth_format(VK_FORMAT_UNDEFINED);
+    sprite_ = pb.build_pipeline(ctx.device);
+    vkDestroyShaderModule(ctx.device, vs, nullptr);
+    vkDestroyShaderModule(ctx.device, fs, nullptr);
+}
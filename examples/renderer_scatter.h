@@ -0,0 +1,97 @@
+#ifndef RENDERER_SCATTER_H
+#define RENDERER_SCATTER_H
+
+#include <vulkan/vulkan.h>
+#include <string>
+#include <string_view>
+#include "src/renderer_iface.h"
+#include "src/ext/vk_bindless.h"
+#include "vk_mem_alloc.h"
+
+// 百万级散点：点坐标常驻 GPU（由 compute 合成），每帧把所有点用图像原子操作累加进一张
+// R32_UINT 密度图（每像素一个计数），再取最大值做对数归一化、经 viridis 色表写进 offscreen。
+// 代价是 O(点数) 次原子加 + O(像素) 次着色，与重叠程度无关。设备支持 subgroup ballot 时，
+// 同一 subgroup 里落在同一像素的点先合并成一次原子加（密集簇里争用大幅下降）。
+// 点数少于 sprite_threshold 时改为实例化画抗锯齿圆点，此时光栅比清空 + 扫描整张密度图更省。
+class ScatterRenderer final : public IRenderer
+{
+public:
+    ScatterRenderer();
+    ~ScatterRenderer() override = default;
+
+    void initialize(const RenderContext& ctx) override;
+    void destroy(const RenderContext& ctx) override;
+    void record(VkCommandBuffer cmd, uint32_t width, uint32_t height, const RenderContext& ctx) override;
+    void on_swapchain_resized(const RenderContext& ctx) override;
+    void on_imgui() override;
+    // 点是静态的：只有参数或视图变化时重画
+    bool needs_redraw() override { const bool d = dirty_; dirty_ = false; return d; }
+    VkFormat preferred_offscreen_format() const override { return VK_FORMAT_R8G8B8A8_UNORM; }
+    // points / clusters / path=auto|density|sprites / aggregate=0|1 / sprite_threshold
+    bool set_option(std::string_view key, std::string_view value) override;
+
+    enum class Path { Auto, Density, Sprites };
+
+    const char* timing_sweep_label() const override { return "Sweep scatter paths (100k-50M points)"; }
+    RendererSweep make_timing_sweep() override;
+
+private:
+    // —— 点缓冲（scatter_common.glsl 的 ScatterPoints）——
+    struct Points {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VmaAllocation allocation{};
+        VkDeviceAddress address = 0;
+        uint32_t count = 0;    // 缓冲里已生成的点数
+        uint32_t clusters = 0;
+    } points_;
+    uint32_t requested_count_ = 1'000'000;
+    uint32_t clusters_ = 24;
+    uint32_t seed_ = 0x5CA77E5u;
+
+    // —— 密度图（R32_UINT，bindless storage image）——
+    struct Density {
+        VkImage image = VK_NULL_HANDLE;
+        VmaAllocation allocation{};
+        VkImageView view = VK_NULL_HANDLE;
+        uint32_t index = ~0u;
+        VkExtent2D extent{};
+    } density_;
+
+    // —— 管线 ——
+    VkPipelineLayout layout_ = VK_NULL_HANDLE; // bindless 堆的共享 layout，不归本类销毁
+    VkPipeline generate_ = VK_NULL_HANDLE;
+    VkPipeline splat_ = VK_NULL_HANDLE;
+    VkPipeline splat_aggregate_ = VK_NULL_HANDLE; // 仅 caps.subgroupBallot
+    uint32_t subgroup_size_ = 0;
+    VkPipeline max_ = VK_NULL_HANDLE;
+    VkPipeline shade_ = VK_NULL_HANDLE;
+    VkPipeline sprite_ = VK_NULL_HANDLE;
+    static constexpr uint32_t MaxGroups = 65535; // maxComputeWorkGroupCount[0] 的保证下限，其余由网格步进覆盖
+
+    // —— 参数 ——
+    Path path_ = Path::Auto;
+    bool aggregate_ = true;
+    bool dirty_ = true;
+    uint32_t sprite_threshold_ = 100'000;
+    float sprite_radius_ = 1.5f;
+    float exposure_ = 1.0f;
+    // 视图：数据坐标 center 处于屏幕中心，zoom = 1 时 [-1.1, 1.1] 正好填满短边
+    float center_[2] = {0.0f, 0.0f};
+    float zoom_ = 1.0f;
+    float last_scale_ = 1.0f; // 最近一帧的像素/单位（鼠标平移换算用）
+    bool last_sprites_ = false;
+
+    std::string sweep_result_;
+
+    bool use_sprites() const;
+    float pixel_scale(uint32_t width, uint32_t height) const;
+    void create_pipelines(const RenderContext& ctx);
+    void create_density(const RenderContext& ctx, VkExtent2D extent);
+    void destroy_density(const RenderContext& ctx);
+    // 点数或簇数变化时换一块点缓冲（旧的交给 retired）并在 cmd 里重新生成
+    void ensure_points(VkCommandBuffer cmd, const RenderContext& ctx);
+    void record_density(VkCommandBuffer cmd, uint32_t width, uint32_t height, const RenderContext& ctx);
+    void record_sprites(VkCommandBuffer cmd, uint32_t width, uint32_t height, const RenderContext& ctx);
+};
+
+#endif //RENDERER_SCATTER_H
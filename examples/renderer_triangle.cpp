@@ -25,7 +25,7 @@ void TriangleRenderer::initialize(const RenderContext& ctx)
     }
 
     // 3) 用 PipelineBuilder 生成图形管线（Dynamic Rendering）
-    //    目标颜色格式 = offscreen 的格式：R16G16B16A16_SFLOAT（由 Engine 创建）
+    //    目标颜色格式 = offscreen 的格式（由 Engine 创建，见 ctx.offscreenFormat）
     {
         PipelineBuilder pb;
         pb._pipelineLayout = pipelineLayout_;
@@ -37,7 +37,7 @@ void TriangleRenderer::initialize(const RenderContext& ctx)
         pb.disable_blending();
         pb.disable_depthtest(); // 目前不启用深度
 
-        pb.set_color_attachment_format(VK_FORMAT_R16G16B16A16_SFLOAT);
+        pb.set_color_attachment_format(ctx.offscreenFormat);
         pb.set_depth_format(VK_FORMAT_UNDEFINED);
 
         pipeline_ = pb.build_pipeline(ctx.device);
@@ -51,11 +51,11 @@ void TriangleRenderer::record(VkCommandBuffer cmd,
                               uint32_t width, uint32_t height,
                               const RenderContext& ctx)
 {
-    // --- A. 把 offscreen 切到 ColorAttachment ---
+    // --- A. 把 offscreen 切到 GENERAL（可直接作 ColorAttachment，结束后也无需再转） ---
     vkutil::transition_image(cmd,
                              ctx.offscreenImage,
                              VK_IMAGE_LAYOUT_UNDEFINED,
-                             VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+                             VK_IMAGE_LAYOUT_GENERAL);
 
     // --- B. Dynamic Rendering 画三角形到 offscreen ---
     VkClearValue clear{};
@@ -63,7 +63,7 @@ void TriangleRenderer::record(VkCommandBuffer cmd,
 
     VkRenderingAttachmentInfo color{VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO};
     color.imageView   = ctx.offscreenImageView;
-    color.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    color.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
     color.loadOp      = VK_ATTACHMENT_LOAD_OP_CLEAR;
     color.storeOp     = VK_ATTACHMENT_STORE_OP_STORE;
     color.clearValue  = clear;
@@ -97,25 +97,7 @@ void TriangleRenderer::record(VkCommandBuffer cmd,
 
     vkCmdEndRendering(cmd);
 
-    // --- C. 拷到 swapchain ---
-    vkutil::transition_image(cmd,
-                             ctx.offscreenImage,
-                             VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
-                             VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
-
-    vkutil::transition_image(cmd,
-                             ctx.swapchainImage,
-                             VK_IMAGE_LAYOUT_UNDEFINED,
-                             VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-
-    vkutil::copy_image_to_image(cmd,
-                                ctx.offscreenImage,
-                                ctx.swapchainImage,
-                                VkExtent2D{width, height},
-                                VkExtent2D{width, height});
-
-    // 注意：保持 swapchain 在 TRANSFER_DST_OPTIMAL，
-    // 你的 ImGuiLayer 会基于此转到 COLOR_ATTACHMENT 再绘制，并最终转 PRESENT。
+    // 注意：offscreen 保持在 GENERAL，由 Engine 的 composite pass 采样到 swapchain 并叠加 ImGui
 }
 
 void TriangleRenderer::destroy(const RenderContext& ctx)
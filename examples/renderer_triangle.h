@@ -13,6 +13,8 @@ public:
     void destroy(const RenderContext& ctx) override;
     void on_swapchain_resized(const RenderContext& ctx) override;
     void on_imgui() override;
+    // 静态画面：只有引擎侧的 resize / 切换需要重画
+    bool needs_redraw() override { return false; }
 
 private:
     VkPipelineLayout pipelineLayout_{};
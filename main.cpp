@@ -1,14 +1,69 @@
 #include "src/vk_engine.h"
 
-int main()
+#include <charconv>
+#include <cstdio>
+#include <string_view>
+
+namespace
 {
+    void print_usage(const char* exe)
+    {
+        std::fprintf(stderr,
+                     "usage: %s [--renderer NAME] [--set key=value]... [--bench FRAMES]\n"
+                     "  --renderer NAME   start with an example renderer (compute_bg, mesh, barchart, linechart, scatter, heatmap, dashboard, ...)\n"
+                     "  --set key=value   renderer option applied before initialisation (repeatable)\n"
+                     "  --bench FRAMES    hidden window, render FRAMES frames without presenting and print timings\n",
+                     exe);
+    }
+
+    bool parse_args(int argc, char** argv, LaunchOptions& options)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string_view arg = argv[i];
+            const bool hasValue = i + 1 < argc;
+            if (arg == "--renderer" && hasValue)
+            {
+                options.renderer = argv[++i];
+            }
+            else if (arg == "--set" && hasValue)
+            {
+                const std::string_view kv = argv[++i];
+                const size_t eq = kv.find('=');
+                if (eq == std::string_view::npos || eq == 0) return false;
+                options.settings.emplace_back(std::string(kv.substr(0, eq)), std::string(kv.substr(eq + 1)));
+            }
+            else if (arg == "--bench" && hasValue)
+            {
+                const std::string_view n = argv[++i];
+                auto [ptr, ec] = std::from_chars(n.data(), n.data() + n.size(), options.benchFrames);
+                if (ec != std::errc() || ptr != n.data() + n.size() || options.benchFrames == 0) return false;
+            }
+            else
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    LaunchOptions options;
+    if (!parse_args(argc, argv, options))
+    {
+        print_usage(argv[0]);
+        return 2;
+    }
+
     VulkanEngine engine;
 
-    engine.init();
+    engine.init(options);
 
-    engine.run();
+    const int code = options.benchFrames > 0 ? engine.run_benchmark() : (engine.run(), 0);
 
     engine.cleanup();
 
-    return 0;
-}
\ No newline at end of file
+    return code;
+}
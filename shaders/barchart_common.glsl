@@ -0,0 +1,36 @@
+// Bar chart data layout and styling shared by barchart.comp (per-pixel compute) and
+// barchart_raster.vert (instanced quads), see examples/renderer_barchart.h.
+#ifndef BARCHART_COMMON_GLSL
+#define BARCHART_COMMON_GLSL
+
+#extension GL_EXT_buffer_reference : require
+
+// 柱子数据：values[bar * series_count + series]，由 BarChartRenderer 上传
+layout(buffer_reference, std430, buffer_reference_align = 4) readonly buffer BarValues { float v[]; };
+
+// 与 BarChartRenderer::Layout 一致
+#define LAYOUT_GROUPED 0u
+#define LAYOUT_STACKED 1u
+
+// 简单配色
+vec4 background_color() { return vec4(0.08, 0.09, 0.10, 1.0); }
+vec4 axis_color()       { return vec4(0.75, 0.75, 0.78, 1.0); }
+vec4 bar_color(uint i, uint n) {
+    // 单序列：按柱子索引做一个淡变化
+    float t = n > 1u ? float(i) / float(n - 1u) : 0.0;
+    return vec4(0.30 + 0.35 * t, 0.45, 0.85 - 0.45 * t, 1.0);
+}
+vec4 series_color(uint s) {
+    // 多序列：固定色板循环
+    const vec3 palette[6] = vec3[6](vec3(0.30, 0.45, 0.85), vec3(0.90, 0.55, 0.25), vec3(0.35, 0.75, 0.45),
+                                    vec3(0.85, 0.35, 0.40), vec3(0.60, 0.45, 0.80), vec3(0.85, 0.80, 0.35));
+    return vec4(palette[s % 6u], 1.0);
+}
+
+// 值 → 像素高度
+float bar_height(float v, float innerH, float maxValue) { return innerH * clamp(v / maxValue, 0.0, 1.0); }
+
+// 槽宽很窄时间隙随之收缩，柱子至少 1 像素宽
+float bar_gap(float slotW, float gapPx) { return min(gapPx, slotW * 0.25); }
+
+#endif // BARCHART_COMMON_GLSL
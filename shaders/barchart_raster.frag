@@ -0,0 +1,10 @@
+#version 460
+
+// 光栅路径：颜色在顶点阶段按柱子/序列算好，这里只输出
+layout(location = 0) flat in vec4 inColor;
+layout(location = 0) out vec4 outFragColor;
+
+void main()
+{
+    outFragColor = inColor;
+}
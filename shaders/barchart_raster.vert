@@ -0,0 +1,66 @@
+#version 460
+#extension GL_GOOGLE_include_directive : require
+
+// 光栅路径：每根柱子（多序列时每一段）一个实例，6 个顶点拼成一个矩形，
+// 数据与 barchart.comp 一样通过设备地址直接从数据缓冲读取（vertex pulling）
+#include "barchart_common.glsl"
+
+layout(push_constant) uniform Push {
+    uint W;
+    uint H;
+    float margin_px;
+    float gap_px;
+    float base_line_px;
+    float max_value;
+    BarValues values;
+    uint bar_count;
+    uint series_count;
+    uint layout_mode; // LAYOUT_GROUPED / LAYOUT_STACKED
+} pc;
+
+layout(location = 0) flat out vec4 outColor;
+
+// 两个三角形的角点（0/1 表示左右、下上）
+const vec2 corners[6] = vec2[6](vec2(0, 0), vec2(1, 0), vec2(0, 1), vec2(0, 1), vec2(1, 0), vec2(1, 1));
+
+void main()
+{
+    uint S = max(pc.series_count, 1u);
+    uint bar = uint(gl_InstanceIndex) / S;
+    uint s = uint(gl_InstanceIndex) % S;
+    uint base = bar * S;
+
+    // 与 barchart.comp 相同的几何
+    float innerW = float(pc.W) - 2.0 * pc.margin_px;
+    float innerH = float(pc.H) - pc.margin_px - pc.base_line_px;
+    float slotW = innerW / float(pc.bar_count);
+    float gap = bar_gap(slotW, pc.gap_px);
+    float barW = max(1.0, slotW - gap);
+    float axis_y = float(int(pc.H) - int(pc.base_line_px));
+
+    float x0 = pc.margin_px + float(bar) * slotW + gap * 0.5;
+    float x1 = x0 + barW;
+    float lo = 0.0; // 轴线以上的像素高度
+    float hi;
+    if (S > 1u && pc.layout_mode == LAYOUT_STACKED) {
+        float acc = 0.0;
+        for (uint k = 0u; k < s; ++k) acc += max(pc.values.v[base + k], 0.0);
+        lo = bar_height(acc, innerH, pc.max_value);
+        hi = bar_height(acc + max(pc.values.v[base + s], 0.0), innerH, pc.max_value);
+        outColor = series_color(s);
+    } else if (S > 1u) {
+        float subW = barW / float(S);
+        x0 += float(s) * subW;
+        x1 = x0 + subW;
+        hi = bar_height(pc.values.v[base + s], innerH, pc.max_value);
+        outColor = series_color(s);
+    } else {
+        hi = bar_height(pc.values.v[base], innerH, pc.max_value);
+        outColor = bar_color(bar, pc.bar_count);
+    }
+
+    // compute 路径包含轴线那一行（d <= h），矩形底边下移 1 像素
+    vec2 c = corners[gl_VertexIndex];
+    vec2 px = vec2(mix(x0, x1, c.x), axis_y + 1.0 - mix(lo, hi, c.y));
+    gl_Position = vec4(px / vec2(pc.W, pc.H) * 2.0 - 1.0, 0.0, 1.0);
+}
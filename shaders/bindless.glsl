@@ -0,0 +1,44 @@
+// Global bindless heap, see src/ext/vk_bindless.h for the C++ side.
+// Resources are addressed by 32-bit indices passed through push constants.
+#ifndef BINDLESS_GLSL
+#define BINDLESS_GLSL
+
+#extension GL_EXT_nonuniform_qualifier : require
+#ifdef BINDLESS_SAMPLED_ARRAYS
+#extension GL_EXT_samplerless_texture_functions : require
+#endif
+
+// Shaders that only touch the offscreen target through the heap follow its format variant
+#ifndef BINDLESS_STORAGE_IMAGE_FORMAT
+#ifdef OFFSCREEN_FORMAT
+#define BINDLESS_STORAGE_IMAGE_FORMAT OFFSCREEN_FORMAT
+#else
+#define BINDLESS_STORAGE_IMAGE_FORMAT rgba16f
+#endif
+#endif
+
+#ifdef BINDLESS_STORAGE_IMAGE_WRITEONLY
+// Direct-present variants write swapchain images, whose BGRA format has no GLSL qualifier
+// (needs shaderStorageImageWriteWithoutFormat; imageLoad is not available)
+layout(set = 0, binding = 0) writeonly uniform image2D g_storage_images[];
+#else
+layout(set = 0, binding = 0, BINDLESS_STORAGE_IMAGE_FORMAT) uniform image2D g_storage_images[];
+#endif
+#ifdef BINDLESS_UINT_IMAGES
+// r32ui view of the same binding for counters / density images (image atomics)
+layout(set = 0, binding = 0, r32ui) uniform uimage2D g_storage_uimages[];
+#define BINDLESS_UIMAGE(idx) g_storage_uimages[nonuniformEXT(idx)]
+#endif
+layout(set = 0, binding = 1) uniform texture2D g_sampled_images[];
+#ifdef BINDLESS_SAMPLED_ARRAYS
+// 2D-array view of the same binding (layered caches such as tile arrays), read with texelFetch
+layout(set = 0, binding = 1) uniform texture2DArray g_sampled_arrays[];
+#define BINDLESS_TEXTURE_ARRAY(idx) g_sampled_arrays[nonuniformEXT(idx)]
+#endif
+layout(set = 0, binding = 2) uniform sampler g_samplers[];
+layout(set = 0, binding = 3, std430) buffer GlobalStorageBuffer { uint words[]; } g_storage_buffers[];
+
+#define BINDLESS_IMAGE(idx) g_storage_images[nonuniformEXT(idx)]
+#define BINDLESS_TEXTURE(tex, smp) sampler2D(g_sampled_images[nonuniformEXT(tex)], g_samplers[nonuniformEXT(smp)])
+
+#endif // BINDLESS_GLSL
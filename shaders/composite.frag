@@ -0,0 +1,32 @@
+#version 460
+#extension GL_GOOGLE_include_directive : require
+
+#include "bindless.glsl"
+
+layout(location = 0) in vec2 inUV;
+layout(location = 0) out vec4 outColor;
+
+// Must match composite.vert and CompositePass::record
+layout(push_constant) uniform Push {
+    uint texture_index;
+    uint sampler_index;
+    vec2 uv_scale;
+    float exposure;
+    uint tonemap;
+} pc;
+
+// Krzysztof Narkowicz's fit of the ACES filmic curve
+vec3 aces_fit(vec3 x)
+{
+    const float a = 2.51, b = 0.03, c = 2.43, d = 0.59, e = 0.14;
+    return clamp((x * (a * x + b)) / (x * (c * x + d) + e), 0.0, 1.0);
+}
+
+void main()
+{
+    vec4 src = texture(BINDLESS_TEXTURE(pc.texture_index, pc.sampler_index), inUV);
+    vec3 c = src.rgb * pc.exposure;
+    if (pc.tonemap == 1u) c = c / (1.0 + c);
+    else if (pc.tonemap == 2u) c = aces_fit(c);
+    outColor = vec4(clamp(c, 0.0, 1.0), src.a);
+}
@@ -0,0 +1,19 @@
+#version 460
+
+// Engine composite pass: one triangle that covers the whole swapchain image.
+layout(location = 0) out vec2 outUV;
+
+layout(push_constant) uniform Push {
+    uint texture_index; // offscreen target as a bindless sampled image
+    uint sampler_index;
+    vec2 uv_scale;      // rendered region of the offscreen target / its full size
+    float exposure;
+    uint tonemap;       // 0 = clamp, 1 = Reinhard, 2 = ACES fit
+} pc;
+
+void main()
+{
+    const vec2 uv = vec2((gl_VertexIndex << 1) & 2, gl_VertexIndex & 2);
+    gl_Position = vec4(uv * 2.0 - 1.0, 0.0, 1.0);
+    outUV = uv * pc.uv_scale;
+}
@@ -0,0 +1,25 @@
+// Damage-tile dispatch, see src/damage_region.h for the C++ side.
+// Full frames dispatch a grid over the whole target; partial frames dispatch one 16x16
+// workgroup per dirty tile and read the tile's pixel origin from a scratch buffer. Tile
+// lists longer than maxComputeWorkGroupCount[0] wrap into a 2D grid (DamageRegion::tile_groups).
+#ifndef DAMAGE_TILES_GLSL
+#define DAMAGE_TILES_GLSL
+
+#extension GL_EXT_buffer_reference : require
+
+// Must match DamageRegion::TileSize and the including shader's local size
+#define DAMAGE_TILE_SIZE 16
+
+layout(buffer_reference, std430, buffer_reference_align = 8) readonly buffer DamageTileList { uvec2 origin[]; };
+
+// tileCount == 0 means a full-frame dispatch (the tile list is not read). Padding groups
+// of the last grid row return a pixel past any target, so the caller's bounds check drops them.
+ivec2 damage_pixel(uint tileCount, DamageTileList tiles)
+{
+    if (tileCount == 0u) return ivec2(gl_GlobalInvocationID.xy);
+    uint tile = gl_WorkGroupID.y * gl_NumWorkGroups.x + gl_WorkGroupID.x;
+    if (tile >= tileCount) return ivec2(0x7FFFFFFF);
+    return ivec2(tiles.origin[tile] + gl_LocalInvocationID.xy);
+}
+
+#endif // DAMAGE_TILES_GLSL
@@ -0,0 +1,78 @@
+// Dashboard compositor shared by dashboard_{line,bars,heat}.comp, see examples/renderer_dashboard.h
+// for the C++ side. Every kernel shades 16x16-pixel tiles of panels: in batched mode one workgroup
+// per work item (panel, tile) of its chart type, in per-panel mode one full-screen dispatch per panel.
+#ifndef DASHBOARD_COMMON_GLSL
+#define DASHBOARD_COMMON_GLSL
+
+#extension GL_EXT_buffer_reference : require
+
+#define DASHBOARD_TILE 16
+#define DASHBOARD_INSET 6
+#define DASHBOARD_NO_PANEL 0xFFFFFFFFu
+
+layout(local_size_x = DASHBOARD_TILE, local_size_y = DASHBOARD_TILE, local_size_z = 1) in;
+
+layout(buffer_reference, std430, buffer_reference_align = 4) readonly buffer DashboardValues { float v[]; };
+
+// 64 字节，与 renderer_dashboard.cpp 的 GpuPanel 一致
+struct DashboardPanel {
+    DashboardValues values; // 该面板的数据（任意缓冲的设备地址）
+    ivec4 rect;             // x, y, w, h（像素）
+    vec2 range;             // 映射到绘图区上下沿的值
+    uint count;
+    uint chart;             // DashboardRenderer::Chart
+    vec4 color;
+};
+layout(buffer_reference, std430, buffer_reference_align = 16) readonly buffer DashboardPanels { DashboardPanel p[]; };
+// 工作项：面板下标，面板内块坐标 tx | ty << 16
+layout(buffer_reference, std430, buffer_reference_align = 8) readonly buffer DashboardItems { uvec2 item[]; };
+
+layout(push_constant) uniform Push {
+    DashboardPanels panels;
+    DashboardItems items;
+    uint item_count;
+    uint image_index;    // offscreen 的 bindless storage image 句柄
+    uint panel_override; // 逐面板模式：本次派发覆盖整屏，只画这个面板
+    uint W;
+    uint H;
+} pc;
+
+// 当前调用负责的面板与像素；落在面板或屏幕外时返回 false
+bool dashboard_pixel(out DashboardPanel panel, out ivec2 local, out ivec2 pixel)
+{
+    if (pc.panel_override != DASHBOARD_NO_PANEL) {
+        panel = pc.panels.p[pc.panel_override];
+        pixel = ivec2(gl_WorkGroupID.xy) * DASHBOARD_TILE + ivec2(gl_LocalInvocationID.xy);
+    } else {
+        uint wg = gl_WorkGroupID.x + gl_WorkGroupID.y * gl_NumWorkGroups.x;
+        if (wg >= pc.item_count) return false;
+        uvec2 it = pc.items.item[wg];
+        panel = pc.panels.p[it.x];
+        ivec2 tile = ivec2(it.y & 0xFFFFu, it.y >> 16);
+        pixel = panel.rect.xy + tile * DASHBOARD_TILE + ivec2(gl_LocalInvocationID.xy);
+    }
+    local = pixel - panel.rect.xy;
+    return all(greaterThanEqual(local, ivec2(0))) && all(lessThan(local, panel.rect.zw)) &&
+           pixel.x < int(pc.W) && pixel.y < int(pc.H);
+}
+
+// 面板底色 + 1 像素边框；在绘图区内时返回 true，plot 为绘图区像素坐标（y 向上）
+bool dashboard_plot(DashboardPanel panel, ivec2 local, out ivec2 plot, out ivec2 plot_size, out vec4 color)
+{
+    ivec2 size = panel.rect.zw;
+    plot_size = max(size - 2 * DASHBOARD_INSET, ivec2(1));
+    plot = ivec2(local.x - DASHBOARD_INSET, size.y - 1 - DASHBOARD_INSET - local.y);
+    color = vec4(0.11, 0.11, 0.13, 1.0);
+    if (local.x == 0 || local.y == 0 || local.x == size.x - 1 || local.y == size.y - 1) {
+        color = vec4(0.24, 0.24, 0.28, 1.0);
+        return false;
+    }
+    return all(greaterThanEqual(plot, ivec2(0))) && all(lessThan(plot, plot_size));
+}
+
+float dashboard_norm(DashboardPanel panel, float v)
+{
+    return clamp((v - panel.range.x) / (panel.range.y - panel.range.x), 0.0, 1.0);
+}
+
+#endif // DASHBOARD_COMMON_GLSL
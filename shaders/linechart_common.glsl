@@ -0,0 +1,53 @@
+// Streaming line chart shared by linechart_reduce.comp, linechart.comp and the raster
+// variant, see examples/renderer_linechart.h for the C++ side.
+#ifndef LINECHART_COMMON_GLSL
+#define LINECHART_COMMON_GLSL
+
+#extension GL_EXT_buffer_reference : require
+
+// 每条序列一段环形缓冲：ring.v[series * capacity + slot]
+layout(buffer_reference, std430, buffer_reference_align = 4) readonly buffer SampleRing { float v[]; };
+
+// 每列每序列的包络（像素 y）：x = 顶端，y = 底端；x > y 表示该列没有数据
+layout(buffer_reference, std430, buffer_reference_align = 8) buffer ColumnEnvelope { vec2 e[]; };
+
+// min/max 金字塔：第 l 层（l >= 1）每个节点汇总 8^l 个连续样本，count 为其中已写入的样本数。
+// 每条序列占 pyramid_stride() 个节点，层内同样按环排列：节点 = (slot >> 3l) & ((capacity >> 3l) - 1)
+struct MinMaxCount { float lo; float hi; uint count; };
+layout(buffer_reference, std430, buffer_reference_align = 4) buffer MinMaxPyramid { MinMaxCount n[]; };
+
+const uint PYRAMID_FANOUT_LOG2 = 3u;
+
+// 一条序列内第 level 层之前的节点数；level = levels + 1 即每条序列的节点总数
+uint pyramid_level_offset(uint capacity, uint level)
+{
+    uint o = 0u;
+    for (uint j = 1u; j < level; ++j) o += capacity >> (PYRAMID_FANOUT_LOG2 * j);
+    return o;
+}
+
+// 降采样后的折线点（linechart_m4.comp / linechart_lttb.comp 输出，按 index 非降序）：
+// index 为相对视窗起点的样本下标；每条序列占 stride 个点
+struct DownsamplePoint { uint index; float value; };
+layout(buffer_reference, std430, buffer_reference_align = 8) buffer DownsamplePoints { DownsamplePoint p[]; };
+
+vec4 chart_background() { return vec4(0.08, 0.09, 0.10, 1.0); }
+vec4 chart_axis()       { return vec4(0.75, 0.75, 0.78, 1.0); }
+
+// 序列颜色：黄金角步进色相，64 条线也能分得开
+vec3 series_rgb(uint s)
+{
+    float h = fract(float(s) * 0.618034 + 0.55);
+    vec3 k = clamp(abs(fract(h + vec3(0.0, 2.0 / 3.0, 1.0 / 3.0)) * 6.0 - 3.0) - 1.0, 0.0, 1.0);
+    return mix(vec3(1.0), k, 0.65) * 0.95;
+}
+
+// 到竖直包络 [top, bottom] 的像素距离 → 覆盖率（线宽 2 * halfWidth，1 像素过渡）
+float envelope_coverage(vec2 env, float py, float halfWidth)
+{
+    if (env.x > env.y) return 0.0;
+    float d = max(max(env.x - py, py - env.y), 0.0);
+    return clamp(halfWidth + 0.5 - d, 0.0, 1.0);
+}
+
+#endif // LINECHART_COMMON_GLSL
@@ -0,0 +1,29 @@
+#version 460
+#extension GL_GOOGLE_include_directive : require
+
+#include "linechart_common.glsl"
+
+layout(push_constant) uniform Push {
+    ColumnEnvelope env;
+    uint W;
+    uint H;
+    uint image_index;
+    uint series_count;
+    uint plot_x;
+    uint plot_w;
+    float plot_y;
+    float plot_h;
+    float half_width;
+} pc;
+
+layout(location = 0) flat in vec2 inEnvelope;
+layout(location = 1) flat in vec3 inColor;
+layout(location = 0) out vec4 outFragColor;
+
+void main()
+{
+    // 与 linechart.comp 相同的覆盖率，交给 alpha 混合叠加
+    float a = envelope_coverage(inEnvelope, gl_FragCoord.y, pc.half_width);
+    if (a <= 0.0) discard;
+    outFragColor = vec4(inColor, a);
+}
@@ -0,0 +1,41 @@
+#version 460
+#extension GL_GOOGLE_include_directive : require
+
+// 光栅路径：每列 × 每条序列一个实例，矩形覆盖包络加上线宽，覆盖率在片元里算
+#include "linechart_common.glsl"
+
+layout(push_constant) uniform Push {
+    ColumnEnvelope env;
+    uint W;
+    uint H;
+    uint image_index;  // 未使用，与 linechart.comp 共用同一 push 布局
+    uint series_count;
+    uint plot_x;
+    uint plot_w;
+    float plot_y;
+    float plot_h;
+    float half_width;
+} pc;
+
+layout(location = 0) flat out vec2 outEnvelope;
+layout(location = 1) flat out vec3 outColor;
+
+const vec2 corners[6] = vec2[6](vec2(0, 0), vec2(1, 0), vec2(0, 1), vec2(0, 1), vec2(1, 0), vec2(1, 1));
+
+void main()
+{
+    uint s = uint(gl_InstanceIndex) / pc.plot_w;
+    uint c = uint(gl_InstanceIndex) % pc.plot_w;
+    vec2 env = pc.env.e[gl_InstanceIndex];
+    outEnvelope = env;
+    outColor = series_rgb(s);
+
+    // 空列退化成零面积
+    float pad = pc.half_width + 1.0;
+    vec2 lo = vec2(float(pc.plot_x + c), env.x - pad);
+    vec2 hi = vec2(lo.x + 1.0, env.y + pad);
+    if (env.x > env.y) hi = lo;
+
+    vec2 px = mix(lo, hi, corners[gl_VertexIndex]);
+    gl_Position = vec4(px / vec2(pc.W, pc.H) * 2.0 - 1.0, 0.0, 1.0);
+}
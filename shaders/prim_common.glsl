@@ -0,0 +1,105 @@
+// Compute primitives shared by the prim_*.comp kernels, see src/ext/vk_compute_primitives.h
+// for the C++ side. Every kernel runs PRIM_WG invocations per workgroup; the SUBGROUP_OPS
+// variants (foo.subgroup.comp.spv) reduce/scan inside a subgroup first and only combine the
+// per-subgroup results through shared memory, the plain variants use shared-memory trees.
+#ifndef PRIM_COMMON_GLSL
+#define PRIM_COMMON_GLSL
+
+#extension GL_EXT_buffer_reference : require
+#ifdef SUBGROUP_OPS
+#extension GL_KHR_shader_subgroup_basic : require
+#extension GL_KHR_shader_subgroup_arithmetic : require
+#extension GL_KHR_shader_subgroup_ballot : require
+#endif
+
+#define PRIM_WG 256u
+#define PRIM_ITEMS 4u                     // scan / compaction: contiguous items per invocation
+#define PRIM_BLOCK (PRIM_WG * PRIM_ITEMS) // scan / compaction: items per workgroup
+
+layout(buffer_reference, std430, buffer_reference_align = 4) buffer PrimFloats { float v[]; };
+layout(buffer_reference, std430, buffer_reference_align = 4) buffer PrimUints { uint v[]; };
+layout(buffer_reference, std430, buffer_reference_align = 16) buffer PrimVec4s { vec4 v[]; };
+
+// Scan / compaction dispatch 2D grids so more than 65535 blocks fit
+uint prim_block_id() { return gl_WorkGroupID.y * gl_NumWorkGroups.x + gl_WorkGroupID.x; }
+
+#ifdef PRIM_NEED_SCAN
+shared uint s_scan[PRIM_WG];
+shared uint s_scan_total;
+
+// Workgroup-wide exclusive prefix sum; every invocation must call it (uniform control flow)
+uint prim_exclusive_scan(uint v, out uint total)
+{
+#ifdef SUBGROUP_OPS
+    uint incl = subgroupInclusiveAdd(v);
+    uint sub_total = subgroupAdd(v); // no assumption that the last lane is active
+    if (subgroupElect()) s_scan[gl_SubgroupID] = sub_total;
+    barrier();
+    if (gl_LocalInvocationIndex == 0u) {
+        uint run = 0u;
+        for (uint i = 0u; i < gl_NumSubgroups; ++i) {
+            uint t = s_scan[i];
+            s_scan[i] = run;
+            run += t;
+        }
+        s_scan_total = run;
+    }
+    barrier();
+    uint r = s_scan[gl_SubgroupID] + incl - v;
+    total = s_scan_total;
+    barrier(); // s_scan is reused by the next call
+    return r;
+#else
+    uint i = gl_LocalInvocationIndex;
+    s_scan[i] = v;
+    barrier();
+    for (uint off = 1u; off < PRIM_WG; off <<= 1) {
+        uint add = i >= off ? s_scan[i - off] : 0u;
+        barrier();
+        s_scan[i] += add;
+        barrier();
+    }
+    uint incl = s_scan[i];
+    total = s_scan[PRIM_WG - 1u];
+    barrier();
+    return incl - v;
+#endif
+}
+#endif // PRIM_NEED_SCAN
+
+#ifdef PRIM_NEED_REDUCE
+// (min, max, sum, sum of squares)
+vec4 prim_identity() { return vec4(uintBitsToFloat(0x7f800000u), uintBitsToFloat(0xff800000u), 0.0, 0.0); }
+vec4 prim_combine(vec4 a, vec4 b) { return vec4(min(a.x, b.x), max(a.y, b.y), a.z + b.z, a.w + b.w); }
+
+shared vec4 s_reduce[PRIM_WG];
+
+// Workgroup-wide (min, max, sum, sum of squares); every invocation must call it
+vec4 prim_reduce(vec4 v)
+{
+#ifdef SUBGROUP_OPS
+    vec4 r = vec4(subgroupMin(v.x), subgroupMax(v.y), subgroupAdd(v.z), subgroupAdd(v.w));
+    if (subgroupElect()) s_reduce[gl_SubgroupID] = r;
+    barrier();
+    if (gl_LocalInvocationIndex == 0u) {
+        vec4 a = s_reduce[0];
+        for (uint i = 1u; i < gl_NumSubgroups; ++i) a = prim_combine(a, s_reduce[i]);
+        s_reduce[0] = a;
+    }
+    barrier();
+#else
+    uint i = gl_LocalInvocationIndex;
+    s_reduce[i] = v;
+    barrier();
+    for (uint off = PRIM_WG / 2u; off > 0u; off >>= 1) {
+        if (i < off) s_reduce[i] = prim_combine(s_reduce[i], s_reduce[i + off]);
+        barrier();
+    }
+#endif
+    vec4 res = s_reduce[0];
+    barrier();
+    return res;
+}
+#endif // PRIM_NEED_REDUCE
+
+#endif // PRIM_COMMON_GLSL
@@ -0,0 +1,36 @@
+// Scatter / density renderer shared by the scatter_*.comp passes and the sprite fallback,
+// see examples/renderer_scatter.h for the C++ side.
+#ifndef SCATTER_COMMON_GLSL
+#define SCATTER_COMMON_GLSL
+
+#extension GL_EXT_buffer_reference : require
+
+// 点的数据坐标（大致在 [-1, 1]^2）
+layout(buffer_reference, std430, buffer_reference_align = 8) buffer ScatterPoints { vec2 p[]; };
+// 每帧的统计（帧 scratch，CPU 清零）
+layout(buffer_reference, std430, buffer_reference_align = 4) buffer ScatterStats { uint max_density; };
+
+// 数据坐标 → 像素：以 center 为中心缩放 scale 像素/单位，y 向上
+vec2 scatter_to_pixel(vec2 p, vec2 center, vec2 origin, float scale)
+{
+    return (p - center) * vec2(scale, -scale) + origin;
+}
+
+vec4 scatter_background() { return vec4(0.06, 0.06, 0.08, 1.0); }
+vec4 scatter_sprite_color() { return vec4(0.35, 0.75, 1.0, 0.65); }
+
+// viridis 的多项式拟合，t ∈ [0, 1]
+vec3 density_colormap(float t)
+{
+    const vec3 c0 = vec3(0.2777273272234177, 0.005407344544966578, 0.3340998053353061);
+    const vec3 c1 = vec3(0.1050930431085774, 1.404613529898575, 1.384590162594685);
+    const vec3 c2 = vec3(-0.3308618287255563, 0.214847559468213, 0.09509516302823659);
+    const vec3 c3 = vec3(-4.634230498983486, -5.799100973351585, -19.33244095627987);
+    const vec3 c4 = vec3(6.228269936347081, 14.17993336680509, 56.69055260068105);
+    const vec3 c5 = vec3(4.776384997670288, -13.74514537774601, -65.35303263337234);
+    const vec3 c6 = vec3(-5.435455855934631, 4.645852612178535, 26.3124352495832);
+    t = clamp(t, 0.0, 1.0);
+    return c0 + t * (c1 + t * (c2 + t * (c3 + t * (c4 + t * (c5 + t * c6)))));
+}
+
+#endif // SCATTER_COMMON_GLSL
@@ -0,0 +1,26 @@
+#version 460
+#extension GL_GOOGLE_include_directive : require
+
+#include "scatter_common.glsl"
+
+layout(push_constant) uniform Push {
+    ScatterPoints pts;
+    vec2 center;
+    vec2 origin;
+    uint count;
+    uint W;
+    uint H;
+    float scale;
+    float radius;
+} pc;
+
+layout(location = 0) in vec2 inLocal;
+layout(location = 0) out vec4 outColor;
+
+void main()
+{
+    float a = clamp(pc.radius + 0.5 - length(inLocal), 0.0, 1.0);
+    if (a <= 0.0) discard;
+    vec4 c = scatter_sprite_color();
+    outColor = vec4(c.rgb, c.a * a);
+}
@@ -0,0 +1,31 @@
+#version 460
+#extension GL_GOOGLE_include_directive : require
+
+// 点数少时的退路：每个点一个实例化的小方片（6 个顶点），片元着色器裁成抗锯齿圆点。
+// 顶点从点缓冲按设备地址拉取，无顶点输入
+#include "scatter_common.glsl"
+
+layout(push_constant) uniform Push {
+    ScatterPoints pts;
+    vec2 center;
+    vec2 origin;
+    uint count;
+    uint W;
+    uint H;
+    float scale;
+    float radius;  // 圆点半径（像素）
+} pc;
+
+layout(location = 0) out vec2 outLocal;
+
+const vec2 corners[6] = vec2[](vec2(-1, -1), vec2(1, -1), vec2(1, 1), vec2(-1, -1), vec2(1, 1), vec2(-1, 1));
+
+void main()
+{
+    vec2 c = scatter_to_pixel(pc.pts.p[gl_InstanceIndex], pc.center, pc.origin, pc.scale);
+    float extent = pc.radius + 1.0;
+    vec2 local = corners[gl_VertexIndex] * extent;
+    vec2 pos = c + local;
+    outLocal = local;
+    gl_Position = vec4(pos / vec2(pc.W, pc.H) * 2.0 - 1.0, 0.0, 1.0);
+}
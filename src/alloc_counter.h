@@ -0,0 +1,20 @@
+#ifndef ALLOC_COUNTER_H
+#define ALLOC_COUNTER_H
+
+#include <cstdint>
+
+// Process-wide count of global operator new calls. Only built with the CMake option
+// LEARNVULKAN_ALLOC_COUNTER=ON, which makes alloc_counter.cpp replace the global allocation
+// functions; otherwise total() is always 0. Used by the debug panel to check that a
+// steady-state frame does not touch the heap; malloc from C libraries (SDL, ImGui) is not counted.
+namespace alloc_counter
+{
+#ifdef LEARNVULKAN_ALLOC_COUNTER
+    inline constexpr bool Enabled = true;
+#else
+    inline constexpr bool Enabled = false;
+#endif
+    uint64_t total();
+}
+
+#endif //ALLOC_COUNTER_H
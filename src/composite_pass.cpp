@@ -0,0 +1,195 @@
+#include "composite_pass.h"
+#include "imgui_layer.h"
+#include "ext/vk_images.h"
+#include "ext/vk_pipelines.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#ifndef VK_CHECK
+#define VK_CHECK(x) do { VkResult err__ = (x); if (err__ != VK_SUCCESS) { throw std::runtime_error(std::string("Vulkan error ") + std::to_string(err__)); } } while(0)
+#endif
+
+namespace
+{
+    // Must match the push constant block of shaders/composite.{vert,frag}
+    struct CompositePush
+    {
+        uint32_t textureIndex;
+        uint32_t samplerIndex;
+        float uvScale[2];
+        float exposure;
+        uint32_t tonemap;
+    };
+
+    // Part of the offscreen target the renderer drew into (it never outgrows the frame)
+    VkExtent2D source_region(const CompositePass::Source& src, VkExtent2D frame)
+    {
+        return {std::min(src.extent.width, frame.width), std::min(src.extent.height, frame.height)};
+    }
+}
+
+void CompositePass::init(VkDevice device, BindlessHeap& bindless, VkFormat swapchainFormat)
+{
+    bindless_ = &bindless;
+
+    VkSamplerCreateInfo sci{VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO};
+    sci.magFilter = VK_FILTER_LINEAR;
+    sci.minFilter = VK_FILTER_LINEAR;
+    sci.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    sci.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    sci.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    VK_CHECK(vkCreateSampler(device, &sci, nullptr, &sampler_));
+    samplerIndex_ = bindless.add_sampler(device, sampler_);
+
+    VkShaderModule vs{}, fs{};
+    if (!vkutil::load_shader_module("./shaders/composite.vert.spv", device, &vs))
+        throw std::runtime_error("failed to load composite.vert.spv");
+    if (!vkutil::load_shader_module("./shaders/composite.frag.spv", device, &fs))
+    {
+        vkDestroyShaderModule(device, vs, nullptr);
+        throw std::runtime_error("failed to load composite.frag.spv");
+    }
+
+    PipelineBuilder pb;
+    pb._pipelineLayout = bindless.pipelineLayout;
+    pb.set_shaders(vs, fs);
+    pb.set_input_topology(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST);
+    pb.set_polygon_mode(VK_POLYGON_MODE_FILL);
+    pb.set_cull_mode(VK_CULL_MODE_NONE, VK_FRONT_FACE_CLOCKWISE);
+    pb.set_multisampling_none();
+    pb.disable_blending();
+    pb.disable_depthtest();
+    pb.set_color_attachment_format(swapchainFormat);
+    pb.set_depth_format(VK_FORMAT_UNDEFINED);
+    pipeline_ = pb.build_pipeline(device);
+
+    vkDestroyShaderModule(device, vs, nullptr);
+    vkDestroyShaderModule(device, fs, nullptr);
+}
+
+void CompositePass::destroy(VkDevice device, BindlessHeap& bindless)
+{
+    if (pipeline_) vkDestroyPipeline(device, pipeline_, nullptr);
+    pipeline_ = VK_NULL_HANDLE;
+    if (samplerIndex_ != BindlessHeap::InvalidIndex) bindless.release(BindlessHeap::Sampler, samplerIndex_);
+    samplerIndex_ = BindlessHeap::InvalidIndex;
+    if (sampler_) vkDestroySampler(device, sampler_, nullptr);
+    sampler_ = VK_NULL_HANDLE;
+}
+
+void CompositePass::record(VkCommandBuffer cmd, const Source& src, const Target& dst, ImGuiLayer* overlay) const
+{
+    const bool resolve = src.image != VK_NULL_HANDLE;
+
+    // One dependency for both images: the offscreen target stays in GENERAL (no layout change,
+    // only visibility for sampling) and the swapchain image becomes the attachment.
+    VkImageMemoryBarrier2 barriers[2]{};
+    uint32_t barrierCount = 0;
+    {
+        VkImageMemoryBarrier2& b = barriers[barrierCount++];
+        b.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+        // COLOR_ATTACHMENT_OUTPUT chains with the acquire semaphore wait; compute after direct present
+        b.srcStageMask = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
+        if (dst.layout == VK_IMAGE_LAYOUT_GENERAL)
+        {
+            b.srcStageMask |= VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+            b.srcAccessMask = VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+        }
+        b.dstStageMask = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
+        b.dstAccessMask = VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT;
+        b.oldLayout = dst.layout;
+        b.newLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        b.image = dst.image;
+        b.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+    }
+    if (resolve)
+    {
+        VkImageMemoryBarrier2& b = barriers[barrierCount++];
+        b.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+        b.srcStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+        b.srcAccessMask = VK_ACCESS_2_MEMORY_WRITE_BIT;
+        b.dstStageMask = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT;
+        b.dstAccessMask = VK_ACCESS_2_SHADER_SAMPLED_READ_BIT;
+        b.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+        b.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+        b.image = src.image;
+        b.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+    }
+    VkDependencyInfo dep{VK_STRUCTURE_TYPE_DEPENDENCY_INFO};
+    dep.imageMemoryBarrierCount = barrierCount;
+    dep.pImageMemoryBarriers = barriers;
+    vkCmdPipelineBarrier2(cmd, &dep);
+
+    // The fullscreen triangle overwrites every pixel, so the old contents are never loaded
+    VkRenderingAttachmentInfo color{VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO};
+    color.imageView = dst.view;
+    color.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    color.loadOp = resolve ? VK_ATTACHMENT_LOAD_OP_DONT_CARE : VK_ATTACHMENT_LOAD_OP_LOAD;
+    color.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+
+    VkRenderingInfo ri{VK_STRUCTURE_TYPE_RENDERING_INFO};
+    ri.renderArea = {{0, 0}, dst.extent};
+    ri.layerCount = 1;
+    ri.colorAttachmentCount = 1;
+    ri.pColorAttachments = &color;
+    vkCmdBeginRendering(cmd, &ri);
+
+    if (resolve)
+    {
+        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_);
+
+        VkViewport vp{};
+        vp.width = static_cast<float>(dst.extent.width);
+        vp.height = static_cast<float>(dst.extent.height);
+        vp.minDepth = 0.f;
+        vp.maxDepth = 1.f;
+        vkCmdSetViewport(cmd, 0, 1, &vp);
+        VkRect2D sc{{0, 0}, dst.extent};
+        vkCmdSetScissor(cmd, 0, 1, &sc);
+
+        const VkExtent2D region = source_region(src, dst.extent);
+        CompositePush push{};
+        push.textureIndex = src.sampledIndex;
+        push.samplerIndex = samplerIndex_;
+        push.uvScale[0] = static_cast<float>(region.width) / static_cast<float>(src.extent.width);
+        push.uvScale[1] = static_cast<float>(region.height) / static_cast<float>(src.extent.height);
+        push.exposure = params.exposure;
+        push.tonemap = params.tonemap;
+        bindless_->push(cmd, &push, sizeof(push));
+
+        vkCmdDraw(cmd, 3, 1, 0, 0);
+    }
+
+    if (overlay) overlay->render(cmd);
+
+    vkCmdEndRendering(cmd);
+
+    VkImageMemoryBarrier2& present = barriers[0];
+    present.srcStageMask = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
+    present.srcAccessMask = VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT;
+    present.dstStageMask = VK_PIPELINE_STAGE_2_NONE;
+    present.dstAccessMask = 0;
+    present.oldLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    present.newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    dep.imageMemoryBarrierCount = 1;
+    vkCmdPipelineBarrier2(cmd, &dep);
+}
+
+void CompositePass::record_blit(VkCommandBuffer cmd, const Source& src, const Target& dst, ImGuiLayer* overlay) const
+{
+    VkImageLayout layout = dst.layout;
+    if (src.image != VK_NULL_HANDLE)
+    {
+        vkutil::transition_image(cmd, src.image, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+        vkutil::transition_image(cmd, dst.image, dst.layout, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+        vkutil::copy_image_to_image(cmd, src.image, dst.image, source_region(src, dst.extent), dst.extent);
+        layout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    }
+
+    if (overlay)
+        overlay->render_overlay(cmd, dst.image, dst.view, dst.extent, layout);
+    else
+        vkutil::transition_image(cmd, dst.image, layout, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+}
@@ -0,0 +1,68 @@
+#ifndef COMPOSITE_PASS_H
+#define COMPOSITE_PASS_H
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+
+#include "ext/vk_bindless.h"
+
+class ImGuiLayer;
+
+// Engine-owned last pass of the frame: resolves the renderer's offscreen target into the
+// swapchain image, draws the UI on top and leaves the image in PRESENT_SRC_KHR.
+//
+// Fused path (record): one dynamic rendering instance on the swapchain image samples the
+// offscreen target with a fullscreen triangle (scale + tonemap) and then draws ImGui.
+// Blit path (record_blit): the previous sequence, a vkCmdBlitImage into TRANSFER_DST
+// followed by ImGuiLayer::render_overlay; kept for A/B timing.
+class CompositePass
+{
+public:
+    enum Tonemap : uint32_t
+    {
+        TonemapClamp = 0,
+        TonemapReinhard = 1,
+        TonemapAces = 2,
+    };
+
+    struct Params
+    {
+        float exposure{1.0f};
+        uint32_t tonemap{TonemapClamp};
+    };
+
+    // The offscreen target, left in VK_IMAGE_LAYOUT_GENERAL by the renderer.
+    // image == VK_NULL_HANDLE when the renderer already wrote the swapchain image (direct present).
+    struct Source
+    {
+        VkImage image{};
+        uint32_t sampledIndex{BindlessHeap::InvalidIndex};
+        VkExtent2D extent{};
+    };
+
+    struct Target
+    {
+        VkImage image{};
+        VkImageView view{};
+        VkExtent2D extent{};
+        VkImageLayout layout{VK_IMAGE_LAYOUT_UNDEFINED}; // GENERAL after direct present
+    };
+
+    void init(VkDevice device, BindlessHeap& bindless, VkFormat swapchainFormat);
+    void destroy(VkDevice device, BindlessHeap& bindless);
+
+    // The bindless heap must already be bound for graphics; overlay may be null
+    void record(VkCommandBuffer cmd, const Source& src, const Target& dst, ImGuiLayer* overlay) const;
+    void record_blit(VkCommandBuffer cmd, const Source& src, const Target& dst, ImGuiLayer* overlay) const;
+
+    Params params;
+
+private:
+    const BindlessHeap* bindless_{};
+    VkPipeline pipeline_{};
+    VkSampler sampler_{};
+    uint32_t samplerIndex_{BindlessHeap::InvalidIndex};
+};
+
+
+#endif //COMPOSITE_PASS_H
@@ -0,0 +1,79 @@
+#include "damage_region.h"
+#include "ext/vk_scratch.h"
+
+#include <algorithm>
+
+void DamageRegion::begin(VkExtent2D extent, bool forceFull)
+{
+    extent_ = extent;
+    full_ = forceFull;
+    rects_.clear();
+    tileCount_ = 0;
+    tiles_ = 0;
+}
+
+void DamageRegion::add(const VkRect2D& rect)
+{
+    if (full_) return;
+    // clip to the frame; rectangles may come straight from layout math
+    const int64_t x0 = std::max<int64_t>(rect.offset.x, 0);
+    const int64_t y0 = std::max<int64_t>(rect.offset.y, 0);
+    const int64_t x1 = std::min<int64_t>(static_cast<int64_t>(rect.offset.x) + rect.extent.width, extent_.width);
+    const int64_t y1 = std::min<int64_t>(static_cast<int64_t>(rect.offset.y) + rect.extent.height, extent_.height);
+    if (x1 <= x0 || y1 <= y0) return;
+    rects_.push_back(VkRect2D{{static_cast<int32_t>(x0), static_cast<int32_t>(y0)},
+                              {static_cast<uint32_t>(x1 - x0), static_cast<uint32_t>(y1 - y0)}});
+}
+
+void DamageRegion::add_full()
+{
+    full_ = true;
+    rects_.clear();
+}
+
+void DamageRegion::build_tiles(ScratchAllocator& scratch)
+{
+    tileCount_ = 0;
+    tiles_ = 0;
+    if (full_ || rects_.empty()) return;
+
+    // overlapping rectangles share tiles, so mark first and emit each tile once
+    const uint32_t tilesX = (extent_.width + TileSize - 1) / TileSize;
+    const uint32_t tilesY = (extent_.height + TileSize - 1) / TileSize;
+    tileMask_.assign(static_cast<size_t>(tilesX) * tilesY, 0);
+    tileOrigins_.clear();
+    for (const VkRect2D& r : rects_)
+    {
+        const uint32_t tx0 = static_cast<uint32_t>(r.offset.x) / TileSize;
+        const uint32_t ty0 = static_cast<uint32_t>(r.offset.y) / TileSize;
+        const uint32_t tx1 = (static_cast<uint32_t>(r.offset.x) + r.extent.width - 1) / TileSize;
+        const uint32_t ty1 = (static_cast<uint32_t>(r.offset.y) + r.extent.height - 1) / TileSize;
+        for (uint32_t ty = ty0; ty <= ty1; ty++)
+        {
+            for (uint32_t tx = tx0; tx <= tx1; tx++)
+            {
+                uint8_t& m = tileMask_[static_cast<size_t>(ty) * tilesX + tx];
+                if (m) continue;
+                m = 1;
+                tileOrigins_.push_back(tx * TileSize);
+                tileOrigins_.push_back(ty * TileSize);
+            }
+        }
+    }
+
+    tileCount_ = static_cast<uint32_t>(tileOrigins_.size() / 2);
+    tiles_ = tileCount_ > 0 ? scratch.push(tileOrigins_.data(), tileOrigins_.size(), 8).address : 0;
+}
+
+VkExtent2D DamageRegion::tile_groups() const
+{
+    if (tileCount_ == 0) return {0, 0};
+    const uint32_t x = std::min(tileCount_, MaxGroupsX);
+    return {x, (tileCount_ + x - 1) / x};
+}
+
+uint64_t DamageRegion::covered_pixels() const
+{
+    if (full_) return static_cast<uint64_t>(extent_.width) * extent_.height;
+    return static_cast<uint64_t>(tileCount_) * TileSize * TileSize;
+}
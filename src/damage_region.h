@@ -0,0 +1,59 @@
+#ifndef DAMAGE_REGION_H
+#define DAMAGE_REGION_H
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+struct ScratchAllocator;
+
+// Pixels of the persistent offscreen target that change this frame. Renderers add
+// rectangles in IRenderer::report_damage(); the engine turns them into a list of
+// TileSize x TileSize tiles in frame scratch memory, so compute passes dispatch one
+// workgroup per dirty tile (shaders/damage_tiles.glsl) instead of the whole frame.
+// The same rectangles feed VK_KHR_incremental_present when the device has it.
+class DamageRegion
+{
+public:
+    // Must match DAMAGE_TILE_SIZE and the 16x16 workgroups of the compute shaders
+    static constexpr uint32_t TileSize = 16;
+    // Guaranteed maxComputeWorkGroupCount[0]; longer tile lists wrap into y
+    static constexpr uint32_t MaxGroupsX = 65535;
+
+    // forceFull: the offscreen target does not hold the previous frame (first frame,
+    // resize, renderer/format switch, direct present) or damage tracking is disabled
+    void begin(VkExtent2D extent, bool forceFull);
+    void add(const VkRect2D& rect);
+    void add_full();
+
+    // Upload tile origins (uvec2 pixels) to scratch memory; call once after report_damage()
+    void build_tiles(ScratchAllocator& scratch);
+
+    bool full() const { return full_; }
+    bool empty() const { return !full_ && tileCount_ == 0; }
+    std::span<const VkRect2D> rects() const { return rects_; }
+    VkExtent2D extent() const { return extent_; }
+
+    // Valid after build_tiles() when !full()
+    uint32_t tile_count() const { return tileCount_; }
+    VkDeviceAddress tiles() const { return tiles_; }
+    // Workgroup grid for a tile dispatch: x = min(tiles, MaxGroupsX), y = ceil(tiles / x).
+    // damage_pixel() linearizes the id and pushes padding groups off the target.
+    VkExtent2D tile_groups() const;
+
+    // Pixels the tile dispatch covers (whole frame when full)
+    uint64_t covered_pixels() const;
+
+private:
+    VkExtent2D extent_{};
+    bool full_{true};
+    std::vector<VkRect2D> rects_;
+    std::vector<uint8_t> tileMask_;     // reused every frame
+    std::vector<uint32_t> tileOrigins_; // x, y pairs
+    uint32_t tileCount_ = 0;
+    VkDeviceAddress tiles_ = 0;
+};
+
+
+#endif //DAMAGE_REGION_H
@@ -0,0 +1,860 @@
+#include "engine_bench.h"
+#include "vk_engine.h"
+#include "gpu_memory.h"
+
+#include "ext/vk_bindless.h"
+#include "ext/vk_compute_primitives.h"
+#include "ext/vk_descriptor_buffer.h"
+#include "ext/vk_deletion.h"
+#include "ext/vk_descriptors.h"
+#include "ext/vk_images.h"
+#include "ext/vk_initializers.h"
+#include "ext/vk_pipelines.h"
+#include "ext/vk_transient.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifndef VK_CHECK
+#define VK_CHECK(x) do { VkResult err__ = (x); if (err__ != VK_SUCCESS) { throw std::runtime_error(std::string("Vulkan error ") + std::to_string(err__)); } } while(0)
+#endif
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double ms_since(Clock::time_point t0)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+    }
+
+    // One command buffer + fence, reused for every measured submission of a benchmark
+    struct OneShot
+    {
+        VkDevice device{};
+        VkQueue queue{};
+        VkCommandPool pool{};
+        VkCommandBuffer cmd{};
+        VkFence fence{};
+
+        OneShot(const RenderContext& ctx) : device(ctx.device), queue(ctx.graphics_queue)
+        {
+            VkCommandPoolCreateInfo pci = vkinit::command_pool_create_info(ctx.graphics_queue_family, VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT);
+            VK_CHECK(vkCreateCommandPool(device, &pci, nullptr, &pool));
+            VkCommandBufferAllocateInfo cbai = vkinit::command_buffer_allocate_info(pool, 1);
+            VK_CHECK(vkAllocateCommandBuffers(device, &cbai, &cmd));
+            VkFenceCreateInfo fci = vkinit::fence_create_info();
+            VK_CHECK(vkCreateFence(device, &fci, nullptr, &fence));
+        }
+
+        ~OneShot()
+        {
+            vkDestroyFence(device, fence, nullptr);
+            vkDestroyCommandPool(device, pool, nullptr);
+        }
+
+        void begin()
+        {
+            VK_CHECK(vkResetCommandBuffer(cmd, 0));
+            VkCommandBufferBeginInfo bi = vkinit::command_buffer_begin_info(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+            VK_CHECK(vkBeginCommandBuffer(cmd, &bi));
+        }
+
+        // returns wall time from submit until the fence signals
+        double submit_and_wait()
+        {
+            VK_CHECK(vkEndCommandBuffer(cmd));
+            VkCommandBufferSubmitInfo cbsi = vkinit::command_buffer_submit_info(cmd);
+            VkSubmitInfo2 si = vkinit::submit_info(&cbsi, nullptr, nullptr);
+            auto t0 = Clock::now();
+            VK_CHECK(vkQueueSubmit2(queue, 1, &si, fence));
+            VK_CHECK(vkWaitForFences(device, 1, &fence, VK_TRUE, UINT64_MAX));
+            double ms = ms_since(t0);
+            VK_CHECK(vkResetFences(device, 1, &fence));
+            return ms;
+        }
+    };
+
+    // Small storage target so the benchmark never races the frame's offscreen image
+    struct ScratchImage
+    {
+        VkImage image{};
+        VkImageView view{};
+        VmaAllocation allocation{};
+
+        void create(const RenderContext& ctx, VkExtent3D extent, VkImageUsageFlags usage = VK_IMAGE_USAGE_STORAGE_BIT)
+        {
+            const VkFormat format = VK_FORMAT_R16G16B16A16_SFLOAT;
+            VkImageCreateInfo ici = vkinit::image_create_info(format, usage, extent);
+            VmaAllocationCreateInfo ai{};
+            ai.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+            VK_CHECK(gpu_memory::create_image(ctx.allocator, ici, ai, "Bench/scratch-image", &image, &allocation));
+            VkImageViewCreateInfo vci = vkinit::imageview_create_info(format, image, VK_IMAGE_ASPECT_COLOR_BIT);
+            VK_CHECK(vkCreateImageView(ctx.device, &vci, nullptr, &view));
+        }
+
+        void destroy(const RenderContext& ctx)
+        {
+            vkDestroyImageView(ctx.device, view, nullptr);
+            gpu_memory::destroy_image(ctx.allocator, image, allocation);
+        }
+    };
+
+    // Buffer addressed by BDA; host-visible ones are persistently mapped (staging / readback)
+    struct BenchBuffer
+    {
+        VkBuffer buffer{};
+        VmaAllocation allocation{};
+        VkDeviceAddress address{};
+        void* mapped{};
+
+        // Fails softly (buffer stays null) so size sweeps can stop at the device's memory limit
+        VkResult create(const RenderContext& ctx, VkDeviceSize size, VkBufferUsageFlags usage, VmaAllocationCreateFlags hostAccess = 0)
+        {
+            VkBufferCreateInfo bci{.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+            bci.size = size;
+            bci.usage = usage | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+            VmaAllocationCreateInfo ai{};
+            ai.usage = hostAccess ? VMA_MEMORY_USAGE_AUTO : VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+            ai.flags = hostAccess ? (hostAccess | VMA_ALLOCATION_CREATE_MAPPED_BIT) : 0;
+            VmaAllocationInfo info{};
+            const VkResult result = gpu_memory::create_buffer(ctx.allocator, bci, ai, "Bench/primitives", &buffer, &allocation, &info);
+            if (result != VK_SUCCESS) return result;
+            mapped = info.pMappedData;
+            VkBufferDeviceAddressInfo dai{.sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO};
+            dai.buffer = buffer;
+            address = vkGetBufferDeviceAddress(ctx.device, &dai);
+            return VK_SUCCESS;
+        }
+
+        void destroy(const RenderContext& ctx)
+        {
+            if (buffer) gpu_memory::destroy_buffer(ctx.allocator, buffer, allocation);
+            *this = {};
+        }
+    };
+
+    void compute_to_compute(VkCommandBuffer cmd)
+    {
+        VkMemoryBarrier2 mb{.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2};
+        mb.srcStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_2_TRANSFER_BIT;
+        mb.srcAccessMask = VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT | VK_ACCESS_2_TRANSFER_WRITE_BIT;
+        mb.dstStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_2_TRANSFER_BIT;
+        mb.dstAccessMask = VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT | VK_ACCESS_2_TRANSFER_READ_BIT;
+        VkDependencyInfo dep{.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO};
+        dep.memoryBarrierCount = 1;
+        dep.pMemoryBarriers = &mb;
+        vkCmdPipelineBarrier2(cmd, &dep);
+    }
+}
+
+bench::DescriptorBindingResult bench::descriptor_binding(const RenderContext& ctx, uint32_t draws)
+{
+    DescriptorBindingResult r{};
+    r.draws = draws;
+
+    OneShot os(ctx);
+    ScratchImage target;
+    target.create(ctx, VkExtent3D{16, 16, 1});
+
+    // --- classic path: one descriptor set per draw, bound before every dispatch ---
+    {
+        DescriptorLayoutBuilder b;
+        b.add_binding(0, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE);
+        VkDescriptorSetLayout dsl = b.build(ctx.device, VK_SHADER_STAGE_COMPUTE_BIT);
+
+        // same shader as the bindless path; the one-image set is indexed with handle 0
+        VkPushConstantRange pcr{VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(uint32_t)};
+        VkPipelineLayoutCreateInfo plci = vkinit::pipeline_layout_create_info();
+        plci.setLayoutCount = 1;
+        plci.pSetLayouts = &dsl;
+        plci.pushConstantRangeCount = 1;
+        plci.pPushConstantRanges = &pcr;
+        VkPipelineLayout layout{};
+        VK_CHECK(vkCreatePipelineLayout(ctx.device, &plci, nullptr, &layout));
+        VkPipeline pipeline = vkutil::create_compute_pipeline(ctx.device, layout, "./shaders/bench_binding.comp.spv");
+
+        // allocation and writes are setup cost, only binding is measured
+        std::vector<DescriptorAllocator::PoolSizeRatio> ratios = {{VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1.0f}};
+        DescriptorAllocator pool{};
+        pool.init_pool(ctx.device, draws, ratios);
+        std::vector<VkDescriptorSet> sets(draws);
+        DescriptorWriter writer;
+        for (auto& set : sets)
+        {
+            set = pool.allocate(ctx.device, dsl);
+            writer.clear();
+            writer.write_image(0, target.view, VK_NULL_HANDLE, VK_IMAGE_LAYOUT_GENERAL, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE);
+            writer.update_set(ctx.device, set);
+        }
+
+        os.begin();
+        vkutil::transition_image(os.cmd, target.image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL);
+        auto t0 = Clock::now();
+        vkCmdBindPipeline(os.cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+        const uint32_t index = 0;
+        vkCmdPushConstants(os.cmd, layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(index), &index);
+        for (uint32_t i = 0; i < draws; i++)
+        {
+            vkCmdBindDescriptorSets(os.cmd, VK_PIPELINE_BIND_POINT_COMPUTE, layout, 0, 1, &sets[i], 0, nullptr);
+            vkCmdDispatch(os.cmd, 1, 1, 1);
+        }
+        r.setsRecordMs = ms_since(t0);
+        r.setsSubmitMs = os.submit_and_wait();
+
+        pool.destroy_pool(ctx.device);
+        vkDestroyPipeline(ctx.device, pipeline, nullptr);
+        vkDestroyPipelineLayout(ctx.device, layout, nullptr);
+        vkDestroyDescriptorSetLayout(ctx.device, dsl, nullptr);
+    }
+
+    // --- bindless path: heap bound once, each draw only pushes its handle ---
+    {
+        VkPipeline pipeline = vkutil::create_compute_pipeline(ctx.device, ctx.bindless->pipelineLayout, "./shaders/bench_binding.comp.spv");
+        const uint32_t handle = ctx.bindless->add_storage_image(ctx.device, target.view);
+
+        os.begin();
+        vkutil::transition_image(os.cmd, target.image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL);
+        auto t0 = Clock::now();
+        vkCmdBindPipeline(os.cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+        ctx.bindless->bind(os.cmd, VK_PIPELINE_BIND_POINT_COMPUTE);
+        for (uint32_t i = 0; i < draws; i++)
+        {
+            ctx.bindless->push(os.cmd, &handle, sizeof(handle));
+            vkCmdDispatch(os.cmd, 1, 1, 1);
+        }
+        r.bindlessRecordMs = ms_since(t0);
+        r.bindlessSubmitMs = os.submit_and_wait();
+
+        ctx.bindless->release(BindlessHeap::StorageImage, handle);
+        vkDestroyPipeline(ctx.device, pipeline, nullptr);
+    }
+
+    target.destroy(ctx);
+    return r;
+}
+
+bench::DescriptorUpdateResult bench::descriptor_updates(const RenderContext& ctx, uint32_t updates)
+{
+    DescriptorUpdateResult r{};
+    r.updates = updates;
+
+    ScratchImage target;
+    target.create(ctx, VkExtent3D{16, 16, 1}, VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT);
+
+    VkSamplerCreateInfo sci{.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO};
+    VkSampler sampler{};
+    VK_CHECK(vkCreateSampler(ctx.device, &sci, nullptr, &sampler));
+
+    VkBufferCreateInfo bci{.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+    bci.size = 256;
+    bci.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+    VmaAllocationCreateInfo ai{};
+    ai.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+    VkBuffer buffer{};
+    VmaAllocation bufferAlloc{};
+    VK_CHECK(gpu_memory::create_buffer(ctx.allocator, bci, ai, "Bench/descriptor-target", &buffer, &bufferAlloc));
+
+    // same shape as the MSDF text pass set
+    DescriptorLayoutBuilder b;
+    b.add_binding(0, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE);
+    b.add_binding(1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
+    b.add_binding(2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER);
+    VkDescriptorSetLayout dsl = b.build(ctx.device, VK_SHADER_STAGE_COMPUTE_BIT);
+
+    std::vector<DescriptorAllocator::PoolSizeRatio> ratios = {
+        {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1.0f},
+        {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1.0f},
+        {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1.0f},
+    };
+    DescriptorAllocator pool{};
+    pool.init_pool(ctx.device, 1, ratios);
+    VkDescriptorSet set = pool.allocate(ctx.device, dsl);
+
+    // --- writer path ---
+    {
+        DescriptorWriter writer;
+        auto t0 = Clock::now();
+        for (uint32_t i = 0; i < updates; i++)
+        {
+            writer.clear();
+            writer.write_image(0, target.view, VK_NULL_HANDLE, VK_IMAGE_LAYOUT_GENERAL, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE);
+            writer.write_image(1, target.view, sampler, VK_IMAGE_LAYOUT_GENERAL, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
+            writer.write_buffer(2, buffer, 256, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER);
+            writer.update_set(ctx.device, set);
+        }
+        r.writerMs = ms_since(t0);
+    }
+
+    // --- template path ---
+    {
+        struct Packed
+        {
+            VkDescriptorImageInfo target;
+            VkDescriptorImageInfo texture;
+            VkDescriptorBufferInfo buffer;
+        };
+
+        DescriptorUpdateTemplateBuilder tb;
+        tb.add_entry(0, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, offsetof(Packed, target));
+        tb.add_entry(1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, offsetof(Packed, texture));
+        tb.add_entry(2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, offsetof(Packed, buffer));
+        VkDescriptorUpdateTemplate tmpl = tb.build(ctx.device, dsl);
+
+        auto t0 = Clock::now();
+        for (uint32_t i = 0; i < updates; i++)
+        {
+            Packed packed{
+                .target = {VK_NULL_HANDLE, target.view, VK_IMAGE_LAYOUT_GENERAL},
+                .texture = {sampler, target.view, VK_IMAGE_LAYOUT_GENERAL},
+                .buffer = {buffer, 0, 256},
+            };
+            vkUpdateDescriptorSetWithTemplate(ctx.device, set, tmpl, &packed);
+        }
+        r.templateMs = ms_since(t0);
+
+        vkDestroyDescriptorUpdateTemplate(ctx.device, tmpl, nullptr);
+    }
+
+    pool.destroy_pool(ctx.device);
+    vkDestroyDescriptorSetLayout(ctx.device, dsl, nullptr);
+    gpu_memory::destroy_buffer(ctx.allocator, buffer, bufferAlloc);
+    vkDestroySampler(ctx.device, sampler, nullptr);
+    target.destroy(ctx);
+    return r;
+}
+
+bench::DescriptorBackendResult bench::descriptor_backends(const RenderContext& ctx, uint32_t changes)
+{
+    DescriptorBackendResult r{};
+    r.changes = changes;
+    r.pushMs = -1.0;
+    r.bufferMs = -1.0;
+
+    OneShot os(ctx);
+    ScratchImage target;
+    target.create(ctx, VkExtent3D{16, 16, 1});
+
+    // gradient.comp: one storage image at set 0, binding 0
+    struct Pass
+    {
+        VkDescriptorSetLayout dsl{};
+        VkPipelineLayout layout{};
+        VkPipeline pipeline{};
+
+        void create(const RenderContext& ctx, VkDescriptorSetLayoutCreateFlags dslFlags, VkPipelineCreateFlags pipelineFlags)
+        {
+            DescriptorLayoutBuilder b;
+            b.add_binding(0, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE);
+            dsl = b.build(ctx.device, VK_SHADER_STAGE_COMPUTE_BIT, nullptr, dslFlags);
+            VkPipelineLayoutCreateInfo plci = vkinit::pipeline_layout_create_info();
+            plci.setLayoutCount = 1;
+            plci.pSetLayouts = &dsl;
+            VK_CHECK(vkCreatePipelineLayout(ctx.device, &plci, nullptr, &layout));
+            pipeline = vkutil::create_compute_pipeline(ctx.device, layout, "./shaders/gradient.comp.spv", pipelineFlags);
+        }
+
+        void destroy(const RenderContext& ctx)
+        {
+            vkDestroyPipeline(ctx.device, pipeline, nullptr);
+            vkDestroyPipelineLayout(ctx.device, layout, nullptr);
+            vkDestroyDescriptorSetLayout(ctx.device, dsl, nullptr);
+        }
+    };
+
+    auto begin = [&]()
+    {
+        os.begin();
+        vkutil::transition_image(os.cmd, target.image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL);
+    };
+
+    // --- pool: a fresh set per change ---
+    {
+        Pass pass;
+        pass.create(ctx, 0, 0);
+        std::vector<DescriptorAllocator::PoolSizeRatio> ratios = {{VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1.0f}};
+        DescriptorAllocator pool{};
+        pool.init_pool(ctx.device, changes, ratios);
+
+        begin();
+        auto t0 = Clock::now();
+        vkCmdBindPipeline(os.cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pass.pipeline);
+        DescriptorWriter writer;
+        for (uint32_t i = 0; i < changes; i++)
+        {
+            VkDescriptorSet set = pool.allocate(ctx.device, pass.dsl);
+            writer.clear();
+            writer.write_image(0, target.view, VK_NULL_HANDLE, VK_IMAGE_LAYOUT_GENERAL, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE);
+            writer.update_set(ctx.device, set);
+            vkCmdBindDescriptorSets(os.cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pass.layout, 0, 1, &set, 0, nullptr);
+            vkCmdDispatch(os.cmd, 1, 1, 1);
+        }
+        r.poolMs = ms_since(t0);
+        os.submit_and_wait();
+
+        pool.destroy_pool(ctx.device);
+        pass.destroy(ctx);
+    }
+
+    // --- push descriptors ---
+    if (ctx.caps.pushDescriptor)
+    {
+        Pass pass;
+        pass.create(ctx, VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR, 0);
+
+        begin();
+        auto t0 = Clock::now();
+        vkCmdBindPipeline(os.cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pass.pipeline);
+        DescriptorWriter writer;
+        for (uint32_t i = 0; i < changes; i++)
+        {
+            writer.clear();
+            writer.write_image(0, target.view, VK_NULL_HANDLE, VK_IMAGE_LAYOUT_GENERAL, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE);
+            writer.push_set(ctx.caps.cmdPushDescriptorSet, os.cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pass.layout);
+            vkCmdDispatch(os.cmd, 1, 1, 1);
+        }
+        r.pushMs = ms_since(t0);
+        os.submit_and_wait();
+
+        pass.destroy(ctx);
+    }
+
+    // --- descriptor buffer: private ring sized for every change ---
+    if (ctx.frameDescriptorBuffer)
+    {
+        Pass pass;
+        pass.create(ctx, VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT, VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT);
+
+        const DescriptorBufferApi* api = ctx.frameDescriptorBuffer->api;
+        VkDeviceSize setSize = 0;
+        api->getLayoutSize(ctx.device, pass.dsl, &setSize);
+        const VkDeviceSize align = api->props.descriptorBufferOffsetAlignment;
+        const VkDeviceSize stride = (setSize + align - 1) & ~(align - 1);
+        DescriptorBufferRing ring;
+        ring.init(ctx.device, ctx.allocator, api, stride * changes + align);
+
+        begin();
+        auto t0 = Clock::now();
+        vkCmdBindPipeline(os.cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pass.pipeline);
+        ring.bind(os.cmd);
+        DescriptorWriter writer;
+        for (uint32_t i = 0; i < changes; i++)
+        {
+            writer.clear();
+            writer.write_image(0, target.view, VK_NULL_HANDLE, VK_IMAGE_LAYOUT_GENERAL, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE);
+            VkDeviceSize offset = ring.push(ctx.device, pass.dsl, writer);
+            ring.set_offset(os.cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pass.layout, 0, offset);
+            vkCmdDispatch(os.cmd, 1, 1, 1);
+        }
+        r.bufferMs = ms_since(t0);
+        os.submit_and_wait();
+
+        ring.destroy(ctx.allocator);
+        pass.destroy(ctx);
+    }
+
+    target.destroy(ctx);
+    return r;
+}
+
+bench::DeletionQueueResult bench::deletion_queue(const RenderContext& ctx, uint32_t entries)
+{
+    DeletionQueueResult r{};
+    r.entries = entries;
+
+    // unbound buffers: cheap to create, and creation is kept out of the measured region
+    auto make_buffers = [&]()
+    {
+        std::vector<VkBuffer> buffers(entries);
+        VkBufferCreateInfo bci{.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+        bci.size = 256;
+        bci.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+        for (auto& b : buffers) VK_CHECK(vkCreateBuffer(ctx.device, &bci, nullptr, &b));
+        return buffers;
+    };
+
+    // --- std::function closures ---
+    {
+        std::vector<VkBuffer> buffers = make_buffers();
+        DeletionQueue queue;
+        VkDevice device = ctx.device;
+        VmaAllocator allocator = ctx.allocator;
+
+        auto t0 = Clock::now();
+        for (VkBuffer b : buffers)
+        {
+            // same capture the engine uses for buffers: device, allocator, handle, allocation
+            VmaAllocation allocation = nullptr;
+            queue.push_function([device, allocator, b, allocation]()
+            {
+                vkDestroyBuffer(device, b, nullptr);
+                if (allocation) gpu_memory::free_memory(allocator, allocation);
+            });
+        }
+        r.closurePushMs = ms_since(t0);
+        t0 = Clock::now();
+        queue.flush();
+        r.closureFlushMs = ms_since(t0);
+    }
+
+    // --- typed records ---
+    {
+        std::vector<VkBuffer> buffers = make_buffers();
+        TypedDeletionQueue queue;
+
+        auto t0 = Clock::now();
+        for (VkBuffer b : buffers)
+        {
+            queue.push_buffer(b, nullptr);
+        }
+        r.typedPushMs = ms_since(t0);
+        t0 = Clock::now();
+        queue.collect(ctx.device, ctx.allocator, queue.current_value());
+        r.typedFlushMs = ms_since(t0);
+    }
+
+    return r;
+}
+
+bench::ComputePrimitivesResult bench::compute_primitives(const RenderContext& ctx, uint32_t count)
+{
+    ComputePrimitivesResult r{};
+    r.count = count;
+    r.subgroups = ctx.primitives->uses_subgroups();
+    const ComputePrimitives& prims = *ctx.primitives;
+    constexpr uint32_t Reps = 10;
+    constexpr uint32_t Bins = 256;
+    constexpr float Lo = -4.0f, Hi = 4.0f;       // histogram range
+    constexpr float KeepLo = 0.5f, KeepHi = 2.0f; // compaction predicate
+
+    // Inputs: a bimodal float distribution (some values fall outside the histogram range) and
+    // small uints for the scan, from a fixed LCG so every run sees the same data
+    std::vector<float> values(count);
+    std::vector<uint32_t> words(count);
+    uint32_t state = 0x12345678u;
+    auto next = [&state]() { state = state * 1664525u + 1013904223u; return state; };
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        const float u = float(next() >> 8) * (1.0f / 16777216.0f);
+        const float v = float(next() >> 8) * (1.0f / 16777216.0f);
+        values[i] = (i & 1 ? 1.5f : -1.0f) + (u + v - 1.0f) * 3.0f;
+        words[i] = next() >> 28;
+    }
+
+    const VkDeviceSize bytes = VkDeviceSize(std::max(count, 1u)) * sizeof(uint32_t);
+    const VkDeviceSize tempBytes = std::max(ComputePrimitives::reduce_temp_bytes(count), ComputePrimitives::scan_temp_bytes(count));
+    // small results: reduce (16 bytes) | compaction count (4) | histogram bins
+    const VkDeviceSize smallBytes = 32 + Bins * sizeof(uint32_t);
+    const VkBufferUsageFlags storage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    BenchBuffer floatsIn, wordsIn, out, temp, small, upload, readback;
+    VK_CHECK(floatsIn.create(ctx, bytes, storage));
+    VK_CHECK(wordsIn.create(ctx, bytes, storage));
+    VK_CHECK(out.create(ctx, bytes, storage));
+    VK_CHECK(temp.create(ctx, tempBytes, storage));
+    VK_CHECK(small.create(ctx, smallBytes, storage));
+    VK_CHECK(upload.create(ctx, bytes * 2, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT));
+    VK_CHECK(readback.create(ctx, bytes + smallBytes, VK_BUFFER_USAGE_TRANSFER_DST_BIT, VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT));
+    const VkDeviceAddress reduceOut = small.address, countOut = small.address + 16, binsOut = small.address + 32;
+
+    OneShot os(ctx);
+    std::memcpy(upload.mapped, values.data(), size_t(count) * sizeof(float));
+    std::memcpy(static_cast<uint8_t*>(upload.mapped) + bytes, words.data(), size_t(count) * sizeof(uint32_t));
+    vmaFlushAllocation(ctx.allocator, upload.allocation, 0, VK_WHOLE_SIZE);
+    os.begin();
+    VkBufferCopy toFloats{0, 0, bytes}, toWords{bytes, 0, bytes};
+    vkCmdCopyBuffer(os.cmd, upload.buffer, floatsIn.buffer, 1, &toFloats);
+    vkCmdCopyBuffer(os.cmd, upload.buffer, wordsIn.buffer, 1, &toWords);
+    os.submit_and_wait();
+
+    // Runs `record` Reps times for the timing, then once more and copies out[0, outBytes) and
+    // the small results back to the host
+    auto run = [&](const char* name, auto&& record, VkDeviceSize outBytes, auto&& cpuReference) {
+        ComputePrimitivesResult::Op op{};
+        op.name = name;
+        os.begin();
+        ctx.bindless->bind(os.cmd, VK_PIPELINE_BIND_POINT_COMPUTE);
+        for (uint32_t i = 0; i < Reps; ++i)
+        {
+            compute_to_compute(os.cmd);
+            record(os.cmd);
+        }
+        op.gpuMs = os.submit_and_wait() / Reps;
+
+        os.begin();
+        ctx.bindless->bind(os.cmd, VK_PIPELINE_BIND_POINT_COMPUTE);
+        compute_to_compute(os.cmd);
+        record(os.cmd);
+        compute_to_compute(os.cmd);
+        VkBufferCopy copies[2] = {{0, 0, std::max<VkDeviceSize>(outBytes, 4)}, {0, bytes, smallBytes}};
+        vkCmdCopyBuffer(os.cmd, out.buffer, readback.buffer, 1, &copies[0]);
+        vkCmdCopyBuffer(os.cmd, small.buffer, readback.buffer, 1, &copies[1]);
+        os.submit_and_wait();
+        vmaInvalidateAllocation(ctx.allocator, readback.allocation, 0, VK_WHOLE_SIZE);
+
+        auto t0 = Clock::now();
+        cpuReference(op);
+        op.cpuMs = ms_since(t0);
+        r.ops.push_back(std::move(op));
+    };
+    const uint8_t* back = static_cast<const uint8_t*>(readback.mapped);
+    const uint8_t* backSmall = back + bytes;
+    char text[160];
+
+    // --- reduction ---
+    run("reduce", [&](VkCommandBuffer cmd) { prims.reduce(cmd, floatsIn.address, count, temp.address, reduceOut); }, 0,
+        [&](ComputePrimitivesResult::Op& op) {
+            float lo = INFINITY, hi = -INFINITY;
+            double sum = 0.0, sumSq = 0.0;
+            for (float x : values)
+            {
+                lo = std::min(lo, x);
+                hi = std::max(hi, x);
+                sum += x;
+                sumSq += double(x) * x;
+            }
+            ComputePrimitives::ReduceResult gpu{};
+            std::memcpy(&gpu, backSmall, sizeof(gpu));
+            // the GPU sums in float in a different order, so sums only match to a relative tolerance
+            auto close = [](double a, double b) { return std::abs(a - b) <= 1e-3 * std::max(1.0, std::abs(b)); };
+            op.match = gpu.min == lo && gpu.max == hi && close(gpu.sum, sum) && close(gpu.sumSquares, sumSq);
+            std::snprintf(text, sizeof(text), "min %g / %g, max %g / %g, sum %.6g / %.6g", gpu.min, lo, gpu.max, hi, gpu.sum, sum);
+            op.detail = text;
+        });
+
+    // --- histogram ---
+    run("histogram", [&](VkCommandBuffer cmd) { prims.histogram(cmd, floatsIn.address, count, Lo, Hi, Bins, binsOut); }, 0,
+        [&](ComputePrimitivesResult::Op& op) {
+            // same float math as prim_histogram.comp
+            const float invWidth = float(Bins) / (Hi - Lo);
+            std::vector<uint32_t> bins(Bins, 0);
+            for (float x : values)
+            {
+                const float f = (x - Lo) * invWidth;
+                if (f >= 0.0f && f < float(Bins)) ++bins[std::min(uint32_t(f), Bins - 1)];
+            }
+            const uint32_t* gpu = reinterpret_cast<const uint32_t*>(backSmall + 32);
+            uint32_t first = Bins;
+            for (uint32_t b = 0; b < Bins && first == Bins; ++b)
+                if (gpu[b] != bins[b]) first = b;
+            op.match = first == Bins;
+            if (op.match) std::snprintf(text, sizeof(text), "%u bins identical", Bins);
+            else std::snprintf(text, sizeof(text), "bin %u: %u vs %u", first, gpu[first], bins[first]);
+            op.detail = text;
+        });
+
+    // --- exclusive scan ---
+    run("exclusive scan", [&](VkCommandBuffer cmd) { prims.exclusive_scan(cmd, wordsIn.address, count, temp.address, out.address); },
+        VkDeviceSize(count) * sizeof(uint32_t),
+        [&](ComputePrimitivesResult::Op& op) {
+            const uint32_t* gpu = reinterpret_cast<const uint32_t*>(back);
+            uint32_t prefix = 0, first = count;
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                if (gpu[i] != prefix && first == count) first = i;
+                prefix += words[i];
+            }
+            op.match = first == count;
+            if (op.match) std::snprintf(text, sizeof(text), "%u prefixes identical, total %u", count, prefix);
+            else std::snprintf(text, sizeof(text), "index %u differs", first);
+            op.detail = text;
+        });
+
+    // --- stream compaction ---
+    run("compaction", [&](VkCommandBuffer cmd) {
+            prims.compact(cmd, floatsIn.address, count, KeepLo, KeepHi, temp.address, out.address, countOut);
+        },
+        VkDeviceSize(count) * sizeof(float),
+        [&](ComputePrimitivesResult::Op& op) {
+            std::vector<float> kept;
+            kept.reserve(count);
+            for (float x : values)
+                if (x >= KeepLo && x <= KeepHi) kept.push_back(x);
+            uint32_t gpuCount = 0;
+            std::memcpy(&gpuCount, backSmall + 16, sizeof(gpuCount));
+            op.match = gpuCount == kept.size() && std::memcmp(back, kept.data(), kept.size() * sizeof(float)) == 0;
+            std::snprintf(text, sizeof(text), "kept %u / %zu of %u, order %s", gpuCount, kept.size(), count,
+                          op.match ? "preserved" : "differs");
+            op.detail = text;
+        });
+
+    for (BenchBuffer* b : {&floatsIn, &wordsIn, &out, &temp, &small, &upload, &readback}) b->destroy(ctx);
+    return r;
+}
+
+bench::RadixSortResult bench::radix_sort(const RenderContext& ctx, uint32_t maxCount)
+{
+    RadixSortResult r{};
+    r.subgroups = ctx.primitives->uses_subgroups();
+    constexpr uint32_t VerifyLimit = 1u << 24;
+    const VkBufferUsageFlags storage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    OneShot os(ctx);
+
+    for (uint64_t n = 1u << 20; n <= maxCount; n *= 4)
+    {
+        RadixSortResult::Size size{};
+        size.count = static_cast<uint32_t>(n);
+        const uint32_t count = size.count;
+        const VkDeviceSize bytes = VkDeviceSize(count) * sizeof(uint32_t);
+        const bool verify = count <= VerifyLimit;
+
+        // keys | values sorted in place, the unsorted originals they are reset from before every sort
+        BenchBuffer keys, values, original, temp, upload, readback;
+        VkResult result = keys.create(ctx, bytes, storage);
+        if (result == VK_SUCCESS) result = values.create(ctx, bytes, storage);
+        if (result == VK_SUCCESS) result = original.create(ctx, bytes * 2, storage);
+        if (result == VK_SUCCESS) result = temp.create(ctx, ComputePrimitives::radix_sort_temp_bytes(count), storage);
+        if (result == VK_SUCCESS) result = upload.create(ctx, bytes * 2, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT);
+        if (result == VK_SUCCESS && verify)
+            result = readback.create(ctx, bytes * 2, VK_BUFFER_USAGE_TRANSFER_DST_BIT, VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT);
+        if (result != VK_SUCCESS)
+        {
+            size.error = std::string("allocation failed: ") + string_VkResult(result);
+            for (BenchBuffer* b : {&keys, &values, &original, &temp, &upload, &readback}) b->destroy(ctx);
+            r.sizes.push_back(std::move(size));
+            break; // larger sizes will not fit either
+        }
+
+        // random 32-bit keys (fixed LCG) with their index as payload
+        uint32_t* staged = static_cast<uint32_t*>(upload.mapped);
+        uint32_t state = 0x9E3779B9u ^ count;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            state = state * 1664525u + 1013904223u;
+            staged[i] = state ^ (state >> 15);
+            staged[count + i] = i;
+        }
+        vmaFlushAllocation(ctx.allocator, upload.allocation, 0, VK_WHOLE_SIZE);
+        os.begin();
+        VkBufferCopy all{0, 0, bytes * 2};
+        vkCmdCopyBuffer(os.cmd, upload.buffer, original.buffer, 1, &all);
+        os.submit_and_wait();
+
+        auto reset = [&](VkCommandBuffer cmd) {
+            VkBufferCopy k{0, 0, bytes}, v{bytes, 0, bytes};
+            vkCmdCopyBuffer(cmd, original.buffer, keys.buffer, 1, &k);
+            vkCmdCopyBuffer(cmd, original.buffer, values.buffer, 1, &v);
+            compute_to_compute(cmd);
+        };
+        // the resets are timed on their own and subtracted
+        const uint32_t reps = count <= (1u << 22) ? 10 : 3;
+        os.begin();
+        ctx.bindless->bind(os.cmd, VK_PIPELINE_BIND_POINT_COMPUTE);
+        for (uint32_t i = 0; i < reps; ++i)
+        {
+            reset(os.cmd);
+            ctx.primitives->radix_sort(os.cmd, keys.address, values.address, count, temp.address);
+            compute_to_compute(os.cmd);
+        }
+        const double sortAndResetMs = os.submit_and_wait();
+        os.begin();
+        for (uint32_t i = 0; i < reps; ++i) reset(os.cmd);
+        const double resetMs = os.submit_and_wait();
+        size.gpuMs = std::max(0.0, sortAndResetMs - resetMs) / reps;
+
+        if (verify)
+        {
+            // keys / values still hold the last sort of the timed batch
+            os.begin();
+            VkBufferCopy k{0, 0, bytes}, v{0, bytes, bytes};
+            vkCmdCopyBuffer(os.cmd, keys.buffer, readback.buffer, 1, &k);
+            vkCmdCopyBuffer(os.cmd, values.buffer, readback.buffer, 1, &v);
+            os.submit_and_wait();
+            vmaInvalidateAllocation(ctx.allocator, readback.allocation, 0, VK_WHOLE_SIZE);
+
+            // (key, index) packed into 64 bits: an unstable sort of these is the stable sort of the keys
+            std::vector<uint64_t> pairs(count);
+            for (uint32_t i = 0; i < count; ++i) pairs[i] = (uint64_t(staged[i]) << 32) | i;
+            auto t0 = Clock::now();
+            std::sort(pairs.begin(), pairs.end());
+            size.cpuMs = ms_since(t0);
+
+            const uint32_t* gpuKeys = static_cast<const uint32_t*>(readback.mapped);
+            const uint32_t* gpuValues = gpuKeys + count;
+            size.verified = true;
+            size.match = true;
+            for (uint32_t i = 0; i < count && size.match; ++i)
+                size.match = gpuKeys[i] == uint32_t(pairs[i] >> 32) && gpuValues[i] == uint32_t(pairs[i]);
+        }
+
+        for (BenchBuffer* b : {&keys, &values, &original, &temp, &upload, &readback}) b->destroy(ctx);
+        r.sizes.push_back(std::move(size));
+    }
+    return r;
+}
+
+bench::TransientAliasingResult bench::transient_aliasing(const RenderContext& ctx)
+{
+    TransientAliasingResult r{};
+    const VkExtent2D extent{1920, 1080};
+    const VkExtent2D half{extent.width / 2, extent.height / 2};
+
+    // Images with the same format, usage and tiling report the same memoryTypeBits, so the
+    // expected sharing below holds on every device. Sizes differ per device and come from
+    // vkGetDeviceImageMemoryRequirements; slots are numbered largest request first.
+    auto depth = [](uint32_t first, uint32_t last)
+    {
+        return TransientDesc{"depth", VK_FORMAT_D32_SFLOAT, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, VK_IMAGE_ASPECT_DEPTH_BIT, {}, first, last};
+    };
+    auto color = [](VkExtent2D e, uint32_t first, uint32_t last)
+    {
+        return TransientDesc{"color", VK_FORMAT_R16G16B16A16_SFLOAT, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+                             VK_IMAGE_ASPECT_COLOR_BIT, e, first, last};
+    };
+    auto bytes = [&](const TransientDesc& d) { return TransientPool::estimate(ctx.device, &d, 1, extent).requestedBytes; };
+    const VkDeviceSize depthBytes = bytes(depth(0, 0));
+    const VkDeviceSize colorBytes = bytes(color({}, 0, 0));
+
+    auto describe = [](const std::vector<uint32_t>& slots, VkDeviceSize allocated)
+    {
+        std::string s = "slots {";
+        for (size_t i = 0; i < slots.size(); i++) s += (i ? ", " : "") + std::to_string(slots[i]);
+        return s + "}, " + std::to_string(allocated) + " bytes";
+    };
+    auto check = [&](const char* name, const std::vector<TransientDesc>& descs, const std::vector<uint32_t>& expectedSlots, VkDeviceSize expectedBytes)
+    {
+        std::vector<uint32_t> slots(descs.size());
+        const TransientPool::Plan p = TransientPool::estimate(ctx.device, descs.data(), descs.size(), extent, slots.data());
+        VkDeviceSize requested = 0;
+        for (const TransientDesc& d : descs) requested += bytes(d);
+        const uint32_t expectedSlotCount = *std::max_element(expectedSlots.begin(), expectedSlots.end()) + 1;
+
+        TransientAliasingResult::Case c{name};
+        c.match = slots == expectedSlots && p.slots == expectedSlotCount && p.allocatedBytes == expectedBytes && p.requestedBytes == requested;
+        c.detail = describe(slots, p.allocatedBytes) + ", expected " + describe(expectedSlots, expectedBytes);
+        r.cases.push_back(std::move(c));
+    };
+
+    check("overlapping", {depth(0, 1), depth(1, 2)}, {0, 1}, 2 * depthBytes);
+    check("disjoint", {depth(0, 0), depth(1, 1)}, {0, 0}, depthBytes);
+    // full-size color [0, 1], depth [0, 0], depth [1, 1], half-size color [2, 2]: the depths share
+    // the second slot and the half-size color reuses the full-size one after pass 1
+    const std::vector<TransientDesc> mixed = {color({}, 0, 1), depth(0, 0), depth(1, 1), color(half, 2, 2)};
+    check("mixed", mixed, {0, 1, 1, 0}, colorBytes + depthBytes);
+
+    // the same list through compile(): one allocation per slot, images bound with vmaCreateAliasingImage
+    {
+        TransientPool pool;
+        pool.init(ctx.device, ctx.allocator);
+        pool.begin(extent);
+        for (const TransientDesc& d : mixed) pool.request(d);
+        const bool built = pool.compile();
+        const TransientPool::Plan p = pool.plan();
+        bool created = true;
+        for (uint32_t i = 0; i < mixed.size(); i++) created = created && pool.get(i).image && pool.get(i).view;
+
+        TransientAliasingResult::Case c{"compiled"};
+        c.match = built && created && p.slots == 2 && p.allocatedBytes == colorBytes + depthBytes;
+        c.detail = std::to_string(p.images) + " images in " + std::to_string(p.slots) + " slots, " + std::to_string(p.allocatedBytes) +
+                   " bytes" + (created ? "" : ", image creation failed");
+        r.cases.push_back(std::move(c));
+        pool.destroy();
+    }
+    return r;
+}
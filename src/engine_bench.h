@@ -0,0 +1,119 @@
+#ifndef ENGINE_BENCH_H
+#define ENGINE_BENCH_H
+
+#include "renderer_iface.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Engine micro-benchmarks. Each one owns the graphics queue while it runs, so the engine
+// only calls them between frames with the device idle.
+namespace bench
+{
+    // Per-draw vkCmdBindDescriptorSets vs. one bindless set bound once + push-constant handles
+    struct DescriptorBindingResult
+    {
+        uint32_t draws{};
+        double setsRecordMs{};     // CPU time to record `draws` dispatches, one set bound per draw
+        double setsSubmitMs{};     // wall time submit -> fence
+        double bindlessRecordMs{}; // CPU time to record `draws` dispatches against the bindless heap
+        double bindlessSubmitMs{};
+    };
+
+    DescriptorBindingResult descriptor_binding(const RenderContext& ctx, uint32_t draws);
+
+    // CPU cost of rewriting a 3-binding set (storage image, combined sampler, ssbo) `updates` times
+    struct DescriptorUpdateResult
+    {
+        uint32_t updates{};
+        double writerMs{};   // DescriptorWriter + vkUpdateDescriptorSets per update
+        double templateMs{}; // one vkUpdateDescriptorSetWithTemplate per update
+    };
+
+    DescriptorUpdateResult descriptor_updates(const RenderContext& ctx, uint32_t updates);
+
+    // One descriptor change per dispatch through each backend; CPU record time only.
+    // A backend the device lacks reports a negative time.
+    struct DescriptorBackendResult
+    {
+        uint32_t changes{};
+        double poolMs{};   // allocate + vkUpdateDescriptorSets + vkCmdBindDescriptorSets
+        double pushMs{};   // vkCmdPushDescriptorSetKHR
+        double bufferMs{}; // vkGetDescriptorEXT into a ring + vkCmdSetDescriptorBufferOffsetsEXT
+    };
+
+    DescriptorBackendResult descriptor_backends(const RenderContext& ctx, uint32_t changes);
+
+    // Retire and destroy `entries` buffers through the std::function DeletionQueue and the
+    // typed queue. Both destroy the same kind of objects, so the gap is queue overhead.
+    struct DeletionQueueResult
+    {
+        uint32_t entries{};
+        double closurePushMs{};
+        double closureFlushMs{};
+        double typedPushMs{};
+        double typedFlushMs{};
+    };
+
+    DeletionQueueResult deletion_queue(const RenderContext& ctx, uint32_t entries);
+
+    // ComputePrimitives (RenderContext::primitives) on `count` device-local elements against CPU
+    // reference implementations: GPU time is the wall time of a batch of calls divided by its size
+    struct ComputePrimitivesResult
+    {
+        struct Op
+        {
+            const char* name{};
+            double gpuMs{};
+            double cpuMs{};
+            bool match{};
+            std::string detail; // what was compared, or the first mismatch
+        };
+
+        uint32_t count{};
+        bool subgroups{};
+        std::vector<Op> ops; // reduce, histogram, exclusive scan, compaction
+    };
+
+    ComputePrimitivesResult compute_primitives(const RenderContext& ctx, uint32_t count);
+
+    // ComputePrimitives::radix_sort on random 32-bit keys with index payloads, 1M keys and then x4
+    // up to maxCount. Sizes the device cannot allocate are reported instead of aborting the run.
+    struct RadixSortResult
+    {
+        struct Size
+        {
+            uint32_t count{};
+            double gpuMs{};    // sort only: (copy + sort) - copy batches, per sort
+            double cpuMs{};    // std::sort of (key, index) pairs, verified sizes only
+            bool verified{};   // read back and checked against the CPU sort (counts <= 16M)
+            bool match{};
+            std::string error; // allocation failure etc.
+        };
+
+        bool subgroups{};
+        std::vector<Size> sizes;
+    };
+
+    RadixSortResult radix_sort(const RenderContext& ctx, uint32_t maxCount);
+
+    // TransientPool slot assignment on request lists with known lifetimes: overlapping requests
+    // must get their own memory, disjoint ones must share it, and a pool compiled from the
+    // aliased list must create every image in the planned memory. No GPU work is submitted.
+    struct TransientAliasingResult
+    {
+        struct Case
+        {
+            const char* name{};
+            bool match{};
+            std::string detail; // slots and bytes assigned against the expected ones
+        };
+
+        std::vector<Case> cases;
+    };
+
+    TransientAliasingResult transient_aliasing(const RenderContext& ctx);
+}
+
+#endif //ENGINE_BENCH_H
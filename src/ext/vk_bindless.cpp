@@ -0,0 +1,215 @@
+#include "vk_bindless.h"
+
+#include <vulkan/vk_enum_string_helper.h>
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <stdexcept>
+#include <string>
+
+#ifndef VK_CHECK
+#define VK_CHECK(x) do { VkResult err__ = (x); if (err__ != VK_SUCCESS) { throw std::runtime_error(std::string("Vulkan error ") + string_VkResult(err__)); } } while(0)
+#endif
+
+//> bindless_slots
+uint32_t BindlessHeap::Slots::acquire()
+{
+    if (!freeList.empty())
+    {
+        uint32_t index = freeList.back();
+        freeList.pop_back();
+        live[index] = true;
+        return index;
+    }
+    if (next >= capacity)
+    {
+        throw std::runtime_error("BindlessHeap: out of descriptor slots");
+    }
+    live.push_back(true);
+    return next++;
+}
+
+void BindlessHeap::Slots::release(uint32_t index)
+{
+    if (index == InvalidIndex) return;
+    const bool valid = index < next && live[index];
+    assert(valid && "BindlessHeap: slot released twice or never acquired");
+    if (!valid) return;
+    live[index] = false;
+    freeList.push_back(index);
+}
+//< bindless_slots
+
+//> bindless_init
+void BindlessHeap::init(VkDevice device, VkPhysicalDevice physical, Capacity capacity)
+{
+    // clamp requested sizes to what the device allows for update-after-bind sets
+    VkPhysicalDeviceVulkan12Properties p12{.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_PROPERTIES};
+    VkPhysicalDeviceProperties2 props{.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2, .pNext = &p12};
+    vkGetPhysicalDeviceProperties2(physical, &props);
+
+    slots[StorageImage].capacity = std::min({capacity.storageImages, p12.maxDescriptorSetUpdateAfterBindStorageImages, p12.maxPerStageDescriptorUpdateAfterBindStorageImages});
+    slots[SampledImage].capacity = std::min({capacity.sampledImages, p12.maxDescriptorSetUpdateAfterBindSampledImages, p12.maxPerStageDescriptorUpdateAfterBindSampledImages});
+    slots[Sampler].capacity = std::min({capacity.samplers, p12.maxDescriptorSetUpdateAfterBindSamplers, p12.maxPerStageDescriptorUpdateAfterBindSamplers});
+    slots[StorageBuffer].capacity = std::min({capacity.storageBuffers, p12.maxDescriptorSetUpdateAfterBindStorageBuffers, p12.maxPerStageDescriptorUpdateAfterBindStorageBuffers});
+
+    const std::array<VkDescriptorType, BindingCount> types = {
+        VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+        VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
+        VK_DESCRIPTOR_TYPE_SAMPLER,
+        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+    };
+
+    std::array<VkDescriptorSetLayoutBinding, BindingCount> bindings{};
+    std::array<VkDescriptorBindingFlags, BindingCount> bindingFlags{};
+    std::array<VkDescriptorPoolSize, BindingCount> poolSizes{};
+    for (uint32_t i = 0; i < BindingCount; i++)
+    {
+        bindings[i].binding = i;
+        bindings[i].descriptorType = types[i];
+        bindings[i].descriptorCount = slots[i].capacity;
+        bindings[i].stageFlags = VK_SHADER_STAGE_ALL;
+        bindingFlags[i] = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT;
+        poolSizes[i] = VkDescriptorPoolSize{.type = types[i], .descriptorCount = slots[i].capacity};
+    }
+
+    VkDescriptorSetLayoutBindingFlagsCreateInfo flagsInfo = {.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO};
+    flagsInfo.bindingCount = BindingCount;
+    flagsInfo.pBindingFlags = bindingFlags.data();
+
+    VkDescriptorSetLayoutCreateInfo dslci = {.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO};
+    dslci.pNext = &flagsInfo;
+    dslci.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+    dslci.bindingCount = BindingCount;
+    dslci.pBindings = bindings.data();
+    VK_CHECK(vkCreateDescriptorSetLayout(device, &dslci, nullptr, &layout));
+
+    VkDescriptorPoolCreateInfo dpci = {.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO};
+    dpci.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+    dpci.maxSets = 1;
+    dpci.poolSizeCount = BindingCount;
+    dpci.pPoolSizes = poolSizes.data();
+    VK_CHECK(vkCreateDescriptorPool(device, &dpci, nullptr, &pool));
+
+    VkDescriptorSetAllocateInfo dsai = {.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO};
+    dsai.descriptorPool = pool;
+    dsai.descriptorSetCount = 1;
+    dsai.pSetLayouts = &layout;
+    VK_CHECK(vkAllocateDescriptorSets(device, &dsai, &set));
+
+    VkPushConstantRange pcr{};
+    pcr.stageFlags = VK_SHADER_STAGE_ALL;
+    pcr.offset = 0;
+    pcr.size = PushConstantSize;
+
+    VkPipelineLayoutCreateInfo plci = {.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO};
+    plci.setLayoutCount = 1;
+    plci.pSetLayouts = &layout;
+    plci.pushConstantRangeCount = 1;
+    plci.pPushConstantRanges = &pcr;
+    VK_CHECK(vkCreatePipelineLayout(device, &plci, nullptr, &pipelineLayout));
+}
+
+void BindlessHeap::destroy(VkDevice device)
+{
+    if (pipelineLayout) { vkDestroyPipelineLayout(device, pipelineLayout, nullptr); pipelineLayout = VK_NULL_HANDLE; }
+    if (pool) { vkDestroyDescriptorPool(device, pool, nullptr); pool = VK_NULL_HANDLE; }
+    if (layout) { vkDestroyDescriptorSetLayout(device, layout, nullptr); layout = VK_NULL_HANDLE; }
+    set = VK_NULL_HANDLE;
+    for (auto& s : slots) { s = Slots{}; }
+}
+//< bindless_init
+
+//> bindless_write
+void BindlessHeap::write_image(VkDevice device, Binding binding, uint32_t index, VkImageView view, VkSampler sampler, VkImageLayout imageLayout)
+{
+    static constexpr VkDescriptorType types[] = {
+        VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, VK_DESCRIPTOR_TYPE_SAMPLER
+    };
+
+    VkDescriptorImageInfo info{.sampler = sampler, .imageView = view, .imageLayout = imageLayout};
+
+    VkWriteDescriptorSet write = {.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
+    write.dstSet = set;
+    write.dstBinding = binding;
+    write.dstArrayElement = index;
+    write.descriptorCount = 1;
+    write.descriptorType = types[binding];
+    write.pImageInfo = &info;
+    vkUpdateDescriptorSets(device, 1, &write, 0, nullptr);
+}
+
+uint32_t BindlessHeap::add_storage_image(VkDevice device, VkImageView view, VkImageLayout imageLayout)
+{
+    uint32_t index = slots[StorageImage].acquire();
+    write_image(device, StorageImage, index, view, VK_NULL_HANDLE, imageLayout);
+    return index;
+}
+
+uint32_t BindlessHeap::add_sampled_image(VkDevice device, VkImageView view, VkImageLayout imageLayout)
+{
+    uint32_t index = slots[SampledImage].acquire();
+    write_image(device, SampledImage, index, view, VK_NULL_HANDLE, imageLayout);
+    return index;
+}
+
+uint32_t BindlessHeap::add_sampler(VkDevice device, VkSampler sampler)
+{
+    uint32_t index = slots[Sampler].acquire();
+    write_image(device, Sampler, index, VK_NULL_HANDLE, sampler, VK_IMAGE_LAYOUT_UNDEFINED);
+    return index;
+}
+
+uint32_t BindlessHeap::add_storage_buffer(VkDevice device, VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range)
+{
+    uint32_t index = slots[StorageBuffer].acquire();
+    update_storage_buffer(device, index, buffer, offset, range);
+    return index;
+}
+
+void BindlessHeap::update_storage_image(VkDevice device, uint32_t index, VkImageView view, VkImageLayout imageLayout)
+{
+    write_image(device, StorageImage, index, view, VK_NULL_HANDLE, imageLayout);
+}
+
+void BindlessHeap::update_sampled_image(VkDevice device, uint32_t index, VkImageView view, VkImageLayout imageLayout)
+{
+    write_image(device, SampledImage, index, view, VK_NULL_HANDLE, imageLayout);
+}
+
+void BindlessHeap::update_storage_buffer(VkDevice device, uint32_t index, VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range)
+{
+    VkDescriptorBufferInfo info{.buffer = buffer, .offset = offset, .range = range};
+
+    VkWriteDescriptorSet write = {.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
+    write.dstSet = set;
+    write.dstBinding = StorageBuffer;
+    write.dstArrayElement = index;
+    write.descriptorCount = 1;
+    write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    write.pBufferInfo = &info;
+    vkUpdateDescriptorSets(device, 1, &write, 0, nullptr);
+}
+
+void BindlessHeap::release(Binding binding, uint32_t index)
+{
+    slots[binding].release(index);
+}
+//< bindless_write
+
+//> bindless_bind
+void BindlessHeap::bind(VkCommandBuffer cmd, VkPipelineBindPoint bindPoint) const
+{
+    vkCmdBindDescriptorSets(cmd, bindPoint, pipelineLayout, 0, 1, &set, 0, nullptr);
+}
+
+void BindlessHeap::push(VkCommandBuffer cmd, const void* data, uint32_t size, uint32_t offset) const
+{
+    vkCmdPushConstants(cmd, pipelineLayout, VK_SHADER_STAGE_ALL, offset, size, data);
+}
+
+uint32_t BindlessHeap::live_count(Binding binding) const
+{
+    return slots[binding].next - static_cast<uint32_t>(slots[binding].freeList.size());
+}
+//< bindless_bind
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <vector>
+
+//> bindless_heap
+// Engine-owned global descriptor heap. One update-after-bind set with partially bound
+// arrays, indexed from shaders by 32-bit handles passed in push constants.
+// Binding layout must stay in sync with shaders/bindless.glsl.
+struct BindlessHeap {
+    enum Binding : uint32_t {
+        StorageImage = 0,
+        SampledImage = 1,
+        Sampler = 2,
+        StorageBuffer = 3,
+        BindingCount = 4
+    };
+
+    static constexpr uint32_t InvalidIndex = ~0u;
+    static constexpr uint32_t PushConstantSize = 128; // guaranteed minimum of maxPushConstantsSize
+
+    struct Capacity {
+        uint32_t storageImages = 4096;
+        uint32_t sampledImages = 4096;
+        uint32_t samplers = 256;
+        uint32_t storageBuffers = 4096;
+    };
+
+    void init(VkDevice device, VkPhysicalDevice physical, Capacity capacity = {});
+    void destroy(VkDevice device);
+
+    // Handles stay valid until released. Releasing a handle that an in-flight frame still
+    // reads is the caller's problem; retire it after the frame fence like any other resource.
+    uint32_t add_storage_image(VkDevice device, VkImageView view, VkImageLayout layout = VK_IMAGE_LAYOUT_GENERAL);
+    uint32_t add_sampled_image(VkDevice device, VkImageView view, VkImageLayout layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    uint32_t add_sampler(VkDevice device, VkSampler sampler);
+    uint32_t add_storage_buffer(VkDevice device, VkBuffer buffer, VkDeviceSize offset = 0, VkDeviceSize range = VK_WHOLE_SIZE);
+
+    // Re-point an existing handle (e.g. after the offscreen drawable is recreated)
+    void update_storage_image(VkDevice device, uint32_t index, VkImageView view, VkImageLayout layout = VK_IMAGE_LAYOUT_GENERAL);
+    void update_sampled_image(VkDevice device, uint32_t index, VkImageView view, VkImageLayout layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    void update_storage_buffer(VkDevice device, uint32_t index, VkBuffer buffer, VkDeviceSize offset = 0, VkDeviceSize range = VK_WHOLE_SIZE);
+
+    void release(Binding binding, uint32_t index);
+
+    // Bind the heap at set 0 through the shared pipeline layout
+    void bind(VkCommandBuffer cmd, VkPipelineBindPoint bindPoint) const;
+    // Push constants through the shared layout (stage flags must be VK_SHADER_STAGE_ALL)
+    void push(VkCommandBuffer cmd, const void* data, uint32_t size, uint32_t offset = 0) const;
+
+    uint32_t live_count(Binding binding) const;
+    uint32_t capacity(Binding binding) const { return slots[binding].capacity; }
+
+    VkDescriptorSetLayout layout{};
+    VkPipelineLayout pipelineLayout{}; // set 0 = heap, PushConstantSize bytes of push constants for all stages
+    VkDescriptorPool pool{};
+    VkDescriptorSet set{};
+
+private:
+    struct Slots {
+        std::vector<uint32_t> freeList;
+        std::vector<bool> live; // indexed by slot; guards against releasing a slot twice
+        uint32_t next = 0;
+        uint32_t capacity = 0;
+
+        uint32_t acquire();
+        // Releasing a slot that is not live (double release, never acquired) asserts and is ignored
+        void release(uint32_t index);
+    };
+
+    void write_image(VkDevice device, Binding binding, uint32_t index, VkImageView view, VkSampler sampler, VkImageLayout layout);
+
+    Slots slots[BindingCount];
+};
+//< bindless_heap
@@ -0,0 +1,299 @@
+#include "vk_compute_primitives.h"
+#include "vk_bindless.h"
+#include "vk_pipelines.h"
+
+#include <vulkan/vk_enum_string_helper.h>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#ifndef VK_CHECK
+#define VK_CHECK(x) do { VkResult err__ = (x); if (err__ != VK_SUCCESS) { throw std::runtime_error(std::string("Vulkan error ") + string_VkResult(err__)); } } while(0)
+#endif
+
+namespace {
+
+constexpr uint32_t WorkgroupSize = 256;
+constexpr uint32_t MaxReduceGroups = 1024;   // pass 1 folds the partials with one workgroup
+constexpr uint32_t MaxHistogramGroups = 512; // each group adds its bins to global memory once
+constexpr uint32_t MaxGroupsX = 65535;       // guaranteed maxComputeWorkGroupCount[0]
+
+// Push blocks of the prim_*.comp kernels
+struct FillPush {
+    VkDeviceAddress data;
+    uint32_t count;
+    uint32_t value;
+};
+
+struct ReducePush {
+    VkDeviceAddress data;
+    VkDeviceAddress partials;
+    VkDeviceAddress out;
+    uint32_t count;
+    uint32_t partialCount;
+    uint32_t pass;
+};
+
+struct HistogramPush {
+    VkDeviceAddress data;
+    VkDeviceAddress out;
+    uint32_t count;
+    uint32_t bins;
+    float lo;
+    float invWidth;
+};
+
+struct ScanPush {
+    VkDeviceAddress data;
+    VkDeviceAddress out;
+    VkDeviceAddress blockSums;
+    uint32_t count;
+    uint32_t blocks;
+    uint32_t pass;
+};
+
+struct RadixPush {
+    VkDeviceAddress keysIn;
+    VkDeviceAddress valuesIn;
+    VkDeviceAddress keysOut;
+    VkDeviceAddress valuesOut;
+    VkDeviceAddress histogram;
+    uint32_t count;
+    uint32_t blocks;
+    uint32_t shift;
+    uint32_t pass;
+};
+
+struct CompactPush {
+    VkDeviceAddress data;
+    VkDeviceAddress out;
+    VkDeviceAddress blockCounts;
+    VkDeviceAddress outCount;
+    uint32_t count;
+    uint32_t blocks;
+    uint32_t pass;
+    float lo;
+    float hi;
+};
+
+VkPipeline create_kernel(VkDevice device, VkPipelineLayout layout, const std::string& name, bool subgroups)
+{
+    const std::string path = "./shaders/" + name + (subgroups ? ".subgroup.comp.spv" : ".comp.spv");
+    return vkutil::create_compute_pipeline(device, layout, path.c_str());
+}
+
+// Compute write -> compute read/write between two passes
+void pass_barrier(VkCommandBuffer cmd)
+{
+    VkMemoryBarrier2 mb{VK_STRUCTURE_TYPE_MEMORY_BARRIER_2};
+    mb.srcStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+    mb.srcAccessMask = VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+    mb.dstStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+    mb.dstAccessMask = VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+    VkDependencyInfo dep{VK_STRUCTURE_TYPE_DEPENDENCY_INFO};
+    dep.memoryBarrierCount = 1;
+    dep.pMemoryBarriers = &mb;
+    vkCmdPipelineBarrier2(cmd, &dep);
+}
+
+uint32_t reduce_groups(uint32_t count)
+{
+    return std::clamp((count + WorkgroupSize - 1) / WorkgroupSize, 1u, MaxReduceGroups);
+}
+
+uint32_t block_count(uint32_t count)
+{
+    return static_cast<uint32_t>((uint64_t(count) + ComputePrimitives::BlockItems - 1) / ComputePrimitives::BlockItems);
+}
+
+VkDeviceSize align16(VkDeviceSize size) { return (size + 15) & ~VkDeviceSize(15); }
+
+// radix_sort temp layout: alternate keys | alternate values | digit-major histogram | scan temp
+struct RadixTemp {
+    VkDeviceSize keys, values, histogram, scan, total;
+
+    explicit RadixTemp(uint32_t count)
+    {
+        const VkDeviceSize pairs = align16(VkDeviceSize(count) * sizeof(uint32_t));
+        const uint32_t histogramWords = 16 * block_count(count);
+        keys = 0;
+        values = pairs;
+        histogram = 2 * pairs;
+        scan = histogram + align16(VkDeviceSize(histogramWords) * sizeof(uint32_t));
+        total = scan + ComputePrimitives::scan_temp_bytes(histogramWords);
+    }
+};
+
+} // namespace
+
+//> compute_primitives_init
+void ComputePrimitives::init(VkDevice device, const BindlessHeap& bindless, bool useSubgroups)
+{
+    heap = &bindless;
+    subgroups = useSubgroups;
+    // fill has nothing to gain from subgroups and is only built plain
+    fillPipeline = create_kernel(device, bindless.pipelineLayout, "prim_fill", false);
+    reducePipeline = create_kernel(device, bindless.pipelineLayout, "prim_reduce", subgroups);
+    histogramPipeline = create_kernel(device, bindless.pipelineLayout, "prim_histogram", subgroups);
+    scanPipeline = create_kernel(device, bindless.pipelineLayout, "prim_scan", subgroups);
+    compactPipeline = create_kernel(device, bindless.pipelineLayout, "prim_compact", subgroups);
+    radixPipeline = create_kernel(device, bindless.pipelineLayout, "prim_radix", subgroups);
+}
+
+void ComputePrimitives::destroy(VkDevice device)
+{
+    for (VkPipeline* p : {&fillPipeline, &reducePipeline, &histogramPipeline, &scanPipeline, &compactPipeline, &radixPipeline})
+    {
+        if (*p) vkDestroyPipeline(device, *p, nullptr);
+        *p = VK_NULL_HANDLE;
+    }
+    heap = nullptr;
+}
+//< compute_primitives_init
+
+void ComputePrimitives::dispatch_blocks(VkCommandBuffer cmd, uint32_t blocks) const
+{
+    // 2D grid; the kernels skip block ids past `blocks` (prim_block_id)
+    const uint32_t x = std::min(blocks, MaxGroupsX);
+    vkCmdDispatch(cmd, x, (blocks + x - 1) / x, 1);
+}
+
+void ComputePrimitives::fill(VkCommandBuffer cmd, VkDeviceAddress data, uint32_t count, uint32_t value) const
+{
+    if (count == 0) return;
+    FillPush p{data, count, value};
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, fillPipeline);
+    heap->push(cmd, &p, sizeof(p));
+    vkCmdDispatch(cmd, std::min((count + WorkgroupSize - 1) / WorkgroupSize, MaxGroupsX), 1, 1);
+}
+
+//> compute_primitives_reduce
+VkDeviceSize ComputePrimitives::reduce_temp_bytes(uint32_t count)
+{
+    return VkDeviceSize(reduce_groups(count)) * sizeof(ReduceResult);
+}
+
+void ComputePrimitives::reduce(VkCommandBuffer cmd, VkDeviceAddress data, uint32_t count, VkDeviceAddress temp, VkDeviceAddress out) const
+{
+    const uint32_t groups = reduce_groups(count);
+    ReducePush p{data, temp, out, count, groups, 0};
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, reducePipeline);
+    heap->push(cmd, &p, sizeof(p));
+    vkCmdDispatch(cmd, groups, 1, 1);
+    pass_barrier(cmd);
+    p.pass = 1;
+    heap->push(cmd, &p, sizeof(p));
+    vkCmdDispatch(cmd, 1, 1, 1);
+}
+//< compute_primitives_reduce
+
+//> compute_primitives_histogram
+void ComputePrimitives::histogram(VkCommandBuffer cmd, VkDeviceAddress data, uint32_t count, float lo, float hi, uint32_t bins,
+                                  VkDeviceAddress out) const
+{
+    if (bins == 0 || bins > MaxHistogramBins || !(hi > lo))
+        throw std::runtime_error("ComputePrimitives::histogram: need 0 < bins <= " + std::to_string(MaxHistogramBins) + " and lo < hi");
+    fill(cmd, out, bins, 0);
+    if (count == 0) return;
+    pass_barrier(cmd);
+    // the kernel bins with (x - lo) * invWidth in float; CPU references must do the same
+    HistogramPush p{data, out, count, bins, lo, float(bins) / (hi - lo)};
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, histogramPipeline);
+    heap->push(cmd, &p, sizeof(p));
+    vkCmdDispatch(cmd, std::clamp((count + WorkgroupSize * 16 - 1) / (WorkgroupSize * 16), 1u, MaxHistogramGroups), 1, 1);
+}
+//< compute_primitives_histogram
+
+//> compute_primitives_scan
+VkDeviceSize ComputePrimitives::scan_temp_bytes(uint32_t count)
+{
+    // one word per block plus the total
+    return VkDeviceSize(block_count(count) + 1) * sizeof(uint32_t);
+}
+
+void ComputePrimitives::exclusive_scan(VkCommandBuffer cmd, VkDeviceAddress data, uint32_t count, VkDeviceAddress temp, VkDeviceAddress out) const
+{
+    if (count == 0) return;
+    const uint32_t blocks = block_count(count);
+    ScanPush p{data, out, temp, count, blocks, 0};
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, scanPipeline);
+    heap->push(cmd, &p, sizeof(p));
+    dispatch_blocks(cmd, blocks);
+    pass_barrier(cmd);
+    p.pass = 1;
+    heap->push(cmd, &p, sizeof(p));
+    vkCmdDispatch(cmd, 1, 1, 1);
+    pass_barrier(cmd);
+    p.pass = 2;
+    heap->push(cmd, &p, sizeof(p));
+    dispatch_blocks(cmd, blocks);
+}
+//< compute_primitives_scan
+
+//> compute_primitives_compact
+void ComputePrimitives::compact(VkCommandBuffer cmd, VkDeviceAddress data, uint32_t count, float lo, float hi, VkDeviceAddress temp,
+                                VkDeviceAddress out, VkDeviceAddress outCount) const
+{
+    if (count == 0)
+    {
+        fill(cmd, outCount, 1, 0);
+        return;
+    }
+    const uint32_t blocks = block_count(count);
+    CompactPush p{data, out, temp, outCount, count, blocks, 0, lo, hi};
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, compactPipeline);
+    heap->push(cmd, &p, sizeof(p));
+    dispatch_blocks(cmd, blocks);
+    pass_barrier(cmd);
+
+    // block counts -> exclusive offsets + total, shared with exclusive_scan
+    ScanPush sp{0, 0, temp, 0, blocks, 1};
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, scanPipeline);
+    heap->push(cmd, &sp, sizeof(sp));
+    vkCmdDispatch(cmd, 1, 1, 1);
+    pass_barrier(cmd);
+
+    p.pass = 2;
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, compactPipeline);
+    heap->push(cmd, &p, sizeof(p));
+    dispatch_blocks(cmd, blocks);
+}
+//< compute_primitives_compact
+
+//> compute_primitives_radix
+VkDeviceSize ComputePrimitives::radix_sort_temp_bytes(uint32_t count)
+{
+    return RadixTemp(count).total;
+}
+
+void ComputePrimitives::radix_sort(VkCommandBuffer cmd, VkDeviceAddress keys, VkDeviceAddress values, uint32_t count, VkDeviceAddress temp,
+                                   uint32_t keyBits) const
+{
+    if (count < 2 || keyBits == 0) return;
+    const RadixTemp layout(count);
+    const uint32_t blocks = block_count(count);
+    const uint32_t passes = std::min((keyBits + 7) / 8, 4u) * 2;
+    VkDeviceAddress src[2] = {keys, values};
+    VkDeviceAddress dst[2] = {temp + layout.keys, temp + layout.values};
+    const VkDeviceAddress histogram = temp + layout.histogram;
+
+    for (uint32_t pass = 0; pass < passes; ++pass)
+    {
+        RadixPush p{src[0], src[1], dst[0], dst[1], histogram, count, blocks, pass * 4, 0};
+        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, radixPipeline);
+        heap->push(cmd, &p, sizeof(p));
+        dispatch_blocks(cmd, blocks);
+        pass_barrier(cmd);
+        exclusive_scan(cmd, histogram, 16 * blocks, temp + layout.scan, histogram);
+        pass_barrier(cmd);
+        p.pass = 1;
+        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, radixPipeline);
+        heap->push(cmd, &p, sizeof(p));
+        dispatch_blocks(cmd, blocks);
+        if (pass + 1 < passes) pass_barrier(cmd);
+        std::swap(src[0], dst[0]);
+        std::swap(src[1], dst[1]);
+    }
+}
+//< compute_primitives_radix
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+
+struct BindlessHeap;
+
+//> compute_primitives
+// Data-parallel building blocks recorded into the caller's command buffer: fill, reduction
+// (min / max / sum / sum of squares), histogram, exclusive prefix sum, stream compaction and
+// radix sort.
+// All buffers are passed by device address and the pipelines use the bindless heap's shared
+// layout, so the heap must be bound for compute (the engine does that once per frame).
+//
+// Each call records its own barriers between internal passes. The caller orders the inputs
+// before the call and the outputs after it (compute shader write -> whatever reads them).
+// Kernels that need temporary memory take a `temp` address of at least *_temp_bytes(count)
+// bytes; frame scratch works, a device-local buffer is faster on discrete GPUs.
+//
+// With subgroup arithmetic + ballot support the *.subgroup.comp.spv variants are used:
+// reductions and scans run inside a subgroup first and only the per-subgroup partials go
+// through shared memory; the histogram merges lanes hitting the same bin with a ballot.
+struct ComputePrimitives {
+    // Result of reduce(), 16 bytes at the `out` address
+    struct ReduceResult {
+        float min;
+        float max;
+        float sum;
+        float sumSquares;
+    };
+
+    static constexpr uint32_t MaxHistogramBins = 2048; // shared-memory bins per workgroup
+    static constexpr uint32_t BlockItems = 1024;       // scan / compaction items per workgroup
+
+    void init(VkDevice device, const BindlessHeap& heap, bool subgroups);
+    void destroy(VkDevice device);
+
+    bool uses_subgroups() const { return subgroups; }
+
+    // data[i] = value for i < count
+    void fill(VkCommandBuffer cmd, VkDeviceAddress data, uint32_t count, uint32_t value) const;
+
+    // min / max / sum / sum of squares of `count` floats, NaNs skipped; empty input gives (+inf, -inf, 0, 0)
+    static VkDeviceSize reduce_temp_bytes(uint32_t count);
+    void reduce(VkCommandBuffer cmd, VkDeviceAddress data, uint32_t count, VkDeviceAddress temp, VkDeviceAddress out) const;
+
+    // out[b] = number of values with lo + b * w <= x < lo + (b + 1) * w, w = (hi - lo) / bins.
+    // out is cleared first; bins <= MaxHistogramBins
+    void histogram(VkCommandBuffer cmd, VkDeviceAddress data, uint32_t count, float lo, float hi, uint32_t bins,
+                   VkDeviceAddress out) const;
+
+    // out[i] = data[0] + ... + data[i - 1] (uint32, wrapping); out may equal data
+    static VkDeviceSize scan_temp_bytes(uint32_t count);
+    void exclusive_scan(VkCommandBuffer cmd, VkDeviceAddress data, uint32_t count, VkDeviceAddress temp, VkDeviceAddress out) const;
+
+    // Copy the floats with lo <= x <= hi to out in order and store how many were kept (uint32) at outCount.
+    // out needs room for `count` floats
+    static VkDeviceSize compact_temp_bytes(uint32_t count) { return scan_temp_bytes(count); }
+    void compact(VkCommandBuffer cmd, VkDeviceAddress data, uint32_t count, float lo, float hi, VkDeviceAddress temp,
+                 VkDeviceAddress out, VkDeviceAddress outCount) const;
+
+    // Stable ascending LSD radix sort of `count` (uint32 key, uint32 value) pairs in place, 4 bits per
+    // pass. Only the low keyBits bits of the keys are compared, rounded up to a multiple of 8 so the
+    // ping-pong through temp ends back in keys / values (keyBits = 16 sorts tile or glyph ids in 4
+    // passes instead of 8). temp holds a second copy of the pairs, so use a device-local buffer
+    // for large counts rather than frame scratch.
+    static VkDeviceSize radix_sort_temp_bytes(uint32_t count);
+    void radix_sort(VkCommandBuffer cmd, VkDeviceAddress keys, VkDeviceAddress values, uint32_t count, VkDeviceAddress temp,
+                    uint32_t keyBits = 32) const;
+
+private:
+    void dispatch_blocks(VkCommandBuffer cmd, uint32_t blocks) const;
+
+    const BindlessHeap* heap{};
+    bool subgroups = false;
+    VkPipeline fillPipeline{};
+    VkPipeline reducePipeline{};
+    VkPipeline histogramPipeline{};
+    VkPipeline scanPipeline{};
+    VkPipeline compactPipeline{};
+    VkPipeline radixPipeline{};
+};
+//< compute_primitives
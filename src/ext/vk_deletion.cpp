@@ -0,0 +1,91 @@
+#include "vk_deletion.h"
+#include "src/gpu_memory.h"
+
+#include <array>
+
+//> typed_deletion_collect
+void TypedDeletionQueue::collect(VkDevice device, VmaAllocator allocator, uint64_t completedValue)
+{
+    constexpr size_t kinds = static_cast<size_t>(Kind::Count);
+
+    // counting sort of the ready records by kind; pending ones are compacted in place
+    std::array<size_t, kinds + 1> start{};
+    for (const Entry& e : entries)
+    {
+        if (e.retireValue <= completedValue) start[static_cast<size_t>(e.kind) + 1]++;
+    }
+    for (size_t k = 0; k < kinds; k++) start[k + 1] += start[k];
+    if (start[kinds] == 0) return;
+
+    ready.resize(start[kinds]);
+    std::array<size_t, kinds> cursor{};
+    for (size_t k = 0; k < kinds; k++) cursor[k] = start[k];
+
+    size_t kept = 0;
+    for (const Entry& e : entries)
+    {
+        if (e.retireValue <= completedValue)
+            ready[cursor[static_cast<size_t>(e.kind)]++] = e;
+        else
+            entries[kept++] = e;
+    }
+    entries.resize(kept);
+
+    for (size_t k = 0; k < kinds; k++)
+    {
+        if (start[k] != start[k + 1])
+            destroy_batch(device, allocator, static_cast<Kind>(k), ready.data() + start[k], ready.data() + start[k + 1]);
+    }
+    ready.clear();
+}
+
+void TypedDeletionQueue::flush(VkDevice device, VmaAllocator allocator)
+{
+    collect(device, allocator, UINT64_MAX);
+}
+//< typed_deletion_collect
+
+//> typed_deletion_batch
+void TypedDeletionQueue::destroy_batch(VkDevice device, VmaAllocator allocator, Kind kind, const Entry* begin, const Entry* end)
+{
+    switch (kind)
+    {
+    case Kind::Pipeline:
+        for (auto* e = begin; e != end; ++e) vkDestroyPipeline(device, (VkPipeline)e->handle, nullptr);
+        break;
+    case Kind::PipelineLayout:
+        for (auto* e = begin; e != end; ++e) vkDestroyPipelineLayout(device, (VkPipelineLayout)e->handle, nullptr);
+        break;
+    case Kind::DescriptorSetLayout:
+        for (auto* e = begin; e != end; ++e) vkDestroyDescriptorSetLayout(device, (VkDescriptorSetLayout)e->handle, nullptr);
+        break;
+    case Kind::DescriptorPool:
+        for (auto* e = begin; e != end; ++e) vkDestroyDescriptorPool(device, (VkDescriptorPool)e->handle, nullptr);
+        break;
+    case Kind::ShaderModule:
+        for (auto* e = begin; e != end; ++e) vkDestroyShaderModule(device, (VkShaderModule)e->handle, nullptr);
+        break;
+    case Kind::Sampler:
+        for (auto* e = begin; e != end; ++e) vkDestroySampler(device, (VkSampler)e->handle, nullptr);
+        break;
+    case Kind::ImageView:
+        for (auto* e = begin; e != end; ++e) vkDestroyImageView(device, (VkImageView)e->handle, nullptr);
+        break;
+    case Kind::Image:
+    case Kind::Buffer:
+        // destroy the handles first, then hand every allocation back to VMA in one call
+        allocations.clear();
+        for (auto* e = begin; e != end; ++e)
+        {
+            if (kind == Kind::Image) vkDestroyImage(device, (VkImage)e->handle, nullptr);
+            else vkDestroyBuffer(device, (VkBuffer)e->handle, nullptr);
+            if (e->allocation) allocations.push_back(e->allocation);
+        }
+        if (!allocations.empty())
+            gpu_memory::free_memory_pages(allocator, allocations.size(), allocations.data());
+        break;
+    case Kind::Count:
+        break;
+    }
+}
+//< typed_deletion_batch
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include "vk_mem_alloc.h"
+#include <cstdint>
+#include <vector>
+
+//> typed_deletion_queue
+// Deferred destruction without closures: each retired object is a plain
+// (kind, handle, allocation, retire value) record in a flat vector.
+// Records are tagged with the value current at push time (the engine uses the frame
+// number) and destroyed by collect() once the GPU has passed that value, grouped by
+// kind so each batch runs one tight loop and VMA memory is freed with one call.
+struct TypedDeletionQueue {
+    // Destroy order inside a batch: dependants before the objects they reference
+    enum class Kind : uint8_t {
+        Pipeline,
+        PipelineLayout,
+        DescriptorSetLayout,
+        DescriptorPool,
+        ShaderModule,
+        Sampler,
+        ImageView,
+        Image,
+        Buffer,
+        Count
+    };
+
+    struct Entry {
+        uint64_t handle;
+        VmaAllocation allocation;
+        uint64_t retireValue;
+        Kind kind;
+    };
+
+    void set_current_value(uint64_t value) { currentValue = value; }
+    uint64_t current_value() const { return currentValue; }
+
+    void push(Kind kind, uint64_t handle, VmaAllocation allocation = nullptr)
+    {
+        entries.push_back(Entry{handle, allocation, currentValue, kind});
+    }
+
+    void push_buffer(VkBuffer buffer, VmaAllocation allocation) { push(Kind::Buffer, (uint64_t)buffer, allocation); }
+    void push_image(VkImage image, VmaAllocation allocation) { push(Kind::Image, (uint64_t)image, allocation); }
+    void push_image_view(VkImageView view) { push(Kind::ImageView, (uint64_t)view); }
+    void push_sampler(VkSampler sampler) { push(Kind::Sampler, (uint64_t)sampler); }
+    void push_pipeline(VkPipeline pipeline) { push(Kind::Pipeline, (uint64_t)pipeline); }
+    void push_pipeline_layout(VkPipelineLayout layout) { push(Kind::PipelineLayout, (uint64_t)layout); }
+    void push_descriptor_set_layout(VkDescriptorSetLayout layout) { push(Kind::DescriptorSetLayout, (uint64_t)layout); }
+    void push_descriptor_pool(VkDescriptorPool pool) { push(Kind::DescriptorPool, (uint64_t)pool); }
+    void push_shader_module(VkShaderModule module) { push(Kind::ShaderModule, (uint64_t)module); }
+
+    // Destroy every record whose retire value is <= completedValue
+    void collect(VkDevice device, VmaAllocator allocator, uint64_t completedValue);
+    // Destroy everything regardless of value (device must be idle)
+    void flush(VkDevice device, VmaAllocator allocator);
+
+    size_t pending() const { return entries.size(); }
+    void reserve(size_t count) { entries.reserve(count); }
+
+private:
+    void destroy_batch(VkDevice device, VmaAllocator allocator, Kind kind, const Entry* begin, const Entry* end);
+
+    std::vector<Entry> entries;
+    std::vector<Entry> ready;              // reused between collects
+    std::vector<VmaAllocation> allocations; // reused between collects
+    uint64_t currentValue = 0;
+};
+//< typed_deletion_queue
@@ -0,0 +1,118 @@
+#include "vk_descriptor_buffer.h"
+#include "vk_descriptors.h"
+#include "src/gpu_memory.h"
+
+#include <vulkan/vk_enum_string_helper.h>
+#include <stdexcept>
+#include <string>
+
+#ifndef VK_CHECK
+#define VK_CHECK(x) do { VkResult err__ = (x); if (err__ != VK_SUCCESS) { throw std::runtime_error(std::string("Vulkan error ") + string_VkResult(err__)); } } while(0)
+#endif
+
+//> descriptor_buffer_api
+bool DescriptorBufferApi::load(VkDevice device, VkPhysicalDevice physical)
+{
+    getLayoutSize = reinterpret_cast<PFN_vkGetDescriptorSetLayoutSizeEXT>(vkGetDeviceProcAddr(device, "vkGetDescriptorSetLayoutSizeEXT"));
+    getBindingOffset = reinterpret_cast<PFN_vkGetDescriptorSetLayoutBindingOffsetEXT>(vkGetDeviceProcAddr(device, "vkGetDescriptorSetLayoutBindingOffsetEXT"));
+    getDescriptor = reinterpret_cast<PFN_vkGetDescriptorEXT>(vkGetDeviceProcAddr(device, "vkGetDescriptorEXT"));
+    cmdBindBuffers = reinterpret_cast<PFN_vkCmdBindDescriptorBuffersEXT>(vkGetDeviceProcAddr(device, "vkCmdBindDescriptorBuffersEXT"));
+    cmdSetOffsets = reinterpret_cast<PFN_vkCmdSetDescriptorBufferOffsetsEXT>(vkGetDeviceProcAddr(device, "vkCmdSetDescriptorBufferOffsetsEXT"));
+
+    VkPhysicalDeviceProperties2 p2{.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2, .pNext = &props};
+    vkGetPhysicalDeviceProperties2(physical, &p2);
+    props.pNext = nullptr;
+
+    return getLayoutSize && getBindingOffset && getDescriptor && cmdBindBuffers && cmdSetOffsets;
+}
+
+size_t DescriptorBufferApi::descriptor_size(VkDescriptorType type) const
+{
+    switch (type)
+    {
+    case VK_DESCRIPTOR_TYPE_SAMPLER: return props.samplerDescriptorSize;
+    case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER: return props.combinedImageSamplerDescriptorSize;
+    case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE: return props.sampledImageDescriptorSize;
+    case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE: return props.storageImageDescriptorSize;
+    case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER: return props.uniformBufferDescriptorSize;
+    case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER: return props.storageBufferDescriptorSize;
+    default: throw std::runtime_error(std::string("DescriptorBufferApi: unsupported type ") + string_VkDescriptorType(type));
+    }
+}
+//< descriptor_buffer_api
+
+//> descriptor_buffer_ring
+void DescriptorBufferRing::init(VkDevice device, VmaAllocator allocator, const DescriptorBufferApi* descriptorApi, VkDeviceSize bytes)
+{
+    api = descriptorApi;
+    size = bytes;
+    head = 0;
+    highWater = 0;
+
+    // combined image samplers live in resource memory but need the sampler usage bit too
+    usage = VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT | VK_BUFFER_USAGE_SAMPLER_DESCRIPTOR_BUFFER_BIT_EXT
+        | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+
+    VkBufferCreateInfo bci = {.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+    bci.size = size;
+    bci.usage = usage;
+
+    VmaAllocationCreateInfo ai{};
+    ai.usage = VMA_MEMORY_USAGE_AUTO;
+    ai.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+    VmaAllocationInfo info{};
+    VK_CHECK(gpu_memory::create_buffer(allocator, bci, ai, "Engine/descriptor-ring", &buffer, &allocation, &info));
+    mapped = static_cast<uint8_t*>(info.pMappedData);
+
+    VkBufferDeviceAddressInfo dai = {.sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO};
+    dai.buffer = buffer;
+    address = vkGetBufferDeviceAddress(device, &dai);
+}
+
+void DescriptorBufferRing::destroy(VmaAllocator allocator)
+{
+    if (buffer)
+    {
+        gpu_memory::destroy_buffer(allocator, buffer, allocation);
+    }
+    *this = DescriptorBufferRing{};
+}
+
+void DescriptorBufferRing::reset()
+{
+    head = 0;
+}
+
+VkDeviceSize DescriptorBufferRing::push(VkDevice device, VkDescriptorSetLayout layout, const DescriptorWriter& writer)
+{
+    VkDeviceSize setSize = 0;
+    api->getLayoutSize(device, layout, &setSize);
+
+    const VkDeviceSize align = api->props.descriptorBufferOffsetAlignment;
+    const VkDeviceSize offset = (head + align - 1) & ~(align - 1);
+    if (offset + setSize > size)
+    {
+        throw std::runtime_error("DescriptorBufferRing: out of descriptor memory, increase the ring size");
+    }
+
+    writer.write_descriptor_buffer(*api, device, layout, mapped + offset);
+    head = offset + setSize;
+    if (head > highWater) highWater = head;
+    return offset;
+}
+
+void DescriptorBufferRing::bind(VkCommandBuffer cmd) const
+{
+    VkDescriptorBufferBindingInfoEXT bindInfo = {.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_BUFFER_BINDING_INFO_EXT};
+    bindInfo.address = address;
+    bindInfo.usage = usage;
+    api->cmdBindBuffers(cmd, 1, &bindInfo);
+}
+
+void DescriptorBufferRing::set_offset(VkCommandBuffer cmd, VkPipelineBindPoint bindPoint, VkPipelineLayout layout, uint32_t set, VkDeviceSize offset) const
+{
+    const uint32_t bufferIndex = 0;
+    api->cmdSetOffsets(cmd, bindPoint, layout, set, 1, &bufferIndex, &offset);
+}
+//< descriptor_buffer_ring
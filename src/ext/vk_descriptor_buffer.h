@@ -0,0 +1,62 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include "vk_mem_alloc.h"
+#include <cstdint>
+
+struct DescriptorWriter;
+
+//> descriptor_buffer_api
+// VK_EXT_descriptor_buffer entry points and limits, loaded once per device.
+struct DescriptorBufferApi {
+    PFN_vkGetDescriptorSetLayoutSizeEXT getLayoutSize{};
+    PFN_vkGetDescriptorSetLayoutBindingOffsetEXT getBindingOffset{};
+    PFN_vkGetDescriptorEXT getDescriptor{};
+    PFN_vkCmdBindDescriptorBuffersEXT cmdBindBuffers{};
+    PFN_vkCmdSetDescriptorBufferOffsetsEXT cmdSetOffsets{};
+    VkPhysicalDeviceDescriptorBufferPropertiesEXT props{.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_PROPERTIES_EXT};
+
+    // false when any entry point is missing
+    bool load(VkDevice device, VkPhysicalDevice physical);
+
+    // Size in bytes of one descriptor of `type` as written by vkGetDescriptorEXT
+    size_t descriptor_size(VkDescriptorType type) const;
+};
+//< descriptor_buffer_api
+
+//> descriptor_buffer_ring
+// Linear ring of descriptor memory in a host-visible, persistently mapped buffer.
+// One ring per FrameData: sets are written with vkGetDescriptorEXT at record time,
+// bound by offset, and the whole ring is rewound once the frame fence has signalled.
+// Set layouts must be built with VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT
+// and pipelines with VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT.
+struct DescriptorBufferRing {
+    void init(VkDevice device, VmaAllocator allocator, const DescriptorBufferApi* api, VkDeviceSize size);
+    void destroy(VmaAllocator allocator);
+    void reset();
+
+    // Reserve space for one set of `layout` and fill it from the writer's queued writes.
+    // Returns the offset to pass to set_offset(). Throws when the ring is full.
+    VkDeviceSize push(VkDevice device, VkDescriptorSetLayout layout, const DescriptorWriter& writer);
+
+    // Bind the ring as descriptor buffer 0 (once per command buffer is enough)
+    void bind(VkCommandBuffer cmd) const;
+    void set_offset(VkCommandBuffer cmd, VkPipelineBindPoint bindPoint, VkPipelineLayout layout, uint32_t set, VkDeviceSize offset) const;
+
+    VkDeviceSize used() const { return head; }
+    VkDeviceSize high_water() const { return highWater; }
+    VkDeviceSize capacity() const { return size; }
+
+    const DescriptorBufferApi* api{};
+    VkBuffer buffer{};
+    VmaAllocation allocation{};
+    VkDeviceAddress address{};
+    uint8_t* mapped{};
+
+private:
+    VkDeviceSize size = 0;
+    VkDeviceSize head = 0;
+    VkDeviceSize highWater = 0;
+    VkBufferUsageFlags usage = 0;
+};
+//< descriptor_buffer_ring
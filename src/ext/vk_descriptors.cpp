@@ -1,4 +1,5 @@
 ﻿#include "vk_descriptors.h"
+#include "vk_descriptor_buffer.h"
 
 #include <iostream>
 #include <exception>
@@ -110,21 +111,27 @@ VkDescriptorSet DescriptorAllocator::allocate(VkDevice device, VkDescriptorSetLa
 //> write_image
 void DescriptorWriter::write_image(int binding, VkImageView image, VkSampler sampler, VkImageLayout layout, VkDescriptorType type)
 {
-    VkDescriptorImageInfo& info = imageInfos.emplace_back(VkDescriptorImageInfo{
+    if (imageCount >= MaxWrites || writeCount >= MaxWrites)
+    {
+        std::cerr << "DescriptorWriter: more than " << MaxWrites << " writes queued" << std::endl;
+        std::terminate();
+    }
+
+    VkDescriptorImageInfo& info = imageInfos[imageCount++];
+    info = VkDescriptorImageInfo{
         .sampler = sampler,
         .imageView = image,
         .imageLayout = layout
-    });
+    };
 
-    VkWriteDescriptorSet write = {.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
+    VkWriteDescriptorSet& write = writes[writeCount++];
+    write = {.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
 
     write.dstBinding = binding;
     write.dstSet = VK_NULL_HANDLE; //left empty for now until we need to write it
     write.descriptorCount = 1;
     write.descriptorType = type;
     write.pImageInfo = &info;
-
-    writes.push_back(write);
 }
 
 //< write_image
@@ -132,43 +139,154 @@ void DescriptorWriter::write_image(int binding, VkImageView image, VkSampler sam
 //> write_buffer
 void DescriptorWriter::write_buffer(int binding, VkBuffer buffer, size_t size, size_t offset, VkDescriptorType type)
 {
-    VkDescriptorBufferInfo& info = bufferInfos.emplace_back(VkDescriptorBufferInfo{
+    if (bufferCount >= MaxWrites || writeCount >= MaxWrites)
+    {
+        std::cerr << "DescriptorWriter: more than " << MaxWrites << " writes queued" << std::endl;
+        std::terminate();
+    }
+
+    VkDescriptorBufferInfo& info = bufferInfos[bufferCount++];
+    info = VkDescriptorBufferInfo{
         .buffer = buffer,
         .offset = offset,
         .range = size
-    });
+    };
 
-    VkWriteDescriptorSet write = {.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
+    VkWriteDescriptorSet& write = writes[writeCount++];
+    write = {.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
 
     write.dstBinding = binding;
     write.dstSet = VK_NULL_HANDLE; //left empty for now until we need to write it
     write.descriptorCount = 1;
     write.descriptorType = type;
     write.pBufferInfo = &info;
-
-    writes.push_back(write);
 }
 
 //< write_buffer
 //> writer_end
 void DescriptorWriter::clear()
 {
-    imageInfos.clear();
-    writes.clear();
-    bufferInfos.clear();
+    imageCount = 0;
+    bufferCount = 0;
+    writeCount = 0;
 }
 
 void DescriptorWriter::update_set(VkDevice device, VkDescriptorSet set)
 {
-    for (VkWriteDescriptorSet& write : writes)
+    for (uint32_t i = 0; i < writeCount; i++)
     {
-        write.dstSet = set;
+        writes[i].dstSet = set;
     }
 
-    vkUpdateDescriptorSets(device, (uint32_t)writes.size(), writes.data(), 0, nullptr);
+    vkUpdateDescriptorSets(device, writeCount, writes.data(), 0, nullptr);
+}
+
+void DescriptorWriter::push_set(PFN_vkCmdPushDescriptorSetKHR pushFn, VkCommandBuffer cmd, VkPipelineBindPoint bindPoint, VkPipelineLayout layout, uint32_t set)
+{
+    // dstSet is ignored for push descriptors
+    for (uint32_t i = 0; i < writeCount; i++)
+    {
+        writes[i].dstSet = VK_NULL_HANDLE;
+    }
+
+    pushFn(cmd, bindPoint, layout, set, writeCount, writes.data());
+}
+
+void DescriptorWriter::write_descriptor_buffer(const DescriptorBufferApi& api, VkDevice device, VkDescriptorSetLayout layout, void* dst) const
+{
+    uint8_t* base = static_cast<uint8_t*>(dst);
+    for (uint32_t i = 0; i < writeCount; i++)
+    {
+        const VkWriteDescriptorSet& w = writes[i];
+
+        VkDeviceSize bindingOffset = 0;
+        api.getBindingOffset(device, layout, w.dstBinding, &bindingOffset);
+
+        VkDescriptorGetInfoEXT info = {.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT};
+        info.type = w.descriptorType;
+
+        VkDescriptorAddressInfoEXT addressInfo = {.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_ADDRESS_INFO_EXT};
+        switch (w.descriptorType)
+        {
+        case VK_DESCRIPTOR_TYPE_SAMPLER:
+            info.data.pSampler = &w.pImageInfo->sampler;
+            break;
+        case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+            info.data.pCombinedImageSampler = w.pImageInfo;
+            break;
+        case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+            info.data.pSampledImage = w.pImageInfo;
+            break;
+        case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+            info.data.pStorageImage = w.pImageInfo;
+            break;
+        case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+        case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+        {
+            if (w.pBufferInfo->range == VK_WHOLE_SIZE)
+            {
+                std::cerr << "DescriptorWriter: descriptor buffers need an explicit buffer range" << std::endl;
+                std::terminate();
+            }
+            VkBufferDeviceAddressInfo dai = {.sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO};
+            dai.buffer = w.pBufferInfo->buffer;
+            addressInfo.address = vkGetBufferDeviceAddress(device, &dai) + w.pBufferInfo->offset;
+            addressInfo.range = w.pBufferInfo->range;
+            if (w.descriptorType == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER)
+                info.data.pUniformBuffer = &addressInfo;
+            else
+                info.data.pStorageBuffer = &addressInfo;
+            break;
+        }
+        default:
+            std::cerr << "DescriptorWriter: unsupported descriptor type " << string_VkDescriptorType(w.descriptorType) << std::endl;
+            std::terminate();
+        }
+
+        api.getDescriptor(device, &info, api.descriptor_size(w.descriptorType), base + bindingOffset);
+    }
 }
 
 //< writer_end
+//> update_template
+void DescriptorUpdateTemplateBuilder::add_entry(uint32_t binding, VkDescriptorType type, size_t offset, size_t stride, uint32_t count)
+{
+    if (stride == 0)
+    {
+        const bool isBuffer = type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER || type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER
+            || type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC || type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+        stride = isBuffer ? sizeof(VkDescriptorBufferInfo) : sizeof(VkDescriptorImageInfo);
+    }
+
+    entries.push_back(VkDescriptorUpdateTemplateEntry{
+        .dstBinding = binding,
+        .dstArrayElement = 0,
+        .descriptorCount = count,
+        .descriptorType = type,
+        .offset = offset,
+        .stride = stride
+    });
+}
+
+void DescriptorUpdateTemplateBuilder::clear()
+{
+    entries.clear();
+}
+
+VkDescriptorUpdateTemplate DescriptorUpdateTemplateBuilder::build(VkDevice device, VkDescriptorSetLayout layout)
+{
+    VkDescriptorUpdateTemplateCreateInfo info = {.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO};
+    info.descriptorUpdateEntryCount = (uint32_t)entries.size();
+    info.pDescriptorUpdateEntries = entries.data();
+    info.templateType = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET;
+    info.descriptorSetLayout = layout;
+
+    VkDescriptorUpdateTemplate tmpl;
+    VK_CHECK(vkCreateDescriptorUpdateTemplate(device, &info, nullptr, &tmpl));
+
+    return tmpl;
+}
+//< update_template
 //> growpool_2
 void DescriptorAllocatorGrowable::init(VkDevice device, uint32_t maxSets, std::span<PoolSizeRatio> poolRatios)
 {
@@ -198,6 +316,7 @@ void DescriptorAllocatorGrowable::clear_pools(VkDevice device)
         readyPools.push_back(p);
     }
     fullPools.clear();
+    allocatedSets = 0;
 }
 
 void DescriptorAllocatorGrowable::destroy_pools(VkDevice device)
@@ -212,6 +331,7 @@ void DescriptorAllocatorGrowable::destroy_pools(VkDevice device)
         vkDestroyDescriptorPool(device, p, nullptr);
     }
     fullPools.clear();
+    allocatedSets = 0;
 }
 
 //< growpool_2
@@ -293,6 +413,7 @@ VkDescriptorSet DescriptorAllocatorGrowable::allocate(VkDevice device, VkDescrip
     }
 
     readyPools.push_back(poolToUse);
+    allocatedSets++;
     return ds;
 }
 
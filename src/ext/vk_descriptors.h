@@ -1,14 +1,20 @@
 ﻿#pragma once
 
 #include <vulkan/vk_enum_string_helper.h>
+#include <array>
 #include <vector>
-#include <deque>
+#include <memory_resource>
 #include <span>
 
+struct DescriptorBufferApi;
+
 //> descriptor_layout
 struct DescriptorLayoutBuilder {
 
-    std::vector<VkDescriptorSetLayoutBinding> bindings;
+    // pass a FrameArena (or any pmr resource) when building layouts on a per-frame path
+    explicit DescriptorLayoutBuilder(std::pmr::memory_resource* mr = std::pmr::get_default_resource()) : bindings(mr) {}
+
+    std::pmr::vector<VkDescriptorSetLayoutBinding> bindings;
 
     void add_binding(uint32_t binding, VkDescriptorType type);
     void clear();
@@ -17,18 +23,45 @@ struct DescriptorLayoutBuilder {
 //< descriptor_layout
 // 
 //> writer
+// Fixed inline storage: writing and flushing a set never touches the heap.
+// Info structs live in arrays so the pointers stored in the writes stay valid.
 struct DescriptorWriter {
-    std::deque<VkDescriptorImageInfo> imageInfos;
-    std::deque<VkDescriptorBufferInfo> bufferInfos;
-    std::vector<VkWriteDescriptorSet> writes;
+    static constexpr uint32_t MaxWrites = 16;
+
+    std::array<VkDescriptorImageInfo, MaxWrites> imageInfos{};
+    std::array<VkDescriptorBufferInfo, MaxWrites> bufferInfos{};
+    std::array<VkWriteDescriptorSet, MaxWrites> writes{};
+    uint32_t imageCount = 0;
+    uint32_t bufferCount = 0;
+    uint32_t writeCount = 0;
 
     void write_image(int binding,VkImageView image,VkSampler sampler , VkImageLayout layout, VkDescriptorType type);
     void write_buffer(int binding,VkBuffer buffer,size_t size, size_t offset,VkDescriptorType type); 
 
     void clear();
     void update_set(VkDevice device, VkDescriptorSet set);
+    // VK_KHR_push_descriptor: record the queued writes straight into the command buffer.
+    // `layout` must have been built with VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR at `set`.
+    void push_set(PFN_vkCmdPushDescriptorSetKHR pushFn, VkCommandBuffer cmd, VkPipelineBindPoint bindPoint, VkPipelineLayout layout, uint32_t set = 0);
+    // VK_EXT_descriptor_buffer: encode the queued writes with vkGetDescriptorEXT into `dst`, which
+    // points at one set of `layout` inside a descriptor buffer. Buffer writes need an explicit size
+    // (no VK_WHOLE_SIZE) and buffers created with VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT.
+    void write_descriptor_buffer(const DescriptorBufferApi& api, VkDevice device, VkDescriptorSetLayout layout, void* dst) const;
 };
 //< writer
+//
+//> update_template
+// Compiles a set layout into a VkDescriptorUpdateTemplate. Entries describe where each
+// binding's info struct lives inside a caller-defined packed struct, so a repeated update
+// is a single vkUpdateDescriptorSetWithTemplate(device, set, tmpl, &packed).
+struct DescriptorUpdateTemplateBuilder {
+    std::vector<VkDescriptorUpdateTemplateEntry> entries;
+
+    void add_entry(uint32_t binding, VkDescriptorType type, size_t offset, size_t stride = 0, uint32_t count = 1);
+    void clear();
+    VkDescriptorUpdateTemplate build(VkDevice device, VkDescriptorSetLayout layout);
+};
+//< update_template
 // 
 //> descriptor_allocator
 struct DescriptorAllocator {
@@ -61,6 +94,10 @@ public:
 	void destroy_pools(VkDevice device);
 
     VkDescriptorSet allocate(VkDevice device, VkDescriptorSetLayout layout, void* pNext = nullptr);
+
+    // bookkeeping for leak checks: pools owned and sets handed out since the last clear
+    size_t pool_count() const { return readyPools.size() + fullPools.size(); }
+    uint32_t allocated_sets() const { return allocatedSets; }
 private:
 	VkDescriptorPool get_pool(VkDevice device);
 	VkDescriptorPool create_pool(VkDevice device, uint32_t setCount, std::span<PoolSizeRatio> poolRatios);
@@ -69,6 +106,7 @@ private:
 	std::vector<VkDescriptorPool> fullPools;
 	std::vector<VkDescriptorPool> readyPools;
 	uint32_t setsPerPool;
+	uint32_t allocatedSets = 0;
 
 };
 //< descriptor_allocator_grow
\ No newline at end of file
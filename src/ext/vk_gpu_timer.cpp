@@ -0,0 +1,79 @@
+#include "vk_gpu_timer.h"
+
+#include <vulkan/vk_enum_string_helper.h>
+#include <stdexcept>
+#include <string>
+
+#ifndef VK_CHECK
+#define VK_CHECK(x) do { VkResult err__ = (x); if (err__ != VK_SUCCESS) { throw std::runtime_error(std::string("Vulkan error ") + string_VkResult(err__)); } } while(0)
+#endif
+
+//> gpu_timer_init
+void GpuTimer::init(VkDevice device, VkPhysicalDevice physical, uint32_t queueFamily, uint32_t scopes)
+{
+    scopeCount = scopes;
+    recorded.assign(scopes, 0);
+    ticks.assign(scopes * 2, 0);
+    results.assign(scopes, -1.0);
+
+    VkPhysicalDeviceProperties props{};
+    vkGetPhysicalDeviceProperties(physical, &props);
+    uint32_t familyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(physical, &familyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> families(familyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(physical, &familyCount, families.data());
+
+    const uint32_t validBits = queueFamily < familyCount ? families[queueFamily].timestampValidBits : 0;
+    if (validBits == 0 || props.limits.timestampPeriod == 0.0f) return;
+
+    periodNs = props.limits.timestampPeriod;
+    validMask = validBits >= 64 ? ~0ull : ((1ull << validBits) - 1);
+
+    VkQueryPoolCreateInfo qci = {.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO};
+    qci.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    qci.queryCount = scopes * 2;
+    VK_CHECK(vkCreateQueryPool(device, &qci, nullptr, &pool));
+}
+
+void GpuTimer::destroy(VkDevice device)
+{
+    if (pool) vkDestroyQueryPool(device, pool, nullptr);
+    pool = VK_NULL_HANDLE;
+}
+//< gpu_timer_init
+
+//> gpu_timer_record
+void GpuTimer::reset(VkCommandBuffer cmd)
+{
+    if (!pool) return;
+    vkCmdResetQueryPool(cmd, pool, 0, scopeCount * 2);
+    for (auto& r : recorded) r = 0;
+}
+
+void GpuTimer::begin(VkCommandBuffer cmd, uint32_t scope)
+{
+    if (!pool) return;
+    vkCmdWriteTimestamp2(cmd, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, pool, scope * 2);
+}
+
+void GpuTimer::end(VkCommandBuffer cmd, uint32_t scope)
+{
+    if (!pool) return;
+    vkCmdWriteTimestamp2(cmd, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, pool, scope * 2 + 1);
+    recorded[scope] = 1;
+}
+
+void GpuTimer::resolve(VkDevice device)
+{
+    for (uint32_t s = 0; s < scopeCount; s++)
+    {
+        results[s] = -1.0;
+        if (!pool || !recorded[s]) continue;
+        const VkResult r = vkGetQueryPoolResults(device, pool, s * 2, 2, sizeof(uint64_t) * 2, &ticks[s * 2],
+                                                 sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+        if (r != VK_SUCCESS) continue;
+        const uint64_t delta = (ticks[s * 2 + 1] - ticks[s * 2]) & validMask;
+        results[s] = static_cast<double>(delta) * periodNs * 1e-6;
+    }
+}
+//< gpu_timer_record
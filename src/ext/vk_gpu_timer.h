@@ -0,0 +1,37 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <vector>
+
+//> gpu_timer
+// Timestamp scopes for one frame's command buffer. Each scope is a begin/end pair of
+// timestamps; results are read back once the submission's fence has signalled, so one
+// GpuTimer per frame in flight never stalls. All calls are no-ops when the graphics
+// queue has no timestamp support.
+struct GpuTimer {
+    void init(VkDevice device, VkPhysicalDevice physical, uint32_t queueFamily, uint32_t scopes);
+    void destroy(VkDevice device);
+
+    // Record before the first begin() of the command buffer
+    void reset(VkCommandBuffer cmd);
+    void begin(VkCommandBuffer cmd, uint32_t scope);
+    void end(VkCommandBuffer cmd, uint32_t scope);
+
+    // Fetch the scopes ended in the last submission; call after its fence has signalled
+    void resolve(VkDevice device);
+    // Milliseconds of the last resolved submission, negative when the scope was not recorded
+    double ms(uint32_t scope) const { return results[scope]; }
+
+    bool supported() const { return pool != VK_NULL_HANDLE; }
+
+private:
+    VkQueryPool pool{};
+    double periodNs = 0.0;
+    uint64_t validMask = 0;
+    uint32_t scopeCount = 0;
+    std::vector<uint8_t> recorded; // scope ended since the last reset
+    std::vector<uint64_t> ticks;
+    std::vector<double> results;
+};
+//< gpu_timer
@@ -0,0 +1,50 @@
+#include "vk_immediate.h"
+#include "vk_initializers.h"
+
+#include <vulkan/vk_enum_string_helper.h>
+#include <stdexcept>
+#include <string>
+
+#ifndef VK_CHECK
+#define VK_CHECK(x) do { VkResult err__ = (x); if (err__ != VK_SUCCESS) { throw std::runtime_error(std::string("Vulkan error ") + string_VkResult(err__)); } } while(0)
+#endif
+
+//> immediate_init
+void ImmediateSubmit::init(VkDevice device, VkQueue graphicsQueue, uint32_t queueFamily)
+{
+    queue = graphicsQueue;
+    VkCommandPoolCreateInfo pci = vkinit::command_pool_create_info(queueFamily, VK_COMMAND_POOL_CREATE_TRANSIENT_BIT);
+    VK_CHECK(vkCreateCommandPool(device, &pci, nullptr, &pool));
+    VkCommandBufferAllocateInfo cbai = vkinit::command_buffer_allocate_info(pool, 1);
+    VK_CHECK(vkAllocateCommandBuffers(device, &cbai, &cmd));
+    VkFenceCreateInfo fci = vkinit::fence_create_info();
+    VK_CHECK(vkCreateFence(device, &fci, nullptr, &fence));
+}
+
+void ImmediateSubmit::destroy(VkDevice device)
+{
+    vkDestroyFence(device, fence, nullptr);
+    vkDestroyCommandPool(device, pool, nullptr);
+    fence = VK_NULL_HANDLE;
+    pool = VK_NULL_HANDLE;
+    cmd = VK_NULL_HANDLE;
+}
+//< immediate_init
+
+//> immediate_submit_impl
+void ImmediateSubmit::submit(VkDevice device, const std::function<void(VkCommandBuffer cmd)>& record)
+{
+    // the previous call waited on the fence, so the pool is idle and can be recycled wholesale
+    VK_CHECK(vkResetCommandPool(device, pool, 0));
+    VkCommandBufferBeginInfo bi = vkinit::command_buffer_begin_info(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+    VK_CHECK(vkBeginCommandBuffer(cmd, &bi));
+    record(cmd);
+    VK_CHECK(vkEndCommandBuffer(cmd));
+
+    VkCommandBufferSubmitInfo cbsi = vkinit::command_buffer_submit_info(cmd);
+    VkSubmitInfo2 si = vkinit::submit_info(&cbsi, nullptr, nullptr);
+    VK_CHECK(vkQueueSubmit2(queue, 1, &si, fence));
+    VK_CHECK(vkWaitForFences(device, 1, &fence, VK_TRUE, UINT64_MAX));
+    VK_CHECK(vkResetFences(device, 1, &fence));
+}
+//< immediate_submit_impl
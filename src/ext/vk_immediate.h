@@ -0,0 +1,24 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <functional>
+
+//> immediate_submit
+// Records a command buffer outside the frame loop, submits it to the graphics queue and
+// blocks until it has finished. Meant for uploads and readbacks at init / resize time; the
+// pool, command buffer and fence are created once by the engine and reused for every call.
+// Not thread-safe: call from the thread that records frames.
+struct ImmediateSubmit {
+    void init(VkDevice device, VkQueue graphicsQueue, uint32_t queueFamily);
+    void destroy(VkDevice device);
+
+    void submit(VkDevice device, const std::function<void(VkCommandBuffer cmd)>& record);
+
+private:
+    VkQueue queue{};
+    VkCommandPool pool{};
+    VkCommandBuffer cmd{};
+    VkFence fence{};
+};
+//< immediate_submit
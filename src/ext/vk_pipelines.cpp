@@ -2,6 +2,8 @@
 
 #include "vk_initializers.h"
 #include <fstream>
+#include <stdexcept>
+#include <string>
 
 //> pipe_clear
 void PipelineBuilder::clear()
@@ -277,4 +279,28 @@ bool vkutil::load_shader_module(const char* filePath,
     *outShaderModule = shaderModule;
     return true;
 }
-//< load_shader
\ No newline at end of file
+//< load_shader
+
+//> compute_pipeline
+VkPipeline vkutil::create_compute_pipeline(VkDevice device, VkPipelineLayout layout, const char* filePath, VkPipelineCreateFlags flags)
+{
+    VkShaderModule computeShader;
+    if (!load_shader_module(filePath, device, &computeShader)) {
+        throw std::runtime_error(std::string("failed to load shader: ") + filePath);
+    }
+
+    VkComputePipelineCreateInfo pipelineInfo = { .sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO };
+    pipelineInfo.flags = flags;
+    pipelineInfo.stage = vkinit::pipeline_shader_stage_create_info(VK_SHADER_STAGE_COMPUTE_BIT, computeShader);
+    pipelineInfo.layout = layout;
+
+    // the module is only needed while the pipeline is being created
+    VkPipeline newPipeline;
+    const VkResult result = vkCreateComputePipelines(device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &newPipeline);
+    vkDestroyShaderModule(device, computeShader, nullptr);
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error(std::string("failed to create compute pipeline: ") + filePath);
+    }
+    return newPipeline;
+}
+//< compute_pipeline
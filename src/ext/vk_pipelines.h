@@ -2,11 +2,12 @@
 
 #include <vulkan/vk_enum_string_helper.h>
 #include <vector>
+#include <memory_resource>
 
 class PipelineBuilder {
 //> pipeline
 public:
-    std::vector<VkPipelineShaderStageCreateInfo> _shaderStages;
+    std::pmr::vector<VkPipelineShaderStageCreateInfo> _shaderStages;
    
     VkPipelineInputAssemblyStateCreateInfo _inputAssembly;
     VkPipelineRasterizationStateCreateInfo _rasterizer;
@@ -17,7 +18,7 @@ public:
     VkPipelineRenderingCreateInfo _renderInfo;
     VkFormat _colorAttachmentformat;
 
-	PipelineBuilder(){ clear(); }
+	explicit PipelineBuilder(std::pmr::memory_resource* mr = std::pmr::get_default_resource()) : _shaderStages(mr) { clear(); }
 
     void clear();
 
@@ -40,4 +41,6 @@ public:
 
 namespace vkutil {
 bool load_shader_module(const char* filePath, VkDevice device, VkShaderModule* outShaderModule);
+// Loads a SPIR-V compute shader and builds a pipeline on `layout`; throws std::runtime_error on failure
+VkPipeline create_compute_pipeline(VkDevice device, VkPipelineLayout layout, const char* filePath, VkPipelineCreateFlags flags = 0);
 }
@@ -0,0 +1,126 @@
+#include "vk_scratch.h"
+#include "src/gpu_memory.h"
+
+#include <vulkan/vk_enum_string_helper.h>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#ifndef VK_CHECK
+#define VK_CHECK(x) do { VkResult err__ = (x); if (err__ != VK_SUCCESS) { throw std::runtime_error(std::string("Vulkan error ") + string_VkResult(err__)); } } while(0)
+#endif
+
+//> scratch_init
+void ScratchAllocator::init(VkDevice dev, VmaAllocator alloc, VkDeviceSize bytesPerBlock, VkDeviceSize alignment)
+{
+    device = dev;
+    allocator = alloc;
+    blockSize = bytesPerBlock;
+    minAlignment = std::max<VkDeviceSize>(alignment, 16);
+    blocks.push_back(create_block(blockSize));
+    current = 0;
+}
+
+void ScratchAllocator::destroy()
+{
+    for (auto& b : blocks)
+    {
+        gpu_memory::destroy_buffer(allocator, b.buffer, b.allocation);
+    }
+    blocks.clear();
+    current = 0;
+}
+
+void ScratchAllocator::reset()
+{
+    for (auto& b : blocks)
+    {
+        b.head = 0;
+    }
+    current = 0;
+}
+
+ScratchAllocator::Block ScratchAllocator::create_block(VkDeviceSize size)
+{
+    VkBufferCreateInfo bci = {.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+    bci.size = size;
+    bci.usage = Usage;
+
+    VmaAllocationCreateInfo ai{};
+    ai.usage = VMA_MEMORY_USAGE_AUTO;
+    ai.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+    Block b{};
+    VmaAllocationInfo info{};
+    VK_CHECK(gpu_memory::create_buffer(allocator, bci, ai, "Engine/frame-scratch", &b.buffer, &b.allocation, &info));
+    b.mapped = static_cast<uint8_t*>(info.pMappedData);
+    b.size = size;
+
+    VkBufferDeviceAddressInfo dai = {.sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO};
+    dai.buffer = b.buffer;
+    b.address = vkGetBufferDeviceAddress(device, &dai);
+    return b;
+}
+//< scratch_init
+
+//> scratch_alloc
+ScratchAllocation ScratchAllocator::allocate(VkDeviceSize size, VkDeviceSize alignment)
+{
+    // a zero-sized range is not a valid descriptor or copy region; callers skip empty work instead
+    if (size == 0)
+    {
+        throw std::runtime_error("ScratchAllocator: zero-sized allocation");
+    }
+    const VkDeviceSize align = std::max(alignment, minAlignment);
+
+    // walk forward through the chain; blocks are only created once and then reused every frame
+    while (true)
+    {
+        Block& b = blocks[current];
+        const VkDeviceSize offset = (b.head + align - 1) & ~(align - 1);
+        if (offset + size <= b.size)
+        {
+            b.head = offset + size;
+            return ScratchAllocation{
+                .ptr = b.mapped + offset,
+                .buffer = b.buffer,
+                .offset = offset,
+                .address = b.address + offset,
+                .size = size,
+            };
+        }
+
+        if (current + 1 == blocks.size())
+        {
+            // oversized requests get a block of their own size
+            blocks.push_back(create_block(std::max(blockSize, size)));
+        }
+        current++;
+    }
+}
+
+void ScratchAllocator::flush()
+{
+    for (size_t i = 0; i <= current && i < blocks.size(); i++)
+    {
+        if (blocks[i].head > 0)
+        {
+            VK_CHECK(vmaFlushAllocation(allocator, blocks[i].allocation, 0, blocks[i].head));
+        }
+    }
+}
+
+VkDeviceSize ScratchAllocator::used() const
+{
+    VkDeviceSize total = 0;
+    for (const auto& b : blocks) total += b.head;
+    return total;
+}
+
+VkDeviceSize ScratchAllocator::capacity() const
+{
+    VkDeviceSize total = 0;
+    for (const auto& b : blocks) total += b.size;
+    return total;
+}
+//< scratch_alloc
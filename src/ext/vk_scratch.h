@@ -0,0 +1,75 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include "vk_mem_alloc.h"
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+//> scratch_allocation
+// One sub-allocation handed out by ScratchAllocator. Valid until the owning frame's
+// fence signals; bind `buffer` at `offset` or hand `address` to a shader through BDA.
+struct ScratchAllocation {
+    void* ptr{};
+    VkBuffer buffer{};
+    VkDeviceSize offset{};
+    VkDeviceAddress address{};
+    VkDeviceSize size{};
+};
+//< scratch_allocation
+
+//> scratch_allocator
+// Per-frame linear allocator over persistently mapped, host-visible blocks.
+// Allocation is a pointer bump; when a block runs out the next one is chained in (and
+// created on first use), so VMA is only touched while the working set is still growing.
+// reset() rewinds every block and must only be called after the frame fence has signalled.
+struct ScratchAllocator {
+    void init(VkDevice device, VmaAllocator allocator, VkDeviceSize blockSize, VkDeviceSize minAlignment);
+    void destroy();
+    void reset();
+
+    // size must be non-zero (throws otherwise)
+    ScratchAllocation allocate(VkDeviceSize size, VkDeviceSize alignment = 0);
+
+    template <typename T>
+    ScratchAllocation push(const T* data, size_t count, VkDeviceSize alignment = 0)
+    {
+        ScratchAllocation a = allocate(sizeof(T) * count, alignment);
+        std::memcpy(a.ptr, data, sizeof(T) * count);
+        return a;
+    }
+
+    // Make host writes visible to the device (no-op on coherent memory). Call before submit.
+    void flush();
+
+    size_t block_count() const { return blocks.size(); }
+    VkDeviceSize used() const;
+    VkDeviceSize capacity() const;
+
+    // Every allocation can back any of these uses
+    static constexpr VkBufferUsageFlags Usage =
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT |
+        VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT |
+        VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT |
+        VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+
+private:
+    struct Block {
+        VkBuffer buffer{};
+        VmaAllocation allocation{};
+        uint8_t* mapped{};
+        VkDeviceAddress address{};
+        VkDeviceSize size = 0;
+        VkDeviceSize head = 0;
+    };
+
+    Block create_block(VkDeviceSize size);
+
+    VkDevice device{};
+    VmaAllocator allocator{};
+    VkDeviceSize blockSize = 0;
+    VkDeviceSize minAlignment = 16;
+    std::vector<Block> blocks;
+    size_t current = 0;
+};
+//< scratch_allocator
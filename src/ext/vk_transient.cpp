@@ -0,0 +1,201 @@
+#include "vk_transient.h"
+#include "vk_initializers.h"
+#include "src/gpu_memory.h"
+
+#include <vulkan/vk_enum_string_helper.h>
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+
+#ifndef VK_CHECK
+#define VK_CHECK(x) do { VkResult err__ = (x); if (err__ != VK_SUCCESS) { throw std::runtime_error(std::string("Vulkan error ") + string_VkResult(err__)); } } while(0)
+#endif
+
+namespace {
+    bool same_request(const TransientDesc& a, const TransientDesc& b)
+    {
+        return a.format == b.format && a.usage == b.usage && a.aspect == b.aspect
+            && a.extent.width == b.extent.width && a.extent.height == b.extent.height
+            && a.firstPass == b.firstPass && a.lastPass == b.lastPass;
+    }
+
+    bool overlaps(const TransientDesc& a, const TransientDesc& b)
+    {
+        return a.firstPass <= b.lastPass && b.firstPass <= a.lastPass;
+    }
+}
+
+//> transient_init
+void TransientPool::init(VkDevice dev, VmaAllocator alloc)
+{
+    device = dev;
+    allocator = alloc;
+    // a handful of attachments per frame; keeps begin()/request() off the heap
+    requests.reserve(16);
+}
+
+void TransientPool::destroy()
+{
+    release();
+    built.clear();
+    requests.clear();
+}
+
+void TransientPool::release()
+{
+    for (auto& img : images)
+    {
+        if (img.view) vkDestroyImageView(device, img.view, nullptr);
+        if (img.image) vkDestroyImage(device, img.image, nullptr);
+    }
+    images.clear();
+    for (auto& s : slots)
+    {
+        if (s.allocation) gpu_memory::free_memory(allocator, s.allocation);
+    }
+    slots.clear();
+    slotOfImage.clear();
+    current = {};
+}
+//< transient_init
+
+//> transient_request
+void TransientPool::begin(VkExtent2D extent)
+{
+    frameExtent = extent;
+    requests.clear();
+}
+
+TransientPool::Handle TransientPool::request(const TransientDesc& desc)
+{
+    requests.push_back(desc);
+    return static_cast<Handle>(requests.size() - 1);
+}
+
+bool TransientPool::needs_rebuild() const
+{
+    if (requests.size() != built.size()) return true;
+    if (builtExtent.width != frameExtent.width || builtExtent.height != frameExtent.height)
+    {
+        // only requests that follow the frame extent care about it
+        for (const auto& r : requests)
+            if (r.extent.width == 0 || r.extent.height == 0) return true;
+    }
+    for (size_t i = 0; i < requests.size(); i++)
+    {
+        if (!same_request(requests[i], built[i])) return true;
+    }
+    return false;
+}
+//< transient_request
+
+//> transient_compile
+VkImageCreateInfo TransientPool::image_info(const TransientDesc& desc, VkExtent2D frameExtent)
+{
+    const VkExtent2D e = (desc.extent.width == 0 || desc.extent.height == 0) ? frameExtent : desc.extent;
+    VkImageCreateInfo info = vkinit::image_create_info(desc.format, desc.usage, VkExtent3D{e.width, e.height, 1});
+    // aliased memory: contents are never carried over from a previous owner
+    info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    return info;
+}
+
+TransientPool::Plan TransientPool::assign_slots(VkDevice device, const TransientDesc* descs, size_t count, VkExtent2D extent,
+                                                uint32_t* slotOfDesc, std::vector<Slot>& slots)
+{
+    Plan plan{};
+    plan.images = static_cast<uint32_t>(count);
+
+    std::vector<VkMemoryRequirements> reqs(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        const VkImageCreateInfo ici = image_info(descs[i], extent);
+        VkDeviceImageMemoryRequirements dimr{.sType = VK_STRUCTURE_TYPE_DEVICE_IMAGE_MEMORY_REQUIREMENTS};
+        dimr.pCreateInfo = &ici;
+        VkMemoryRequirements2 mr{.sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2};
+        vkGetDeviceImageMemoryRequirements(device, &dimr, &mr);
+        reqs[i] = mr.memoryRequirements;
+        plan.requestedBytes += reqs[i].size;
+    }
+
+    // largest first, each into the first slot whose members are all dead during its passes
+    std::vector<uint32_t> order(count);
+    std::iota(order.begin(), order.end(), 0u);
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return reqs[a].size > reqs[b].size; });
+
+    slots.clear();
+    for (uint32_t i : order)
+    {
+        uint32_t chosen = static_cast<uint32_t>(slots.size());
+        for (uint32_t s = 0; s < slots.size() && chosen == slots.size(); s++)
+        {
+            if ((slots[s].memoryTypeBits & reqs[i].memoryTypeBits) == 0) continue;
+            bool free = true;
+            for (size_t j = 0; j < count && free; j++)
+            {
+                if (slotOfDesc[j] == s && overlaps(descs[i], descs[j])) free = false;
+            }
+            if (free) chosen = s;
+        }
+        if (chosen == slots.size()) slots.push_back(Slot{});
+
+        Slot& slot = slots[chosen];
+        slot.size = std::max(slot.size, reqs[i].size);
+        slot.alignment = std::max(slot.alignment, reqs[i].alignment);
+        slot.memoryTypeBits &= reqs[i].memoryTypeBits;
+        slotOfDesc[i] = chosen;
+    }
+
+    for (const auto& s : slots) plan.allocatedBytes += s.size;
+    plan.slots = static_cast<uint32_t>(slots.size());
+    return plan;
+}
+
+TransientPool::Plan TransientPool::estimate(VkDevice device, const TransientDesc* descs, size_t count, VkExtent2D extent, uint32_t* slotOfDesc)
+{
+    std::vector<uint32_t> slotStorage;
+    if (!slotOfDesc)
+    {
+        slotStorage.resize(count);
+        slotOfDesc = slotStorage.data();
+    }
+    std::fill(slotOfDesc, slotOfDesc + count, InvalidHandle);
+    std::vector<Slot> slots;
+    return assign_slots(device, descs, count, extent, slotOfDesc, slots);
+}
+
+bool TransientPool::compile()
+{
+    if (!needs_rebuild()) return false;
+
+    // the caller has waited for the GPU (see needs_rebuild)
+    release();
+    built = requests;
+    builtExtent = frameExtent;
+
+    slotOfImage.assign(built.size(), InvalidHandle);
+    current = assign_slots(device, built.data(), built.size(), builtExtent, slotOfImage.data(), slots);
+
+    for (auto& s : slots)
+    {
+        VkMemoryRequirements mr{s.size, s.alignment, s.memoryTypeBits};
+        VmaAllocationCreateInfo ai{};
+        ai.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+        ai.requiredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+        VK_CHECK(gpu_memory::allocate_memory(allocator, mr, ai, "Engine/transient", &s.allocation));
+    }
+
+    images.resize(built.size());
+    for (size_t i = 0; i < built.size(); i++)
+    {
+        const VkImageCreateInfo ici = image_info(built[i], builtExtent);
+        TransientImage& img = images[i];
+        VK_CHECK(vmaCreateAliasingImage(allocator, slots[slotOfImage[i]].allocation, &ici, &img.image));
+        VkImageViewCreateInfo vci = vkinit::imageview_create_info(built[i].format, img.image, built[i].aspect);
+        VK_CHECK(vkCreateImageView(device, &vci, nullptr, &img.view));
+        img.format = built[i].format;
+        img.extent = ici.extent;
+    }
+    return true;
+}
+//< transient_compile
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include "vk_mem_alloc.h"
+#include <cstdint>
+#include <vector>
+
+//> transient_desc
+// Description of an attachment a renderer needs for part of one frame.
+// Passes are numbered in the order the renderer records them; the image is only
+// guaranteed to hold its contents from firstPass through lastPass.
+struct TransientDesc {
+    const char* name{""};
+    VkFormat format{VK_FORMAT_UNDEFINED};
+    VkImageUsageFlags usage{};
+    VkImageAspectFlags aspect{VK_IMAGE_ASPECT_COLOR_BIT};
+    VkExtent2D extent{}; // {0, 0} follows the frame extent
+    uint32_t firstPass = 0;
+    uint32_t lastPass = 0;
+};
+
+struct TransientImage {
+    VkImage image{};
+    VkImageView view{};
+    VkFormat format{};
+    VkExtent3D extent{};
+};
+//< transient_desc
+
+//> transient_pool
+// Attachments requested by description every frame and placed in shared memory.
+// Requests whose pass ranges do not overlap are aliased in the same VMA allocation,
+// so the frame only pays for the attachments that are alive at the same time.
+// The layout is rebuilt only when the request list changes (resize, renderer switch);
+// otherwise begin()/request()/compile() just compare against the cached list.
+//
+// Aliased images start every frame with undefined contents: the first use in a frame
+// must transition from VK_IMAGE_LAYOUT_UNDEFINED through a full barrier
+// (vkutil::transition_image), which also orders it after the previous owner's writes.
+struct TransientPool {
+    using Handle = uint32_t;
+    static constexpr Handle InvalidHandle = ~0u;
+
+    struct Plan {
+        VkDeviceSize requestedBytes = 0; // one allocation per attachment
+        VkDeviceSize allocatedBytes = 0; // after aliasing
+        uint32_t images = 0;
+        uint32_t slots = 0;
+    };
+
+    void init(VkDevice device, VmaAllocator allocator);
+    void destroy();
+
+    void begin(VkExtent2D frameExtent);
+    Handle request(const TransientDesc& desc);
+    // True when compile() is going to recreate images (callers wait for the GPU first)
+    bool needs_rebuild() const;
+    // Returns true when the images were recreated
+    bool compile();
+
+    const TransientImage& get(Handle handle) const { return images[handle]; }
+
+    Plan plan() const { return current; }
+    const std::vector<TransientDesc>& requested() const { return requests; }
+    // Memory the given requests would take at `extent`, without creating anything.
+    // When `slotOfDesc` is set it receives the memory slot chosen for each request.
+    static Plan estimate(VkDevice device, const TransientDesc* descs, size_t count, VkExtent2D extent, uint32_t* slotOfDesc = nullptr);
+
+private:
+    struct Slot {
+        VkDeviceSize size = 0;
+        VkDeviceSize alignment = 1;
+        uint32_t memoryTypeBits = ~0u;
+        VmaAllocation allocation{};
+    };
+
+    static VkImageCreateInfo image_info(const TransientDesc& desc, VkExtent2D frameExtent);
+    static Plan assign_slots(VkDevice device, const TransientDesc* descs, size_t count, VkExtent2D extent,
+                             uint32_t* slotOfDesc, std::vector<Slot>& slots);
+    void release();
+
+    VkDevice device{};
+    VmaAllocator allocator{};
+
+    VkExtent2D frameExtent{};
+    std::vector<TransientDesc> requests; // this frame
+    VkExtent2D builtExtent{};
+    std::vector<TransientDesc> built;    // what `images` were created from
+    std::vector<TransientImage> images;
+    std::vector<Slot> slots;
+    std::vector<uint32_t> slotOfImage;
+    Plan current{};
+};
+//< transient_pool
@@ -0,0 +1,71 @@
+#include "frame_arena.h"
+
+#include <algorithm>
+#include <new>
+
+namespace
+{
+    constexpr std::align_val_t BlockAlignment{64};
+}
+
+FrameArena::FrameArena(size_t blockSize) : blockSize_(blockSize)
+{
+    add_block(blockSize_);
+}
+
+FrameArena::~FrameArena()
+{
+    release_blocks();
+}
+
+void FrameArena::reset()
+{
+    if (blocks_.size() > 1)
+    {
+        // last frame spilled: replace the chain with one block that fits all of it
+        const size_t total = capacity();
+        release_blocks();
+        add_block(total);
+    }
+    if (!blocks_.empty()) blocks_.front().head = 0;
+    used_ = 0;
+}
+
+size_t FrameArena::capacity() const
+{
+    size_t total = 0;
+    for (const auto& b : blocks_) total += b.size;
+    return total;
+}
+
+void* FrameArena::do_allocate(size_t bytes, size_t alignment)
+{
+    Block* b = &blocks_.back();
+    size_t offset = (b->head + alignment - 1) & ~(alignment - 1);
+    if (offset + bytes > b->size)
+    {
+        add_block(std::max(blockSize_, bytes + alignment));
+        b = &blocks_.back();
+        offset = (b->head + alignment - 1) & ~(alignment - 1);
+    }
+
+    b->head = offset + bytes;
+    used_ += bytes;
+    peak_ = std::max(peak_, used_);
+    return b->data + offset;
+}
+
+void FrameArena::add_block(size_t size)
+{
+    auto* data = static_cast<std::byte*>(::operator new(size, BlockAlignment));
+    blocks_.push_back(Block{data, size, 0});
+}
+
+void FrameArena::release_blocks()
+{
+    for (auto& b : blocks_)
+    {
+        ::operator delete(b.data, BlockAlignment);
+    }
+    blocks_.clear();
+}
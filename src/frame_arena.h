@@ -0,0 +1,52 @@
+#ifndef FRAME_ARENA_H
+#define FRAME_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+// Per-frame CPU bump arena. Hand it to std::pmr containers for data that only lives
+// while a frame is being recorded; deallocate is a no-op and reset() rewinds everything.
+// If a frame overflows the first block, further blocks are chained in and the next
+// reset() folds them into one block of the combined size, so steady state never allocates.
+class FrameArena final : public std::pmr::memory_resource
+{
+public:
+    explicit FrameArena(size_t blockSize = 256 * 1024);
+    ~FrameArena() override;
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+    FrameArena(FrameArena&&) noexcept = default;
+    FrameArena& operator=(FrameArena&&) noexcept = default;
+
+    void reset();
+
+    size_t used() const { return used_; }
+    size_t peak() const { return peak_; }
+    size_t capacity() const;
+    size_t block_count() const { return blocks_.size(); }
+
+private:
+    struct Block
+    {
+        std::byte* data{};
+        size_t size{};
+        size_t head{};
+    };
+
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void*, size_t, size_t) override {}
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+    void add_block(size_t size);
+    void release_blocks();
+
+    std::vector<Block> blocks_;
+    size_t blockSize_{};
+    size_t used_{};
+    size_t peak_{};
+};
+
+#endif //FRAME_ARENA_H
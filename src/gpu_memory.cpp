@@ -0,0 +1,161 @@
+#include "gpu_memory.h"
+
+#include <algorithm>
+#include <cassert>
+#include <map>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+
+namespace
+{
+    enum class Kind : uint8_t { Buffer, Image, Memory };
+
+    struct Record
+    {
+        VmaAllocator allocator;
+        std::string tag;
+        VkDeviceSize size;
+        Kind kind;
+    };
+
+    // Allocations are created from loader, worker and render code, so the registry is locked
+    std::mutex registryMutex;
+    std::unordered_map<VmaAllocation, Record> registry;
+
+    void track(VmaAllocator allocator, VmaAllocation allocation, const char* tag, Kind kind)
+    {
+        vmaSetAllocationName(allocator, allocation, tag);
+        VmaAllocationInfo info{};
+        vmaGetAllocationInfo(allocator, allocation, &info);
+        std::lock_guard lock(registryMutex);
+        registry[allocation] = Record{allocator, tag ? tag : "", info.size, kind};
+    }
+
+    void untrack(VmaAllocation allocation)
+    {
+        if (!allocation) return;
+        std::lock_guard lock(registryMutex);
+        [[maybe_unused]] const size_t erased = registry.erase(allocation);
+        assert(erased == 1 && "gpu_memory: freeing an allocation that was not created through gpu_memory");
+    }
+
+    const char* kind_name(Kind kind)
+    {
+        switch (kind)
+        {
+        case Kind::Buffer: return "BUFFER";
+        case Kind::Image: return "IMAGE";
+        case Kind::Memory: return "MEMORY";
+        }
+        return "?";
+    }
+}
+
+VkResult gpu_memory::create_buffer(VmaAllocator allocator, const VkBufferCreateInfo& bci, const VmaAllocationCreateInfo& aci,
+                                   const char* tag, VkBuffer* buffer, VmaAllocation* allocation, VmaAllocationInfo* info)
+{
+    const VkResult result = vmaCreateBuffer(allocator, &bci, &aci, buffer, allocation, info);
+    if (result == VK_SUCCESS) track(allocator, *allocation, tag, Kind::Buffer);
+    return result;
+}
+
+VkResult gpu_memory::create_image(VmaAllocator allocator, const VkImageCreateInfo& ici, const VmaAllocationCreateInfo& aci,
+                                  const char* tag, VkImage* image, VmaAllocation* allocation, VmaAllocationInfo* info)
+{
+    const VkResult result = vmaCreateImage(allocator, &ici, &aci, image, allocation, info);
+    if (result == VK_SUCCESS) track(allocator, *allocation, tag, Kind::Image);
+    return result;
+}
+
+VkResult gpu_memory::allocate_memory(VmaAllocator allocator, const VkMemoryRequirements& requirements, const VmaAllocationCreateInfo& aci,
+                                     const char* tag, VmaAllocation* allocation)
+{
+    const VkResult result = vmaAllocateMemory(allocator, &requirements, &aci, allocation, nullptr);
+    if (result == VK_SUCCESS) track(allocator, *allocation, tag, Kind::Memory);
+    return result;
+}
+
+void gpu_memory::destroy_buffer(VmaAllocator allocator, VkBuffer buffer, VmaAllocation allocation)
+{
+    untrack(allocation);
+    vmaDestroyBuffer(allocator, buffer, allocation);
+}
+
+void gpu_memory::destroy_image(VmaAllocator allocator, VkImage image, VmaAllocation allocation)
+{
+    untrack(allocation);
+    vmaDestroyImage(allocator, image, allocation);
+}
+
+void gpu_memory::free_memory(VmaAllocator allocator, VmaAllocation allocation)
+{
+    untrack(allocation);
+    vmaFreeMemory(allocator, allocation);
+}
+
+void gpu_memory::free_memory_pages(VmaAllocator allocator, size_t count, const VmaAllocation* allocations)
+{
+    for (size_t i = 0; i < count; i++) untrack(allocations[i]);
+    vmaFreeMemoryPages(allocator, count, allocations);
+}
+
+uint32_t gpu_memory::heaps(VmaAllocator allocator, HeapInfo (&out)[VK_MAX_MEMORY_HEAPS])
+{
+    const VkPhysicalDeviceMemoryProperties* props = nullptr;
+    vmaGetMemoryProperties(allocator, &props);
+
+    VmaBudget budgets[VK_MAX_MEMORY_HEAPS]{};
+    vmaGetHeapBudgets(allocator, budgets);
+
+    for (uint32_t i = 0; i < props->memoryHeapCount; i++)
+    {
+        out[i].usage = budgets[i].usage;
+        out[i].budget = budgets[i].budget;
+        out[i].blockBytes = budgets[i].statistics.blockBytes;
+        out[i].allocationBytes = budgets[i].statistics.allocationBytes;
+        out[i].allocationCount = budgets[i].statistics.allocationCount;
+        out[i].deviceLocal = (props->memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0;
+    }
+    return props->memoryHeapCount;
+}
+
+std::vector<gpu_memory::TagTotal> gpu_memory::live_by_tag(VmaAllocator allocator, bool byOwner)
+{
+    std::map<std::string, TagTotal, std::less<>> totals;
+    {
+        std::lock_guard lock(registryMutex);
+        for (const auto& [_, rec] : registry)
+        {
+            if (rec.allocator != allocator) continue;
+            std::string_view key = rec.tag.empty() ? std::string_view("(untagged)") : std::string_view(rec.tag);
+            if (byOwner) key = key.substr(0, key.find('/'));
+            auto it = totals.find(key);
+            if (it == totals.end()) it = totals.emplace(std::string(key), TagTotal{std::string(key)}).first;
+            it->second.bytes += rec.size;
+            it->second.count++;
+        }
+    }
+
+    std::vector<TagTotal> out;
+    out.reserve(totals.size());
+    for (auto& [_, t] : totals) out.push_back(std::move(t));
+    std::sort(out.begin(), out.end(), [](const TagTotal& a, const TagTotal& b) { return a.bytes > b.bytes; });
+    return out;
+}
+
+uint32_t gpu_memory::report_leaks(VmaAllocator allocator, FILE* out)
+{
+    uint32_t leaks = 0;
+    std::lock_guard lock(registryMutex);
+    for (const auto& [_, rec] : registry)
+    {
+        if (rec.allocator != allocator) continue;
+        if (leaks == 0) std::fprintf(out, "[gpu_memory] allocations still alive at shutdown:\n");
+        std::fprintf(out, "  %-8s %10llu bytes  %s\n", kind_name(rec.kind), static_cast<unsigned long long>(rec.size),
+                     rec.tag.empty() ? "(untagged)" : rec.tag.c_str());
+        leaks++;
+    }
+    if (leaks > 0) std::fprintf(out, "[gpu_memory] %u leaked allocation(s)\n", leaks);
+    return leaks;
+}
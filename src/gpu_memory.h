@@ -0,0 +1,62 @@
+#ifndef GPU_MEMORY_H
+#define GPU_MEMORY_H
+
+#include "vk_mem_alloc.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// GPU memory visibility on top of VMA.
+// Every allocation is created and freed through the wrappers below, which tag it with an
+// "Owner/resource" string (also set as the VMA allocation name for captures) and record
+// tag and size in a registry keyed by VmaAllocation. Live totals and the leak report read
+// that registry, so an allocation freed with a raw vmaDestroy* call shows up as a leak.
+namespace gpu_memory
+{
+    struct HeapInfo
+    {
+        VkDeviceSize usage{};           // process usage reported by the driver (VK_EXT_memory_budget)
+        VkDeviceSize budget{};          // what the process may use before it starts to hurt
+        VkDeviceSize blockBytes{};      // VkDeviceMemory allocated by VMA
+        VkDeviceSize allocationBytes{}; // bytes handed out to resources
+        uint32_t allocationCount{};
+        bool deviceLocal{};
+    };
+
+    struct TagTotal
+    {
+        std::string tag;
+        VkDeviceSize bytes{};
+        uint32_t count{};
+    };
+
+    // Tag convention: "Owner/resource", e.g. "MSDF/atlas". Wrappers return the VMA result;
+    // nothing is registered on failure.
+    VkResult create_buffer(VmaAllocator allocator, const VkBufferCreateInfo& bci, const VmaAllocationCreateInfo& aci,
+                           const char* tag, VkBuffer* buffer, VmaAllocation* allocation, VmaAllocationInfo* info = nullptr);
+    VkResult create_image(VmaAllocator allocator, const VkImageCreateInfo& ici, const VmaAllocationCreateInfo& aci,
+                          const char* tag, VkImage* image, VmaAllocation* allocation, VmaAllocationInfo* info = nullptr);
+    VkResult allocate_memory(VmaAllocator allocator, const VkMemoryRequirements& requirements, const VmaAllocationCreateInfo& aci,
+                             const char* tag, VmaAllocation* allocation);
+
+    // Null handles / allocations are ignored
+    void destroy_buffer(VmaAllocator allocator, VkBuffer buffer, VmaAllocation allocation);
+    void destroy_image(VmaAllocator allocator, VkImage image, VmaAllocation allocation);
+    void free_memory(VmaAllocator allocator, VmaAllocation allocation);
+    void free_memory_pages(VmaAllocator allocator, size_t count, const VmaAllocation* allocations);
+
+    // Fills out[0..heapCount) without allocating, so it is safe to call every frame
+    uint32_t heaps(VmaAllocator allocator, HeapInfo (&out)[VK_MAX_MEMORY_HEAPS]);
+
+    // Live allocations summed by full tag, or by owner (the part before '/') when byOwner is set;
+    // sorted by bytes, largest first. Walks the registry under its lock, so call it on demand.
+    std::vector<TagTotal> live_by_tag(VmaAllocator allocator, bool byOwner);
+
+    // Print every allocation still alive with its tag; returns how many were found
+    uint32_t report_leaks(VmaAllocator allocator, FILE* out);
+}
+
+#endif //GPU_MEMORY_H
@@ -3,6 +3,9 @@
 #include "ext/vk_images.h"
 
 #include <array>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
 
 #ifndef VK_CHECK
 #define VK_CHECK(x) do { VkResult err__ = (x); if (err__ != VK_SUCCESS) { /* simple check */ abort(); } } while(0)
@@ -105,6 +108,53 @@ void ImGuiLayer::new_frame()
     for (auto& fn : panels_) { fn(); }
 }
 
+bool ImGuiLayer::is_active() const
+{
+    if (!inited_) return false;
+    const ImGuiIO& io = ImGui::GetIO();
+    return ImGui::IsAnyItemActive() || ImGui::IsAnyMouseDown() || io.WantTextInput;
+}
+
+void ImGuiLayer::draw_bounds(std::vector<VkRect2D>& out) const
+{
+    out.clear();
+    if (!inited_) return;
+    const ImDrawData* dd = ImGui::GetDrawData();
+    if (!dd || !dd->Valid) return;
+
+    // one draw list per window; its clip rects bound everything it drew
+    for (int n = 0; n < dd->CmdListsCount; n++)
+    {
+        const ImDrawList* list = dd->CmdLists[n];
+        ImVec2 mn(FLT_MAX, FLT_MAX), mx(-FLT_MAX, -FLT_MAX);
+        for (const ImDrawCmd& c : list->CmdBuffer)
+        {
+            if (c.ElemCount == 0) continue;
+            mn.x = std::min(mn.x, c.ClipRect.x);
+            mn.y = std::min(mn.y, c.ClipRect.y);
+            mx.x = std::max(mx.x, c.ClipRect.z);
+            mx.y = std::max(mx.y, c.ClipRect.w);
+        }
+        if (mn.x >= mx.x || mn.y >= mx.y) continue;
+        const float x0 = std::max(0.0f, std::floor((mn.x - dd->DisplayPos.x) * dd->FramebufferScale.x));
+        const float y0 = std::max(0.0f, std::floor((mn.y - dd->DisplayPos.y) * dd->FramebufferScale.y));
+        const float x1 = std::ceil((mx.x - dd->DisplayPos.x) * dd->FramebufferScale.x);
+        const float y1 = std::ceil((mx.y - dd->DisplayPos.y) * dd->FramebufferScale.y);
+        if (x1 <= x0 || y1 <= y0) continue;
+        out.push_back(VkRect2D{{static_cast<int32_t>(x0), static_cast<int32_t>(y0)},
+                               {static_cast<uint32_t>(x1 - x0), static_cast<uint32_t>(y1 - y0)}});
+    }
+}
+
+void ImGuiLayer::render(VkCommandBuffer cmd)
+{
+    if (!inited_) return;
+
+    // Build draw data and record it
+    ImGui::Render();
+    ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), cmd);
+}
+
 void ImGuiLayer::render_overlay(VkCommandBuffer cmd,
                                 VkImage swapchainImage,
                                 VkImageView swapchainView,
@@ -145,11 +195,7 @@ void ImGuiLayer::render_overlay(VkCommandBuffer cmd,
     ri.pColorAttachments = &color;
 
     vkCmdBeginRendering(cmd, &ri);
-
-    // Build draw data and record it
-    ImGui::Render();
-    ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), cmd);
-
+    render(cmd);
     vkCmdEndRendering(cmd);
 
     // COLOR_ATTACHMENT_OPTIMAL -> PRESENT_SRC_KHR
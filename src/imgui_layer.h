@@ -33,9 +33,19 @@ public:
     // Begin a new UI frame and run registered panels
     void new_frame();
 
+    // True while the user is interacting (active widget, held mouse button, text input);
+    // an on-demand loop keeps drawing frames until this goes false
+    bool is_active() const;
+
+    // Framebuffer-pixel bounds of every window drawn by the last render() (for present damage)
+    void draw_bounds(std::vector<VkRect2D>& out) const;
+
+    // Record ImGui draw data into a dynamic rendering instance the caller has already begun
+    // (one colour attachment in the swapchain format, e.g. the engine composite pass)
+    void render(VkCommandBuffer cmd);
+
     // Record ImGui draw data on top of the current swapchain image
-    // Assumes the image is in TRANSFER_DST_OPTIMAL
-    // Transitions: TRANSFER_DST_OPTIMAL -> COLOR_ATTACHMENT_OPTIMAL -> PRESENT_SRC_KHR
+    // Transitions: previousLayout -> COLOR_ATTACHMENT_OPTIMAL -> PRESENT_SRC_KHR
     void render_overlay(VkCommandBuffer cmd,
                         VkImage swapchainImage,
                         VkImageView swapchainView,
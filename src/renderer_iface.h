@@ -2,32 +2,119 @@
 #define RENDERER_IFACE_H
 
 #include "vk_mem_alloc.h"
+#include "damage_region.h"
 
 #include <vulkan/vulkan.h>
 #include <cstdint>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
 
-struct  DescriptorAllocator; // forward decl from your project
+struct  DescriptorAllocatorGrowable; // forward decl from your project
+struct  BindlessHeap;
+struct  DescriptorBufferRing;
+struct  ScratchAllocator;
+struct  TypedDeletionQueue;
+struct  TransientPool;
+struct  ComputePrimitives;
+struct  ImmediateSubmit;
+
+// Optional device features detected at startup; renderers pick a path from these
+struct DeviceCaps
+{
+    // VK_KHR_push_descriptor (entry point is null when the extension is absent)
+    bool pushDescriptor{};
+    PFN_vkCmdPushDescriptorSetKHR cmdPushDescriptorSet{};
+    // VK_EXT_descriptor_buffer (RenderContext::frameDescriptorBuffer is null when absent)
+    bool descriptorBuffer{};
+    // VK_EXT_memory_budget (heap budgets are VMA estimates when absent)
+    bool memoryBudget{};
+    // Swapchain images carry VK_IMAGE_USAGE_STORAGE_BIT and can be written from compute
+    // (surface usage + format support + shaderStorageImageWriteWithoutFormat)
+    bool storageSwapchain{};
+    // VK_KHR_incremental_present (damage rectangles are passed to vkQueuePresentKHR)
+    bool incrementalPresent{};
+    // Compute shaders support subgroup basic + vote + ballot operations (Vulkan 1.1 subgroups)
+    bool subgroupBallot{};
+    // ... and subgroup arithmetic (subgroupAdd / subgroupInclusiveAdd / subgroupMin ...)
+    bool subgroupArithmetic{};
+    uint32_t subgroupSize{};
+    // VkPhysicalDeviceLimits::maxImageArrayLayers (at least 256)
+    uint32_t maxImageArrayLayers{256};
+};
 
 struct RenderContext
 {
     // ========== EngineContext ==========
     VkDevice device{};
     VmaAllocator allocator{};
-    DescriptorAllocator* descriptorAllocator{};
+    // Long-lived sets (allocated at init, rewritten in place on resize)
+    DescriptorAllocatorGrowable* descriptorAllocator{};
+    // Sets valid for the current frame only; bulk-reset once the frame fence signals
+    DescriptorAllocatorGrowable* frameDescriptors{};
+    // Per-frame descriptor buffer ring (VK_EXT_descriptor_buffer), rewound once the frame fence signals
+    DescriptorBufferRing* frameDescriptorBuffer{};
+    // Per-frame mapped linear allocator for uniforms/instance data, rewound once the frame fence signals
+    ScratchAllocator* frameScratch{};
+    // Per-frame CPU bump arena for std::pmr containers; everything in it dies at the next begin_frame
+    std::pmr::memory_resource* frameArena{std::pmr::get_default_resource()};
+    // Deferred destruction of GPU objects still referenced by in-flight frames
+    TypedDeletionQueue* retired{};
+    // Global bindless heap, bound at set 0 for compute and graphics once per frame
+    BindlessHeap* bindless{};
+    // Histogram / reduction / scan / compaction kernels on the bindless layout (src/ext/vk_compute_primitives.h)
+    ComputePrimitives* primitives{};
+    // Blocking one-off submissions on the graphics queue for init-time uploads (src/ext/vk_immediate.h)
+    ImmediateSubmit* immediate{};
     VkQueue graphics_queue{};
     uint32_t graphics_queue_family{};
+    DeviceCaps caps{};
+    // Frames the engine keeps in flight; per-frame resources and anything the GPU may still read
+    // from an older frame rotate with this period
+    uint32_t framesInFlight{1};
 
     // ========== Swapchain ==========
     VkExtent2D frameExtent{};
     VkFormat swapchainFormat{};
     // Provided by engine per frame
     VkImage swapchainImage{};
-    // Engine-managed offscreen target that content can use
+    VkImageView swapchainImageView{};
+    // Bindless storage handle of this frame's swapchain image when the engine is in direct-present
+    // mode and the renderer supports it, ~0u otherwise. The renderer then writes final pixels into
+    // it from compute and leaves it in GENERAL; the offscreen target is not composited.
+    uint32_t swapchainStorageIndex{~0u};
+    // Engine-managed offscreen target that content can use. Renderers leave it in
+    // VK_IMAGE_LAYOUT_GENERAL; the engine composite pass scales/tonemaps it into the swapchain.
     VkImage offscreenImage{};
     VkImageView offscreenImageView{};
-    // Engine-managed depth image for 3D rendering
-    VkImage depthImage{VK_NULL_HANDLE};
-    VkImageView depthImageView{VK_NULL_HANDLE};
+    // Format of the offscreen target (IRenderer::preferred_offscreen_format when supported)
+    VkFormat offscreenFormat{VK_FORMAT_R16G16B16A16_SFLOAT};
+    // Bindless storage image handle of the offscreen target (stable across resizes)
+    uint32_t offscreenStorageIndex{~0u};
+    // Attachments declared in IRenderer::declare_attachments (depth included); look up by handle in record()
+    TransientPool* transients{};
+    // This frame's dirty area of the offscreen target (set for record()). Unless full(), the target
+    // still holds the previous frame: keep it (GENERAL -> GENERAL, no UNDEFINED discard) and only
+    // shade damage->tiles(); when empty() nothing needs to be recorded at all.
+    const DamageRegion* damage{};
+};
+
+// Renderer-defined variants for the engine's GPU timing sweep (Benchmarks > GPU timings).
+// Each apply() runs between frames with the device idle; report() receives the averaged frame
+// GPU ms of every step (negative when no timestamps) before restore() runs.
+struct RendererSweep
+{
+    struct Step
+    {
+        std::string label;
+        std::function<void()> apply;
+    };
+    std::vector<Step> steps;
+    std::function<void(const std::vector<double>& gpuMs)> report;
+    std::function<void()> restore;
 };
 
 class IRenderer
@@ -39,6 +126,49 @@ public:
     virtual void destroy(const RenderContext& ctx) = 0;
     virtual void on_swapchain_resized(const RenderContext& ctx) = 0;
     virtual void on_imgui() = 0;
+    // Called every frame before record(): request depth or intermediate targets by description.
+    // Handles are indices into this frame's requests, so keep the request order stable.
+    virtual void declare_attachments(TransientPool& pool, const RenderContext& ctx) {}
+    // Storage format the renderer wants for the offscreen target; the engine falls back to
+    // R16G16B16A16_SFLOAT when the device cannot store/blit it. When the format changes at
+    // runtime the engine calls destroy() and then initialize() again on the same object.
+    virtual VkFormat preferred_offscreen_format() const { return VK_FORMAT_R16G16B16A16_SFLOAT; }
+    // On-demand rendering: true when the output would differ from the last recorded frame (new data,
+    // changed parameters, animation). Queried once per loop iteration, so implementations clear their
+    // flag here. The engine redraws by itself after resizes, renderer/format switches and
+    // request_redraw(); animated renderers keep the default.
+    virtual bool needs_redraw() { return true; }
+    // Called before record(): add the rectangles of the offscreen target whose pixels change this
+    // frame. The default repaints everything. The engine reports full() by itself whenever the
+    // target does not hold the previous output, so renderers only describe their own changes.
+    virtual void report_damage(DamageRegion& damage, const RenderContext& ctx) { damage.add_full(); }
+    // True when record() writes RenderContext::swapchainStorageIndex directly if it is provided
+    virtual bool supports_direct_present() const { return false; }
+    // Command-line tuning (main.cpp --set key=value), applied before initialize(); false for unknown keys
+    virtual bool set_option(std::string_view key, std::string_view value) { return false; }
+    // Button label for make_timing_sweep(), or null when the renderer has no variants to compare
+    virtual const char* timing_sweep_label() const { return nullptr; }
+    virtual RendererSweep make_timing_sweep() { return {}; }
+};
+
+// Suffix of the shader variant built for an offscreen format (cmake/compile_shaders.cmake):
+// "shaders/sky" + offscreen_shader_variant(fmt) + ".comp.spv". rgba16f is the unsuffixed default.
+inline const char* offscreen_shader_variant(VkFormat format)
+{
+    switch (format)
+    {
+    case VK_FORMAT_R8G8B8A8_UNORM: return ".rgba8";
+    case VK_FORMAT_A2B10G10R10_UNORM_PACK32: return ".rgb10_a2";
+    case VK_FORMAT_B10G11R11_UFLOAT_PACK32: return ".r11f_g11f_b10f";
+    default: return "";
+    }
+}
+
+// Example renderers by name (examples/entrance.cpp)
+struct RendererInfo
+{
+    const char* name;
+    std::unique_ptr<IRenderer> (*create)();
 };
 
 
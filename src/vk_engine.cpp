@@ -1,12 +1,21 @@
 #include "vk_engine.h"
 
 #include <SDL3/SDL_vulkan.h>
+#include <vulkan/vk_enum_string_helper.h>
 
 #include <stdexcept>
 #include <cmath>
 #include <array>
+#include <map>
+#include <cstdio>
+#include <utility>
+#include <algorithm>
+#include <span>
 
 #include "ext/vk_initializers.h"
+#include "engine_bench.h"
+#include "alloc_counter.h"
+#include "gpu_memory.h"
 #define VMA_IMPLEMENTATION
 #include "vk_mem_alloc.h"
 #include "VkBootstrap.h"
@@ -31,14 +40,73 @@
 #define REQUIRE_OK(expr,ok,msg) ([&](){ auto _rv_=(expr); if(!(_rv_==(ok))) throw std::runtime_error(std::string("Unexpected return from ")+#expr+" got="+std::to_string(static_cast<long long>(_rv_))+" expected="+std::to_string(static_cast<long long>(ok))+" | "+(msg)); return _rv_; }())
 #endif
 
-void VulkanEngine::init()
+namespace
 {
-    create_context(state_.width, state_.height, state_.name.c_str());
+    // Offscreen formats with shader variants (cmake/compile_shaders.cmake), widest first
+    constexpr VkFormat OffscreenFormats[] = {
+        VK_FORMAT_R16G16B16A16_SFLOAT,
+        VK_FORMAT_R8G8B8A8_UNORM,
+        VK_FORMAT_A2B10G10R10_UNORM_PACK32,
+        VK_FORMAT_B10G11R11_UFLOAT_PACK32,
+    };
+    constexpr VkFormat SwapchainFormat = VK_FORMAT_B8G8R8A8_UNORM;
+    constexpr uint32_t SweepWarmupFrames = 16;
+    constexpr uint32_t SweepFrames = 240;
+    // ImGui needs a few frames after an event to settle hover states and window layout
+    constexpr uint32_t UiSettleFrames = 3;
+    // Upper bound on an idle wait so quit/minimise handling never stalls
+    constexpr int32_t IdleWaitMs = 100;
+}
+
+void VulkanEngine::init(const LaunchOptions& options)
+{
+    if (!options.renderer.empty())
+    {
+        extern std::span<const RendererInfo> ExampleRenderers();
+        const auto renderers = ExampleRenderers();
+        const auto it = std::find_if(renderers.begin(), renderers.end(),
+                                     [&](const RendererInfo& info) { return options.renderer == info.name; });
+        REQUIRE_TRUE(it != renderers.end(), "unknown renderer '" + options.renderer + "'");
+        renderer_ = it->create();
+        renderer_name_ = it->name;
+    }
+    if (!renderer_)
+    {
+        extern std::unique_ptr<IRenderer> CreateDefaultComputeRenderer();
+        renderer_ = CreateDefaultComputeRenderer();
+    }
+    // options size GPU resources, so they go in before initialize()
+    for (const auto& [key, value] : options.settings)
+    {
+        REQUIRE_TRUE(renderer_->set_option(key, value), "renderer '" + renderer_name_ + "' rejected option " + key + "=" + value);
+    }
+    bench_frames_ = options.benchFrames;
+
+    create_context(state_.width, state_.height, state_.name.c_str(), bench_frames_ > 0);
     create_swapchain(state_.width, state_.height);
-    create_offscreen_drawable(state_.width, state_.height);
+    // registered once: recreate_swapchain() destroys and rebuilds in place, so whatever swapchain
+    // is current at shutdown goes through this one entry
+    mdq_.push_function([&]()
+    {
+        destroy_swapchain();
+    });
+    composite_.init(ctx_.device, ctx_.bindless, SwapchainFormat);
+    mdq_.push_function([&]() { composite_.destroy(ctx_.device, ctx_.bindless); });
+    primitives_.init(ctx_.device, ctx_.bindless, ctx_.caps.subgroupArithmetic);
+    mdq_.push_function([&]() { primitives_.destroy(ctx_.device); });
+    immediate_.init(ctx_.device, ctx_.graphics_queue, ctx_.graphics_queue_family);
+    mdq_.push_function([&]() { immediate_.destroy(ctx_.device); });
+    // the renderer object exists before the offscreen target so it can pick the format
+    create_offscreen_drawable(state_.width, state_.height, pick_offscreen_format());
+    mdq_.push_function([&]()
+    {
+        destroy_offscreen_drawable();
+    });
     create_command_buffers();
     create_renderer();
     create_imgui();
+    redraw_.wakeEvent = SDL_RegisterEvents(1);
+    invalidate_frame();
 
     state_.initialized = true;
     state_.running = true;
@@ -74,9 +142,17 @@ void VulkanEngine::run()
                 break;
 
             default:
+                // request_redraw(): new data for the renderer
+                if (redraw_.wakeEvent != 0 && e.type == redraw_.wakeEvent)
+                {
+                    redraw_.offscreenValid = false;
+                    redraw_.presentCurrent = false;
+                }
                 break;
             }
 
+            // any input may change the UI; draw until it settles
+            redraw_.settleFrames = UiSettleFrames;
             IF_NOT_NULL_DO(ui_, ui_->process_event(&e));
         }
 
@@ -86,6 +162,15 @@ void VulkanEngine::run()
             continue;
         }
 
+        // benchmarks own the queue while they run, so they go between frames
+        if (pending_bench_)
+        {
+            vkDeviceWaitIdle(ctx_.device);
+            pending_bench_();
+            pending_bench_ = nullptr;
+            invalidate_frame();
+        }
+
         // handle deferred resize
         if (state_.resize_requested)
         {
@@ -93,49 +178,282 @@ void VulkanEngine::run()
             continue; // start next frame
         }
 
-        uint32_t imageIndex = 0;
-        VkCommandBuffer cmd = VK_NULL_HANDLE;
-        begin_frame(imageIndex, cmd);
-
-        // if swapchain was out of date, begin_frame() returns early
-        if (cmd == VK_NULL_HANDLE)
+        // on-demand: nothing changed on screen, so nothing is recorded or submitted and the
+        // presentation engine keeps showing the last image until an event wakes us. Whether the
+        // offscreen target can be reused only matters once we draw, not for deciding to draw.
+        const bool rendererDirty = renderer_->needs_redraw();
+        if (state_.on_demand && !rendererDirty && redraw_.presentCurrent && redraw_.settleFrames == 0 && !timing_sweep_.active)
         {
-            // try to rebuild now
-            if (state_.resize_requested) recreate_swapchain();
+            const uint64_t t0 = SDL_GetTicksNS();
+            SDL_WaitEventTimeout(nullptr, IdleWaitMs);
+            redraw_.idleNs += SDL_GetTicksNS() - t0;
             continue;
         }
+        if (redraw_.settleFrames > 0) redraw_.settleFrames--;
+
+        draw_frame(rendererDirty);
+    }
+}
+
+bool VulkanEngine::draw_frame(bool rendererDirty)
+{
+    const uint64_t allocTotal = alloc_counter::total();
+    state_.frame_allocations = allocTotal - state_.alloc_total_at_frame_start;
+    state_.alloc_total_at_frame_start = allocTotal;
+
+    uint32_t imageIndex = 0;
+    VkCommandBuffer cmd = VK_NULL_HANDLE;
+    begin_frame(imageIndex, cmd);
+    step_timing_sweep();
+
+    // if swapchain was out of date, begin_frame() returns early
+    if (cmd == VK_NULL_HANDLE)
+    {
+        redraw_.offscreenValid = false;
+        redraw_.presentCurrent = false;
+        // try to rebuild now
+        if (state_.resize_requested) recreate_swapchain();
+        return false;
+    }
 
-        // Build per-frame RenderContext
-        RenderContext rctx{};
-        rctx.device = ctx_.device;
-        rctx.allocator = ctx_.allocator;
-        rctx.frameExtent = swapchain_.swapchain_extent;
-        rctx.swapchainFormat = swapchain_.swapchain_image_format;
-        rctx.swapchainImage = swapchain_.swapchain_images[imageIndex];
-        rctx.offscreenImage = swapchain_.drawable_image.image;
-        rctx.offscreenImageView = swapchain_.drawable_image.imageView;
-        rctx.descriptorAllocator = &ctx_.descriptor_allocator;
-        rctx.depthImage = swapchain_.depth_image.image;
-        rctx.depthImageView = swapchain_.depth_image.imageView;
-        rctx.graphics_queue = ctx_.graphics_queue;
-        rctx.graphics_queue_family = ctx_.graphics_queue_family;
+    // Build per-frame RenderContext
+    RenderContext rctx = make_render_context();
+    rctx.swapchainImage = swapchain_.swapchain_images[imageIndex];
+    rctx.swapchainImageView = swapchain_.swapchain_image_views[imageIndex];
+    const bool directPresent = state_.direct_present && renderer_->supports_direct_present()
+                               && !swapchain_.swapchain_storage_indices.empty();
+    if (directPresent)
+        rctx.swapchainStorageIndex = swapchain_.swapchain_storage_indices[imageIndex];
+
+    // attachments are only recreated when the requests change; the old ones may still be in flight
+    transients_.begin(swapchain_.swapchain_extent);
+    renderer_->declare_attachments(transients_, rctx);
+    if (transients_.needs_rebuild())
+    {
+        vkDeviceWaitIdle(ctx_.device);
+        transients_.compile();
+    }
+
+    // The bindless heap is bound once for the whole frame
+    ctx_.bindless.bind(cmd, VK_PIPELINE_BIND_POINT_COMPUTE);
+    ctx_.bindless.bind(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS);
 
+    // when only the UI changed the offscreen target still holds the renderer's last output;
+    // direct present and the blit composite leave nothing reusable, so those always re-record
+    // (and sweeps time whole frames)
+    const bool recordRenderer = !state_.on_demand || rendererDirty || !redraw_.offscreenValid || directPresent || timing_sweep_.active;
+
+    // partial damage needs last frame's pixels in the offscreen target
+    const bool fullDamage = !state_.damage_tracking || !redraw_.offscreenValid || directPresent;
+    damage_.begin(swapchain_.swapchain_extent, fullDamage);
+    if (recordRenderer)
+    {
+        renderer_->report_damage(damage_, rctx);
+        damage_.build_tiles(current_frame().scratch);
+        const VkExtent2D e = damage_.extent();
+        state_.damage_coverage = std::min(1.0, static_cast<double>(damage_.covered_pixels()) / std::max<double>(1.0, static_cast<double>(e.width) * e.height));
+    }
+    rctx.damage = &damage_;
+
+    GpuTimer& timer = current_frame().timer;
+    timer.begin(cmd, GpuScopeFrame);
+    if (recordRenderer)
+    {
+        timer.begin(cmd, GpuScopeRenderer);
         renderer_->record(cmd, static_cast<uint32_t>(swapchain_.swapchain_extent.width), static_cast<uint32_t>(swapchain_.swapchain_extent.height), rctx);
+        timer.end(cmd, GpuScopeRenderer);
+    }
+    else
+    {
+        redraw_.rendererSkips++;
+    }
 
-        if (ui_)
+    if (ui_)
+    {
+        ui_->new_frame();
+        if (renderer_) renderer_->on_imgui();
+        if (ui_->is_active()) redraw_.settleFrames = UiSettleFrames;
+    }
+
+    // offscreen target (or the directly written swapchain image) + UI -> PRESENT_SRC
+    CompositePass::Source src{};
+    if (!directPresent)
+    {
+        src.image = swapchain_.drawable_image.image;
+        src.sampledIndex = swapchain_.drawable_sampled_index;
+        src.extent = {swapchain_.drawable_image.imageExtent.width, swapchain_.drawable_image.imageExtent.height};
+    }
+    CompositePass::Target dst{};
+    dst.image = rctx.swapchainImage;
+    dst.view = rctx.swapchainImageView;
+    dst.extent = swapchain_.swapchain_extent;
+    dst.layout = directPresent ? VK_IMAGE_LAYOUT_GENERAL : VK_IMAGE_LAYOUT_UNDEFINED;
+    timer.begin(cmd, GpuScopeComposite);
+    if (state_.fused_composite)
+        composite_.record(cmd, src, dst, ui_.get());
+    else
+        composite_.record_blit(cmd, src, dst, ui_.get());
+    timer.end(cmd, GpuScopeComposite);
+    timer.end(cmd, GpuScopeFrame);
+    collect_present_regions();
+
+    end_frame(imageIndex, cmd, directPresent);
+    state_.frame_number++;
+    redraw_.drawnFrames++;
+    // the blit path leaves the offscreen target in TRANSFER_SRC, so only the fused path can reuse it
+    redraw_.offscreenValid = state_.fused_composite && !directPresent;
+    redraw_.presentCurrent = true;
+    return true;
+}
+
+int VulkanEngine::run_benchmark()
+{
+    // Same per-frame resources and fences as run(), but nothing is acquired, composited or
+    // presented: the numbers are the renderer's alone and not capped by the display.
+    const VkExtent2D extent = swapchain_.swapchain_extent;
+    const uint32_t total = SweepWarmupFrames + bench_frames_;
+    std::vector<double> cpuMs, frameMs, gpuMs;
+    cpuMs.reserve(bench_frames_);
+    frameMs.reserve(bench_frames_);
+    gpuMs.reserve(bench_frames_);
+
+    uint64_t last = SDL_GetTicksNS();
+    for (uint32_t i = 0; i < total && state_.running; ++i)
+    {
+        SDL_Event e{};
+        while (SDL_PollEvent(&e))
         {
-            ui_->new_frame();
-            if (renderer_) renderer_->on_imgui();
-            ui_->render_overlay(cmd,
-                                swapchain_.swapchain_images[imageIndex],
-                                swapchain_.swapchain_image_views[imageIndex],
-                                swapchain_.swapchain_extent,
-                                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+            if (e.type == SDL_EVENT_QUIT) state_.running = false;
         }
 
-        end_frame(imageIndex, cmd);
+        FrameData& fr = current_frame();
+        wait_frame(fr);
+        // the fence just waited on belongs to frame i - FRAME_OVERLAP
+        if (i >= SweepWarmupFrames + FRAME_OVERLAP && state_.frame_gpu_ms >= 0.0) gpuMs.push_back(state_.frame_gpu_ms);
+
+        VK_CHECK(vkResetFences(ctx_.device, 1, &fr.renderFence));
+        VK_CHECK(vkResetCommandBuffer(fr.mainCommandBuffer, 0));
+        VkCommandBuffer cmd = fr.mainCommandBuffer;
+        VkCommandBufferBeginInfo bi = vkinit::command_buffer_begin_info(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+        VK_CHECK(vkBeginCommandBuffer(cmd, &bi));
+        fr.timer.reset(cmd);
+
+        const uint64_t cpu0 = SDL_GetTicksNS();
+        RenderContext rctx = make_render_context();
+        transients_.begin(extent);
+        renderer_->declare_attachments(transients_, rctx);
+        if (transients_.needs_rebuild())
+        {
+            vkDeviceWaitIdle(ctx_.device);
+            transients_.compile();
+        }
+        ctx_.bindless.bind(cmd, VK_PIPELINE_BIND_POINT_COMPUTE);
+        ctx_.bindless.bind(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS);
+        // every frame is a full redraw, like a frame after the data changed everywhere
+        damage_.begin(extent, true);
+        renderer_->report_damage(damage_, rctx);
+        damage_.build_tiles(fr.scratch);
+        rctx.damage = &damage_;
+
+        fr.timer.begin(cmd, GpuScopeFrame);
+        fr.timer.begin(cmd, GpuScopeRenderer);
+        renderer_->record(cmd, extent.width, extent.height, rctx);
+        fr.timer.end(cmd, GpuScopeRenderer);
+        fr.timer.end(cmd, GpuScopeFrame);
+        VK_CHECK(vkEndCommandBuffer(cmd));
+        fr.scratch.flush();
+        const uint64_t cpu1 = SDL_GetTicksNS();
+
+        VkCommandBufferSubmitInfo cbsi = vkinit::command_buffer_submit_info(cmd);
+        VkSubmitInfo2 si = vkinit::submit_info(&cbsi, nullptr, nullptr);
+        VK_CHECK(vkQueueSubmit2(ctx_.graphics_queue, 1, &si, fr.renderFence));
         state_.frame_number++;
+
+        const uint64_t now = SDL_GetTicksNS();
+        if (i >= SweepWarmupFrames)
+        {
+            cpuMs.push_back(static_cast<double>(cpu1 - cpu0) * 1e-6);
+            frameMs.push_back(static_cast<double>(now - last) * 1e-6);
+        }
+        last = now;
     }
+    vkDeviceWaitIdle(ctx_.device);
+    // the offscreen target was never composited; the next run() frame must redraw it
+    invalidate_frame();
+
+    auto print = [](const char* name, std::vector<double>& v)
+    {
+        if (v.empty())
+        {
+            std::printf("  %-10s n/a\n", name);
+            return;
+        }
+        std::sort(v.begin(), v.end());
+        double sum = 0.0;
+        for (double x : v) sum += x;
+        const auto pct = [&](double p) { return v[std::min(v.size() - 1, static_cast<size_t>(p * static_cast<double>(v.size())))]; };
+        std::printf("  %-10s avg %8.3f ms  p50 %8.3f ms  p95 %8.3f ms  max %8.3f ms\n", name,
+                    sum / static_cast<double>(v.size()), pct(0.50), pct(0.95), v.back());
+    };
+    std::printf("benchmark: renderer '%s', %ux%u, %zu frames (+%u warm-up)\n", renderer_name_.c_str(),
+                extent.width, extent.height, frameMs.size(), SweepWarmupFrames);
+    print("frame", frameMs);
+    print("cpu record", cpuMs);
+    print("gpu", gpuMs);
+    if (!frameMs.empty())
+    {
+        double sum = 0.0;
+        for (double x : frameMs) sum += x;
+        std::printf("  %-10s %.1f\n", "fps", 1000.0 * static_cast<double>(frameMs.size()) / std::max(sum, 1e-6));
+    }
+    std::fflush(stdout);
+    return frameMs.empty() ? 1 : 0;
+}
+
+void VulkanEngine::request_redraw()
+{
+    // SDL_PushEvent is thread-safe and wakes SDL_WaitEventTimeout in the idle loop
+    if (redraw_.wakeEvent == 0) return;
+    SDL_Event e{};
+    e.type = redraw_.wakeEvent;
+    SDL_PushEvent(&e);
+}
+
+void VulkanEngine::collect_present_regions()
+{
+    present_rects_.clear();
+    present_full_ = damage_.full();
+    if (ui_) ui_->draw_bounds(ui_rects_);
+    if (!present_full_)
+    {
+        const VkExtent2D frame = swapchain_.swapchain_extent;
+        auto push = [&](const VkRect2D& r, double sx, double sy)
+        {
+            const int32_t x0 = std::max(0, static_cast<int32_t>(std::floor(r.offset.x * sx)));
+            const int32_t y0 = std::max(0, static_cast<int32_t>(std::floor(r.offset.y * sy)));
+            const int32_t x1 = std::min(static_cast<int32_t>(frame.width), static_cast<int32_t>(std::ceil((r.offset.x + r.extent.width) * sx)));
+            const int32_t y1 = std::min(static_cast<int32_t>(frame.height), static_cast<int32_t>(std::ceil((r.offset.y + r.extent.height) * sy)));
+            if (x1 > x0 && y1 > y0)
+                present_rects_.push_back(VkRectLayerKHR{{x0, y0}, {static_cast<uint32_t>(x1 - x0), static_cast<uint32_t>(y1 - y0)}, 0});
+        };
+        // the composite pass stretches the rendered part of the offscreen target over the frame
+        const VkExtent2D src = {std::min(swapchain_.drawable_image.imageExtent.width, frame.width),
+                                std::min(swapchain_.drawable_image.imageExtent.height, frame.height)};
+        const double sx = static_cast<double>(frame.width) / std::max(1u, src.width);
+        const double sy = static_cast<double>(frame.height) / std::max(1u, src.height);
+        for (const VkRect2D& r : damage_.rects()) push(r, sx, sy);
+        // UI windows drawn now and last frame (a window that closed changed its old area)
+        for (const VkRect2D& r : ui_rects_) push(r, 1.0, 1.0);
+        for (const VkRect2D& r : prev_ui_rects_) push(r, 1.0, 1.0);
+    }
+    std::swap(ui_rects_, prev_ui_rects_);
+}
+
+void VulkanEngine::invalidate_frame()
+{
+    redraw_.offscreenValid = false;
+    redraw_.presentCurrent = false;
+    redraw_.settleFrames = UiSettleFrames;
 }
 
 void VulkanEngine::cleanup()
@@ -146,7 +464,7 @@ void VulkanEngine::cleanup()
     destroy_context();
 }
 
-void VulkanEngine::create_context(int window_width, int window_height, const char* app_name)
+void VulkanEngine::create_context(int window_width, int window_height, const char* app_name, bool hidden)
 {
     // 1. create VkInstance + VkDebugUtilsMessengerEXT
     vkb::Instance vkb_inst = vkb::InstanceBuilder()
@@ -161,7 +479,7 @@ void VulkanEngine::create_context(int window_width, int window_height, const cha
 
     // 2. create SDL3 window and VkSurfaceKHR
     REQUIRE_TRUE(SDL_Init(SDL_INIT_VIDEO), std::string("SDL_Init failed: ") + SDL_GetError());
-    REQUIRE_PTR(ctx_.window = SDL_CreateWindow("Vulkan Engine", window_width, window_height, SDL_WINDOW_VULKAN | SDL_WINDOW_RESIZABLE), std::string("SDL_CreateWindow failed: ") + SDL_GetError());
+    REQUIRE_PTR(ctx_.window = SDL_CreateWindow("Vulkan Engine", window_width, window_height, SDL_WINDOW_VULKAN | (hidden ? SDL_WINDOW_HIDDEN : SDL_WINDOW_RESIZABLE)), std::string("SDL_CreateWindow failed: ") + SDL_GetError());
     REQUIRE_TRUE(SDL_Vulkan_CreateSurface(ctx_.window, ctx_.instance, nullptr, &ctx_.surface), std::string("SDL_Vulkan_CreateSurface failed: ") + SDL_GetError());
 
 
@@ -174,6 +492,15 @@ void VulkanEngine::create_context(int window_width, int window_height, const cha
     f12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
     f12.bufferDeviceAddress = VK_TRUE;
     f12.descriptorIndexing = VK_TRUE;
+    // bindless heap: update-after-bind, partially bound runtime arrays
+    f12.runtimeDescriptorArray = VK_TRUE;
+    f12.descriptorBindingPartiallyBound = VK_TRUE;
+    f12.descriptorBindingStorageImageUpdateAfterBind = VK_TRUE;
+    f12.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+    f12.descriptorBindingStorageBufferUpdateAfterBind = VK_TRUE;
+    f12.shaderStorageImageArrayNonUniformIndexing = VK_TRUE;
+    f12.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+    f12.shaderStorageBufferArrayNonUniformIndexing = VK_TRUE;
     vkb::PhysicalDevice phys = vkb::PhysicalDeviceSelector(vkb_inst)
                                .set_surface(ctx_.surface)
                                .set_minimum_version(1, 3)
@@ -181,9 +508,53 @@ void VulkanEngine::create_context(int window_width, int window_height, const cha
                                .set_required_features_12(f12)
                                .select().value();
     ctx_.physical = phys.physical_device;
+    ctx_.caps.pushDescriptor = phys.enable_extension_if_present(VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME);
+    VkPhysicalDeviceDescriptorBufferFeaturesEXT fdb{.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_FEATURES_EXT};
+    fdb.descriptorBuffer = VK_TRUE;
+    ctx_.caps.descriptorBuffer = phys.enable_extension_if_present(VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME)
+                                 && phys.enable_extension_features_if_present(fdb);
+    ctx_.caps.memoryBudget = phys.enable_extension_if_present(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+    ctx_.caps.incrementalPresent = phys.enable_extension_if_present(VK_KHR_INCREMENTAL_PRESENT_EXTENSION_NAME);
+    {
+        // direct present: compute writes the BGRA8 swapchain image, which has no GLSL format qualifier
+        VkPhysicalDeviceFeatures wof{};
+        wof.shaderStorageImageWriteWithoutFormat = VK_TRUE;
+        VkSurfaceCapabilitiesKHR surfaceCaps{};
+        vkGetPhysicalDeviceSurfaceCapabilitiesKHR(ctx_.physical, ctx_.surface, &surfaceCaps);
+        uint32_t formatCount = 0;
+        vkGetPhysicalDeviceSurfaceFormatsKHR(ctx_.physical, ctx_.surface, &formatCount, nullptr);
+        std::vector<VkSurfaceFormatKHR> formats(formatCount);
+        vkGetPhysicalDeviceSurfaceFormatsKHR(ctx_.physical, ctx_.surface, &formatCount, formats.data());
+        const bool hasFormat = std::any_of(formats.begin(), formats.end(), [](const VkSurfaceFormatKHR& f) { return f.format == SwapchainFormat; });
+        VkFormatProperties fp{};
+        vkGetPhysicalDeviceFormatProperties(ctx_.physical, SwapchainFormat, &fp);
+        ctx_.caps.storageSwapchain = hasFormat
+                                     && (surfaceCaps.supportedUsageFlags & VK_IMAGE_USAGE_STORAGE_BIT)
+                                     && (fp.optimalTilingFeatures & VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT)
+                                     && phys.enable_features_if_present(wof);
+    }
+    {
+        VkPhysicalDeviceSubgroupProperties sp{.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SUBGROUP_PROPERTIES};
+        VkPhysicalDeviceProperties2 p2{.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2, .pNext = &sp};
+        vkGetPhysicalDeviceProperties2(ctx_.physical, &p2);
+        constexpr VkSubgroupFeatureFlags needed = VK_SUBGROUP_FEATURE_BASIC_BIT | VK_SUBGROUP_FEATURE_VOTE_BIT | VK_SUBGROUP_FEATURE_BALLOT_BIT;
+        ctx_.caps.subgroupBallot = (sp.supportedStages & VK_SHADER_STAGE_COMPUTE_BIT) && (sp.supportedOperations & needed) == needed;
+        ctx_.caps.subgroupArithmetic = ctx_.caps.subgroupBallot && (sp.supportedOperations & VK_SUBGROUP_FEATURE_ARITHMETIC_BIT);
+        ctx_.caps.subgroupSize = sp.subgroupSize;
+        ctx_.caps.maxImageArrayLayers = p2.properties.limits.maxImageArrayLayers;
+    }
     vkb::Device vkbDev = vkb::DeviceBuilder(phys)
                          .build().value();
     ctx_.device = vkbDev.device;
+    if (ctx_.caps.pushDescriptor)
+    {
+        ctx_.caps.cmdPushDescriptorSet = reinterpret_cast<PFN_vkCmdPushDescriptorSetKHR>(vkGetDeviceProcAddr(ctx_.device, "vkCmdPushDescriptorSetKHR"));
+        ctx_.caps.pushDescriptor = ctx_.caps.cmdPushDescriptorSet != nullptr;
+    }
+    if (ctx_.caps.descriptorBuffer)
+    {
+        ctx_.caps.descriptorBuffer = ctx_.descriptor_buffer.load(ctx_.device, ctx_.physical);
+    }
     ctx_.graphics_queue = vkbDev.get_queue(vkb::QueueType::graphics).value();
     ctx_.graphics_queue_family = vkbDev.get_queue_index(vkb::QueueType::graphics).value();
 
@@ -194,11 +565,23 @@ void VulkanEngine::create_context(int window_width, int window_height, const cha
     ac.device = ctx_.device;
     ac.instance = ctx_.instance;
     ac.flags = VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT;
+    if (ctx_.caps.memoryBudget) ac.flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
     VK_CHECK(vmaCreateAllocator(&ac, &ctx_.allocator));
     mdq_.push_function([&]() { vmaDestroyAllocator(ctx_.allocator); });
-    std::vector<DescriptorAllocator::PoolSizeRatio> sizes = {{VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1.0f}, {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1.0f}, {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1.0f}};
-    ctx_.descriptor_allocator.init_pool(ctx_.device, 10, sizes);
-    mdq_.push_function([&]() { ctx_.descriptor_allocator.destroy_pool(ctx_.device); });
+    // runs after every other teardown step, so anything listed here was never freed
+    mdq_.push_function([&]() { gpu_memory::report_leaks(ctx_.allocator, stderr); });
+    mdq_.push_function([&]() { retired_.flush(ctx_.device, ctx_.allocator); });
+    std::vector<DescriptorAllocatorGrowable::PoolSizeRatio> sizes = {{VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1.0f}, {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1.0f}, {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1.0f}};
+    ctx_.descriptor_allocator.init(ctx_.device, 10, sizes);
+    mdq_.push_function([&]() { ctx_.descriptor_allocator.destroy_pools(ctx_.device); });
+
+    // 5. create the global bindless heap
+    ctx_.bindless.init(ctx_.device, ctx_.physical);
+    mdq_.push_function([&]() { ctx_.bindless.destroy(ctx_.device); });
+
+    // 6. renderer attachments (depth, intermediates) are created on request
+    transients_.init(ctx_.device, ctx_.allocator);
+    mdq_.push_function([&]() { transients_.destroy(); });
 }
 
 void VulkanEngine::destroy_context()
@@ -216,27 +599,32 @@ void VulkanEngine::destroy_context()
 
 void VulkanEngine::create_swapchain(uint32_t width, uint32_t height)
 {
-    swapchain_.swapchain_image_format = VK_FORMAT_B8G8R8A8_UNORM;
+    swapchain_.swapchain_image_format = SwapchainFormat;
+    VkImageUsageFlags usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+    if (ctx_.caps.storageSwapchain) usage |= VK_IMAGE_USAGE_STORAGE_BIT;
     vkb::Swapchain sc = vkb::SwapchainBuilder(ctx_.physical, ctx_.device, ctx_.surface)
                         .set_desired_format(VkSurfaceFormatKHR{swapchain_.swapchain_image_format, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR})
                         .set_desired_present_mode(VK_PRESENT_MODE_FIFO_KHR)
                         .set_desired_extent(width, height)
-                        .add_image_usage_flags(VK_IMAGE_USAGE_TRANSFER_DST_BIT)
+                        .add_image_usage_flags(usage)
                         .build().value();
     swapchain_.swapchain = sc.swapchain;
     swapchain_.swapchain_extent = sc.extent;
     swapchain_.swapchain_images = sc.get_images().value();
     swapchain_.swapchain_image_views = sc.get_image_views().value();
-
-    mdq_.push_function([&]()
+    if (ctx_.caps.storageSwapchain)
     {
-        destroy_swapchain();
-    });
+        for (VkImageView v : swapchain_.swapchain_image_views)
+            swapchain_.swapchain_storage_indices.push_back(ctx_.bindless.add_storage_image(ctx_.device, v));
+    }
 }
 
 void VulkanEngine::destroy_swapchain()
 {
     // IMPORTANT NOTE: DO NOT MANUALLY DESTROY swapchain_.swapchain_images, they are owned by the swapchain
+    for (uint32_t index : swapchain_.swapchain_storage_indices)
+        ctx_.bindless.release(BindlessHeap::StorageImage, index);
+    swapchain_.swapchain_storage_indices.clear();
     for (auto v : swapchain_.swapchain_image_views)
         IF_NOT_NULL_DO_AND_SET(v, vkDestroyImageView(ctx_.device, v, nullptr), VK_NULL_HANDLE);
     swapchain_.swapchain_image_views.clear();
@@ -256,70 +644,89 @@ void VulkanEngine::recreate_swapchain()
 
     create_swapchain((uint32_t)w, (uint32_t)h);
 
-    RenderContext rctx{};
-    rctx.device = ctx_.device;
-    rctx.allocator = ctx_.allocator;
-    rctx.frameExtent = swapchain_.swapchain_extent;
-    rctx.swapchainFormat = swapchain_.swapchain_image_format;
-    rctx.offscreenImage = swapchain_.drawable_image.image;
-    rctx.offscreenImageView = swapchain_.drawable_image.imageView;
-    rctx.descriptorAllocator = &ctx_.descriptor_allocator;
+    RenderContext rctx = make_render_context();
 
     IF_NOT_NULL_DO(renderer_, renderer_->on_swapchain_resized(rctx));
+    invalidate_frame();
     IF_NOT_NULL_DO(ui_, ui_->set_min_image_count(static_cast<uint32_t>(swapchain_.swapchain_images.size())));
 
     state_.resize_requested = false;
 }
 
-void VulkanEngine::create_offscreen_drawable(uint32_t width, uint32_t height)
+void VulkanEngine::create_offscreen_drawable(uint32_t width, uint32_t height, VkFormat format)
 {
     VkExtent3D imageExtent = {width, height, 1};
     {
-        VkFormat imageFormat = VK_FORMAT_R16G16B16A16_SFLOAT;
+        VkFormat imageFormat = format;
         VkImageUsageFlags usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT
             | VK_IMAGE_USAGE_TRANSFER_DST_BIT
             | VK_IMAGE_USAGE_STORAGE_BIT
+            | VK_IMAGE_USAGE_SAMPLED_BIT
             | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
         VkImageCreateInfo imgci = vkinit::image_create_info(imageFormat, usage, imageExtent);
         VmaAllocationCreateInfo ainfo{};
         ainfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
         ainfo.requiredFlags = VkMemoryPropertyFlags(VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-        VK_CHECK(vmaCreateImage(ctx_.allocator, &imgci, &ainfo, &swapchain_.drawable_image.image, &swapchain_.drawable_image.allocation, nullptr));
+        VK_CHECK(gpu_memory::create_image(ctx_.allocator, imgci, ainfo, "Engine/offscreen", &swapchain_.drawable_image.image, &swapchain_.drawable_image.allocation));
         VkImageViewCreateInfo viewci = vkinit::imageview_create_info(imageFormat, swapchain_.drawable_image.image, VK_IMAGE_ASPECT_COLOR_BIT);
         VK_CHECK(vkCreateImageView(ctx_.device, &viewci, nullptr, &swapchain_.drawable_image.imageView));
         swapchain_.drawable_image.imageFormat = imageFormat;
         swapchain_.drawable_image.imageExtent = imageExtent;
-    }
 
-    {
-        VkFormat depthFormat = VK_FORMAT_D32_SFLOAT;
-        VkImageUsageFlags usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
-        VkImageCreateInfo imgci = vkinit::image_create_info(depthFormat, usage, imageExtent);
-        VmaAllocationCreateInfo ainfo{};
-        ainfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
-        ainfo.requiredFlags = VkMemoryPropertyFlags(VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-        VK_CHECK(vmaCreateImage(ctx_.allocator, &imgci, &ainfo, &swapchain_.depth_image.image, &swapchain_.depth_image.allocation, nullptr));
-        VkImageViewCreateInfo viewci = vkinit::imageview_create_info(depthFormat, swapchain_.depth_image.image, VK_IMAGE_ASPECT_DEPTH_BIT);
-        VK_CHECK(vkCreateImageView(ctx_.device, &viewci, nullptr, &swapchain_.depth_image.imageView));
-        swapchain_.depth_image.imageFormat = depthFormat;
-        swapchain_.depth_image.imageExtent = imageExtent;
+        // keep the bindless handle stable so renderers never need to re-query it
+        if (swapchain_.drawable_storage_index == BindlessHeap::InvalidIndex)
+            swapchain_.drawable_storage_index = ctx_.bindless.add_storage_image(ctx_.device, swapchain_.drawable_image.imageView);
+        else
+            ctx_.bindless.update_storage_image(ctx_.device, swapchain_.drawable_storage_index, swapchain_.drawable_image.imageView);
+        if (swapchain_.drawable_sampled_index == BindlessHeap::InvalidIndex)
+            swapchain_.drawable_sampled_index = ctx_.bindless.add_sampled_image(ctx_.device, swapchain_.drawable_image.imageView, VK_IMAGE_LAYOUT_GENERAL);
+        else
+            ctx_.bindless.update_sampled_image(ctx_.device, swapchain_.drawable_sampled_index, swapchain_.drawable_image.imageView, VK_IMAGE_LAYOUT_GENERAL);
     }
-
-    mdq_.push_function([&]()
-    {
-        destroy_offscreen_drawable();
-    });
 }
 
 void VulkanEngine::destroy_offscreen_drawable()
 {
     IF_NOT_NULL_DO_AND_SET(swapchain_.drawable_image.imageView, vkDestroyImageView(ctx_.device, swapchain_.drawable_image.imageView, nullptr), VK_NULL_HANDLE);
-    IF_NOT_NULL_DO_AND_SET(swapchain_.drawable_image.image, vmaDestroyImage(ctx_.allocator, swapchain_.drawable_image.image, swapchain_.drawable_image.allocation), VK_NULL_HANDLE);
+    IF_NOT_NULL_DO_AND_SET(swapchain_.drawable_image.image, gpu_memory::destroy_image(ctx_.allocator, swapchain_.drawable_image.image, swapchain_.drawable_image.allocation), VK_NULL_HANDLE);
     swapchain_.drawable_image = {};
+}
 
-    IF_NOT_NULL_DO_AND_SET(swapchain_.depth_image.imageView, vkDestroyImageView(ctx_.device, swapchain_.depth_image.imageView, nullptr), VK_NULL_HANDLE);
-    IF_NOT_NULL_DO_AND_SET(swapchain_.depth_image.image, vmaDestroyImage(ctx_.allocator, swapchain_.depth_image.image, swapchain_.depth_image.allocation), VK_NULL_HANDLE);
-    swapchain_.depth_image = {};
+bool VulkanEngine::offscreen_format_supported(VkFormat format) const
+{
+    // renderers write it from compute or as a color attachment; the composite pass samples or blits it
+    constexpr VkFormatFeatureFlags required = VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT
+        | VK_FORMAT_FEATURE_COLOR_ATTACHMENT_BIT
+        | VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT
+        | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT
+        | VK_FORMAT_FEATURE_BLIT_SRC_BIT
+        | VK_FORMAT_FEATURE_TRANSFER_SRC_BIT
+        | VK_FORMAT_FEATURE_TRANSFER_DST_BIT;
+    VkFormatProperties props{};
+    vkGetPhysicalDeviceFormatProperties(ctx_.physical, format, &props);
+    return (props.optimalTilingFeatures & required) == required;
+}
+
+VkFormat VulkanEngine::pick_offscreen_format() const
+{
+    VkFormat format = offscreen_format_override_;
+    if (format == VK_FORMAT_UNDEFINED && renderer_) format = renderer_->preferred_offscreen_format();
+    if (format == VK_FORMAT_UNDEFINED || !offscreen_format_supported(format)) format = VK_FORMAT_R16G16B16A16_SFLOAT;
+    return format;
+}
+
+void VulkanEngine::apply_offscreen_format(VkFormat format)
+{
+    vkDeviceWaitIdle(ctx_.device);
+    offscreen_format_override_ = format;
+    if (pick_offscreen_format() == swapchain_.drawable_image.imageFormat) return;
+
+    // pipelines and shader variants depend on the format, so the renderer starts over
+    IF_NOT_NULL_DO(renderer_, renderer_->destroy(make_render_context()));
+    const VkExtent3D extent = swapchain_.drawable_image.imageExtent;
+    destroy_offscreen_drawable();
+    create_offscreen_drawable(extent.width, extent.height, pick_offscreen_format());
+    IF_NOT_NULL_DO(renderer_, renderer_->initialize(make_render_context()));
 }
 
 void VulkanEngine::create_command_buffers()
@@ -339,6 +746,31 @@ void VulkanEngine::create_command_buffers()
         VK_CHECK(vkCreateSemaphore(ctx_.device, &sci, nullptr, &frames_[i].swapchainSemaphore));
         VK_CHECK(vkCreateSemaphore(ctx_.device, &sci, nullptr, &frames_[i].renderSemaphore));
     }
+
+    // per-frame descriptor sets, reset wholesale in begin_frame
+    std::vector<DescriptorAllocatorGrowable::PoolSizeRatio> sizes = {
+        {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 3.0f},
+        {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 3.0f},
+        {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 3.0f},
+        {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 3.0f},
+    };
+    for (int i = 0; i < FRAME_OVERLAP; i++)
+    {
+        frames_[i].frameDescriptors.init(ctx_.device, 64, sizes);
+        // 4 MiB holds tens of thousands of small sets per frame on every current driver
+        if (ctx_.caps.descriptorBuffer)
+            frames_[i].descriptorRing.init(ctx_.device, ctx_.allocator, &ctx_.descriptor_buffer, 4ull << 20);
+    }
+
+    // per-frame scratch memory; offsets satisfy both UBO and SSBO binding alignment
+    VkPhysicalDeviceProperties props{};
+    vkGetPhysicalDeviceProperties(ctx_.physical, &props);
+    const VkDeviceSize scratchAlign = std::max(props.limits.minUniformBufferOffsetAlignment, props.limits.minStorageBufferOffsetAlignment);
+    for (int i = 0; i < FRAME_OVERLAP; i++)
+    {
+        frames_[i].scratch.init(ctx_.device, ctx_.allocator, 1ull << 20, scratchAlign);
+        frames_[i].timer.init(ctx_.device, ctx_.physical, ctx_.graphics_queue_family, GpuScopeCount);
+    }
 }
 
 void VulkanEngine::destroy_command_buffers()
@@ -346,6 +778,10 @@ void VulkanEngine::destroy_command_buffers()
     for (int i = 0; i < FRAME_OVERLAP; i++)
     {
         frames_[i].deletionQueue.flush();
+        frames_[i].frameDescriptors.destroy_pools(ctx_.device);
+        frames_[i].descriptorRing.destroy(ctx_.allocator);
+        frames_[i].scratch.destroy();
+        frames_[i].timer.destroy(ctx_.device);
         IF_NOT_NULL_DO_AND_SET(frames_[i].renderFence, vkDestroyFence(ctx_.device, frames_[i].renderFence, nullptr), VK_NULL_HANDLE);
         IF_NOT_NULL_DO_AND_SET(frames_[i].swapchainSemaphore, vkDestroySemaphore(ctx_.device, frames_[i].swapchainSemaphore, nullptr), VK_NULL_HANDLE);
         IF_NOT_NULL_DO_AND_SET(frames_[i].renderSemaphore, vkDestroySemaphore(ctx_.device, frames_[i].renderSemaphore, nullptr), VK_NULL_HANDLE);
@@ -353,12 +789,32 @@ void VulkanEngine::destroy_command_buffers()
     }
 }
 
-void VulkanEngine::begin_frame(uint32_t& imageIndex, VkCommandBuffer& cmd)
+void VulkanEngine::wait_frame(FrameData& fr)
 {
-    FrameData& fr = frames_[state_.frame_number % FRAME_OVERLAP];
-
     VK_CHECK(vkWaitForFences(ctx_.device, 1, &fr.renderFence, VK_TRUE, 1000000000));
     fr.deletionQueue.flush();
+    fr.timer.resolve(ctx_.device);
+    state_.renderer_gpu_ms = fr.timer.ms(GpuScopeRenderer);
+    state_.composite_gpu_ms = fr.timer.ms(GpuScopeComposite);
+    state_.frame_gpu_ms = fr.timer.ms(GpuScopeFrame);
+    // this fence covers every submission up to frame_number - FRAME_OVERLAP
+    if (state_.frame_number >= static_cast<int>(FRAME_OVERLAP))
+    {
+        retired_.collect(ctx_.device, ctx_.allocator, static_cast<uint64_t>(state_.frame_number) - FRAME_OVERLAP);
+    }
+    retired_.set_current_value(static_cast<uint64_t>(state_.frame_number));
+    // lets VMA refresh its cached budget numbers once per frame
+    vmaSetCurrentFrameIndex(ctx_.allocator, static_cast<uint32_t>(state_.frame_number));
+    fr.frameDescriptors.clear_pools(ctx_.device);
+    fr.descriptorRing.reset();
+    fr.scratch.reset();
+    fr.arena.reset();
+}
+
+void VulkanEngine::begin_frame(uint32_t& imageIndex, VkCommandBuffer& cmd)
+{
+    FrameData& fr = current_frame();
+    wait_frame(fr);
 
     VkResult acq = vkAcquireNextImageKHR(ctx_.device, swapchain_.swapchain, 1000000000, fr.swapchainSemaphore, nullptr, &imageIndex);
     if (acq == VK_ERROR_OUT_OF_DATE_KHR)
@@ -373,16 +829,21 @@ void VulkanEngine::begin_frame(uint32_t& imageIndex, VkCommandBuffer& cmd)
     cmd = fr.mainCommandBuffer;
     VkCommandBufferBeginInfo bi = vkinit::command_buffer_begin_info(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
     VK_CHECK(vkBeginCommandBuffer(cmd, &bi));
+    fr.timer.reset(cmd);
 }
 
-void VulkanEngine::end_frame(uint32_t imageIndex, VkCommandBuffer cmd)
+void VulkanEngine::end_frame(uint32_t imageIndex, VkCommandBuffer cmd, bool directPresent)
 {
     VK_CHECK(vkEndCommandBuffer(cmd));
 
-    FrameData& fr = frames_[state_.frame_number % FRAME_OVERLAP];
+    FrameData& fr = current_frame();
+    fr.scratch.flush();
 
     VkCommandBufferSubmitInfo cbsi = vkinit::command_buffer_submit_info(cmd);
-    VkSemaphoreSubmitInfo waitInfo = vkinit::semaphore_submit_info(VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR, fr.swapchainSemaphore);
+    // the swapchain image is first touched by the composite pass, by its blit, or by compute in direct-present mode
+    VkPipelineStageFlags2 acquireWait = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR | VK_PIPELINE_STAGE_2_TRANSFER_BIT;
+    if (directPresent) acquireWait |= VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+    VkSemaphoreSubmitInfo waitInfo = vkinit::semaphore_submit_info(acquireWait, fr.swapchainSemaphore);
     VkSemaphoreSubmitInfo signalInfo = vkinit::semaphore_submit_info(VK_PIPELINE_STAGE_2_ALL_GRAPHICS_BIT, fr.renderSemaphore);
     VkSubmitInfo2 si = vkinit::submit_info(&cbsi, &signalInfo, &waitInfo);
 
@@ -395,26 +856,54 @@ void VulkanEngine::end_frame(uint32_t imageIndex, VkCommandBuffer cmd)
     pi.waitSemaphoreCount = 1;
     pi.pImageIndices = &imageIndex;
 
+    // the whole image is still written every frame; the rectangles only tell the
+    // presentation engine which parts differ from the previously presented image
+    VkPresentRegionKHR region{};
+    VkPresentRegionsKHR regions{.sType = VK_STRUCTURE_TYPE_PRESENT_REGIONS_KHR};
+    if (ctx_.caps.incrementalPresent && !present_full_)
+    {
+        region.rectangleCount = static_cast<uint32_t>(present_rects_.size());
+        region.pRectangles = present_rects_.data();
+        regions.swapchainCount = 1;
+        regions.pRegions = &region;
+        pi.pNext = &regions;
+    }
+
     VK_CHECK(vkQueuePresentKHR(ctx_.graphics_queue, &pi));
 }
 
-void VulkanEngine::create_renderer()
+RenderContext VulkanEngine::make_render_context()
 {
-    if (!renderer_)
-    {
-        extern std::unique_ptr<IRenderer> CreateDefaultComputeRenderer();
-        renderer_ = CreateDefaultComputeRenderer();
-    }
+    // swapchainImage is per frame and filled in by run()
     RenderContext rctx{};
     rctx.device = ctx_.device;
     rctx.allocator = ctx_.allocator;
+    rctx.descriptorAllocator = &ctx_.descriptor_allocator;
+    rctx.frameDescriptors = &current_frame().frameDescriptors;
+    rctx.frameDescriptorBuffer = ctx_.caps.descriptorBuffer ? &current_frame().descriptorRing : nullptr;
+    rctx.frameScratch = &current_frame().scratch;
+    rctx.retired = &retired_;
+    rctx.frameArena = &current_frame().arena;
+    rctx.bindless = &ctx_.bindless;
+    rctx.primitives = &primitives_;
+    rctx.immediate = &immediate_;
+    rctx.graphics_queue = ctx_.graphics_queue;
+    rctx.graphics_queue_family = ctx_.graphics_queue_family;
+    rctx.caps = ctx_.caps;
+    rctx.framesInFlight = FRAME_OVERLAP;
     rctx.frameExtent = swapchain_.swapchain_extent;
     rctx.swapchainFormat = swapchain_.swapchain_image_format;
     rctx.offscreenImage = swapchain_.drawable_image.image;
     rctx.offscreenImageView = swapchain_.drawable_image.imageView;
-    rctx.descriptorAllocator = &ctx_.descriptor_allocator;
-    rctx.graphics_queue = ctx_.graphics_queue;
-    rctx.graphics_queue_family = ctx_.graphics_queue_family;
+    rctx.offscreenStorageIndex = swapchain_.drawable_storage_index;
+    rctx.offscreenFormat = swapchain_.drawable_image.imageFormat;
+    rctx.transients = &transients_;
+    return rctx;
+}
+
+void VulkanEngine::create_renderer()
+{
+    RenderContext rctx = make_render_context();
     renderer_->initialize(rctx);
 
     mdq_.push_function([&]()
@@ -426,19 +915,29 @@ void VulkanEngine::create_renderer()
 void VulkanEngine::destroy_renderer()
 {
     IF_NOT_NULL_DO_AND_SET(renderer_, {
-                           RenderContext rctx{};
-                           rctx.device = ctx_.device;
-                           rctx.allocator = ctx_.allocator;
-                           rctx.frameExtent = swapchain_.swapchain_extent;
-                           rctx.swapchainFormat = swapchain_.swapchain_image_format;
-                           rctx.offscreenImage = swapchain_.drawable_image.image;
-                           rctx.offscreenImageView = swapchain_.drawable_image.imageView;
-                           rctx.descriptorAllocator = &ctx_.descriptor_allocator;
+                           RenderContext rctx = make_render_context();
                            renderer_->destroy(rctx);
                            renderer_.reset();
                            }, nullptr);
 }
 
+void VulkanEngine::switch_renderer(const RendererInfo& info)
+{
+    vkDeviceWaitIdle(ctx_.device);
+    IF_NOT_NULL_DO(renderer_, renderer_->destroy(make_render_context()));
+    renderer_ = info.create();
+    renderer_name_ = info.name;
+
+    const VkFormat format = pick_offscreen_format();
+    if (format != swapchain_.drawable_image.imageFormat)
+    {
+        const VkExtent3D extent = swapchain_.drawable_image.imageExtent;
+        destroy_offscreen_drawable();
+        create_offscreen_drawable(extent.width, extent.height, format);
+    }
+    renderer_->initialize(make_render_context());
+}
+
 void VulkanEngine::create_imgui()
 {
     ui_ = std::make_unique<ImGuiLayer>();
@@ -484,6 +983,669 @@ void VulkanEngine::create_imgui()
 
         ImGui::End();
     });
+
+    ui_->add_panel([this]() { draw_bench_panel(); });
+}
+
+void VulkanEngine::draw_bench_panel()
+{
+    ImGui::Begin("Benchmarks");
+
+    if (ImGui::CollapsingHeader("Bindless heap", ImGuiTreeNodeFlags_DefaultOpen))
+    {
+        ImGui::Text("Live handles: img %u  tex %u  smp %u  buf %u",
+                    ctx_.bindless.live_count(BindlessHeap::StorageImage),
+                    ctx_.bindless.live_count(BindlessHeap::SampledImage),
+                    ctx_.bindless.live_count(BindlessHeap::Sampler),
+                    ctx_.bindless.live_count(BindlessHeap::StorageBuffer));
+
+        static int draws = 4096;
+        static bench::DescriptorBindingResult result{};
+        ImGui::SliderInt("Draws", &draws, 256, 65536);
+        if (ImGui::Button("Per-draw sets vs bindless"))
+        {
+            pending_bench_ = [this]() { result = bench::descriptor_binding(make_render_context(), static_cast<uint32_t>(draws)); };
+        }
+        if (result.draws > 0)
+        {
+            ImGui::Text("%u draws", result.draws);
+            ImGui::Text("Per-draw sets: record %.3f ms, submit %.3f ms", result.setsRecordMs, result.setsSubmitMs);
+            ImGui::Text("Bindless     : record %.3f ms, submit %.3f ms", result.bindlessRecordMs, result.bindlessSubmitMs);
+        }
+    }
+
+    if (ImGui::CollapsingHeader("Descriptor updates", ImGuiTreeNodeFlags_DefaultOpen))
+    {
+        static bench::DescriptorUpdateResult small{}, large{};
+        if (ImGui::Button("Writer vs update template (1k / 10k)"))
+        {
+            pending_bench_ = [this]()
+            {
+                small = bench::descriptor_updates(make_render_context(), 1000);
+                large = bench::descriptor_updates(make_render_context(), 10000);
+            };
+        }
+        for (const auto* res : {&small, &large})
+        {
+            if (res->updates == 0) continue;
+            ImGui::Text("%5u updates: writer %.3f ms, template %.3f ms", res->updates, res->writerMs, res->templateMs);
+        }
+    }
+
+    if (ImGui::CollapsingHeader("Descriptor backends", ImGuiTreeNodeFlags_DefaultOpen))
+    {
+        ImGui::Text("push_descriptor: %s   descriptor_buffer: %s",
+                    ctx_.caps.pushDescriptor ? "yes" : "no", ctx_.caps.descriptorBuffer ? "yes" : "no");
+        if (ctx_.caps.descriptorBuffer)
+        {
+            const DescriptorBufferRing& ring = current_frame().descriptorRing;
+            ImGui::Text("Frame ring: %.1f / %.1f KiB (peak %.1f KiB)",
+                        ring.used() / 1024.0, ring.capacity() / 1024.0, ring.high_water() / 1024.0);
+        }
+
+        static int changes = 10000;
+        static bench::DescriptorBackendResult result{};
+        ImGui::SliderInt("Changes", &changes, 1000, 100000);
+        if (ImGui::Button("Pool vs push vs buffer"))
+        {
+            pending_bench_ = [this]() { result = bench::descriptor_backends(make_render_context(), static_cast<uint32_t>(changes)); };
+        }
+        if (result.changes > 0)
+        {
+            auto show = [](const char* name, double ms)
+            {
+                if (ms < 0.0) ImGui::Text("%-7s: unsupported", name);
+                else ImGui::Text("%-7s: %.3f ms", name, ms);
+            };
+            ImGui::Text("%u descriptor changes, CPU record", result.changes);
+            show("Pool", result.poolMs);
+            show("Push", result.pushMs);
+            show("Buffer", result.bufferMs);
+        }
+    }
+
+    if (ImGui::CollapsingHeader("Deletion queue", ImGuiTreeNodeFlags_DefaultOpen))
+    {
+        ImGui::Text("Retired, waiting for GPU: %zu", retired_.pending());
+
+        static bench::DeletionQueueResult result{};
+        if (ImGui::Button("std::function vs typed (10k)"))
+        {
+            pending_bench_ = [this]() { result = bench::deletion_queue(make_render_context(), 10000); };
+        }
+        if (result.entries > 0)
+        {
+            ImGui::Text("%u entries: closures push %.3f / flush %.3f ms", result.entries, result.closurePushMs, result.closureFlushMs);
+            ImGui::Text("%*s  typed    push %.3f / flush %.3f ms", 8, "", result.typedPushMs, result.typedFlushMs);
+        }
+    }
+
+    if (ImGui::CollapsingHeader("Compute primitives", ImGuiTreeNodeFlags_DefaultOpen))
+    {
+        ImGui::Text("Subgroups: %s (size %u), kernels: %s", ctx_.caps.subgroupArithmetic ? "arithmetic + ballot" : "no arithmetic",
+                    ctx_.caps.subgroupSize, primitives_.uses_subgroups() ? "subgroup" : "shared memory");
+
+        static int count = 1 << 24;
+        static bench::ComputePrimitivesResult result{};
+        ImGui::SliderInt("Elements", &count, 1 << 16, 1 << 26, "%d", ImGuiSliderFlags_Logarithmic);
+        if (ImGui::Button("GPU vs CPU reference"))
+        {
+            pending_bench_ = [this]() { result = bench::compute_primitives(make_render_context(), static_cast<uint32_t>(count)); };
+        }
+        if (result.count > 0)
+        {
+            ImGui::Text("%u elements, %s kernels", result.count, result.subgroups ? "subgroup" : "shared memory");
+            for (const auto& op : result.ops)
+            {
+                ImGui::TextColored(op.match ? ImVec4(0.4f, 1.0f, 0.4f, 1.0f) : ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "%-15s GPU %.3f ms  CPU %.3f ms  %s",
+                                   op.name, op.gpuMs, op.cpuMs, op.match ? "ok" : "MISMATCH");
+                ImGui::TextDisabled("  %s", op.detail.c_str());
+            }
+        }
+    }
+
+    if (ImGui::CollapsingHeader("Radix sort"))
+    {
+        static int maxCount = 1 << 24;
+        static bench::RadixSortResult result{};
+        ImGui::SliderInt("Max keys", &maxCount, 1 << 20, 1 << 26, "%d", ImGuiSliderFlags_Logarithmic);
+        if (ImGui::Button("Sort 1M..max keys (x4 steps)"))
+        {
+            pending_bench_ = [this]() { result = bench::radix_sort(make_render_context(), static_cast<uint32_t>(maxCount)); };
+        }
+        if (!result.sizes.empty()) ImGui::Text("32-bit keys + values, %s kernels", result.subgroups ? "subgroup" : "shared memory");
+        for (const auto& s : result.sizes)
+        {
+            if (!s.error.empty())
+            {
+                ImGui::TextColored(ImVec4(1.0f, 0.8f, 0.3f, 1.0f), "%9u keys  %s", s.count, s.error.c_str());
+                continue;
+            }
+            const double mkeys = s.gpuMs > 0.0 ? s.count / (s.gpuMs * 1e3) : 0.0;
+            if (!s.verified)
+                ImGui::Text("%9u keys  GPU %.3f ms (%.0f Mkeys/s)  not verified", s.count, s.gpuMs, mkeys);
+            else
+                ImGui::TextColored(s.match ? ImVec4(0.4f, 1.0f, 0.4f, 1.0f) : ImVec4(1.0f, 0.4f, 0.4f, 1.0f),
+                                   "%9u keys  GPU %.3f ms (%.0f Mkeys/s)  std::sort %.3f ms  %s", s.count, s.gpuMs, mkeys, s.cpuMs,
+                                   s.match ? "ok" : "MISMATCH");
+        }
+    }
+
+    if (ImGui::CollapsingHeader("Frame memory", ImGuiTreeNodeFlags_DefaultOpen))
+    {
+        if constexpr (alloc_counter::Enabled)
+        {
+            const bool clean = state_.frame_allocations == 0;
+            ImGui::TextColored(clean ? ImVec4(0.4f, 1.0f, 0.4f, 1.0f) : ImVec4(1.0f, 0.8f, 0.3f, 1.0f),
+                               "operator new last frame: %llu", static_cast<unsigned long long>(state_.frame_allocations));
+        }
+        else
+        {
+            ImGui::TextDisabled("operator new counter off (configure with -DLEARNVULKAN_ALLOC_COUNTER=ON)");
+        }
+        for (uint32_t i = 0; i < FRAME_OVERLAP; i++)
+        {
+            const FrameArena& a = frames_[i].arena;
+            ImGui::Text("Arena %u: %.1f KiB used, peak %.1f / %.1f KiB, %zu blocks", i, a.used() / 1024.0, a.peak() / 1024.0, a.capacity() / 1024.0, a.block_count());
+        }
+        for (uint32_t i = 0; i < FRAME_OVERLAP; i++)
+        {
+            const ScratchAllocator& sc = frames_[i].scratch;
+            ImGui::Text("Frame %u: %zu blocks, %.1f / %.1f KiB", i, sc.block_count(), sc.used() / 1024.0, sc.capacity() / 1024.0);
+        }
+    }
+
+    if (ImGui::CollapsingHeader("GPU memory", ImGuiTreeNodeFlags_DefaultOpen))
+    {
+        ImGui::Text("VK_EXT_memory_budget: %s", ctx_.caps.memoryBudget ? "yes" : "no (estimated)");
+        // heap budgets are cheap; the per-tag totals walk the allocation registry and are refreshed on demand
+        gpu_memory::HeapInfo heaps[VK_MAX_MEMORY_HEAPS]{};
+        const uint32_t heapCount = gpu_memory::heaps(ctx_.allocator, heaps);
+        for (uint32_t i = 0; i < heapCount; i++)
+        {
+            const gpu_memory::HeapInfo& b = heaps[i];
+            const float frac = b.budget > 0 ? static_cast<float>(static_cast<double>(b.usage) / static_cast<double>(b.budget)) : 0.0f;
+            char overlay[96];
+            std::snprintf(overlay, sizeof(overlay), "%.1f / %.1f MiB", b.usage / 1048576.0, b.budget / 1048576.0);
+            ImGui::Text("Heap %u %s", i, b.deviceLocal ? "(device)" : "(host)");
+            ImGui::SameLine();
+            ImGui::PushStyleColor(ImGuiCol_PlotHistogram, frac > 0.9f ? ImVec4(1.0f, 0.3f, 0.3f, 1.0f) : ImVec4(0.3f, 0.7f, 1.0f, 1.0f));
+            ImGui::ProgressBar(frac, ImVec2(-1.0f, 0.0f), overlay);
+            ImGui::PopStyleColor();
+            ImGui::Text("  VMA: %.1f MiB in blocks, %.1f MiB in %u allocations", b.blockBytes / 1048576.0,
+                        b.allocationBytes / 1048576.0, b.allocationCount);
+        }
+
+        static bool byOwner = true;
+        static bool autoRefresh = false;
+        static std::vector<gpu_memory::TagTotal> totals;
+        bool refresh = ImGui::Button("Refresh allocations");
+        ImGui::SameLine();
+        refresh |= ImGui::Checkbox("By owner", &byOwner);
+        ImGui::SameLine();
+        ImGui::Checkbox("Auto (allocates)", &autoRefresh);
+        if (refresh || (autoRefresh && state_.frame_number % 60 == 0))
+        {
+            totals = gpu_memory::live_by_tag(ctx_.allocator, byOwner);
+        }
+        for (const auto& t : totals)
+        {
+            ImGui::Text("%-28s %8.2f MiB  x%u", t.tag.c_str(), t.bytes / 1048576.0, t.count);
+        }
+    }
+
+    if (ImGui::CollapsingHeader("Offscreen format", ImGuiTreeNodeFlags_DefaultOpen))
+    {
+        extern std::span<const RendererInfo> ExampleRenderers();
+        // renderer-defined sweep steps point at the current renderer
+        ImGui::BeginDisabled(timing_sweep_.active);
+        if (ImGui::BeginCombo("Renderer", renderer_name_.c_str()))
+        {
+            for (const RendererInfo& info : ExampleRenderers())
+            {
+                if (ImGui::Selectable(info.name, renderer_name_ == info.name))
+                    pending_bench_ = [this, &info]() { switch_renderer(info); };
+            }
+            ImGui::EndCombo();
+        }
+        ImGui::EndDisabled();
+
+        const VkFormat current = swapchain_.drawable_image.imageFormat;
+        const char* preview = offscreen_format_override_ == VK_FORMAT_UNDEFINED ? "renderer preference" : string_VkFormat(offscreen_format_override_);
+        if (ImGui::BeginCombo("Format", preview))
+        {
+            if (ImGui::Selectable("renderer preference", offscreen_format_override_ == VK_FORMAT_UNDEFINED))
+                pending_bench_ = [this]() { apply_offscreen_format(VK_FORMAT_UNDEFINED); };
+            for (VkFormat f : OffscreenFormats)
+            {
+                const bool supported = offscreen_format_supported(f);
+                if (ImGui::Selectable(string_VkFormat(f), offscreen_format_override_ == f, supported ? 0 : ImGuiSelectableFlags_Disabled))
+                    pending_bench_ = [this, f]() { apply_offscreen_format(f); };
+            }
+            ImGui::EndCombo();
+        }
+        ImGui::Text("In use: %s", string_VkFormat(current));
+        if (state_.renderer_gpu_ms >= 0.0)
+            ImGui::Text("Renderer GPU time: %.3f ms", state_.renderer_gpu_ms);
+        else
+            ImGui::TextUnformatted("Renderer GPU time: n/a (no timestamp support)");
+
+        if (!timing_sweep_.active && ImGui::Button("GPU time per format"))
+        {
+            std::vector<TimingStep> steps;
+            for (VkFormat f : OffscreenFormats)
+            {
+                if (offscreen_format_supported(f))
+                    steps.push_back(TimingStep{string_VkFormat(f), [this, f]() { apply_offscreen_format(f); }});
+            }
+            start_timing_sweep(std::move(steps), [this, restore = offscreen_format_override_]() { apply_offscreen_format(restore); });
+        }
+    }
+
+    if (ImGui::CollapsingHeader("Direct present", ImGuiTreeNodeFlags_DefaultOpen))
+    {
+        if (!ctx_.caps.storageSwapchain)
+        {
+            ImGui::TextUnformatted("Swapchain images are not storage-capable here: the offscreen target is always composited");
+        }
+        else
+        {
+            ImGui::Checkbox("Write swapchain from compute (renderers that support it)", &state_.direct_present);
+            // What a renderer that supports it stops moving per frame: the blit reads the offscreen
+            // target and writes the swapchain image, and the compute pass writes the offscreen target
+            // instead of the swapchain image
+            const VkExtent2D e = swapchain_.swapchain_extent;
+            const double pixels = static_cast<double>(e.width) * e.height;
+            const double offscreenBpp = swapchain_.drawable_image.imageFormat == VK_FORMAT_R16G16B16A16_SFLOAT ? 8.0 : 4.0;
+            const double savedBytes = pixels * (offscreenBpp + 4.0) + pixels * (offscreenBpp - 4.0);
+            const double fps = 1.0 / std::max(ImGui::GetIO().DeltaTime, 1e-6f);
+            ImGui::Text("Blit traffic avoided: %.1f MiB/frame, %.2f GiB/s at %.0f fps", savedBytes / 1048576.0,
+                        savedBytes * fps / 1073741824.0, fps);
+            if (!timing_sweep_.active && ImGui::Button("GPU time blit vs direct"))
+            {
+                std::vector<TimingStep> steps;
+                steps.push_back(TimingStep{"blit via offscreen", [this]() { state_.direct_present = false; }});
+                steps.push_back(TimingStep{"direct present", [this]() { state_.direct_present = true; }});
+                start_timing_sweep(std::move(steps), [this, restore = state_.direct_present]() { state_.direct_present = restore; });
+            }
+        }
+    }
+
+    if (ImGui::CollapsingHeader("On-demand rendering", ImGuiTreeNodeFlags_DefaultOpen))
+    {
+        ImGui::Checkbox("Skip frames when nothing changed", &state_.on_demand);
+        // idle time expressed in display refresh slots that were not drawn
+        const SDL_DisplayMode* mode = SDL_GetCurrentDisplayMode(SDL_GetDisplayForWindow(ctx_.window));
+        const double hz = mode && mode->refresh_rate > 0.0f ? mode->refresh_rate : 60.0;
+        const double skipped = static_cast<double>(redraw_.idleNs) * 1e-9 * hz;
+        const double slots = skipped + static_cast<double>(redraw_.drawnFrames);
+        ImGui::Text("Drawn %llu frames, idle %.1f s", static_cast<unsigned long long>(redraw_.drawnFrames),
+                    static_cast<double>(redraw_.idleNs) * 1e-9);
+        ImGui::Text("Skipped: %.1f%% of %.0f Hz frame slots", slots > 0.0 ? 100.0 * skipped / slots : 0.0, hz);
+        ImGui::Text("UI-only frames (renderer not recorded): %.1f%%",
+                    redraw_.drawnFrames ? 100.0 * static_cast<double>(redraw_.rendererSkips) / static_cast<double>(redraw_.drawnFrames) : 0.0);
+        if (ImGui::Button("Reset counters"))
+        {
+            redraw_.drawnFrames = 0;
+            redraw_.rendererSkips = 0;
+            redraw_.idleNs = 0;
+        }
+    }
+
+    if (ImGui::CollapsingHeader("Damage tracking", ImGuiTreeNodeFlags_DefaultOpen))
+    {
+        ImGui::Checkbox("Shade dirty tiles only", &state_.damage_tracking);
+        ImGui::Text("Incremental present: %s", ctx_.caps.incrementalPresent ? "VK_KHR_incremental_present" : "not available");
+        ImGui::Text("Last renderer pass shaded %.2f%% of the frame (%u tiles of %ux%u)", state_.damage_coverage * 100.0,
+                    damage_.full() ? 0u : damage_.tile_count(), DamageRegion::TileSize, DamageRegion::TileSize);
+        ImGui::Text("Present regions: %s", present_full_ ? "whole image" : std::to_string(present_rects_.size()).c_str());
+        if (!timing_sweep_.active && ImGui::Button("GPU time full redraw vs dirty tiles"))
+        {
+            std::vector<TimingStep> steps;
+            steps.push_back(TimingStep{"full redraw", [this]() { state_.damage_tracking = false; }});
+            steps.push_back(TimingStep{"dirty tiles", [this]() { state_.damage_tracking = true; }});
+            start_timing_sweep(std::move(steps), [this, restore = state_.damage_tracking]() { state_.damage_tracking = restore; });
+        }
+    }
+
+    if (ImGui::CollapsingHeader("Composite", ImGuiTreeNodeFlags_DefaultOpen))
+    {
+        ImGui::Checkbox("Fused resolve + UI pass", &state_.fused_composite);
+        static const char* tonemaps[] = {"clamp", "Reinhard", "ACES fit"};
+        int tonemap = static_cast<int>(composite_.params.tonemap);
+        if (ImGui::Combo("Tonemap", &tonemap, tonemaps, IM_ARRAYSIZE(tonemaps)))
+            composite_.params.tonemap = static_cast<uint32_t>(tonemap);
+        ImGui::SliderFloat("Exposure", &composite_.params.exposure, 0.1f, 8.0f, "%.2f", ImGuiSliderFlags_Logarithmic);
+        if (!state_.fused_composite) ImGui::TextUnformatted("(the blit path ignores tonemap and exposure)");
+        if (state_.composite_gpu_ms >= 0.0)
+            ImGui::Text("Composite GPU time: %.3f ms, frame %.3f ms", state_.composite_gpu_ms, state_.frame_gpu_ms);
+        if (!timing_sweep_.active && ImGui::Button("GPU time blit + overlay vs fused"))
+        {
+            std::vector<TimingStep> steps;
+            steps.push_back(TimingStep{"blit + overlay pass", [this]() { state_.fused_composite = false; }});
+            steps.push_back(TimingStep{"fused composite", [this]() { state_.fused_composite = true; }});
+            start_timing_sweep(std::move(steps), [this, restore = state_.fused_composite]() { state_.fused_composite = restore; });
+        }
+    }
+
+    if (ImGui::CollapsingHeader("GPU timings", ImGuiTreeNodeFlags_DefaultOpen))
+    {
+        // renderer-defined variants (e.g. compute vs raster bar chart)
+        const char* rendererSweep = renderer_->timing_sweep_label();
+        if (rendererSweep && !timing_sweep_.active && ImGui::Button(rendererSweep))
+        {
+            RendererSweep rs = renderer_->make_timing_sweep();
+            std::vector<TimingStep> steps;
+            for (RendererSweep::Step& st : rs.steps) steps.push_back(TimingStep{std::move(st.label), std::move(st.apply)});
+            start_timing_sweep(std::move(steps), std::move(rs.restore), std::move(rs.report));
+        }
+        if (timing_sweep_.active)
+        {
+            ImGui::Text("Timing %s: %u / %u frames", timing_sweep_.steps[timing_sweep_.index].label.c_str(),
+                        timing_sweep_.frames, SweepWarmupFrames + SweepFrames);
+        }
+        if (!gpu_timings_.empty())
+        {
+            if (ImGui::BeginTable("gpu_timings", 3, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+            {
+                ImGui::TableSetupColumn("Renderer");
+                ImGui::TableSetupColumn("Variant");
+                ImGui::TableSetupColumn("Frame GPU ms");
+                ImGui::TableHeadersRow();
+                for (const GpuTiming& t : gpu_timings_)
+                {
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn();
+                    ImGui::TextUnformatted(t.renderer.c_str());
+                    ImGui::TableNextColumn();
+                    ImGui::TextUnformatted(t.variant.c_str());
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%.3f", t.gpuMs);
+                }
+                ImGui::EndTable();
+            }
+            if (ImGui::Button("Clear timings")) gpu_timings_.clear();
+        }
+    }
+
+    if (ImGui::CollapsingHeader("Transient attachments", ImGuiTreeNodeFlags_DefaultOpen))
+    {
+        const TransientPool::Plan live = transients_.plan();
+        ImGui::Text("Live: %u images in %u slots, %.1f MiB (%.1f MiB without aliasing)", live.images, live.slots,
+                    live.allocatedBytes / 1048576.0, live.requestedBytes / 1048576.0);
+
+        // What each example needs at 4K now that depth and intermediates are on request,
+        // against the fixed R16G16B16A16 color + D32 depth pair the engine used to allocate
+        static std::string report;
+        if (ImGui::Button("4K report"))
+        {
+            extern std::span<const RendererInfo> ExampleRenderers();
+            const VkExtent2D uhd{3840, 2160};
+            const TransientDesc fixed[] = {
+                {"offscreen", VK_FORMAT_R16G16B16A16_SFLOAT,
+                 VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT,
+                 VK_IMAGE_ASPECT_COLOR_BIT, {}, 0, 0},
+                {"depth", VK_FORMAT_D32_SFLOAT, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, VK_IMAGE_ASPECT_DEPTH_BIT, {}, 0, 0},
+            };
+            const VkDeviceSize before = TransientPool::estimate(ctx_.device, fixed, 2, uhd).requestedBytes;
+
+            RenderContext rctx = make_render_context();
+            rctx.frameExtent = uhd;
+            report.clear();
+            for (const RendererInfo& info : ExampleRenderers())
+            {
+                const std::unique_ptr<IRenderer> r = info.create();
+                // the offscreen target now comes in the renderer's preferred format
+                TransientDesc color = fixed[0];
+                color.format = r->preferred_offscreen_format();
+                if (!offscreen_format_supported(color.format)) color.format = VK_FORMAT_R16G16B16A16_SFLOAT;
+                const VkDeviceSize colorBytes = TransientPool::estimate(ctx_.device, &color, 1, uhd).requestedBytes;
+
+                // intermediates may follow the offscreen format, so declare against the example's own
+                rctx.offscreenFormat = color.format;
+                TransientPool probe;
+                probe.begin(uhd);
+                r->declare_attachments(probe, rctx);
+                const TransientPool::Plan p = TransientPool::estimate(ctx_.device, probe.requested().data(), probe.requested().size(), uhd);
+                const VkDeviceSize after = colorBytes + p.allocatedBytes;
+                char line[160];
+                std::snprintf(line, sizeof(line), "%-14s %6.1f -> %6.1f MiB (saved %.1f, %u attachments, %.1f aliased away)\n",
+                              info.name, before / 1048576.0, after / 1048576.0, (static_cast<double>(before) - static_cast<double>(after)) / 1048576.0,
+                              p.images, (p.requestedBytes - p.allocatedBytes) / 1048576.0);
+                report += line;
+            }
+        }
+        if (!report.empty()) ImGui::TextUnformatted(report.c_str());
+
+        // fixed request lists with known lifetimes through the slot assignment and compile()
+        static bench::TransientAliasingResult check{};
+        if (ImGui::Button("Check slot assignment"))
+        {
+            check = bench::transient_aliasing(make_render_context());
+        }
+        for (const auto& c : check.cases)
+        {
+            ImGui::TextColored(c.match ? ImVec4(0.4f, 1.0f, 0.4f, 1.0f) : ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "%-12s %s", c.name, c.match ? "ok" : "MISMATCH");
+            ImGui::TextDisabled("  %s", c.detail.c_str());
+        }
+    }
+
+    if (ImGui::CollapsingHeader("Descriptor allocators", ImGuiTreeNodeFlags_DefaultOpen))
+    {
+        ImGui::Text("Long-lived: %zu pools, %u sets", ctx_.descriptor_allocator.pool_count(), ctx_.descriptor_allocator.allocated_sets());
+        for (uint32_t i = 0; i < FRAME_OVERLAP; i++)
+        {
+            ImGui::Text("Frame %u   : %zu pools, %u sets", i, frames_[i].frameDescriptors.pool_count(), frames_[i].frameDescriptors.allocated_sets());
+        }
+
+        static int iterations = 2000;
+        static std::string report;
+        static bool passed = true;
+        ImGui::SliderInt("Resizes", &iterations, 100, 10000);
+        if (ImGui::Button("Resize soak"))
+        {
+            pending_bench_ = [this]() { passed = soak_resize(static_cast<uint32_t>(iterations), report); };
+        }
+        if (!report.empty())
+        {
+            ImGui::TextColored(passed ? ImVec4(0.4f, 1.0f, 0.4f, 1.0f) : ImVec4(1.0f, 0.3f, 0.3f, 1.0f), "%s", report.c_str());
+        }
+    }
+
+    ImGui::End();
+}
+
+bool VulkanEngine::soak_resize(uint32_t iterations, std::string& report)
+{
+    // Resize back and forth, drawing a full frame after every resize, and check that descriptor
+    // pools / sets and GPU memory do not grow. The first resize is a warm-up so lazily created
+    // sets are not counted as a leak.
+    int w0 = 0, h0 = 0;
+    SDL_GetWindowSize(ctx_.window, &w0, &h0);
+
+    struct Snapshot
+    {
+        size_t pools{};
+        uint64_t sets{};
+        // per frame in flight: pools, sets of the last frame recorded with it
+        std::array<std::pair<size_t, uint32_t>, FRAME_OVERLAP> frames{};
+        size_t deleters{}; // main deletion queue entries
+        std::map<std::string, std::pair<VkDeviceSize, uint32_t>> gpu; // tag -> bytes, count
+        VkDeviceSize gpuBytes{};
+        uint32_t gpuCount{};
+    };
+    auto snapshot = [this]()
+    {
+        Snapshot s;
+        s.pools = ctx_.descriptor_allocator.pool_count();
+        s.sets = ctx_.descriptor_allocator.allocated_sets();
+        s.deleters = mdq_.deleters.size();
+        for (uint32_t i = 0; i < FRAME_OVERLAP; i++)
+        {
+            s.frames[i] = {frames_[i].frameDescriptors.pool_count(), frames_[i].frameDescriptors.allocated_sets()};
+        }
+        for (const gpu_memory::TagTotal& t : gpu_memory::live_by_tag(ctx_.allocator, false))
+        {
+            s.gpu[t.tag] = {t.bytes, t.count};
+            s.gpuBytes += t.bytes;
+            s.gpuCount += t.count;
+        }
+        return s;
+    };
+
+    // SDL_SetWindowSize is asynchronous: wait until the window manager applied the size and
+    // the resize events arrived, then rebuild. The main loop never sees these events.
+    auto resize_to = [this](int w, int h)
+    {
+        SDL_SetWindowSize(ctx_.window, w, h);
+        SDL_SyncWindow(ctx_.window);
+        const uint64_t deadline = SDL_GetTicks() + 1000;
+        bool applied = false;
+        while (!applied && SDL_GetTicks() < deadline)
+        {
+            SDL_PumpEvents();
+            int cw = 0, ch = 0;
+            SDL_GetWindowSize(ctx_.window, &cw, &ch);
+            applied = cw == w && ch == h;
+            if (!applied) SDL_Delay(1);
+        }
+        SDL_FlushEvents(SDL_EVENT_WINDOW_RESIZED, SDL_EVENT_WINDOW_PIXEL_SIZE_CHANGED);
+        recreate_swapchain();
+        return applied;
+    };
+
+    // a frame through the normal path: per-frame descriptor reset, scratch, renderer record with
+    // the new extent, composite and present. An out-of-date swapchain gets one rebuild and retry.
+    auto draw = [this]()
+    {
+        if (draw_frame(true)) return true;
+        recreate_swapchain();
+        return draw_frame(true);
+    };
+    // every frame in flight recorded once at the current size, then idle, so snapshots compare
+    // the same state of each per-frame allocator
+    auto settle = [&]()
+    {
+        bool drawn = true;
+        for (uint32_t i = 0; i < FRAME_OVERLAP; i++) drawn = draw() && drawn;
+        vkDeviceWaitIdle(ctx_.device);
+        return drawn;
+    };
+
+    recreate_swapchain();
+    settle();
+    const Snapshot before = snapshot();
+    uint32_t applied = 0, drawn = 0;
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        const int dw = (i & 1) ? 0 : 64;
+        if (resize_to(std::max(64, w0 - dw), std::max(64, h0 - dw))) applied++;
+        if (draw()) drawn++;
+    }
+    resize_to(w0, h0);
+    const bool settled = settle();
+    const Snapshot after = snapshot();
+    invalidate_frame();
+
+    // a window manager that ignores resizes would let the soak pass without testing anything
+    const bool exercised = applied == iterations && drawn == iterations && settled;
+    const bool ok = exercised && before.pools == after.pools && before.sets == after.sets && before.frames == after.frames
+                    && before.deleters == after.deleters && before.gpu == after.gpu;
+    size_t framePools[2] = {}, frameSets[2] = {};
+    for (uint32_t i = 0; i < FRAME_OVERLAP; i++)
+    {
+        framePools[0] += before.frames[i].first;
+        framePools[1] += after.frames[i].first;
+        frameSets[0] += before.frames[i].second;
+        frameSets[1] += after.frames[i].second;
+    }
+    char buf[384];
+    snprintf(buf, sizeof(buf), "%s: %u/%u resizes applied, %u frames drawn, pools %zu -> %zu, sets %llu -> %llu, "
+             "per-frame pools %zu -> %zu, sets %zu -> %zu, GPU %u allocs %.2f MiB -> %u allocs %.2f MiB",
+             ok ? "PASS" : "FAIL", applied, iterations, drawn, before.pools, after.pools,
+             static_cast<unsigned long long>(before.sets), static_cast<unsigned long long>(after.sets),
+             framePools[0], framePools[1], frameSets[0], frameSets[1],
+             before.gpuCount, before.gpuBytes / 1048576.0, after.gpuCount, after.gpuBytes / 1048576.0);
+    report = buf;
+    if (!ok)
+    {
+        fprintf(stderr, "[soak] %s\n", report.c_str());
+        if (applied != iterations) fprintf(stderr, "[soak] the window manager did not apply every resize\n");
+        if (drawn != iterations || !settled) fprintf(stderr, "[soak] some frames could not be drawn\n");
+        for (uint32_t i = 0; i < FRAME_OVERLAP; i++)
+        {
+            if (before.frames[i] != after.frames[i])
+                fprintf(stderr, "[soak]   frame %u descriptors: %zu pools %u sets -> %zu pools %u sets\n", i,
+                        before.frames[i].first, before.frames[i].second, after.frames[i].first, after.frames[i].second);
+        }
+        if (before.deleters != after.deleters)
+            fprintf(stderr, "[soak]   main deletion queue: %zu -> %zu entries\n", before.deleters, after.deleters);
+        for (const auto& [tag, a] : after.gpu)
+        {
+            const auto it = before.gpu.find(tag);
+            const std::pair<VkDeviceSize, uint32_t> b = it == before.gpu.end() ? std::pair<VkDeviceSize, uint32_t>{} : it->second;
+            if (a != b)
+                fprintf(stderr, "[soak]   %-28s %llu bytes x%u -> %llu bytes x%u\n", tag.c_str(), static_cast<unsigned long long>(b.first), b.second,
+                        static_cast<unsigned long long>(a.first), a.second);
+        }
+        for (const auto& [tag, b] : before.gpu)
+        {
+            if (!after.gpu.contains(tag))
+                fprintf(stderr, "[soak]   %-28s %llu bytes x%u -> freed\n", tag.c_str(), static_cast<unsigned long long>(b.first), b.second);
+        }
+    }
+    return ok;
+}
+
+void VulkanEngine::start_timing_sweep(std::vector<TimingStep> steps, std::function<void()> restore,
+                                      std::function<void(const std::vector<double>&)> report)
+{
+    if (steps.empty()) return;
+    timing_sweep_.active = true;
+    timing_sweep_.index = 0;
+    timing_sweep_.frames = 0;
+    timing_sweep_.samples = 0;
+    timing_sweep_.sum = 0.0;
+    timing_sweep_.steps = std::move(steps);
+    timing_sweep_.restore = std::move(restore);
+    timing_sweep_.results.clear();
+    timing_sweep_.report = std::move(report);
+    pending_bench_ = timing_sweep_.steps.front().apply;
+}
+
+void VulkanEngine::step_timing_sweep()
+{
+    // Frames keep presenting normally; the first few after a switch still resolve
+    // timestamps recorded with the previous variant and are skipped.
+    auto& s = timing_sweep_;
+    if (!s.active || pending_bench_) return;
+
+    s.frames++;
+    if (s.frames > SweepWarmupFrames && state_.frame_gpu_ms >= 0.0)
+    {
+        s.sum += state_.frame_gpu_ms;
+        s.samples++;
+    }
+    if (s.frames < SweepWarmupFrames + SweepFrames) return;
+
+    const double avg = s.samples ? s.sum / s.samples : -1.0;
+    gpu_timings_.push_back(GpuTiming{renderer_name_, s.steps[s.index].label, avg});
+    s.results.push_back(avg);
+    s.frames = 0;
+    s.samples = 0;
+    s.sum = 0.0;
+    if (++s.index < s.steps.size())
+    {
+        pending_bench_ = s.steps[s.index].apply;
+    }
+    else
+    {
+        s.active = false;
+        if (s.report) s.report(s.results);
+        s.report = nullptr;
+        pending_bench_ = std::move(s.restore);
+        s.steps.clear();
+    }
 }
 
 void VulkanEngine::destroy_imgui()
@@ -7,14 +7,26 @@
 
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 #include <functional>
 
 #include "ext/vk_descriptors.h"
+#include "ext/vk_bindless.h"
+#include "ext/vk_descriptor_buffer.h"
+#include "ext/vk_scratch.h"
+#include "ext/vk_deletion.h"
+#include "ext/vk_transient.h"
+#include "ext/vk_gpu_timer.h"
+#include "ext/vk_compute_primitives.h"
+#include "ext/vk_immediate.h"
 #include "vk_mem_alloc.h"
 
 #include "renderer_iface.h"
 #include "imgui_layer.h"
+#include "composite_pass.h"
+#include "damage_region.h"
+#include "frame_arena.h"
 
 struct DeletionQueue
 {
@@ -31,13 +43,27 @@ struct DeletionQueue
 
 constexpr unsigned int FRAME_OVERLAP = 2;
 
+// Command-line configuration (main.cpp): which example renderer to start, renderer options
+// applied before initialize(), and the frame count of a headless benchmark run
+struct LaunchOptions
+{
+    std::string renderer;                                         // ExampleRenderers() name, empty = default
+    std::vector<std::pair<std::string, std::string>> settings;    // IRenderer::set_option(key, value)
+    uint32_t benchFrames{0};                                      // > 0: hidden window, use run_benchmark()
+};
+
 class VulkanEngine
 {
 public: // Main Functions
-    void init();
+    void init(const LaunchOptions& options = {});
     void run();
+    // Headless loop for LaunchOptions::benchFrames: renderer only, no acquire/composite/present.
+    // Prints CPU and GPU frame time statistics to stdout; returns the process exit code.
+    int run_benchmark();
     void cleanup();
     void set_renderer(std::unique_ptr<IRenderer> r) { renderer_ = std::move(r); }
+    // Wake an idle on-demand loop and redraw the renderer output; safe to call from any thread
+    void request_redraw();
 
 public: // Engine State
     struct
@@ -50,6 +76,23 @@ public: // Engine State
         bool should_rendering{false};
         int frame_number{0};
         bool resize_requested{false};
+        // global operator new calls during the last frame (see alloc_counter.h)
+        uint64_t frame_allocations{0};
+        uint64_t alloc_total_at_frame_start{0};
+        // GPU times of the last resolved frame, negative when unknown
+        double renderer_gpu_ms{-1.0};  // renderer_->record()
+        double composite_gpu_ms{-1.0}; // offscreen resolve + UI
+        double frame_gpu_ms{-1.0};     // both
+        // resolve + UI in one render pass (CompositePass::record) instead of blit + overlay pass
+        bool fused_composite{true};
+        // only record/submit frames when the renderer, the UI or the window changed
+        bool on_demand{true};
+        // shade only the offscreen tiles renderers report as changed (IRenderer::report_damage)
+        bool damage_tracking{true};
+        // share of the frame the renderer's tile dispatch covered in the last recorded frame
+        double damage_coverage{1.0};
+        // let renderers write swapchain images from compute when caps.storageSwapchain
+        bool direct_present{true};
     } state_;
 
 public: // Constructors and Operators
@@ -61,7 +104,7 @@ public: // Constructors and Operators
     VulkanEngine& operator=(VulkanEngine&&) noexcept = default;
 
 private: // Engine Context
-    void create_context(int window_width, int window_height, const char* app_name);
+    void create_context(int window_width, int window_height, const char* app_name, bool hidden);
     void destroy_context();
 
     struct EngineContext
@@ -75,15 +118,24 @@ private: // Engine Context
         VkQueue graphics_queue{};
         uint32_t graphics_queue_family{};
         VmaAllocator allocator{};
-        DescriptorAllocator descriptor_allocator;
+        DescriptorAllocatorGrowable descriptor_allocator;
+        BindlessHeap bindless;
+        DeviceCaps caps;
+        DescriptorBufferApi descriptor_buffer;
     } ctx_;
 
 private: // Swapchain and Offscreen Drawable
     void create_swapchain(uint32_t width, uint32_t height);
     void destroy_swapchain();
     void recreate_swapchain();
-    void create_offscreen_drawable(uint32_t width, uint32_t height);
+    void create_offscreen_drawable(uint32_t width, uint32_t height, VkFormat format);
     void destroy_offscreen_drawable();
+    bool offscreen_format_supported(VkFormat format) const;
+    VkFormat pick_offscreen_format() const;
+    // Recreate the offscreen target in a new format and re-initialise the renderer (device idle)
+    void apply_offscreen_format(VkFormat format);
+    // UNDEFINED follows IRenderer::preferred_offscreen_format
+    VkFormat offscreen_format_override_{VK_FORMAT_UNDEFINED};
 
     struct AllocatedImage
     {
@@ -101,16 +153,22 @@ private: // Swapchain and Offscreen Drawable
         VkExtent2D swapchain_extent{};
         std::vector<VkImage> swapchain_images;
         std::vector<VkImageView> swapchain_image_views;
+        // bindless storage handles of the swapchain images (caps.storageSwapchain only)
+        std::vector<uint32_t> swapchain_storage_indices;
         // Engine-offered offscreen target for content
         AllocatedImage drawable_image;
-        AllocatedImage depth_image{};
+        uint32_t drawable_storage_index{BindlessHeap::InvalidIndex};
+        // sampled in GENERAL by the composite pass
+        uint32_t drawable_sampled_index{BindlessHeap::InvalidIndex};
     } swapchain_;
 
 private: // Frame Rendering
     void create_command_buffers();
     void destroy_command_buffers();
     void begin_frame(uint32_t& imageIndex, VkCommandBuffer& cmd);
-    void end_frame(uint32_t imageIndex, VkCommandBuffer cmd);
+    void end_frame(uint32_t imageIndex, VkCommandBuffer cmd, bool directPresent);
+    // Records, submits and presents one frame; false when the swapchain was out of date
+    bool draw_frame(bool rendererDirty);
 
     struct FrameData
     {
@@ -120,18 +178,105 @@ private: // Frame Rendering
         VkCommandPool commandPool{};
         VkCommandBuffer mainCommandBuffer{};
         DeletionQueue deletionQueue;
+        DescriptorAllocatorGrowable frameDescriptors;
+        DescriptorBufferRing descriptorRing; // only initialised when caps.descriptorBuffer
+        ScratchAllocator scratch;
+        FrameArena arena;
+        GpuTimer timer; // scopes are GpuScope values
     } frames_[FRAME_OVERLAP];
 
+    enum GpuScope : uint32_t
+    {
+        GpuScopeRenderer = 0,
+        GpuScopeComposite,
+        GpuScopeFrame,
+        GpuScopeCount
+    };
+
+    FrameData& current_frame() { return frames_[state_.frame_number % FRAME_OVERLAP]; }
+    // Waits for the frame's fence, resolves its timers and rewinds its per-frame resources
+    void wait_frame(FrameData& fr);
+
+    // Renderer attachments requested per frame; shared by the frames in flight like the offscreen target
+    TransientPool transients_;
+    // Offscreen target + UI -> swapchain image, recorded after the renderer every frame
+    CompositePass composite_;
+    // Shared histogram / reduction / scan / compaction kernels, handed to renderers via RenderContext
+    ComputePrimitives primitives_;
+    // Blocking one-off submissions (uploads / readbacks), handed to renderers via RenderContext
+    ImmediateSubmit immediate_;
+    // Dirty area of the offscreen target and the matching VK_KHR_incremental_present rectangles
+    void collect_present_regions();
+    DamageRegion damage_;
+    bool present_full_{true};
+    std::vector<VkRectLayerKHR> present_rects_;
+    std::vector<VkRect2D> ui_rects_, prev_ui_rects_;
+
+    // On-demand rendering bookkeeping (state_.on_demand)
+    void invalidate_frame();
+    struct
+    {
+        uint32_t wakeEvent{0};      // SDL event type pushed by request_redraw()
+        uint32_t settleFrames{0};   // frames still drawn after input or engine changes
+        bool offscreenValid{false}; // the offscreen target holds the renderer's latest output
+        bool presentCurrent{false}; // the last presented image shows the current renderer output and UI
+        uint64_t drawnFrames{0};
+        uint64_t rendererSkips{0};  // drawn frames that re-composited the previous renderer output
+        uint64_t idleNs{0};         // time spent waiting for events instead of drawing
+    } redraw_;
+
 private: // Renderer
+    RenderContext make_render_context();
     void create_renderer();
     void destroy_renderer();
+    void switch_renderer(const RendererInfo& info);
     std::unique_ptr<IRenderer> renderer_;
+    std::string renderer_name_{"default"};
+    uint32_t bench_frames_{0};
 
 private: // ImGui
     void create_imgui();
     void destroy_imgui();
     std::unique_ptr<ImGuiLayer> ui_;
     DeletionQueue mdq_;
+    // Objects retired while frames may still use them; tagged with frame_number
+    TypedDeletionQueue retired_;
+
+private: // Benchmarks (run between frames, triggered from the debug panel)
+    void draw_bench_panel();
+    bool soak_resize(uint32_t iterations, std::string& report);
+    std::function<void()> pending_bench_;
+
+    // Runs the current renderer for a fixed number of frames per step and records the frame's GPU time.
+    // Each step's apply() runs between frames like pending_bench_; restore() runs at the end.
+    struct TimingStep
+    {
+        std::string label;
+        std::function<void()> apply;
+    };
+    struct GpuTiming
+    {
+        std::string renderer;
+        std::string variant;
+        double gpuMs;
+    };
+    void start_timing_sweep(std::vector<TimingStep> steps, std::function<void()> restore,
+                            std::function<void(const std::vector<double>&)> report = {});
+    void step_timing_sweep();
+    struct
+    {
+        bool active{false};
+        size_t index{0};
+        uint32_t frames{0};
+        uint32_t samples{0};
+        double sum{0.0};
+        std::vector<TimingStep> steps;
+        std::function<void()> restore;
+        // per-step averages handed to report() when the sweep finishes
+        std::vector<double> results;
+        std::function<void(const std::vector<double>&)> report;
+    } timing_sweep_;
+    std::vector<GpuTiming> gpu_timings_;
 };
 
 